@@ -0,0 +1,410 @@
+
+#import <GLTFKit2/GLTFAsset.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The local translation, rotation, scale and morph weights of every node of an asset, stored in flat arrays indexed
+/// by the node's position in the asset's `nodes`, for evaluating animations without a renderer.
+GLTFKIT2_EXPORT
+@interface GLTFAnimationPose : NSObject
+
+@property (nonatomic, readonly) NSInteger nodeCount;
+/// Three floats per node
+@property (nonatomic, readonly) const float *translations NS_RETURNS_INNER_POINTER;
+/// Four floats (a unit quaternion, x y z w) per node
+@property (nonatomic, readonly) const float *rotations NS_RETURNS_INNER_POINTER;
+/// Three floats per node
+@property (nonatomic, readonly) const float *scales NS_RETURNS_INNER_POINTER;
+/// The morph target weights of every node, in a run per node; see `weightRangeForNodeAtIndex:`
+@property (nonatomic, readonly) const float *weights NS_RETURNS_INNER_POINTER;
+@property (nonatomic, readonly) NSInteger weightCount;
+
+/// Creates a pose holding the rest transforms and weights of the nodes of `asset`.
+- (instancetype)initWithAsset:(GLTFAsset *)asset NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Restores the rest transforms and weights that the pose was created with.
+- (void)resetToRestPose;
+
+- (simd_float3)translationForNodeAtIndex:(NSInteger)index;
+- (simd_quatf)rotationForNodeAtIndex:(NSInteger)index;
+- (simd_float3)scaleForNodeAtIndex:(NSInteger)index;
+/// Returns the node's local transform, composed from its translation, rotation and scale.
+- (simd_float4x4)localTransformForNodeAtIndex:(NSInteger)index;
+/// Returns the range of `weights` that holds the node's morph target weights, which is empty if it has none.
+- (NSRange)weightRangeForNodeAtIndex:(NSInteger)index;
+
+@end
+
+/// The key intervals at which a clip was last sampled for one playing instance. While playback moves forward or
+/// backward smoothly, the cursor lets each channel find its keys without searching. A cursor may be used with any
+/// clip, but each instance that is sampled concurrently needs one of its own.
+GLTFKIT2_EXPORT
+@interface GLTFAnimationCursor : NSObject
+@end
+
+/// An animation prepared for fast, repeated evaluation: the key times and values of all channels are decoded into
+/// shared arrays, and channels are grouped by interpolation so that translation, rotation and scale channels are
+/// evaluated four at a time. Linear rotations use spherical linear interpolation, and cubic splines are evaluated as
+/// Hermite curves using their in- and out-tangents, as the glTF specification prescribes. A clip is immutable, and
+/// may be sampled from any number of threads at once.
+GLTFKIT2_EXPORT
+@interface GLTFAnimationClip : NSObject
+
+@property (nonatomic, readonly) GLTFAnimation *animation;
+/// The time of the last key of any channel
+@property (nonatomic, readonly) NSTimeInterval duration;
+
+/// Prepares `animation`, whose channels target nodes of `asset`. Channels without a target node are ignored. Returns
+/// nil and sets `error` if a channel's keys or values are invalid.
+- (nullable instancetype)initWithAnimation:(GLTFAnimation *)animation
+                                     asset:(GLTFAsset *)asset
+                                     error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Evaluates every channel at `time` and writes the results to `pose`, which must have been created for the same
+/// asset; properties that no channel animates keep their values. Times before the first key or after the last
+/// take the first or last value. Returns NO if the pose does not have the clip's nodes.
+- (BOOL)sampleAtTime:(NSTimeInterval)time cursor:(GLTFAnimationCursor *)cursor pose:(GLTFAnimationPose *)pose;
+
+@end
+
+/// Samples `clip` for many instances at once, in parallel: instance i is sampled at `times[i]` with `cursors[i]`
+/// into `poses[i]`. The arrays must have the same count, and no cursor or pose may appear twice.
+GLTFKIT2_EXPORT
+void GLTFAnimationClipSampleInstances(GLTFAnimationClip *clip,
+                                      const NSTimeInterval *times,
+                                      NSArray<GLTFAnimationCursor *> *cursors,
+                                      NSArray<GLTFAnimationPose *> *poses);
+
+/// The size and accuracy of a compressed clip. Errors are the largest differences from the uncompressed clip, measured
+/// at four times the sample rate, so they include the error of interpolating between samples.
+typedef struct GLTFAnimationCompressionStatistics {
+    /// The size of the key times and values of the uncompressed clip
+    NSInteger uncompressedByteCount;
+    NSInteger compressedByteCount;
+    NSInteger channelCount;
+    NSInteger constantChannelCount;
+    /// Channels that no quantization reproduces within the tolerance, which are stored as floats
+    NSInteger floatChannelCount;
+    float maxTranslationError;
+    /// In radians
+    float maxRotationError;
+    float maxScaleError;
+    float maxWeightError;
+} GLTFAnimationCompressionStatistics;
+
+/// An animation resampled at a fixed rate and quantized, for playing many clips on many instances in a fraction of
+/// the memory of a `GLTFAnimationClip`. Rotations are stored as 48-bit quaternions (the three smallest components in
+/// 15 bits each); translations, scales and morph weights are stored relative to their range in each segment of 16
+/// samples, with as few bits per component as keep them within the tolerance. Channels whose values never change
+/// are stored once. Any time is decoded from a single segment, so no cursor is needed, and channels are decoded four
+/// at a time. Step channels change value at the sample times nearest their keys. A clip is immutable, and may be
+/// sampled from any number of threads at once.
+GLTFKIT2_EXPORT
+@interface GLTFCompressedAnimationClip : NSObject
+
+@property (nonatomic, readonly) GLTFAnimation *animation;
+@property (nonatomic, readonly) NSTimeInterval duration;
+/// Samples per second
+@property (nonatomic, readonly) double sampleRate;
+@property (nonatomic, readonly) GLTFAnimationCompressionStatistics statistics;
+
+/// Compresses `animation`, whose channels target nodes of `asset`, sampling it `sampleRate` times per second.
+/// Translations, scales and weights are kept within `positionTolerance` of their values at each sample; rotations
+/// that never move by more than `angleTolerance` radians are stored as constants. Returns nil and sets `error` if a
+/// channel's keys or values are invalid, the animation has no channels, or the sample rate is not positive.
+- (nullable instancetype)initWithAnimation:(GLTFAnimation *)animation
+                                     asset:(GLTFAsset *)asset
+                                sampleRate:(double)sampleRate
+                         positionTolerance:(float)positionTolerance
+                            angleTolerance:(float)angleTolerance
+                                     error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Evaluates every channel at `time`, clamped to the clip's duration, and writes the results to `pose`, which must
+/// have been created for the same asset. Returns NO if the pose does not have the clip's nodes.
+- (BOOL)sampleAtTime:(NSTimeInterval)time pose:(GLTFAnimationPose *)pose;
+
+@end
+
+/// Samples `clip` for many instances at once, in parallel: instance i is sampled at `times[i]` into `poses[i]`. No
+/// pose may appear twice.
+GLTFKIT2_EXPORT
+void GLTFCompressedAnimationClipSampleInstances(GLTFCompressedAnimationClip *clip,
+                                                const NSTimeInterval *times,
+                                                NSArray<GLTFAnimationPose *> *poses);
+
+/// The nodes of a scene flattened into arrays, for evaluating transforms without a renderer. Nodes are in depth-first
+/// order, so that each follows its parent and the nodes of each subtree are contiguous, and their translations,
+/// rotations, scales, local and world transforms are each stored in an array of their own. Changing a node's local
+/// transform marks it dirty; `updateWorldTransforms` then recomposes the world transforms of dirty subtrees only,
+/// in parallel across independent subtrees. A graph must not be changed or updated on several threads at once.
+GLTFKIT2_EXPORT
+@interface GLTFSceneGraph : NSObject
+
+@property (nonatomic, readonly) GLTFScene *scene;
+/// The nodes of the scene in the graph's order
+@property (nonatomic, readonly) NSArray<GLTFNode *> *nodes;
+@property (nonatomic, readonly) NSInteger nodeCount;
+/// The index of each node's parent in `nodes`, or -1 for the scene's root nodes
+@property (nonatomic, readonly) const int32_t *parentIndices NS_RETURNS_INNER_POINTER;
+/// Three floats per node
+@property (nonatomic, readonly) const float *translations NS_RETURNS_INNER_POINTER;
+/// Four floats (a unit quaternion, x y z w) per node
+@property (nonatomic, readonly) const float *rotations NS_RETURNS_INNER_POINTER;
+/// Three floats per node
+@property (nonatomic, readonly) const float *scales NS_RETURNS_INNER_POINTER;
+@property (nonatomic, readonly) const simd_float4x4 *localTransforms NS_RETURNS_INNER_POINTER;
+/// The transform of each node relative to the scene's root, as of the last update
+@property (nonatomic, readonly) const simd_float4x4 *worldTransforms NS_RETURNS_INNER_POINTER;
+
+/// Flattens the nodes of `scene`, which must belong to `asset`, taking their transforms from their `matrix`, and
+/// composes their world transforms. A node reached more than once is only included the first time, and nodes that
+/// are not among the asset's nodes are left out.
+- (instancetype)initWithAsset:(GLTFAsset *)asset scene:(GLTFScene *)scene NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Returns the index of `node` in `nodes`, or NSNotFound if it is not in the scene.
+- (NSInteger)indexOfNode:(GLTFNode *)node;
+/// Returns the index after the last node of the subtree at `index`.
+- (NSInteger)subtreeEndForNodeAtIndex:(NSInteger)index;
+
+/// Sets the local transform of the node at `index` from a translation, rotation and scale, marking the node dirty
+/// if they change.
+- (void)setTranslation:(simd_float3)translation
+              rotation:(simd_quatf)rotation
+                 scale:(simd_float3)scale
+        forNodeAtIndex:(NSInteger)index;
+/// Sets the local transform of the node at `index` directly, marking the node dirty.
+- (void)setLocalTransform:(simd_float4x4)transform forNodeAtIndex:(NSInteger)index;
+
+/// Copies the translation, rotation and scale of each node from `pose`, which must have been created for the same
+/// asset, marking the nodes whose transforms change. Returns NO if the pose does not have the asset's nodes.
+- (BOOL)applyPose:(GLTFAnimationPose *)pose;
+
+/// Recomposes the world transforms of every dirty node and its descendants, and returns how many were updated.
+- (NSInteger)updateWorldTransforms;
+
+@end
+
+typedef struct GLTFBoundingSphere {
+    simd_float3 center;
+    /// Negative if the sphere bounds nothing
+    float radius;
+} GLTFBoundingSphere;
+
+/// Writes the six planes of the view frustum of `viewProjectionMatrix`, which maps to clip space with depths from 0
+/// to 1 as Metal does, to `outPlanes`, in the form that `cullWithPlanes:count:nodeIndices:primitiveIndices:` takes.
+GLTFKIT2_EXPORT
+void GLTFFrustumPlanesFromViewProjectionMatrix(simd_float4x4 viewProjectionMatrix, simd_float4 *outPlanes);
+
+/// World-space bounding boxes of every primitive of a scene graph's nodes, of each node's primitives together, and of
+/// each node's subtree, for culling large scenes with hierarchical early-out. Primitives are numbered in the order of
+/// the graph's nodes, and within a node in the order of its mesh's primitives. A primitive's box comes from the
+/// bounds of its positions, widened by those of its POSITION morph targets for weights between 0 and 1; the box of
+/// an instanced node covers every instance, and that of a skinned node the primitive transformed by each joint.
+GLTFKIT2_EXPORT
+@interface GLTFSceneBounds : NSObject
+
+@property (nonatomic, readonly) GLTFSceneGraph *sceneGraph;
+@property (nonatomic, readonly) NSInteger primitiveCount;
+/// The bounds of everything in the scene
+@property (nonatomic, readonly) GLTFBoundingBox boundingBox;
+
+/// Computes the bounds of the nodes of `sceneGraph` from its world transforms. Positions are scanned for primitives
+/// whose accessors have no bounds.
+- (instancetype)initWithSceneGraph:(GLTFSceneGraph *)sceneGraph NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Recomputes the bounds of the subtrees whose world transforms changed at the scene graph's last update, and of
+/// skinned nodes, then those of their ancestors' subtrees. Call it after each update of the graph, or call
+/// `updateAllBounds` if the graph has been updated more than once since.
+- (void)update;
+/// Recomputes the bounds of every node, in parallel.
+- (void)updateAllBounds;
+
+/// Returns the node's primitives as a range of the numbering of all primitives.
+- (NSRange)primitiveRangeForNodeAtIndex:(NSInteger)index;
+- (GLTFBoundingBox)boundingBoxForPrimitiveAtIndex:(NSInteger)index;
+/// Returns the bounds of the node's primitives, which are empty if it has none.
+- (GLTFBoundingBox)boundingBoxForNodeAtIndex:(NSInteger)index;
+/// Returns the bounds of the primitives of the node and its descendants.
+- (GLTFBoundingBox)subtreeBoundingBoxForNodeAtIndex:(NSInteger)index;
+/// Returns the sphere around `boundingBoxForNodeAtIndex:`.
+- (GLTFBoundingSphere)boundingSphereForNodeAtIndex:(NSInteger)index;
+/// Returns the sphere around `subtreeBoundingBoxForNodeAtIndex:`.
+- (GLTFBoundingSphere)subtreeBoundingSphereForNodeAtIndex:(NSInteger)index;
+
+/// Finds the primitives whose boxes intersect the convex volume bounded by `planes`, each (a, b, c, d) bounding the
+/// points p with dot(abc, p) + d >= 0, such as a view frustum. Subtrees outside a plane are skipped and those inside
+/// every plane are accepted whole, testing four planes at a time. The UInt32 indices of the visible primitives, and
+/// of the nodes that draw them, replace the contents of `primitiveIndices` and `nodeIndices`. Returns the number of
+/// visible primitives.
+- (NSInteger)cullWithPlanes:(const simd_float4 *)planes
+                      count:(NSInteger)count
+                nodeIndices:(nullable NSMutableData *)nodeIndices
+           primitiveIndices:(nullable NSMutableData *)primitiveIndices;
+
+@end
+
+typedef NS_ENUM(NSInteger, GLTFSkinPaletteFormat) {
+    /// 16 floats per joint: a column-major 4x4 matrix
+    GLTFSkinPaletteFormat4x4,
+    /// 12 floats per joint: the first three rows of the joint's affine transform, each of four floats, which a vertex
+    /// function applies to a position by taking its dot product with each row
+    GLTFSkinPaletteFormat3x4,
+};
+
+typedef NS_ENUM(NSInteger, GLTFSkinningMethod) {
+    /// Blend the skinning matrices of each vertex's joints
+    GLTFSkinningMethodLinearBlend,
+    /// Blend the rotations and translations of each vertex's joints as dual quaternions, which keeps the volume
+    /// of twisting joints, after blending their scale and shear linearly
+    GLTFSkinningMethodDualQuaternion,
+};
+
+/// The positions, normals and tangents of a skinned primitive, deformed on the CPU.
+GLTFKIT2_EXPORT
+@interface GLTFSkinnedVertices : NSObject
+
+@property (nonatomic, readonly) NSInteger vertexCount;
+/// Three floats per vertex
+@property (nonatomic, readonly) NSData *positions;
+/// Three floats per vertex, or nil if the primitive has no normals
+@property (nonatomic, nullable, readonly) NSData *normals;
+/// Four floats per vertex, the last being the handedness, or nil if the primitive has no tangents
+@property (nonatomic, nullable, readonly) NSData *tangents;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/// The joints and inverse bind matrices of every skin of an asset, gathered into contiguous arrays so that the
+/// skinning matrices of all skins can be computed from a pose in one call. A skinning matrix is the world transform
+/// of a joint times its inverse bind matrix; as the glTF specification prescribes, it does not depend on the
+/// transform of the node that draws the skinned mesh.
+GLTFKIT2_EXPORT
+@interface GLTFSkinPaletteSet : NSObject
+
+@property (nonatomic, readonly) NSArray<GLTFSkin *> *skins;
+/// The number of joints of all skins together
+@property (nonatomic, readonly) NSInteger jointCount;
+
+/// Prepares the skins of `asset`. Returns nil and sets `error` if a skin has a joint that is not a node of the asset,
+/// or has fewer inverse bind matrices than joints.
+- (nullable instancetype)initWithAsset:(GLTFAsset *)asset error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Returns the joints of the skin at `index` of `skins`, as a range of the joints of all skins.
+- (NSRange)jointRangeForSkinAtIndex:(NSInteger)index;
+
+/// Composes the world transforms of the joints from `pose`, which must have been created for the same asset, and
+/// writes the skinning matrices of every skin to `palettes`, in parallel across skins. The skin at index i starts
+/// at joint `[self jointRangeForSkinAtIndex:i].location`; `palettes` must hold `jointCount` joints of the given
+/// format. The set keeps scratch storage for the world transforms, so it must not compute palettes on several
+/// threads at once. Returns NO if the pose does not have the asset's nodes.
+- (BOOL)computePalettesForPose:(GLTFAnimationPose *)pose
+                        format:(GLTFSkinPaletteFormat)format
+                      palettes:(float *)palettes;
+
+/// Writes the skinning matrices of every skin to `palettes` as `computePalettesForPose:format:palettes:` does, taking
+/// the world transforms of the joints from `sceneGraph`, which must have been created for the same asset and be up
+/// to date. Returns NO if a joint is not in the graph's scene.
+- (BOOL)computePalettesForSceneGraph:(GLTFSceneGraph *)sceneGraph
+                              format:(GLTFSkinPaletteFormat)format
+                            palettes:(float *)palettes;
+
+/// Returns the method that `skinnedVerticesForPrimitive:skinAtIndex:palettes:format:error:` uses for the skin at
+/// `index`, which is linear blend skinning unless it has been changed.
+- (GLTFSkinningMethod)skinningMethodForSkinAtIndex:(NSInteger)index;
+
+- (void)setSkinningMethod:(GLTFSkinningMethod)method forSkinAtIndex:(NSInteger)index;
+
+/// Deforms the POSITION, NORMAL and TANGENT attributes of `primitive` by the skin at `index`, using its matrices in
+/// `palettes` as computed by `computePalettesForPose:format:palettes:` with `format`. Every JOINTS_n and WEIGHTS_n
+/// pair contributes influences, so vertices may have more than four; joints may be 8- or 16-bit, and weights float
+/// or normalized 8- or 16-bit integers, and are renormalized to sum to one. Normals and tangents are deformed so that
+/// they stay perpendicular to the surface under non-uniform scale. Vertices are processed in parallel. Returns nil
+/// and sets `error` if the primitive lacks positions or joints and weights, or a vertex refers to a joint the skin
+/// does not have.
+- (nullable GLTFSkinnedVertices *)skinnedVerticesForPrimitive:(GLTFPrimitive *)primitive
+                                                  skinAtIndex:(NSInteger)index
+                                                     palettes:(const float *)palettes
+                                                       format:(GLTFSkinPaletteFormat)format
+                                                        error:(NSError **)error;
+
+@end
+
+/// The morph targets of one attribute of a primitive, stored compactly for blending on the CPU. Each target keeps
+/// only the indices and deltas of the vertices it moves: those of a sparse accessor without a buffer view are taken
+/// as they are, and zero deltas are dropped from the rest. Targets that move most vertices are stored densely.
+GLTFKIT2_EXPORT
+@interface GLTFMorphTargetBlender : NSObject
+
+@property (nonatomic, readonly) NSString *attributeName;
+@property (nonatomic, readonly) NSInteger vertexCount;
+/// The floats per vertex of the base attribute, and of blended output. Targets of tangents leave the handedness
+/// unchanged.
+@property (nonatomic, readonly) NSInteger componentCount;
+@property (nonatomic, readonly) NSInteger targetCount;
+/// The number of vertex deltas stored for all targets, at most `targetCount * vertexCount`
+@property (nonatomic, readonly) NSInteger storedDeltaCount;
+/// The size of the stored deltas and their indices
+@property (nonatomic, readonly) NSInteger byteCount;
+
+/// Prepares the targets of `primitive` for the attribute named `attributeName`, such as POSITION or NORMAL. Targets
+/// that do not have the attribute do not move it. Returns nil and sets `error` if the primitive lacks the attribute,
+/// or a target's accessor is invalid or has a different count.
+- (nullable instancetype)initWithPrimitive:(GLTFPrimitive *)primitive
+                             attributeName:(NSString *)attributeName
+                                     error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Writes the base attribute plus the deltas of each target scaled by its weight to `buffer`, which must hold
+/// `vertexCount * componentCount` floats. Only `count` weights are read; targets beyond them and targets of zero
+/// weight are skipped. Blending reads no mutable state, so it may run on several threads at once.
+- (void)blendWeights:(const float *)weights count:(NSInteger)count intoBuffer:(float *)buffer;
+
+/// Blends with the morph weights of the node at `index` in `pose`, returning `vertexCount * componentCount` floats.
+- (NSData *)blendedDataForPose:(GLTFAnimationPose *)pose nodeAtIndex:(NSInteger)index;
+
+@end
+
+typedef struct GLTFKeyframeReductionStatistics {
+    NSInteger samplerCount;
+    /// Samplers reduced to a single key because their values never change beyond the tolerance
+    NSInteger constantSamplerCount;
+    /// Cubic spline samplers that became linear
+    NSInteger convertedCubicSamplerCount;
+    NSInteger keyCountBefore;
+    NSInteger keyCountAfter;
+    /// The size of the samplers' key times and values
+    NSInteger byteCountBefore;
+    NSInteger byteCountAfter;
+} GLTFKeyframeReductionStatistics;
+
+/// Replaces the keys of each sampler of `animation` with as few linearly interpolated float keys as reproduce it to
+/// within `positionTolerance` (for translations, scales and morph weights) and `angleTolerance` radians (for
+/// rotations). Each sampler is resampled at `sampleRate` samples per second (or, if it is 0, at its own key times),
+/// then keys are removed Ramer–Douglas–Peucker style, with samplers processed in parallel. Cubic splines are
+/// evaluated exactly and converted to linear keys unless that would take more storage; samplers whose values never
+/// change collapse to one key; step samplers only lose repeated keys. Returns the new input and output accessors,
+/// each with a buffer view and buffer of its own, so that they can be added to the asset, or nil and sets `error`
+/// if a sampler's data is invalid, in which case the animation is left unchanged.
+GLTFKIT2_EXPORT
+NSArray<GLTFAccessor *> *_Nullable GLTFAnimationReduceKeyframes(GLTFAnimation *animation,
+                                                                double sampleRate,
+                                                                float positionTolerance,
+                                                                float angleTolerance,
+                                                                GLTFKeyframeReductionStatistics *_Nullable outStatistics,
+                                                                NSError **error);
+
+NS_ASSUME_NONNULL_END
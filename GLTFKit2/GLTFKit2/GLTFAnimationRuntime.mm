@@ -0,0 +1,1100 @@
+
+#import "GLTFAnimationRuntime.h"
+#import "GLTFAccessorViewSupport.h"
+#import "GLTFLogging.h"
+
+#include "GLTFAnimationCompression.h"
+#include "GLTFAnimationSampling.h"
+#include "GLTFKeyframeReduction.h"
+#include "GLTFMorphBlending.h"
+#include "GLTFSceneBounds.h"
+#include "GLTFSceneGraph.h"
+#include "GLTFSkinPalettes.h"
+#include "GLTFSkinning.h"
+
+#include <unordered_map>
+#include <vector>
+
+static NSError *GLTFAnimationRuntimeError(NSString *description) {
+    return [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeInvalidGLTF userInfo:@{
+        NSLocalizedDescriptionKey : description
+    }];
+}
+
+// Returns the number of morph weights that animations of `node` drive: those of its mesh's targets.
+static NSInteger GLTFMorphWeightCountForNode(GLTFNode *node) {
+    if (node.weights.count > 0) {
+        return (NSInteger)node.weights.count;
+    }
+    if (node.mesh.weights.count > 0) {
+        return (NSInteger)node.mesh.weights.count;
+    }
+    return (NSInteger)node.mesh.primitives.firstObject.targets.count;
+}
+
+// Returns the index of each node's first morph weight in a pose of the nodes of `asset`, followed by the total.
+static std::vector<uint32_t> GLTFMorphWeightOffsetsForAsset(GLTFAsset *asset) {
+    std::vector<uint32_t> offsets(asset.nodes.count + 1, 0);
+    for (NSUInteger i = 0; i < asset.nodes.count; ++i) {
+        offsets[i + 1] = offsets[i] + (uint32_t)GLTFMorphWeightCountForNode(asset.nodes[i]);
+    }
+    return offsets;
+}
+
+@interface GLTFAnimationPose ()
+@property (nonatomic, readonly) GLTF::AnimationPose *corePose;
+@end
+
+@implementation GLTFAnimationPose {
+    GLTF::AnimationPose _pose;
+    GLTF::AnimationPose _restPose;
+    std::vector<uint32_t> _weightOffsets;
+}
+
+- (instancetype)initWithAsset:(GLTFAsset *)asset {
+    if (self = [super init]) {
+        const size_t nodeCount = asset.nodes.count;
+        _nodeCount = (NSInteger)nodeCount;
+        _weightOffsets = GLTFMorphWeightOffsetsForAsset(asset);
+        _restPose.translations.resize(3 * nodeCount);
+        _restPose.rotations.resize(4 * nodeCount);
+        _restPose.scales.resize(3 * nodeCount);
+        _restPose.weights.assign(_weightOffsets.back(), 0.0f);
+        for (size_t i = 0; i < nodeCount; ++i) {
+            GLTFNode *node = asset.nodes[i];
+            const simd_float3 t = node.translation, s = node.scale;
+            const simd_float4 r = node.rotation.vector;
+            for (int c = 0; c < 3; ++c) {
+                _restPose.translations[3 * i + c] = t[c];
+                _restPose.scales[3 * i + c] = s[c];
+            }
+            for (int c = 0; c < 4; ++c) {
+                _restPose.rotations[4 * i + c] = r[c];
+            }
+            NSArray<NSNumber *> *weights = node.weights ?: node.mesh.weights;
+            const uint32_t weightCount = _weightOffsets[i + 1] - _weightOffsets[i];
+            for (uint32_t w = 0; w < weightCount && w < weights.count; ++w) {
+                _restPose.weights[_weightOffsets[i] + w] = weights[w].floatValue;
+            }
+        }
+        _weightCount = (NSInteger)_weightOffsets.back();
+        _pose = _restPose;
+    }
+    return self;
+}
+
+- (GLTF::AnimationPose *)corePose {
+    return &_pose;
+}
+
+- (const float *)translations {
+    return _pose.translations.data();
+}
+
+- (const float *)rotations {
+    return _pose.rotations.data();
+}
+
+- (const float *)scales {
+    return _pose.scales.data();
+}
+
+- (const float *)weights {
+    return _pose.weights.data();
+}
+
+- (void)resetToRestPose {
+    _pose = _restPose;
+}
+
+- (simd_float3)translationForNodeAtIndex:(NSInteger)index {
+    const float *t = &_pose.translations[3 * index];
+    return simd_make_float3(t[0], t[1], t[2]);
+}
+
+- (simd_quatf)rotationForNodeAtIndex:(NSInteger)index {
+    const float *r = &_pose.rotations[4 * index];
+    return simd_quaternion(r[0], r[1], r[2], r[3]);
+}
+
+- (simd_float3)scaleForNodeAtIndex:(NSInteger)index {
+    const float *s = &_pose.scales[3 * index];
+    return simd_make_float3(s[0], s[1], s[2]);
+}
+
+- (simd_float4x4)localTransformForNodeAtIndex:(NSInteger)index {
+    const simd_float3 s = [self scaleForNodeAtIndex:index];
+    simd_float4x4 transform = simd_matrix4x4([self rotationForNodeAtIndex:index]);
+    transform.columns[0] *= s.x;
+    transform.columns[1] *= s.y;
+    transform.columns[2] *= s.z;
+    transform.columns[3] = simd_make_float4([self translationForNodeAtIndex:index], 1.0f);
+    return transform;
+}
+
+- (NSRange)weightRangeForNodeAtIndex:(NSInteger)index {
+    return NSMakeRange(_weightOffsets[index], _weightOffsets[index + 1] - _weightOffsets[index]);
+}
+
+@end
+
+@interface GLTFAnimationCursor ()
+@property (nonatomic, readonly) GLTF::AnimationCursor *coreCursor;
+@end
+
+@implementation GLTFAnimationCursor {
+    GLTF::AnimationCursor _cursor;
+}
+
+- (GLTF::AnimationCursor *)coreCursor {
+    return &_cursor;
+}
+
+@end
+
+@interface GLTFAnimationClip ()
+@property (nonatomic, readonly) const GLTF::AnimationClip *coreClip;
+@end
+
+@interface GLTFCompressedAnimationClip ()
+@property (nonatomic, readonly) const GLTF::CompressedAnimationClip *coreClip;
+@end
+
+@implementation GLTFAnimationClip {
+    GLTF::AnimationClip _clip;
+}
+
+- (instancetype)initWithAnimation:(GLTFAnimation *)animation asset:(GLTFAsset *)asset error:(NSError **)error {
+    if (self = [super init]) {
+        _animation = animation;
+        const std::vector<uint32_t> weightOffsets = GLTFMorphWeightOffsetsForAsset(asset);
+        for (GLTFAnimationChannel *channel in animation.channels) {
+            const NSInteger assetIndex = GLTFIndexOfObjectInArray(channel.target.node, asset.nodes);
+            if (assetIndex == NSNotFound) {
+                continue;
+            }
+            const uint32_t nodeIndex = (uint32_t)assetIndex;
+            NSString *path = channel.target.path;
+            int corePath = GLTF::AnimationPathTranslation;
+            uint32_t target = nodeIndex, componentCount = 3;
+            if ([path isEqualToString:GLTFAnimationPathRotation]) {
+                corePath = GLTF::AnimationPathRotation;
+                componentCount = 4;
+            } else if ([path isEqualToString:GLTFAnimationPathScale]) {
+                corePath = GLTF::AnimationPathScale;
+            } else if ([path isEqualToString:GLTFAnimationPathWeights]) {
+                corePath = GLTF::AnimationPathWeights;
+                target = weightOffsets[nodeIndex];
+                componentCount = weightOffsets[nodeIndex + 1] - weightOffsets[nodeIndex];
+                if (componentCount == 0) {
+                    continue;
+                }
+            } else if (![path isEqualToString:GLTFAnimationPathTranslation]) {
+                continue;
+            }
+            NSData *inputStorage = nil, *outputStorage = nil;
+            const GLTF::AccessorView input = GLTFAccessorViewForAccessor(channel.sampler.input, &inputStorage);
+            const GLTF::AccessorView output = GLTFAccessorViewForAccessor(channel.sampler.output, &outputStorage);
+            if (!_clip.addTrack(corePath, (int)channel.sampler.interpolationMode, target, componentCount,
+                                input, output))
+            {
+                if (error) {
+                    *error = GLTFAnimationRuntimeError([NSString stringWithFormat:
+                        @"Animation channel targeting %@ of node %@ has invalid keys or values", path,
+                        channel.target.node.name ?: @"(unnamed)"]);
+                }
+                return nil;
+            }
+        }
+        _duration = _clip.duration();
+    }
+    return self;
+}
+
+- (const GLTF::AnimationClip *)coreClip {
+    return &_clip;
+}
+
+- (BOOL)sampleAtTime:(NSTimeInterval)time cursor:(GLTFAnimationCursor *)cursor pose:(GLTFAnimationPose *)pose {
+    return _clip.sample((float)time, *cursor.coreCursor, *pose.corePose);
+}
+
+@end
+
+void GLTFAnimationClipSampleInstances(GLTFAnimationClip *clip,
+                                      const NSTimeInterval *times,
+                                      NSArray<GLTFAnimationCursor *> *cursors,
+                                      NSArray<GLTFAnimationPose *> *poses)
+{
+    const size_t count = MIN(cursors.count, poses.count);
+    std::vector<float> coreTimes(count);
+    std::vector<GLTF::AnimationCursor *> coreCursors(count);
+    std::vector<GLTF::AnimationPose *> corePoses(count);
+    for (size_t i = 0; i < count; ++i) {
+        coreTimes[i] = (float)times[i];
+        coreCursors[i] = cursors[i].coreCursor;
+        corePoses[i] = poses[i].corePose;
+    }
+    GLTF::SampleAnimationInstances(*clip.coreClip, coreTimes.data(), coreCursors.data(), corePoses.data(), count);
+}
+
+@implementation GLTFCompressedAnimationClip {
+    GLTF::CompressedAnimationClip _clip;
+}
+
+- (instancetype)initWithAnimation:(GLTFAnimation *)animation
+                            asset:(GLTFAsset *)asset
+                       sampleRate:(double)sampleRate
+                positionTolerance:(float)positionTolerance
+                   angleTolerance:(float)angleTolerance
+                            error:(NSError **)error
+{
+    if (self = [super init]) {
+        GLTFAnimationClip *clip = [[GLTFAnimationClip alloc] initWithAnimation:animation asset:asset error:error];
+        if (clip == nil) {
+            return nil;
+        }
+        GLTF::AnimationCompressionSettings settings;
+        settings.sampleRate = (float)sampleRate;
+        settings.positionTolerance = positionTolerance;
+        settings.angleTolerance = angleTolerance;
+        GLTF::AnimationCompressionReport report;
+        if (!_clip.build(*clip.coreClip, settings, &report)) {
+            if (error) {
+                *error = GLTFAnimationRuntimeError(clip.coreClip->tracks().empty() ?
+                    @"Animation has no channels to compress" : @"Animation compression settings are invalid");
+            }
+            return nil;
+        }
+        _animation = animation;
+        _duration = _clip.duration();
+        _sampleRate = _clip.sampleRate();
+        _statistics.uncompressedByteCount = (NSInteger)report.sourceByteCount;
+        _statistics.compressedByteCount = (NSInteger)report.compressedByteCount;
+        _statistics.channelCount = (NSInteger)report.trackCount;
+        _statistics.constantChannelCount = (NSInteger)report.constantTrackCount;
+        _statistics.floatChannelCount = (NSInteger)report.rawTrackCount;
+        _statistics.maxTranslationError = report.maxTranslationError;
+        _statistics.maxRotationError = report.maxRotationError;
+        _statistics.maxScaleError = report.maxScaleError;
+        _statistics.maxWeightError = report.maxWeightError;
+    }
+    return self;
+}
+
+- (BOOL)sampleAtTime:(NSTimeInterval)time pose:(GLTFAnimationPose *)pose {
+    return _clip.sample((float)time, *pose.corePose);
+}
+
+- (const GLTF::CompressedAnimationClip *)coreClip {
+    return &_clip;
+}
+
+@end
+
+void GLTFCompressedAnimationClipSampleInstances(GLTFCompressedAnimationClip *clip,
+                                                const NSTimeInterval *times,
+                                                NSArray<GLTFAnimationPose *> *poses)
+{
+    const size_t count = poses.count;
+    std::vector<float> coreTimes(count);
+    std::vector<GLTF::AnimationPose *> corePoses(count);
+    for (size_t i = 0; i < count; ++i) {
+        coreTimes[i] = (float)times[i];
+        corePoses[i] = poses[i].corePose;
+    }
+    GLTF::SampleCompressedAnimationInstances(*clip.coreClip, coreTimes.data(), corePoses.data(), count);
+}
+
+static_assert(sizeof(GLTF::Matrix4x4) == sizeof(simd_float4x4) && alignof(GLTF::Matrix4x4) <= alignof(simd_float4x4),
+              "GLTF::Matrix4x4 must have the layout of simd_float4x4");
+
+// Appends `node` and its descendants to `nodes` in depth-first order, with the index of each one's parent in
+// `parents`, and records each one's index in `nodes` at its index in `assetNodes` in `graphIndices`. Nodes already
+// appended, and nodes not among `assetNodes`, are skipped.
+static void GLTFFlattenSubtree(GLTFNode *node, int32_t parent, NSArray<GLTFNode *> *assetNodes,
+                               NSMutableArray<GLTFNode *> *nodes, std::vector<int32_t> &parents,
+                               std::vector<int32_t> &graphIndices)
+{
+    const NSInteger assetIndex = GLTFIndexOfObjectInArray(node, assetNodes);
+    if (assetIndex == NSNotFound || graphIndices[(size_t)assetIndex] != -1) {
+        return;
+    }
+    const int32_t index = (int32_t)nodes.count;
+    graphIndices[(size_t)assetIndex] = index;
+    [nodes addObject:node];
+    parents.push_back(parent);
+    for (GLTFNode *child in node.childNodes) {
+        GLTFFlattenSubtree(child, index, assetNodes, nodes, parents, graphIndices);
+    }
+}
+
+@interface GLTFSceneGraph ()
+@property (nonatomic, readonly) GLTF::SceneGraph *coreGraph;
+@property (nonatomic, readonly) NSInteger assetNodeCount;
+/// The index in `nodes` of each node of the asset, or -1 for nodes not in the scene
+@property (nonatomic, readonly) const int32_t *graphIndicesForAssetNodes;
+@end
+
+@implementation GLTFSceneGraph {
+    GLTF::SceneGraph _graph;
+    std::vector<uint32_t> _assetNodeIndices; // The index in the asset's nodes of each node of the graph
+    std::vector<int32_t> _graphIndicesForAssetNodes;
+}
+
+- (instancetype)initWithAsset:(GLTFAsset *)asset scene:(GLTFScene *)scene {
+    if (self = [super init]) {
+        NSMutableArray<GLTFNode *> *nodes = [NSMutableArray array];
+        std::vector<int32_t> parents;
+        _graphIndicesForAssetNodes.assign(asset.nodes.count, -1);
+        for (GLTFNode *root in scene.nodes) {
+            GLTFFlattenSubtree(root, -1, asset.nodes, nodes, parents, _graphIndicesForAssetNodes);
+        }
+        _graph.build(parents.data(), parents.size());
+
+        _assetNodeCount = (NSInteger)asset.nodes.count;
+        _assetNodeIndices.resize(nodes.count);
+        for (size_t assetIndex = 0; assetIndex < _graphIndicesForAssetNodes.size(); ++assetIndex) {
+            if (_graphIndicesForAssetNodes[assetIndex] >= 0) {
+                _assetNodeIndices[(size_t)_graphIndicesForAssetNodes[assetIndex]] = (uint32_t)assetIndex;
+            }
+        }
+        for (NSUInteger i = 0; i < nodes.count; ++i) {
+            GLTFNode *node = nodes[i];
+            const simd_float3 t = node.translation, s = node.scale;
+            const simd_float4 r = node.rotation.vector;
+            const float translation[3] = { t.x, t.y, t.z }, scale[3] = { s.x, s.y, s.z };
+            const float rotation[4] = { r.x, r.y, r.z, r.w };
+            _graph.setTransform(i, translation, rotation, scale);
+            [self setLocalTransform:node.matrix forNodeAtIndex:(NSInteger)i];
+        }
+        _graph.updateWorldTransforms();
+        _scene = scene;
+        _nodes = [nodes copy];
+        _nodeCount = (NSInteger)nodes.count;
+    }
+    return self;
+}
+
+- (GLTF::SceneGraph *)coreGraph {
+    return &_graph;
+}
+
+- (const int32_t *)parentIndices {
+    return _graph.parentIndices();
+}
+
+- (const float *)translations {
+    return _graph.translations();
+}
+
+- (const float *)rotations {
+    return _graph.rotations();
+}
+
+- (const float *)scales {
+    return _graph.scales();
+}
+
+- (const simd_float4x4 *)localTransforms {
+    return (const simd_float4x4 *)_graph.localTransforms();
+}
+
+- (const simd_float4x4 *)worldTransforms {
+    return (const simd_float4x4 *)_graph.worldTransforms();
+}
+
+- (const int32_t *)graphIndicesForAssetNodes {
+    return _graphIndicesForAssetNodes.data();
+}
+
+- (NSInteger)indexOfNode:(GLTFNode *)node {
+    const NSInteger assetIndex = node.index;
+    if (assetIndex >= 0 && assetIndex < _assetNodeCount) {
+        const int32_t index = _graphIndicesForAssetNodes[(size_t)assetIndex];
+        if (index >= 0 && _nodes[(NSUInteger)index] == node) {
+            return (NSInteger)index;
+        }
+    }
+    // The node is not in the graph, or its index was reassigned by adding it to another asset
+    const NSUInteger index = (node != nil) ? [_nodes indexOfObjectIdenticalTo:node] : NSNotFound;
+    return (index != NSNotFound) ? (NSInteger)index : NSNotFound;
+}
+
+- (NSInteger)subtreeEndForNodeAtIndex:(NSInteger)index {
+    return (NSInteger)_graph.subtreeEnd((size_t)index);
+}
+
+- (void)setTranslation:(simd_float3)translation
+              rotation:(simd_quatf)rotation
+                 scale:(simd_float3)scale
+        forNodeAtIndex:(NSInteger)index
+{
+    const float t[3] = { translation.x, translation.y, translation.z };
+    const float r[4] = { rotation.vector.x, rotation.vector.y, rotation.vector.z, rotation.vector.w };
+    const float s[3] = { scale.x, scale.y, scale.z };
+    _graph.setTransform((size_t)index, t, r, s);
+}
+
+- (void)setLocalTransform:(simd_float4x4)transform forNodeAtIndex:(NSInteger)index {
+    GLTF::Matrix4x4 matrix;
+    memcpy(matrix.columns, &transform, sizeof(matrix.columns));
+    _graph.setLocalTransform((size_t)index, matrix);
+}
+
+- (BOOL)applyPose:(GLTFAnimationPose *)pose {
+    if (pose.nodeCount != _assetNodeCount) {
+        return NO;
+    }
+    return _graph.applyPose(*pose.corePose, _assetNodeIndices.data());
+}
+
+- (NSInteger)updateWorldTransforms {
+    return (NSInteger)_graph.updateWorldTransforms();
+}
+
+@end
+
+void GLTFFrustumPlanesFromViewProjectionMatrix(simd_float4x4 viewProjectionMatrix, simd_float4 *outPlanes) {
+    // Each plane bounds one clip-space coordinate by w, expressed through the rows of the matrix
+    const simd_float4x4 rows = simd_transpose(viewProjectionMatrix);
+    const simd_float4 x = rows.columns[0], y = rows.columns[1], z = rows.columns[2], w = rows.columns[3];
+    outPlanes[0] = w + x;
+    outPlanes[1] = w - x;
+    outPlanes[2] = w + y;
+    outPlanes[3] = w - y;
+    outPlanes[4] = z;
+    outPlanes[5] = w - z;
+}
+
+static GLTF::AxisAlignedBox GLTFEmptyAxisAlignedBox(void) {
+    GLTF::AxisAlignedBox box = { { INFINITY, INFINITY, INFINITY, 0.0f }, { -INFINITY, -INFINITY, -INFINITY, 0.0f } };
+    return box;
+}
+
+static GLTFBoundingBox GLTFBoundingBoxForAxisAlignedBox(const GLTF::AxisAlignedBox &box) {
+    GLTFBoundingBox result;
+    result.minPoint = simd_make_float3(box.min[0], box.min[1], box.min[2]);
+    result.maxPoint = simd_make_float3(box.max[0], box.max[1], box.max[2]);
+    return GLTFBoundingBoxIsEmpty(result) ? GLTFBoundingBoxEmpty : result;
+}
+
+static GLTFBoundingSphere GLTFBoundingSphereForBox(GLTFBoundingBox box) {
+    if (GLTFBoundingBoxIsEmpty(box)) {
+        return (GLTFBoundingSphere){ simd_make_float3(0.0f, 0.0f, 0.0f), -1.0f };
+    }
+    const float radius = simd_length(box.maxPoint - box.minPoint) * 0.5f;
+    return (GLTFBoundingSphere){ (box.minPoint + box.maxPoint) * 0.5f, radius };
+}
+
+static void GLTFFormUnion(GLTF::AxisAlignedBox &box, const GLTF::AxisAlignedBox &other) {
+    for (int c = 0; c < 3; ++c) {
+        box.min[c] = MIN(box.min[c], other.min[c]);
+        box.max[c] = MAX(box.max[c], other.max[c]);
+    }
+}
+
+// Returns the box around `box` transformed by `transform`.
+static GLTF::AxisAlignedBox GLTFTransformedBox(simd_float4x4 transform, const GLTF::AxisAlignedBox &box) {
+    const simd_float3 minPoint = simd_make_float3(box.min[0], box.min[1], box.min[2]);
+    const simd_float3 maxPoint = simd_make_float3(box.max[0], box.max[1], box.max[2]);
+    const simd_float3 center = (minPoint + maxPoint) * 0.5f, extent = (maxPoint - minPoint) * 0.5f;
+    const simd_float3 worldCenter = simd_mul(transform, simd_make_float4(center, 1.0f)).xyz;
+    const simd_float3 worldExtent = simd_abs(transform.columns[0].xyz) * extent.x +
+                                    simd_abs(transform.columns[1].xyz) * extent.y +
+                                    simd_abs(transform.columns[2].xyz) * extent.z;
+    GLTF::AxisAlignedBox result = GLTFEmptyAxisAlignedBox();
+    for (int c = 0; c < 3; ++c) {
+        result.min[c] = worldCenter[c] - worldExtent[c];
+        result.max[c] = worldCenter[c] + worldExtent[c];
+    }
+    return result;
+}
+
+// Returns the box around the elements of a position accessor, taken from its bounds if it holds floats and has
+// them, and otherwise scanned from its decoded elements. The box is empty if the accessor cannot be read.
+static GLTF::AxisAlignedBox GLTFBoxForPositionAccessor(GLTFAccessor *accessor) {
+    GLTF::AxisAlignedBox box = GLTFEmptyAxisAlignedBox();
+    if (accessor.componentType == GLTFComponentTypeFloat && accessor.minValues.count >= 3 &&
+        accessor.maxValues.count >= 3)
+    {
+        for (int c = 0; c < 3; ++c) {
+            box.min[c] = accessor.minValues[c].floatValue;
+            box.max[c] = accessor.maxValues[c].floatValue;
+        }
+        return box;
+    }
+    NSData *storage = nil;
+    const GLTF::AccessorView view = GLTFAccessorViewForAccessor(accessor, &storage);
+    if (!view.isValid() || view.componentCount < 3) {
+        return box;
+    }
+    for (size_t i = 0; i < view.count; ++i) {
+        float p[3];
+        GLTF::ReadFloats(view, i, p, 3);
+        for (int c = 0; c < 3; ++c) {
+            if (!isnan(p[c])) {
+                box.min[c] = MIN(box.min[c], p[c]);
+                box.max[c] = MAX(box.max[c], p[c]);
+            }
+        }
+    }
+    return box;
+}
+
+// Returns the box of `primitive` in the space of its node, widened by the bounds of its POSITION morph targets so
+// that it holds for any weights between 0 and 1.
+static GLTF::AxisAlignedBox GLTFLocalBoxForPrimitive(GLTFPrimitive *primitive) {
+    GLTF::AxisAlignedBox box = GLTFEmptyAxisAlignedBox();
+    if (!GLTFBoundingBoxIsEmpty(primitive.boundingBox)) {
+        for (int c = 0; c < 3; ++c) {
+            box.min[c] = primitive.boundingBox.minPoint[c];
+            box.max[c] = primitive.boundingBox.maxPoint[c];
+        }
+    } else {
+        box = GLTFBoxForPositionAccessor([primitive attributeForName:GLTFAttributeSemanticPosition].accessor);
+    }
+    for (GLTFMorphTarget *target in primitive.targets) {
+        for (GLTFAttribute *attribute in target) {
+            if (![attribute.name isEqualToString:GLTFAttributeSemanticPosition]) {
+                continue;
+            }
+            const GLTF::AxisAlignedBox deltas = GLTFBoxForPositionAccessor(attribute.accessor);
+            for (int c = 0; c < 3; ++c) {
+                if (deltas.min[c] <= deltas.max[c]) {
+                    box.min[c] += MIN(deltas.min[c], 0.0f);
+                    box.max[c] += MAX(deltas.max[c], 0.0f);
+                }
+            }
+        }
+    }
+    return box;
+}
+
+@implementation GLTFSceneBounds {
+    GLTF::SceneBounds _bounds;
+}
+
+- (instancetype)initWithSceneGraph:(GLTFSceneGraph *)sceneGraph {
+    if (self = [super init]) {
+        GLTF::SceneGeometry geometry;
+        geometry.primitiveStarts.push_back(0);
+        std::unordered_map<void *, GLTF::AxisAlignedBox> boxForPrimitive;
+        for (NSInteger i = 0; i < sceneGraph.nodeCount; ++i) {
+            GLTFNode *node = sceneGraph.nodes[i];
+            const NSInteger instanceCount = node.meshInstances.instanceCount;
+            for (GLTFPrimitive *primitive in node.mesh.primitives) {
+                auto found = boxForPrimitive.find((__bridge void *)primitive);
+                if (found == boxForPrimitive.end()) {
+                    found = boxForPrimitive.emplace((__bridge void *)primitive,
+                                                    GLTFLocalBoxForPrimitive(primitive)).first;
+                }
+                GLTF::AxisAlignedBox box = found->second;
+                if (instanceCount > 0) {
+                    GLTF::AxisAlignedBox instancesBox = GLTFEmptyAxisAlignedBox();
+                    for (NSInteger instance = 0; instance < instanceCount; ++instance) {
+                        GLTFFormUnion(instancesBox, GLTFTransformedBox([node.meshInstances transformAtIndex:instance],
+                                                                       box));
+                    }
+                    box = instancesBox;
+                }
+                geometry.primitiveBoxes.push_back(box);
+            }
+            geometry.primitiveStarts.push_back((uint32_t)geometry.primitiveBoxes.size());
+
+            GLTFSkin *skin = node.skin;
+            if (skin == nil || node.mesh == nil) {
+                continue;
+            }
+            GLTF::SkinnedNodeBinding binding;
+            binding.node = (uint32_t)i;
+            binding.firstJoint = (uint32_t)geometry.jointNodes.size();
+            NSData *storage = nil;
+            const GLTF::AccessorView inverseBindMatrices = GLTFAccessorViewForAccessor(skin.inverseBindMatrices,
+                                                                                       &storage);
+            for (NSUInteger j = 0; j < skin.joints.count; ++j) {
+                // Joints outside the scene do not move with it, and cannot be bounded
+                const NSInteger jointIndex = [sceneGraph indexOfNode:skin.joints[j]];
+                if (jointIndex == NSNotFound) {
+                    continue;
+                }
+                GLTF::Matrix4x4 inverseBindMatrix = {
+                    { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } }
+                };
+                if (inverseBindMatrices.isValid() && inverseBindMatrices.componentCount == 16 &&
+                    j < inverseBindMatrices.count)
+                {
+                    GLTF::ReadFloats(inverseBindMatrices, j, &inverseBindMatrix.columns[0][0], 16);
+                }
+                geometry.jointNodes.push_back((uint32_t)jointIndex);
+                geometry.inverseBindMatrices.push_back(inverseBindMatrix);
+            }
+            binding.jointCount = (uint32_t)geometry.jointNodes.size() - binding.firstJoint;
+            geometry.skinnedNodes.push_back(binding);
+        }
+        _primitiveCount = (NSInteger)geometry.primitiveBoxes.size();
+        _bounds.build(*sceneGraph.coreGraph, std::move(geometry));
+        _sceneGraph = sceneGraph;
+    }
+    return self;
+}
+
+- (GLTFBoundingBox)boundingBox {
+    GLTF::AxisAlignedBox box = GLTFEmptyAxisAlignedBox();
+    const int32_t *parents = _sceneGraph.parentIndices;
+    for (size_t i = 0; i < _bounds.nodeCount(); ++i) {
+        if (parents[i] < 0) {
+            GLTFFormUnion(box, _bounds.subtreeBox(i));
+        }
+    }
+    return GLTFBoundingBoxForAxisAlignedBox(box);
+}
+
+- (void)update {
+    const GLTF::SceneGraph &graph = *_sceneGraph.coreGraph;
+    _bounds.update(graph, graph.lastUpdatedRoots());
+}
+
+- (void)updateAllBounds {
+    _bounds.updateAll(*_sceneGraph.coreGraph);
+}
+
+- (NSRange)primitiveRangeForNodeAtIndex:(NSInteger)index {
+    const uint32_t first = _bounds.firstPrimitive((size_t)index);
+    return NSMakeRange(first, _bounds.firstPrimitive((size_t)index + 1) - first);
+}
+
+- (GLTFBoundingBox)boundingBoxForPrimitiveAtIndex:(NSInteger)index {
+    return GLTFBoundingBoxForAxisAlignedBox(_bounds.primitiveBox((size_t)index));
+}
+
+- (GLTFBoundingBox)boundingBoxForNodeAtIndex:(NSInteger)index {
+    return GLTFBoundingBoxForAxisAlignedBox(_bounds.nodeBox((size_t)index));
+}
+
+- (GLTFBoundingBox)subtreeBoundingBoxForNodeAtIndex:(NSInteger)index {
+    return GLTFBoundingBoxForAxisAlignedBox(_bounds.subtreeBox((size_t)index));
+}
+
+- (GLTFBoundingSphere)boundingSphereForNodeAtIndex:(NSInteger)index {
+    return GLTFBoundingSphereForBox([self boundingBoxForNodeAtIndex:index]);
+}
+
+- (GLTFBoundingSphere)subtreeBoundingSphereForNodeAtIndex:(NSInteger)index {
+    return GLTFBoundingSphereForBox([self subtreeBoundingBoxForNodeAtIndex:index]);
+}
+
+- (NSInteger)cullWithPlanes:(const simd_float4 *)planes
+                      count:(NSInteger)count
+                nodeIndices:(NSMutableData *)nodeIndices
+           primitiveIndices:(NSMutableData *)primitiveIndices
+{
+    static_assert(sizeof(simd_float4) == 4 * sizeof(float), "Planes must be four packed floats");
+    std::vector<uint32_t> visibleNodes, visiblePrimitives;
+    _bounds.cull(*_sceneGraph.coreGraph, (const float *)planes, (size_t)MAX(count, 0), visibleNodes,
+                 visiblePrimitives);
+    [nodeIndices setData:[NSData dataWithBytes:visibleNodes.data() length:visibleNodes.size() * sizeof(uint32_t)]];
+    [primitiveIndices setData:[NSData dataWithBytes:visiblePrimitives.data()
+                                             length:visiblePrimitives.size() * sizeof(uint32_t)]];
+    return (NSInteger)visiblePrimitives.size();
+}
+
+@end
+
+@interface GLTFSkinnedVertices ()
+- (instancetype)initWithVertexCount:(NSInteger)vertexCount
+                          positions:(NSData *)positions
+                            normals:(nullable NSData *)normals
+                           tangents:(nullable NSData *)tangents;
+@end
+
+@implementation GLTFSkinnedVertices
+
+- (instancetype)initWithVertexCount:(NSInteger)vertexCount
+                          positions:(NSData *)positions
+                            normals:(NSData *)normals
+                           tangents:(NSData *)tangents
+{
+    if (self = [super init]) {
+        _vertexCount = vertexCount;
+        _positions = positions;
+        _normals = normals;
+        _tangents = tangents;
+    }
+    return self;
+}
+
+@end
+
+static NSData *GLTFDataWithFloats(const std::vector<float> &values) {
+    return values.empty() ? nil : [NSData dataWithBytes:values.data() length:values.size() * sizeof(float)];
+}
+
+// Returns a view of the named attribute of `primitive`, or an invalid view if it has none, adding any storage the
+// view needs to `storage`.
+static GLTF::AccessorView GLTFAccessorViewForAttribute(GLTFPrimitive *primitive, NSString *name,
+                                                       NSMutableArray<NSData *> *storage)
+{
+    NSData *data = nil;
+    const GLTF::AccessorView view = GLTFAccessorViewForAccessor([primitive attributeForName:name].accessor, &data);
+    if (data) {
+        [storage addObject:data];
+    }
+    return view;
+}
+
+@implementation GLTFSkinPaletteSet {
+    GLTF::SkinPaletteSet _palettes;
+    std::vector<GLTF::Matrix4x4> _worldTransforms;
+    std::vector<GLTFSkinningMethod> _skinningMethods;
+}
+
+- (instancetype)initWithAsset:(GLTFAsset *)asset error:(NSError **)error {
+    if (self = [super init]) {
+        const size_t nodeCount = asset.nodes.count;
+        std::vector<int32_t> parents(nodeCount, -1);
+        for (NSUInteger i = 0; i < nodeCount; ++i) {
+            GLTFNode *parent = asset.nodes[i].parentNode;
+            const NSInteger parentIndex = GLTFIndexOfObjectInArray(parent, asset.nodes);
+            parents[i] = (parentIndex != NSNotFound) ? (int32_t)parentIndex : -1;
+        }
+        std::vector<GLTF::SkinDescription> skins(asset.skins.count);
+        for (NSUInteger s = 0; s < asset.skins.count; ++s) {
+            GLTFSkin *skin = asset.skins[s];
+            GLTF::SkinDescription &description = skins[s];
+            for (GLTFNode *joint in skin.joints) {
+                const NSInteger jointIndex = GLTFIndexOfObjectInArray(joint, asset.nodes);
+                if (jointIndex == NSNotFound) {
+                    if (error) {
+                        *error = GLTFAnimationRuntimeError([NSString stringWithFormat:
+                            @"Skin %@ has a joint that is not a node of the asset", skin.name ?: @"(unnamed)"]);
+                    }
+                    return nil;
+                }
+                description.joints.push_back((uint32_t)jointIndex);
+            }
+            if (skin.inverseBindMatrices == nil) {
+                continue;
+            }
+            NSData *storage = nil;
+            const GLTF::AccessorView view = GLTFAccessorViewForAccessor(skin.inverseBindMatrices, &storage);
+            if (!view.isValid() || view.componentCount != 16 || view.count < description.joints.size()) {
+                if (error) {
+                    *error = GLTFAnimationRuntimeError([NSString stringWithFormat:
+                        @"Skin %@ has fewer inverse bind matrices than joints", skin.name ?: @"(unnamed)"]);
+                }
+                return nil;
+            }
+            description.inverseBindMatrices.resize(16 * description.joints.size());
+            for (size_t j = 0; j < description.joints.size(); ++j) {
+                GLTF::ReadFloats(view, j, &description.inverseBindMatrices[16 * j], 16);
+            }
+        }
+        if (!_palettes.build(parents.data(), nodeCount, skins)) {
+            if (error) {
+                *error = GLTFAnimationRuntimeError(@"Node hierarchy is not a forest");
+            }
+            return nil;
+        }
+        _skins = [asset.skins copy];
+        _jointCount = (NSInteger)_palettes.jointCount();
+        _skinningMethods.assign(asset.skins.count, GLTFSkinningMethodLinearBlend);
+    }
+    return self;
+}
+
+- (NSRange)jointRangeForSkinAtIndex:(NSInteger)index {
+    return NSMakeRange(_palettes.firstJoint((size_t)index), _palettes.jointCount((size_t)index));
+}
+
+- (BOOL)computePalettesForPose:(GLTFAnimationPose *)pose
+                        format:(GLTFSkinPaletteFormat)format
+                      palettes:(float *)palettes
+{
+    const int coreFormat = (format == GLTFSkinPaletteFormat3x4) ? GLTF::SkinPaletteFormat3x4
+                                                                : GLTF::SkinPaletteFormat4x4;
+    return _palettes.computePalettes(*pose.corePose, coreFormat, palettes, _worldTransforms);
+}
+
+- (BOOL)computePalettesForSceneGraph:(GLTFSceneGraph *)sceneGraph
+                              format:(GLTFSkinPaletteFormat)format
+                            palettes:(float *)palettes
+{
+    if ((size_t)sceneGraph.assetNodeCount != _palettes.nodeCount()) {
+        return NO;
+    }
+    const int coreFormat = (format == GLTFSkinPaletteFormat3x4) ? GLTF::SkinPaletteFormat3x4
+                                                                : GLTF::SkinPaletteFormat4x4;
+    return _palettes.computePalettes((const GLTF::Matrix4x4 *)sceneGraph.worldTransforms,
+                                     sceneGraph.graphIndicesForAssetNodes, coreFormat, palettes);
+}
+
+- (GLTFSkinningMethod)skinningMethodForSkinAtIndex:(NSInteger)index {
+    return _skinningMethods[(size_t)index];
+}
+
+- (void)setSkinningMethod:(GLTFSkinningMethod)method forSkinAtIndex:(NSInteger)index {
+    _skinningMethods[(size_t)index] = method;
+}
+
+- (GLTFSkinnedVertices *)skinnedVerticesForPrimitive:(GLTFPrimitive *)primitive
+                                         skinAtIndex:(NSInteger)index
+                                            palettes:(const float *)palettes
+                                              format:(GLTFSkinPaletteFormat)format
+                                               error:(NSError **)error
+{
+    // Keep the storage behind every view alive until skinning is done
+    NSMutableArray<NSData *> *storage = [NSMutableArray array];
+    GLTF::SkinningInput input;
+    input.positions = GLTFAccessorViewForAttribute(primitive, GLTFAttributeSemanticPosition, storage);
+    input.normals = GLTFAccessorViewForAttribute(primitive, GLTFAttributeSemanticNormal, storage);
+    input.tangents = GLTFAccessorViewForAttribute(primitive, GLTFAttributeSemanticTangent, storage);
+    for (int set = 0;; ++set) {
+        NSString *jointsName = [NSString stringWithFormat:@"JOINTS_%d", set];
+        NSString *weightsName = [NSString stringWithFormat:@"WEIGHTS_%d", set];
+        if ([primitive attributeForName:jointsName] == nil || [primitive attributeForName:weightsName] == nil) {
+            break;
+        }
+        input.jointSets.push_back(GLTFAccessorViewForAttribute(primitive, jointsName, storage));
+        input.weightSets.push_back(GLTFAccessorViewForAttribute(primitive, weightsName, storage));
+    }
+
+    const NSRange joints = [self jointRangeForSkinAtIndex:index];
+    const int coreFormat = (format == GLTFSkinPaletteFormat3x4) ? GLTF::SkinPaletteFormat3x4
+                                                                : GLTF::SkinPaletteFormat4x4;
+    const float *skinPalette = palettes + joints.location * GLTF::SkinPaletteSet::FloatsPerJoint(coreFormat);
+    const int method = (_skinningMethods[(size_t)index] == GLTFSkinningMethodDualQuaternion) ?
+        GLTF::SkinningMethodDualQuaternion : GLTF::SkinningMethodLinearBlend;
+    GLTF::SkinnedVertices output;
+    if (!GLTF::SkinVertices(input, skinPalette, joints.length, coreFormat, method, output)) {
+        if (error) {
+            *error = GLTFAnimationRuntimeError(@"Primitive has invalid positions, joints or weights for its skin");
+        }
+        return nil;
+    }
+    return [[GLTFSkinnedVertices alloc] initWithVertexCount:(NSInteger)input.positions.count
+                                                  positions:GLTFDataWithFloats(output.positions)
+                                                    normals:GLTFDataWithFloats(output.normals)
+                                                   tangents:GLTFDataWithFloats(output.tangents)];
+}
+
+@end
+
+// Adds the deltas of `accessor` to `targets` as a target, taking those of a sparse accessor without a buffer view
+// from its overlay; a nil accessor adds a target that moves nothing.
+static bool GLTFAddMorphTarget(GLTF::MorphTargetSet &targets, GLTFAccessor *accessor) {
+    if (accessor == nil) {
+        return targets.addSparseTarget(nullptr, GLTF::AccessorView());
+    }
+    if ((size_t)accessor.count != targets.vertexCount()) {
+        return false;
+    }
+    GLTFSparseOverlay *overlay = accessor.sparseOverlay;
+    if (overlay.hasImplicitZeroBase) {
+        GLTF::AccessorView values;
+        values.data = (const uint8_t *)overlay.valueData.bytes;
+        values.stride = overlay.elementSize;
+        values.count = (size_t)overlay.count;
+        values.componentType = (int)accessor.componentType;
+        values.componentCount = GLTFComponentCountForDimension(accessor.dimension);
+        values.normalized = accessor.isNormalized;
+        return targets.addSparseTarget((const uint32_t *)overlay.indexData.bytes, values);
+    }
+    NSData *storage = nil;
+    const GLTF::AccessorView view = GLTFAccessorViewForAccessor(accessor, &storage);
+    return targets.addTarget(view, 0.0f);
+}
+
+@implementation GLTFMorphTargetBlender {
+    GLTF::MorphTargetSet _targets;
+    std::vector<float> _base;
+}
+
+- (instancetype)initWithPrimitive:(GLTFPrimitive *)primitive
+                    attributeName:(NSString *)attributeName
+                            error:(NSError **)error
+{
+    if (self = [super init]) {
+        NSData *baseStorage = nil;
+        const GLTF::AccessorView base = GLTFAccessorViewForAccessor([primitive attributeForName:attributeName].accessor,
+                                                                    &baseStorage);
+        if (!base.isValid() || !_targets.reset(base.count, base.componentCount)) {
+            if (error) {
+                *error = GLTFAnimationRuntimeError([NSString stringWithFormat:
+                    @"Primitive has no %@ attribute of up to four components to morph", attributeName]);
+            }
+            return nil;
+        }
+        const size_t componentCount = (size_t)base.componentCount;
+        _base.resize(base.count * componentCount);
+        for (size_t i = 0; i < base.count; ++i) {
+            GLTF::ReadFloats(base, i, &_base[componentCount * i], base.componentCount);
+        }
+        for (GLTFMorphTarget *target in primitive.targets) {
+            GLTFAccessor *accessor = nil;
+            for (GLTFAttribute *attribute in target) {
+                if ([attribute.name isEqualToString:attributeName]) {
+                    accessor = attribute.accessor;
+                    break;
+                }
+            }
+            if (!GLTFAddMorphTarget(_targets, accessor)) {
+                if (error) {
+                    *error = GLTFAnimationRuntimeError([NSString stringWithFormat:
+                        @"Morph target has an invalid %@ accessor", attributeName]);
+                }
+                return nil;
+            }
+        }
+        _attributeName = [attributeName copy];
+        _vertexCount = (NSInteger)base.count;
+        _componentCount = (NSInteger)componentCount;
+        _targetCount = (NSInteger)_targets.targetCount();
+        for (size_t t = 0; t < _targets.targetCount(); ++t) {
+            _storedDeltaCount += (NSInteger)_targets.storedElementCount(t);
+        }
+        _byteCount = (NSInteger)_targets.byteCount();
+    }
+    return self;
+}
+
+- (void)blendWeights:(const float *)weights count:(NSInteger)count intoBuffer:(float *)buffer {
+    _targets.blend(_base.data(), weights, (size_t)MAX(count, 0), buffer);
+}
+
+- (NSData *)blendedDataForPose:(GLTFAnimationPose *)pose nodeAtIndex:(NSInteger)index {
+    NSMutableData *data = [NSMutableData dataWithLength:_base.size() * sizeof(float)];
+    const NSRange weights = [pose weightRangeForNodeAtIndex:index];
+    [self blendWeights:pose.weights + weights.location
+                 count:(NSInteger)weights.length
+            intoBuffer:(float *)data.mutableBytes];
+    return data;
+}
+
+@end
+
+// Returns the core path animated by the channels of `animation` that use `sampler`, or -1 if none does.
+static int GLTFAnimationPathForSampler(GLTFAnimation *animation, GLTFAnimationSampler *sampler) {
+    for (GLTFAnimationChannel *channel in animation.channels) {
+        if (channel.sampler != sampler) {
+            continue;
+        }
+        NSString *path = channel.target.path;
+        if ([path isEqualToString:GLTFAnimationPathTranslation]) {
+            return GLTF::AnimationPathTranslation;
+        } else if ([path isEqualToString:GLTFAnimationPathRotation]) {
+            return GLTF::AnimationPathRotation;
+        } else if ([path isEqualToString:GLTFAnimationPathScale]) {
+            return GLTF::AnimationPathScale;
+        } else if ([path isEqualToString:GLTFAnimationPathWeights]) {
+            return GLTF::AnimationPathWeights;
+        }
+    }
+    return -1;
+}
+
+static NSInteger GLTFAccessorByteCount(GLTFAccessor *accessor) {
+    return accessor.count * GLTFBytesPerComponentForComponentType(accessor.componentType) *
+        GLTFComponentCountForDimension(accessor.dimension);
+}
+
+NSArray<GLTFAccessor *> *GLTFAnimationReduceKeyframes(GLTFAnimation *animation,
+                                                      double sampleRate,
+                                                      float positionTolerance,
+                                                      float angleTolerance,
+                                                      GLTFKeyframeReductionStatistics *outStatistics,
+                                                      NSError **error)
+{
+    GLTFKeyframeReductionStatistics statistics = { 0, 0, 0, 0, 0, 0, 0 };
+    NSMutableArray<GLTFAnimationSampler *> *samplers = [NSMutableArray array];
+    std::vector<GLTF::KeyframeTrack> tracks;
+    for (GLTFAnimationSampler *sampler in animation.samplers) {
+        const int path = GLTFAnimationPathForSampler(animation, sampler);
+        if (path < 0) {
+            continue;
+        }
+        NSData *inputStorage = nil, *outputStorage = nil;
+        const GLTF::AccessorView input = GLTFAccessorViewForAccessor(sampler.input, &inputStorage);
+        const GLTF::AccessorView output = GLTFAccessorViewForAccessor(sampler.output, &outputStorage);
+        const size_t elementsPerKey = (sampler.interpolationMode == GLTFInterpolationModeCubic) ? 3 : 1;
+        const size_t keyElementCount = input.count * elementsPerKey;
+        if (!input.isValid() || !output.isValid() || input.count == 0 ||
+            (output.count * output.componentCount) % keyElementCount != 0)
+        {
+            if (error) {
+                *error = GLTFAnimationRuntimeError(@"Animation sampler has invalid keys or values");
+            }
+            return nil;
+        }
+        GLTF::KeyframeTrack track;
+        track.path = path;
+        track.interpolation = (int)sampler.interpolationMode;
+        track.componentCount = (uint32_t)(output.count * output.componentCount / keyElementCount);
+        track.times.resize(input.count);
+        for (size_t k = 0; k < input.count; ++k) {
+            GLTF::ReadFloats(input, k, &track.times[k], 1);
+        }
+        track.values.resize(output.count * output.componentCount);
+        float *destination = track.values.data();
+        for (size_t e = 0; e < output.count; ++e) {
+            destination += GLTF::ReadFloats(output, e, destination, output.componentCount);
+        }
+        [samplers addObject:sampler];
+        tracks.push_back(std::move(track));
+        statistics.keyCountBefore += (NSInteger)input.count;
+        statistics.byteCountBefore += GLTFAccessorByteCount(sampler.input) + GLTFAccessorByteCount(sampler.output);
+    }
+
+    GLTF::KeyframeReductionSettings settings;
+    settings.sampleRate = (float)sampleRate;
+    settings.positionTolerance = positionTolerance;
+    settings.angleTolerance = angleTolerance;
+    const std::vector<GLTF::KeyframeTrack> originalTracks = tracks;
+    const std::vector<bool> reduced = GLTF::ReduceKeyframeTracks(tracks, settings);
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        if (!reduced[i]) {
+            if (error) {
+                *error = GLTFAnimationRuntimeError(@"Animation sampler has invalid keys or values");
+            }
+            return nil;
+        }
+    }
+
+    NSMutableArray<GLTFAccessor *> *newAccessors = [NSMutableArray array];
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        const GLTF::KeyframeTrack &track = tracks[i];
+        GLTFAnimationSampler *sampler = samplers[i];
+        const NSInteger keyCount = (NSInteger)track.times.size();
+        statistics.samplerCount += 1;
+        statistics.keyCountAfter += keyCount;
+        if (track.times == originalTracks[i].times && track.values == originalTracks[i].values) {
+            // Nothing was removed, so keep the original accessors and their formats
+            statistics.byteCountAfter += GLTFAccessorByteCount(sampler.input) + GLTFAccessorByteCount(sampler.output);
+            continue;
+        }
+        statistics.constantSamplerCount += (keyCount == 1 && originalTracks[i].times.size() > 1) ? 1 : 0;
+        statistics.convertedCubicSamplerCount += (originalTracks[i].interpolation == GLTF::InterpolationCubic &&
+                                                  track.interpolation != GLTF::InterpolationCubic) ? 1 : 0;
+
+        NSData *timeData = [NSData dataWithBytes:track.times.data() length:track.times.size() * sizeof(float)];
+        GLTFAccessor *input = GLTFNewAccessorWithData(timeData, GLTFComponentTypeFloat, GLTFValueDimensionScalar, NO,
+                                                      keyCount);
+        input.minValues = @[ @(track.times.front()) ];
+        input.maxValues = @[ @(track.times.back()) ];
+        // Weights are stored as scalars, a run of one per target for each key
+        const GLTFValueDimension dimension = sampler.output.dimension;
+        const NSInteger outputCount = (NSInteger)track.values.size() / GLTFComponentCountForDimension(dimension);
+        NSData *valueData = [NSData dataWithBytes:track.values.data() length:track.values.size() * sizeof(float)];
+        GLTFAccessor *output = GLTFNewAccessorWithData(valueData, GLTFComponentTypeFloat, dimension, NO, outputCount);
+        sampler.input = input;
+        sampler.output = output;
+        sampler.interpolationMode = (GLTFInterpolationMode)track.interpolation;
+        [newAccessors addObject:input];
+        [newAccessors addObject:output];
+        statistics.byteCountAfter += GLTFAccessorByteCount(input) + GLTFAccessorByteCount(output);
+    }
+    if (outStatistics) {
+        *outStatistics = statistics;
+    }
+    return newAccessors;
+}
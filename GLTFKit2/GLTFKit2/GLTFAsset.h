@@ -67,15 +67,71 @@ typedef NS_ENUM(NSInteger, GLTFMeshoptCompressionFilter) {
     GLTFMeshoptCompressionFilterExponential,
 };
 
-extern float GLTFDegFromRad(float rad);
-extern int GLTFBytesPerComponentForComponentType(GLTFComponentType type);
-extern int GLTFComponentCountForDimension(GLTFValueDimension dim);
+typedef struct {
+    simd_float3 minPoint;
+    simd_float3 maxPoint;
+} GLTFBoundingBox;
+
+/// A bounding box that contains no points; its minimum point is greater than its maximum point.
+GLTFKIT2_EXPORT const GLTFBoundingBox GLTFBoundingBoxEmpty;
+
+GLTFKIT2_EXPORT BOOL GLTFBoundingBoxIsEmpty(GLTFBoundingBox box);
+GLTFKIT2_EXPORT float GLTFDegFromRad(float rad);
+GLTFKIT2_EXPORT int GLTFBytesPerComponentForComponentType(GLTFComponentType type);
+GLTFKIT2_EXPORT int GLTFComponentCountForDimension(GLTFValueDimension dim);
+
+/// The kinds of object that an asset holds in arrays of their own
+typedef NS_ENUM(NSInteger, GLTFObjectKind) {
+    GLTFObjectKindNone,
+    GLTFObjectKindAccessor,
+    GLTFObjectKindAnimation,
+    GLTFObjectKindBuffer,
+    GLTFObjectKindBufferView,
+    GLTFObjectKindCamera,
+    GLTFObjectKindLight,
+    GLTFObjectKindImage,
+    GLTFObjectKindMaterial,
+    GLTFObjectKindMaterialVariant,
+    GLTFObjectKindMesh,
+    GLTFObjectKindNode,
+    GLTFObjectKindSampler,
+    GLTFObjectKindScene,
+    GLTFObjectKindSkin,
+    GLTFObjectKindTexture,
+};
+
+/// A compact reference to an object held by an asset: a number identifying the asset within the process, the
+/// object's kind, and its index in the asset's array of that kind. Handles are cheap to hash and compare, and can key
+/// maps in place of `identifier`; they are not persisted between runs. Zero refers to no object.
+/// The asset number occupies 24 bits and wraps after 2^24 - 1 assets have been created in the process, so handles
+/// only distinguish assets created fewer than that many apart; key by object identity when assets are that long-lived.
+typedef uint64_t GLTFObjectHandle;
+
+GLTFKIT2_EXPORT GLTFObjectKind GLTFObjectHandleGetKind(GLTFObjectHandle handle);
+/// Returns the index of the handle's object in its asset's array, or NSNotFound for the zero handle.
+GLTFKIT2_EXPORT NSInteger GLTFObjectHandleGetIndex(GLTFObjectHandle handle);
+
+@class GLTFObject;
+
+/// Returns the position of `object` in `objects`, one of the arrays of an asset, or NSNotFound if it is not there (or
+/// is nil). The object's `index` is used when it refers to `objects`; if the object's index was since reassigned by
+/// adding it to another asset, the array is searched for it instead.
+GLTFKIT2_EXPORT NSInteger GLTFIndexOfObjectInArray(GLTFObject *_Nullable object, NSArray<GLTFObject *> *objects);
 
 GLTFKIT2_EXPORT
 @interface GLTFObject : NSObject
 
 @property (nonatomic, nullable, copy) NSString *name;
-@property (nonatomic, readonly) NSUUID *identifier; // Globally unique; not persisted between runs
+/// Globally unique; not persisted between runs. Created when first asked for, so prefer `handle` as a key.
+@property (nonatomic, readonly) NSUUID *identifier;
+/// The handle of the object in the asset that holds it, which is assigned along with `index`; zero for objects not
+/// held directly by an asset.
+@property (nonatomic, readonly) GLTFObjectHandle handle;
+/// The object's position in the array of the asset that holds it, such as `materials` for a material, which is
+/// assigned whenever that array is set. NSNotFound for objects not held directly by an asset, such as primitives.
+/// An object in the arrays of more than one asset has the index (and handle) of the array set last, so look objects
+/// up with `GLTFIndexOfObjectInArray` rather than trusting `index` to refer to a particular asset.
+@property (nonatomic, readonly) NSInteger index;
 @property (nonatomic, copy) NSDictionary<NSString *, id> *extensions;
 @property (nonatomic, nullable, copy) id extras;
 
@@ -85,9 +141,88 @@ GLTFKIT2_EXPORT
 
 typedef NSString * GLTFAssetLoadingOption NS_STRING_ENUM;
 
-/// This option is not currently implemented.
+/// If this option is set to YES, triangle primitives that lack a NORMAL attribute have one generated when the asset
+/// is loaded. Normals are weighted by the angle of each face at the vertex, and are shared by vertices with the same
+/// position. See `GLTFAssetNormalCreaseAngleKey` for how normals are smoothed across faces.
 GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetCreateNormalsIfAbsentKey;
 
+/// An NSNumber holding the angle, in radians, beyond which adjacent faces are not smoothed together when normals
+/// are created because of `GLTFAssetCreateNormalsIfAbsentKey`. The default of 0 produces the flat normals the glTF
+/// specification requires of primitives without normals; an angle of M_PI or more produces fully smooth normals.
+/// Vertices along a crease are split, so primitives may gain vertices and indices.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetNormalCreaseAngleKey;
+
+/// If this option is set to YES, triangle primitives whose material has a normal texture but which lack a TANGENT
+/// attribute have one generated with MikkTSpace when the asset is loaded. Tangents are generated after
+/// any normals requested with `GLTFAssetCreateNormalsIfAbsentKey`; primitives without normals are left unchanged.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetCreateTangentsIfAbsentKey;
+
+/// If this option is set to YES, indexed triangle primitives have their triangles reordered for vertex cache
+/// efficiency and overdraw, and their vertices renumbered for fetch locality, after any attributes are generated.
+/// Accessors that belong to a single primitive and have a buffer view to themselves are rewritten in place; shared
+/// ones are copied. Unindexed primitives are left as they are unless `GLTFAssetWeldVerticesKey` gives them indices.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetOptimizeMeshesKey;
+
+/// An NSNumber holding the number of levels of detail to generate for each triangle primitive when the asset is
+/// loaded. Each level aims for half the triangles of the one before it. Levels are stored in the primitive's
+/// `levelOfDetailIndices`. The default is 0.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetLevelOfDetailCountKey;
+
+/// An NSNumber holding the greatest geometric error that level of detail generation may introduce, relative to the
+/// largest dimension of each primitive's bounds. Simplification stops early rather than exceed it. The default is 0.01.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetLevelOfDetailTargetErrorKey;
+
+/// If this option is set to YES, the triangles of each triangle primitive are partitioned into meshlets when the
+/// asset is loaded, and stored in the primitive's `meshlets`. See `GLTFAssetMeshletMaxVertexCountKey` and
+/// `GLTFAssetMeshletMaxTriangleCountKey` for the size of each meshlet.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetBuildMeshletsKey;
+
+/// An NSNumber holding the greatest number of vertices in a meshlet, up to 256. The default is 64.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetMeshletMaxVertexCountKey;
+
+/// An NSNumber holding the greatest number of triangles in a meshlet, up to 512. The default is 124.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetMeshletMaxTriangleCountKey;
+
+/// If this option is set to YES, vertices of each primitive that are identical in every attribute and morph target
+/// are merged when the asset is loaded, before any other processing. Unindexed primitives become indexed.
+/// See `GLTFAssetWeldEpsilonKey` for how attributes are compared.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetWeldVerticesKey;
+
+/// An NSNumber holding the spacing to which float attribute components are rounded before vertices are compared for
+/// welding because of `GLTFAssetWeldVerticesKey`. The default of 0 merges only vertices that are exactly equal.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetWeldEpsilonKey;
+
+/// If this option is set to YES, float vertex attributes are quantized as KHR_mesh_quantization permits once the
+/// asset's nodes are loaded, as described for `GLTFAssetQuantizeMeshes` with `GLTFQuantizationOptionAll`.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetQuantizeMeshesKey;
+
+/// If this option is set to YES, the keys of each animation are resampled and thinned once the asset's animations
+/// are loaded, as described for `GLTFAnimationReduceKeyframes`, so that linear interpolation between the remaining
+/// keys stays within the tolerances given by `GLTFAssetKeyframePositionToleranceKey` and
+/// `GLTFAssetKeyframeAngleToleranceKey`.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetReduceKeyframesKey;
+
+/// An NSNumber holding the rate, in samples per second, at which animations are resampled because of
+/// `GLTFAssetReduceKeyframesKey`. A rate of 0 samples each animation at its own key times. The default is 30.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetKeyframeSampleRateKey;
+
+/// An NSNumber holding the greatest error in a translation, scale or morph weight that keyframe reduction may
+/// introduce. The default is 0.0001.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetKeyframePositionToleranceKey;
+
+/// An NSNumber holding the greatest error in a rotation, in radians, that keyframe reduction may introduce. The
+/// default is 0.001.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetKeyframeAngleToleranceKey;
+
+/// If this option is set to YES, accessors that lack `minValues` and `maxValues` have them computed from their data
+/// when the asset is loaded, so that every primitive with positions receives a bounding box.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetComputeMissingBoundsKey;
+
+/// If this option is set to YES, the indices of every primitive are scanned when the asset is loaded, and a warning is
+/// logged for each primitive with an index beyond the end of its attributes. Scanning touches every index buffer, so
+/// it is off by default; the mesh processing options validate the primitives they process regardless.
+GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetValidateIndicesKey;
+
 /// If a suitable asset directory URL is passed in the options dictionary, connected files (binary buffer files, textures, etc.)
 /// will be accessed using security-scoped URLs, as required by the app sandbox model. If an asset directory URL is
 /// not provided, it is assumed that the asset file is self-contained (e.g., a .glb) or that any necessary connected files are
@@ -96,6 +231,22 @@ GLTFKIT2_EXPORT GLTFAssetLoadingOption const GLTFAssetAssetDirectoryURLKey;
 
 #define GLTFAssetLoadingOptionCreateNormalsIfAbsent GLTFAssetCreateNormalsIfAbsentKey
 #define GLTFAssetLoadingOptionAssetDirectoryURL     GLTFAssetAssetDirectoryURLKey
+#define GLTFAssetLoadingOptionComputeMissingBounds  GLTFAssetComputeMissingBoundsKey
+#define GLTFAssetLoadingOptionNormalCreaseAngle     GLTFAssetNormalCreaseAngleKey
+#define GLTFAssetLoadingOptionCreateTangentsIfAbsent GLTFAssetCreateTangentsIfAbsentKey
+#define GLTFAssetLoadingOptionOptimizeMeshes        GLTFAssetOptimizeMeshesKey
+#define GLTFAssetLoadingOptionLevelOfDetailCount    GLTFAssetLevelOfDetailCountKey
+#define GLTFAssetLoadingOptionLevelOfDetailTargetError GLTFAssetLevelOfDetailTargetErrorKey
+#define GLTFAssetLoadingOptionBuildMeshlets         GLTFAssetBuildMeshletsKey
+#define GLTFAssetLoadingOptionMeshletMaxVertexCount GLTFAssetMeshletMaxVertexCountKey
+#define GLTFAssetLoadingOptionMeshletMaxTriangleCount GLTFAssetMeshletMaxTriangleCountKey
+#define GLTFAssetLoadingOptionWeldVertices          GLTFAssetWeldVerticesKey
+#define GLTFAssetLoadingOptionWeldEpsilon           GLTFAssetWeldEpsilonKey
+#define GLTFAssetLoadingOptionQuantizeMeshes        GLTFAssetQuantizeMeshesKey
+#define GLTFAssetLoadingOptionReduceKeyframes       GLTFAssetReduceKeyframesKey
+#define GLTFAssetLoadingOptionKeyframeSampleRate    GLTFAssetKeyframeSampleRateKey
+#define GLTFAssetLoadingOptionKeyframePositionTolerance GLTFAssetKeyframePositionToleranceKey
+#define GLTFAssetLoadingOptionKeyframeAngleTolerance GLTFAssetKeyframeAngleToleranceKey
 
 typedef NS_ENUM(NSInteger, GLTFAssetStatus) {
     GLTFAssetStatusError = -1,
@@ -168,7 +319,7 @@ GLTFKIT2_EXPORT
 
 @end
 
-@class GLTFSparseStorage;
+@class GLTFSparseOverlay, GLTFSparseStorage;
 
 GLTFKIT2_EXPORT
 @interface GLTFAccessor : GLTFObject
@@ -182,6 +333,8 @@ GLTFKIT2_EXPORT
 @property (nonatomic, copy) NSArray<NSNumber *> *minValues;
 @property (nonatomic, copy) NSArray<NSNumber *> *maxValues;
 @property (nonatomic, nullable, strong) GLTFSparseStorage *sparse;
+/// The validated, sorted substitutions described by `sparse`, built on first access. Nil if the accessor is not sparse.
+@property (nonatomic, nullable, readonly) GLTFSparseOverlay *sparseOverlay;
 
 - (instancetype)initWithBufferView:(nullable GLTFBufferView *)bufferView
                             offset:(NSInteger)offset
@@ -194,8 +347,8 @@ GLTFKIT2_EXPORT
 
 @end
 
-extern NSData *GLTFPackedDataForAccessor(GLTFAccessor * accessor);
-extern NSData *GLTFTransformPackedDataToFloat(NSData *sourceData, GLTFAccessor *sourceAccessor);
+GLTFKIT2_EXPORT NSData *GLTFPackedDataForAccessor(GLTFAccessor * accessor);
+GLTFKIT2_EXPORT NSData *GLTFTransformPackedDataToFloat(NSData *sourceData, GLTFAccessor *sourceAccessor);
 
 @class GLTFAnimationChannel;
 @class GLTFAnimationSampler;
@@ -536,7 +689,7 @@ GLTFKIT2_EXPORT
 
 @end
 
-@class GLTFPrimitive;
+@class GLTFMeshletSet, GLTFPrimitive;
 
 GLTFKIT2_EXPORT
 @interface GLTFMesh : GLTFObject
@@ -577,6 +730,15 @@ GLTFKIT2_EXPORT
 @property (nonatomic, assign) GLTFPrimitiveType primitiveType;
 @property (nonatomic, copy) NSArray<GLTFMorphTarget *> *targets;
 @property (nonatomic, nullable, copy) NSArray<GLTFMaterialMapping *> *materialMappings;
+/// The axis-aligned bounds of the POSITION attribute, taken from its accessor's bounds. Empty if they are unknown.
+@property (nonatomic, assign) GLTFBoundingBox boundingBox;
+/// Index accessors for progressively simpler versions of the primitive, each a triangle list over the primitive's
+/// own vertices. Empty unless levels of detail were generated.
+@property (nonatomic, copy) NSArray<GLTFAccessor *> *levelOfDetailIndices;
+/// The geometric error of each level of detail, relative to the largest dimension of the primitive's bounds.
+@property (nonatomic, copy) NSArray<NSNumber *> *levelOfDetailErrors;
+/// The primitive's triangles partitioned into meshlets, if they were built.
+@property (nonatomic, nullable, strong) GLTFMeshletSet *meshlets;
 
 - (instancetype)initWithPrimitiveType:(GLTFPrimitiveType)primitiveType
                            attributes:(NSArray<GLTFAttribute *> *)attributes
@@ -663,6 +825,83 @@ GLTFKIT2_EXPORT
 
 @end
 
+/// A compact view of the elements substituted by a sparse accessor, for consumers such as morph target
+/// blending that only need to visit the elements that differ from the accessor's base data. Storage is
+/// proportional to the number of substituted elements rather than to the accessor's count.
+GLTFKIT2_EXPORT
+@interface GLTFSparseOverlay : NSObject
+
+/// The number of substituted elements
+@property (nonatomic, readonly) NSInteger count;
+/// The count of the accessor this overlay was built from
+@property (nonatomic, readonly) NSInteger elementCount;
+/// The size in bytes of each substituted value
+@property (nonatomic, readonly) size_t elementSize;
+/// `count` UInt32 element indices, in strictly increasing order and less than `elementCount`
+@property (nonatomic, readonly) NSData *indexData;
+/// `count` tightly packed values, in the same order as `indexData`
+@property (nonatomic, readonly) NSData *valueData;
+/// YES if the accessor has no buffer view, in which case every element not in the overlay is zero
+@property (nonatomic, readonly) BOOL hasImplicitZeroBase;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (void)enumerateElementsUsingBlock:(void (^)(NSInteger index, const void *value, BOOL *stop))block;
+
+/// Stores the overlay's values into `bytes`, which must hold `elementCount` tightly packed elements.
+- (void)applyToPackedBytes:(void *)bytes;
+
+@end
+
+typedef struct GLTFMeshlet {
+    /// The index of the meshlet's first entry in the vertex index data
+    uint32_t vertexOffset;
+    /// The index of the meshlet's first local index in the triangle data
+    uint32_t triangleOffset;
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+} GLTFMeshlet;
+
+typedef struct GLTFMeshletBounds {
+    float center[3];
+    float radius;
+    /// The meshlet faces away from a viewer at `eye`, and can be culled, if
+    /// dot(normalize(coneApex - eye), coneAxis) >= coneCutoff. The cutoff is 1 if the cone cannot cull the meshlet.
+    float coneAxis[3];
+    float coneCutoff;
+    float coneApex[3];
+} GLTFMeshletBounds;
+
+/// A partition of a triangle primitive into small clusters of triangles (meshlets) for GPU-driven rendering
+/// and per-cluster culling. Each meshlet has a run of primitive vertex indices and a run of byte-sized
+/// triangle indices into that run.
+GLTFKIT2_EXPORT
+@interface GLTFMeshletSet : NSObject
+
+@property (nonatomic, readonly) NSInteger meshletCount;
+/// `meshletCount` GLTFMeshlet structures
+@property (nonatomic, readonly) NSData *meshletData;
+/// UInt32 indices of primitive vertices, in a run per meshlet
+@property (nonatomic, readonly) NSData *vertexIndexData;
+/// UInt8 triangle indices into each meshlet's vertex run, three per triangle, in a run per meshlet
+@property (nonatomic, readonly) NSData *triangleData;
+/// `meshletCount` GLTFMeshletBounds structures, in primitive space
+@property (nonatomic, readonly) NSData *boundsData;
+/// The limits the meshlets were built with
+@property (nonatomic, readonly) NSInteger maxVertexCount;
+@property (nonatomic, readonly) NSInteger maxTriangleCount;
+
+- (instancetype)initWithMeshletData:(NSData *)meshletData
+                    vertexIndexData:(NSData *)vertexIndexData
+                       triangleData:(NSData *)triangleData
+                         boundsData:(NSData *)boundsData
+                     maxVertexCount:(NSInteger)maxVertexCount
+                   maxTriangleCount:(NSInteger)maxTriangleCount NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
 GLTFKIT2_EXPORT
 @interface GLTFTextureTransform : NSObject
 
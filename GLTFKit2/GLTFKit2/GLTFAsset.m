@@ -3,8 +3,10 @@
 #import "GLTFAssetReader.h"
 #import "GLTFLogging.h"
 #import "GLTFKTX2Support.h"
+#import "GLTFSparseSupport.h"
 
 #import <ImageIO/ImageIO.h>
+#import <stdatomic.h>
 
 #if TARGET_OS_IPHONE
 #import <MobileCoreServices/MobileCoreServices.h>
@@ -22,6 +24,23 @@ static NSString *g_dracoDecompressorClassName = nil;
 
 GLTFAssetLoadingOption const GLTFAssetCreateNormalsIfAbsentKey = @"GLTFAssetCreateNormalsIfAbsentKey";
 GLTFAssetLoadingOption const GLTFAssetAssetDirectoryURLKey = @"GLTFAssetAssetDirectoryURLKey";
+GLTFAssetLoadingOption const GLTFAssetComputeMissingBoundsKey = @"GLTFAssetComputeMissingBoundsKey";
+GLTFAssetLoadingOption const GLTFAssetValidateIndicesKey = @"GLTFAssetValidateIndicesKey";
+GLTFAssetLoadingOption const GLTFAssetNormalCreaseAngleKey = @"GLTFAssetNormalCreaseAngleKey";
+GLTFAssetLoadingOption const GLTFAssetCreateTangentsIfAbsentKey = @"GLTFAssetCreateTangentsIfAbsentKey";
+GLTFAssetLoadingOption const GLTFAssetOptimizeMeshesKey = @"GLTFAssetOptimizeMeshesKey";
+GLTFAssetLoadingOption const GLTFAssetLevelOfDetailCountKey = @"GLTFAssetLevelOfDetailCountKey";
+GLTFAssetLoadingOption const GLTFAssetLevelOfDetailTargetErrorKey = @"GLTFAssetLevelOfDetailTargetErrorKey";
+GLTFAssetLoadingOption const GLTFAssetBuildMeshletsKey = @"GLTFAssetBuildMeshletsKey";
+GLTFAssetLoadingOption const GLTFAssetMeshletMaxVertexCountKey = @"GLTFAssetMeshletMaxVertexCountKey";
+GLTFAssetLoadingOption const GLTFAssetMeshletMaxTriangleCountKey = @"GLTFAssetMeshletMaxTriangleCountKey";
+GLTFAssetLoadingOption const GLTFAssetWeldVerticesKey = @"GLTFAssetWeldVerticesKey";
+GLTFAssetLoadingOption const GLTFAssetWeldEpsilonKey = @"GLTFAssetWeldEpsilonKey";
+GLTFAssetLoadingOption const GLTFAssetQuantizeMeshesKey = @"GLTFAssetQuantizeMeshesKey";
+GLTFAssetLoadingOption const GLTFAssetReduceKeyframesKey = @"GLTFAssetReduceKeyframesKey";
+GLTFAssetLoadingOption const GLTFAssetKeyframeSampleRateKey = @"GLTFAssetKeyframeSampleRateKey";
+GLTFAssetLoadingOption const GLTFAssetKeyframePositionToleranceKey = @"GLTFAssetKeyframePositionToleranceKey";
+GLTFAssetLoadingOption const GLTFAssetKeyframeAngleToleranceKey = @"GLTFAssetKeyframeAngleToleranceKey";
 
 GLTFAttributeSemantic GLTFAttributeSemanticPosition = @"POSITION";
 GLTFAttributeSemantic GLTFAttributeSemanticNormal = @"NORMAL";
@@ -47,6 +66,39 @@ GLTFAnimationPath GLTFAnimationPathWeights = @"weights";
 
 static NSString *const GLTFMediaTypeWebP = @"image/webp";
 
+const GLTFBoundingBox GLTFBoundingBoxEmpty = {
+    .minPoint = { INFINITY, INFINITY, INFINITY },
+    .maxPoint = { -INFINITY, -INFINITY, -INFINITY },
+};
+
+BOOL GLTFBoundingBoxIsEmpty(GLTFBoundingBox box) {
+    return simd_any(box.minPoint > box.maxPoint);
+}
+
+// A handle holds the asset's number in its top 24 bits, then the kind in 8 bits, then the index in 32 bits
+static const int GLTFObjectHandleAssetShift = 40;
+static const int GLTFObjectHandleKindShift = 32;
+
+GLTFObjectKind GLTFObjectHandleGetKind(GLTFObjectHandle handle) {
+    return (GLTFObjectKind)((handle >> GLTFObjectHandleKindShift) & 0xFF);
+}
+
+NSInteger GLTFObjectHandleGetIndex(GLTFObjectHandle handle) {
+    return (handle != 0) ? (NSInteger)(handle & 0xFFFFFFFF) : NSNotFound;
+}
+
+NSInteger GLTFIndexOfObjectInArray(GLTFObject *object, NSArray<GLTFObject *> *objects) {
+    if (object == nil) {
+        return NSNotFound;
+    }
+    const NSInteger index = object.index;
+    if (index >= 0 && index < (NSInteger)objects.count && objects[index] == object) {
+        return index;
+    }
+    const NSUInteger foundIndex = [objects indexOfObjectIdenticalTo:object];
+    return (foundIndex != NSNotFound) ? (NSInteger)foundIndex : NSNotFound;
+}
+
 float GLTFDegFromRad(float rad) {
     return rad * (180.0 / M_PI);
 }
@@ -95,22 +147,23 @@ NSData *GLTFPackedDataForAccessor(GLTFAccessor *accessor) {
     size_t bytesPerComponent = GLTFBytesPerComponentForComponentType(accessor.componentType);
     size_t componentCount = GLTFComponentCountForDimension(accessor.dimension);
     size_t elementSize = bytesPerComponent * componentCount;
-    size_t bufferLength = elementSize * accessor.count;
+    size_t elementCount = (size_t)MAX(accessor.count, 0);
+    size_t bufferLength = elementSize * elementCount;
     void *bytes = malloc(bufferLength);
     if (bytes == NULL) {
         GLTFLogError(@"[GLTFKit2] Failed to allocate %ld (= %ld * %ld * %ld * %ld) bytes for packed data storage.",
-                     (long)bufferLength, (long)elementSize, (long)componentCount, (long)bytesPerComponent, (long)accessor.count);
+                     (long)bufferLength, (long)elementSize, (long)componentCount, (long)bytesPerComponent, (long)elementCount);
         return [NSData data];
     }
     if (bufferView != nil) {
         void *bufferViewBaseAddr = (void *)buffer.data.bytes + bufferView.offset;
         if (bufferView.stride == 0 || bufferView.stride == elementSize) {
             // Fast path
-            memcpy(bytes, bufferViewBaseAddr + accessor.offset, accessor.count * elementSize);
+            memcpy(bytes, bufferViewBaseAddr + accessor.offset, bufferLength);
         } else {
             // Slow path, element by element
             size_t sourceStride = bufferView.stride ?: elementSize;
-            for (int i = 0; i < accessor.count; ++i) {
+            for (size_t i = 0; i < elementCount; ++i) {
                 void *src = bufferViewBaseAddr + (i * sourceStride) + accessor.offset;
                 void *dest = bytes + (i * elementSize);
                 memcpy(dest, src, elementSize);
@@ -124,45 +177,7 @@ NSData *GLTFPackedDataForAccessor(GLTFAccessor *accessor) {
         memset(bytes, 0, bufferLength);
     }
     if (accessor.sparse) {
-        const void *baseSparseIndexBufferViewPtr = accessor.sparse.indices.buffer.data.bytes +
-                                                   accessor.sparse.indices.offset;
-        const void *baseSparseIndexAccessorPtr = baseSparseIndexBufferViewPtr + accessor.sparse.indexOffset;
-
-        const void *baseValueBufferViewPtr = accessor.sparse.values.buffer.data.bytes + accessor.sparse.values.offset;
-        const void *baseSrcPtr = baseValueBufferViewPtr + accessor.sparse.valueOffset;
-        const size_t srcValueStride = accessor.sparse.values.stride ?: elementSize;
-
-        void *baseDestPtr = bytes;
-
-        switch (accessor.sparse.indexComponentType) {
-            case GLTFComponentTypeUnsignedByte: {
-                const UInt8 *sparseIndices = (UInt8 *)baseSparseIndexAccessorPtr;
-                for (int i = 0; i < accessor.sparse.count; ++i) {
-                    UInt8 sparseIndex = sparseIndices[i];
-                    memcpy(baseDestPtr + sparseIndex * elementSize, baseSrcPtr + (i * srcValueStride), elementSize);
-                }
-                break;
-            }
-            case GLTFComponentTypeUnsignedShort: {
-                const UInt16 *sparseIndices = (UInt16 *)baseSparseIndexAccessorPtr;
-                for (int i = 0; i < accessor.sparse.count; ++i) {
-                    UInt16 sparseIndex = sparseIndices[i];
-                    memcpy(baseDestPtr + sparseIndex * elementSize, baseSrcPtr + (i * srcValueStride), elementSize);
-                }
-                break;
-            }
-            case GLTFComponentTypeUnsignedInt: {
-                const UInt32 *sparseIndices = (UInt32 *)baseSparseIndexAccessorPtr;
-                for (int i = 0; i < accessor.sparse.count; ++i) {
-                    UInt32 sparseIndex = sparseIndices[i];
-                    memcpy(baseDestPtr + sparseIndex * elementSize, baseSrcPtr + (i * srcValueStride), elementSize);
-                }
-                break;
-            }
-            default:
-                assert(!"Sparse accessor index type must be one of: unsigned byte, unsigned short, or unsigned int.");
-                break;
-        }
+        [accessor.sparseOverlay applyToPackedBytes:bytes];
     }
     return [NSData dataWithBytesNoCopy:bytes length:bufferLength freeWhenDone:YES];
 }
@@ -182,7 +197,7 @@ NSData *GLTFTransformPackedDataToFloat(NSData *sourceData, GLTFAccessor *sourceA
     }
 
     size_t vectorCount = sourceAccessor.count;
-    size_t componentCount = sourceAccessor.dimension;
+    size_t componentCount = GLTFComponentCountForDimension(sourceAccessor.dimension);
     size_t elementCount = vectorCount * componentCount;
 
     size_t outBufferSize = vectorCount * componentCount * sizeof(float);
@@ -338,17 +353,66 @@ NSString *GLTFMediaTypeFromDataURI(NSString *uriData) {
     return nil;
 }
 
-@implementation GLTFObject
+@interface GLTFObject ()
+@property (nonatomic, assign) GLTFObjectHandle handle;
+@end
+
+@implementation GLTFObject {
+    // Holds a +1 reference to a lazily created NSUUID, published with a compare-and-swap
+    _Atomic(void *) _identifier;
+}
 
 - (instancetype)init {
     if (self = [super init]) {
         _name = @"";
-        _identifier = [NSUUID UUID];
         _extensions = @{};
     }
     return self;
 }
 
+- (void)dealloc {
+    void *identifier = atomic_load_explicit(&_identifier, memory_order_relaxed);
+    if (identifier != NULL) {
+        CFRelease(identifier);
+    }
+}
+
+- (NSUUID *)identifier {
+    void *identifier = atomic_load_explicit(&_identifier, memory_order_acquire);
+    if (identifier != NULL) {
+        return (__bridge NSUUID *)identifier;
+    }
+    // Racing callers may each create a UUID; only the first to publish wins and the rest are released
+    void *newIdentifier = (__bridge_retained void *)[NSUUID UUID];
+    if (!atomic_compare_exchange_strong_explicit(&_identifier, &identifier, newIdentifier,
+                                                 memory_order_acq_rel, memory_order_acquire))
+    {
+        CFRelease(newIdentifier);
+        return (__bridge NSUUID *)identifier;
+    }
+    return (__bridge NSUUID *)newIdentifier;
+}
+
+- (NSInteger)index {
+    return GLTFObjectHandleGetIndex(_handle);
+}
+
+@end
+
+// Copies `objects`, assigning each the handle of its position in the array as one of the asset's objects of `kind`.
+static NSArray *GLTFIndexedArray(NSArray<GLTFObject *> *objects, uint64_t assetNumber, GLTFObjectKind kind) {
+    NSArray<GLTFObject *> *indexedObjects = [objects copy];
+    const GLTFObjectHandle base = (assetNumber << GLTFObjectHandleAssetShift) |
+                                  ((GLTFObjectHandle)kind << GLTFObjectHandleKindShift);
+    GLTFObjectHandle index = 0;
+    for (GLTFObject *object in indexedObjects) {
+        object.handle = base | index++;
+    }
+    return indexedObjects;
+}
+
+@interface GLTFAsset ()
+@property (nonatomic, readonly) uint64_t assetNumber;
 @end
 
 @implementation GLTFAsset
@@ -391,6 +455,9 @@ NSString *GLTFMediaTypeFromDataURI(NSString *uriData) {
 
 - (instancetype)init {
     if (self = [super init]) {
+        // Numbers start at 1 so that no handle is zero, and wrap after 2^24 - 1 assets (see GLTFObjectHandle)
+        static atomic_uint_fast32_t assetCount = 0;
+        _assetNumber = atomic_fetch_add(&assetCount, 1) % 0xFFFFFF + 1;
         _version = @"2.0";
         _extensionsUsed = @[];
         _extensionsRequired = @[];
@@ -411,6 +478,74 @@ NSString *GLTFMediaTypeFromDataURI(NSString *uriData) {
     return self;
 }
 
+- (void)setAccessors:(NSArray<GLTFAccessor *> *)accessors {
+    _accessors = GLTFIndexedArray(accessors, _assetNumber, GLTFObjectKindAccessor);
+}
+
+- (void)setAnimations:(NSArray<GLTFAnimation *> *)animations {
+    _animations = GLTFIndexedArray(animations, _assetNumber, GLTFObjectKindAnimation);
+}
+
+- (void)setBuffers:(NSArray<GLTFBuffer *> *)buffers {
+    _buffers = GLTFIndexedArray(buffers, _assetNumber, GLTFObjectKindBuffer);
+}
+
+- (void)setBufferViews:(NSArray<GLTFBufferView *> *)bufferViews {
+    _bufferViews = GLTFIndexedArray(bufferViews, _assetNumber, GLTFObjectKindBufferView);
+}
+
+- (void)setCameras:(NSArray<GLTFCamera *> *)cameras {
+    _cameras = GLTFIndexedArray(cameras, _assetNumber, GLTFObjectKindCamera);
+}
+
+- (void)setLights:(NSArray<GLTFLight *> *)lights {
+    _lights = GLTFIndexedArray(lights, _assetNumber, GLTFObjectKindLight);
+}
+
+- (void)setImages:(NSArray<GLTFImage *> *)images {
+    _images = GLTFIndexedArray(images, _assetNumber, GLTFObjectKindImage);
+}
+
+- (void)setMaterials:(NSArray<GLTFMaterial *> *)materials {
+    _materials = GLTFIndexedArray(materials, _assetNumber, GLTFObjectKindMaterial);
+}
+
+- (void)setMaterialVariants:(nullable NSArray<GLTFMaterialVariant *> *)materialVariants {
+    _materialVariants = GLTFIndexedArray(materialVariants, _assetNumber, GLTFObjectKindMaterialVariant);
+}
+
+- (void)setMeshes:(NSArray<GLTFMesh *> *)meshes {
+    _meshes = GLTFIndexedArray(meshes, _assetNumber, GLTFObjectKindMesh);
+}
+
+- (void)setNodes:(NSArray<GLTFNode *> *)nodes {
+    _nodes = GLTFIndexedArray(nodes, _assetNumber, GLTFObjectKindNode);
+}
+
+- (void)setSamplers:(NSArray<GLTFTextureSampler *> *)samplers {
+    _samplers = GLTFIndexedArray(samplers, _assetNumber, GLTFObjectKindSampler);
+}
+
+- (void)setScenes:(NSArray<GLTFScene *> *)scenes {
+    _scenes = GLTFIndexedArray(scenes, _assetNumber, GLTFObjectKindScene);
+}
+
+- (void)setSkins:(NSArray<GLTFSkin *> *)skins {
+    _skins = GLTFIndexedArray(skins, _assetNumber, GLTFObjectKindSkin);
+}
+
+- (void)setTextures:(NSArray<GLTFTexture *> *)textures {
+    _textures = GLTFIndexedArray(textures, _assetNumber, GLTFObjectKindTexture);
+}
+
+@end
+
+@interface GLTFSparseOverlay ()
+- (nullable instancetype)initWithAccessor:(GLTFAccessor *)accessor NS_DESIGNATED_INITIALIZER;
+@end
+
+@interface GLTFAccessor ()
+@property (nonatomic, nullable, strong) GLTFSparseOverlay *cachedSparseOverlay;
 @end
 
 @implementation GLTFAccessor
@@ -435,6 +570,25 @@ NSString *GLTFMediaTypeFromDataURI(NSString *uriData) {
     return self;
 }
 
+- (void)setSparse:(GLTFSparseStorage *)sparse {
+    @synchronized (self) {
+        _sparse = sparse;
+        _cachedSparseOverlay = nil;
+    }
+}
+
+- (nullable GLTFSparseOverlay *)sparseOverlay {
+    @synchronized (self) {
+        if (_sparse == nil) {
+            return nil;
+        }
+        if (_cachedSparseOverlay == nil || _cachedSparseOverlay.elementCount != _count) {
+            _cachedSparseOverlay = [[GLTFSparseOverlay alloc] initWithAccessor:self];
+        }
+        return _cachedSparseOverlay;
+    }
+}
+
 @end
 
 @implementation GLTFAnimation
@@ -983,7 +1137,7 @@ NSString *GLTFMediaTypeFromDataURI(NSString *uriData) {
                 GLTFLogWarning(@"[GLTFKit2] Scale attribute was present on mesh instancing object, but was not of float VEC3 type");
             }
         }
-        for (int i = 0; i < self.instanceCount; ++i) {
+        for (NSInteger i = 0; i < self.instanceCount; ++i) {
             simd_float4x4 M = matrix_identity_float4x4;
             if (scaleData && scaleData.bytes != NULL) {
                 float *scale = ((float *)scaleData.bytes) + (i * 3);
@@ -1033,6 +1187,9 @@ NSString *GLTFMediaTypeFromDataURI(NSString *uriData) {
         _primitiveType = primitiveType;
         _attributes = [attributes copy];
         _indices = indices;
+        _boundingBox = GLTFBoundingBoxEmpty;
+        _levelOfDetailIndices = @[];
+        _levelOfDetailErrors = @[];
     }
     return self;
 }
@@ -1139,6 +1296,110 @@ NSString *GLTFMediaTypeFromDataURI(NSString *uriData) {
 
 @end
 
+@implementation GLTFSparseOverlay
+
+- (nullable instancetype)initWithAccessor:(GLTFAccessor *)accessor {
+    GLTFSparseStorage *sparse = accessor.sparse;
+    size_t bytesPerComponent = GLTFBytesPerComponentForComponentType(accessor.componentType);
+    size_t elementSize = bytesPerComponent * GLTFComponentCountForDimension(accessor.dimension);
+    size_t bytesPerIndex = GLTFBytesPerComponentForComponentType(sparse.indexComponentType);
+    size_t sparseCount = MAX(sparse.count, 0);
+    size_t valueStride = sparse.values.stride ?: elementSize;
+
+    if (sparse.indices.buffer.data == nil || sparse.values.buffer.data == nil || elementSize == 0 || bytesPerIndex == 0) {
+        GLTFLogError(@"[GLTFKit2] Sparse accessor is missing index or value data, or has an invalid type.");
+        return nil;
+    }
+    if (sparseCount > UINT32_MAX) {
+        GLTFLogError(@"[GLTFKit2] Sparse accessor has too many (%ld) substitutions.", (long)sparseCount);
+        return nil;
+    }
+    size_t requiredIndexLength = sparse.indexOffset + sparseCount * bytesPerIndex;
+    size_t requiredValueLength = (sparseCount > 0) ? sparse.valueOffset + (sparseCount - 1) * valueStride + elementSize : 0;
+    if (requiredIndexLength > (size_t)sparse.indices.length || requiredValueLength > (size_t)sparse.values.length ||
+        (size_t)(sparse.indices.offset + sparse.indices.length) > sparse.indices.buffer.data.length ||
+        (size_t)(sparse.values.offset + sparse.values.length) > sparse.values.buffer.data.length)
+    {
+        GLTFLogError(@"[GLTFKit2] Sparse accessor indices or values extend beyond the end of their buffer views.");
+        return nil;
+    }
+
+    if (self = [super init]) {
+        const void *sparseIndices = sparse.indices.buffer.data.bytes + sparse.indices.offset + sparse.indexOffset;
+        const void *sparseValues = sparse.values.buffer.data.bytes + sparse.values.offset + sparse.valueOffset;
+
+        uint32_t *indices = malloc(MAX(sparseCount, 1) * sizeof(uint32_t));
+        uint32_t *slots = malloc(MAX(sparseCount, 1) * sizeof(uint32_t));
+        void *values = malloc(MAX(sparseCount, 1) * elementSize);
+        if (indices == NULL || slots == NULL || values == NULL) {
+            GLTFLogError(@"[GLTFKit2] Failed to allocate storage for %ld sparse substitutions.", (long)sparseCount);
+            free(indices);
+            free(slots);
+            free(values);
+            return nil;
+        }
+
+        size_t discardedCount = 0;
+        size_t resolvedCount = GLTFSparseResolveIndices(sparseIndices, sparse.indexComponentType, sparseCount,
+                                                        MAX(accessor.count, 0), indices, slots, &discardedCount);
+        if (discardedCount > 0) {
+            GLTFLogError(@"[GLTFKit2] Ignoring %ld sparse indices that are out of range for accessor of count %ld.",
+                         (long)discardedCount, (long)accessor.count);
+        }
+        GLTFSparseGatherValues(sparseValues, valueStride, slots, resolvedCount, elementSize, values);
+        free(slots);
+
+        _count = resolvedCount;
+        _elementCount = accessor.count;
+        _elementSize = elementSize;
+        _indexData = [NSData dataWithBytesNoCopy:indices length:resolvedCount * sizeof(uint32_t) freeWhenDone:YES];
+        _valueData = [NSData dataWithBytesNoCopy:values length:resolvedCount * elementSize freeWhenDone:YES];
+        _hasImplicitZeroBase = (accessor.bufferView == nil);
+    }
+    return self;
+}
+
+- (void)enumerateElementsUsingBlock:(void (^)(NSInteger index, const void *value, BOOL *stop))block {
+    const uint32_t *indices = _indexData.bytes;
+    const void *values = _valueData.bytes;
+    BOOL stop = NO;
+    for (NSInteger i = 0; i < _count; ++i) {
+        block(indices[i], values + i * _elementSize, &stop);
+        if (stop) {
+            break;
+        }
+    }
+}
+
+- (void)applyToPackedBytes:(void *)bytes {
+    GLTFSparseScatterValues(_valueData.bytes, _indexData.bytes, _count, _elementSize, bytes);
+}
+
+@end
+
+@implementation GLTFMeshletSet
+
+- (instancetype)initWithMeshletData:(NSData *)meshletData
+                    vertexIndexData:(NSData *)vertexIndexData
+                       triangleData:(NSData *)triangleData
+                         boundsData:(NSData *)boundsData
+                     maxVertexCount:(NSInteger)maxVertexCount
+                   maxTriangleCount:(NSInteger)maxTriangleCount
+{
+    if (self = [super init]) {
+        _meshletCount = meshletData.length / sizeof(GLTFMeshlet);
+        _meshletData = meshletData;
+        _vertexIndexData = vertexIndexData;
+        _triangleData = triangleData;
+        _boundsData = boundsData;
+        _maxVertexCount = maxVertexCount;
+        _maxTriangleCount = maxTriangleCount;
+    }
+    return self;
+}
+
+@end
+
 @implementation GLTFTextureTransform
 
 - (instancetype)init {
@@ -21,6 +21,9 @@ FOUNDATION_EXPORT double GLTFKit2VersionNumber;
 
 FOUNDATION_EXPORT const unsigned char GLTFKit2VersionString[];
 
+#import <GLTFKit2/GLTFAnimationRuntime.h>
 #import <GLTFKit2/GLTFAsset.h>
+#import <GLTFKit2/GLTFMeshProcessing.h>
 #import <GLTFKit2/GLTFModelIO.h>
+#import <GLTFKit2/GLTFSceneProcessing.h>
 #import <GLTFKit2/GLTFSceneKit.h>
@@ -0,0 +1,216 @@
+
+#import <GLTFKit2/GLTFAsset.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, GLTFVertexComponentFormat) {
+    GLTFVertexComponentFormatFloat,
+    GLTFVertexComponentFormatHalf,
+    GLTFVertexComponentFormatSNorm8,
+    GLTFVertexComponentFormatUNorm8,
+    GLTFVertexComponentFormatSNorm16,
+    GLTFVertexComponentFormatUNorm16,
+    GLTFVertexComponentFormatUInt8,
+    GLTFVertexComponentFormatUInt16,
+    GLTFVertexComponentFormatUInt32,
+};
+
+typedef NS_OPTIONS(NSUInteger, GLTFVertexAttributeTransform) {
+    GLTFVertexAttributeTransformNone                 = 0,
+    /// Replaces the second component v with 1 - v, converting texture coordinates from a top-left to a bottom-left origin
+    GLTFVertexAttributeTransformFlipTexCoordVertical = 1 << 0,
+};
+
+GLTFKIT2_EXPORT
+@interface GLTFVertexAttributeLayout : NSObject
+
+@property (nonatomic, copy) NSString *semantic;
+@property (nonatomic, assign) GLTFVertexComponentFormat format;
+/// The number of components written per vertex, from 1 to 4
+@property (nonatomic, assign) NSInteger componentCount;
+/// The offset of the attribute within each vertex, or NSNotFound to place it after the preceding attribute
+@property (nonatomic, assign) NSInteger offset;
+@property (nonatomic, assign) GLTFVertexAttributeTransform transform;
+
+- (instancetype)initWithSemantic:(NSString *)semantic
+                          format:(GLTFVertexComponentFormat)format
+                  componentCount:(NSInteger)componentCount NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+GLTFKIT2_EXPORT
+@interface GLTFVertexLayout : NSObject
+
+/// The attributes of each vertex, in the order in which they are placed when their offsets are automatic
+@property (nonatomic, copy) NSArray<GLTFVertexAttributeLayout *> *attributes;
+/// The distance in bytes between consecutive vertices, or 0 to use the end of the last attribute rounded up to `alignment`
+@property (nonatomic, assign) NSInteger stride;
+/// The alignment in bytes of automatically placed attributes and of the automatic stride. Defaults to 4.
+@property (nonatomic, assign) NSInteger alignment;
+
+- (instancetype)initWithAttributes:(NSArray<GLTFVertexAttributeLayout *> *)attributes NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Returns the byte offset of each attribute, in order, with automatic offsets resolved.
+- (NSArray<NSNumber *> *)resolvedOffsets;
+
+/// Returns the stride of the layout, with an automatic stride resolved.
+- (NSInteger)resolvedStride;
+
+@end
+
+/// Builds an interleaved vertex buffer for `primitive` in the given layout, reading each source accessor once and
+/// converting it directly into its destination format. Attributes named in the layout that the primitive lacks are
+/// filled with (0, 0, 0, 1). The vertex count is that of the primitive's POSITION attribute (or its first attribute).
+/// Returns nil and sets `error` if the layout is invalid.
+GLTFKIT2_EXPORT
+NSData *_Nullable GLTFInterleavedVertexDataForPrimitive(GLTFPrimitive *primitive,
+                                                       GLTFVertexLayout *layout,
+                                                       NSError **error);
+
+typedef NS_OPTIONS(NSUInteger, GLTFIndexConversionOptions) {
+    GLTFIndexConversionOptionNone                   = 0,
+    /// Leave triangle strips as strips, unless they contain primitive restarts, rather than converting them to triangle lists
+    GLTFIndexConversionOptionPreserveTriangleStrips = 1 << 0,
+    /// Narrow 32-bit indices to 16 bits when every index fits
+    GLTFIndexConversionOptionNarrowTo16Bit          = 1 << 1,
+};
+
+/// Returns index data for `primitive` in a form accepted by renderers that lack 8-bit indices and non-list topologies.
+/// Line loops and line strips become lines, triangle fans (and, unless preserved, triangle strips) become triangles,
+/// strips, loops and fans are split at primitive restart indices, and 8-bit indices are widened to 16 bits. If the
+/// primitive is not indexed, sequential indices are synthesized. On return, `outPrimitiveType`, `outIndexCount`
+/// and `outBytesPerIndex` describe the returned data. Returns nil if the primitive has no drawable indices.
+GLTFKIT2_EXPORT
+NSData *_Nullable GLTFIndexDataForPrimitive(GLTFPrimitive *primitive,
+                                           GLTFIndexConversionOptions options,
+                                           GLTFPrimitiveType *_Nullable outPrimitiveType,
+                                           NSInteger *_Nullable outIndexCount,
+                                           NSInteger *_Nullable outBytesPerIndex);
+
+/// Computes the per-component minimum and maximum of the elements of `accessor`, including any sparse substitutions,
+/// in a single vectorized pass. As with `minValues` and `maxValues`, the bounds are raw component values, even if the
+/// accessor is normalized. NaN components are ignored. Returns NO if the accessor has no readable data.
+GLTFKIT2_EXPORT
+BOOL GLTFAccessorComputeBounds(GLTFAccessor *accessor,
+                               NSArray<NSNumber *> *_Nullable *_Nullable outMinValues,
+                               NSArray<NSNumber *> *_Nullable *_Nullable outMaxValues);
+
+/// Returns the bounding box given by the bounds of the POSITION accessor of `primitive`, decoding normalized
+/// (quantized) positions. Returns GLTFBoundingBoxEmpty if the positions have no bounds.
+GLTFKIT2_EXPORT
+GLTFBoundingBox GLTFBoundingBoxForPrimitive(GLTFPrimitive *primitive);
+
+/// Scans the indices of `primitive`, returning NO and setting `error` if any index refers to a vertex
+/// beyond the end of the primitive's attributes.
+GLTFKIT2_EXPORT
+BOOL GLTFValidatePrimitiveIndices(GLTFPrimitive *primitive, NSError **error);
+
+/// Returns angle-weighted smooth normals for the vertices of `primitive`, packed as three floats per vertex, without
+/// modifying the primitive. Returns nil if the primitive has no positions or is not made of triangles.
+GLTFKIT2_EXPORT
+NSData *_Nullable GLTFSmoothNormalDataForPrimitive(GLTFPrimitive *primitive);
+
+/// Adds an angle-weighted NORMAL attribute to `primitive` if it is made of triangles and lacks one. Where faces meet
+/// at more than `creaseAngle` radians, shading is not smoothed across the edge between them; pass 0 for the flat
+/// normals that the glTF specification prescribes, or M_PI for fully smooth normals. If creases require vertices to
+/// be split, every attribute and morph target of the primitive is replaced by a copy with the split vertices, and
+/// the primitive becomes an indexed triangle list. Returns the accessors that were created, each with a buffer view
+/// and buffer of its own, so that they can be added to the asset; the array is empty if the primitive was left
+/// unchanged. Returns nil and sets `error` if the primitive's positions or indices are invalid.
+GLTFKIT2_EXPORT
+NSArray<GLTFAccessor *> *_Nullable GLTFPrimitiveGenerateNormals(GLTFPrimitive *primitive,
+                                                                float creaseAngle,
+                                                                NSError **error);
+
+/// Adds a TANGENT attribute computed with MikkTSpace to `primitive` if its material has a normal texture and it lacks
+/// tangents. The primitive must have normals and the texture coordinate set used by the normal texture. Vertices
+/// whose faces are given different tangents (such as those along mirrored UV seams) are split, in which case every attribute and morph target is
+/// replaced as described for `GLTFPrimitiveGenerateNormals`. Returns the accessors that were created, or an empty
+/// array if the primitive was left unchanged. Returns nil and sets `error` if the primitive's data is invalid.
+GLTFKIT2_EXPORT
+NSArray<GLTFAccessor *> *_Nullable GLTFPrimitiveGenerateTangents(GLTFPrimitive *primitive, NSError **error);
+
+typedef struct GLTFVertexCacheStatistics {
+    /// Average cache miss ratio: vertices transformed per triangle, from 0.5 (ideal) to 3 (no reuse)
+    float acmr;
+    /// Average transformed vertex ratio: vertices transformed per referenced vertex, from 1 (ideal) upward
+    float atvr;
+} GLTFVertexCacheStatistics;
+
+typedef struct GLTFMeshOptimizationStatistics {
+    GLTFVertexCacheStatistics before;
+    GLTFVertexCacheStatistics after;
+} GLTFMeshOptimizationStatistics;
+
+typedef NS_OPTIONS(NSUInteger, GLTFMeshOptimizationOptions) {
+    /// Reorder triangles for post-transform vertex cache locality
+    GLTFMeshOptimizationOptionVertexCache = 1 << 0,
+    /// After optimizing for the vertex cache, reorder clusters of triangles so that outward-facing ones draw first
+    GLTFMeshOptimizationOptionOverdraw    = 1 << 1,
+    /// Renumber vertices in the order the triangles use them, for vertex fetch locality
+    GLTFMeshOptimizationOptionVertexFetch = 1 << 2,
+    GLTFMeshOptimizationOptionAll         = GLTFMeshOptimizationOptionVertexCache |
+                                            GLTFMeshOptimizationOptionOverdraw |
+                                            GLTFMeshOptimizationOptionVertexFetch,
+};
+
+/// Reorders the triangles and vertices of an indexed `primitive` of type GLTFPrimitiveTypeTriangles for GPU
+/// efficiency, simulating a 16-entry FIFO vertex cache to report the effect in `outStatistics`. The primitive's
+/// indices are replaced and, if vertices are renumbered, so are its attributes and morph targets. Returns the
+/// accessors that were created, or an empty array if the primitive is not an indexed triangle list. Returns nil
+/// and sets `error` if the primitive's indices are invalid. Unindexed triangle lists are left unchanged, since none
+/// of their vertices are shared; welding them with `GLTFPrimitiveWeldVertices` first gives them indices.
+GLTFKIT2_EXPORT
+NSArray<GLTFAccessor *> *_Nullable GLTFPrimitiveOptimizeVertexOrder(GLTFPrimitive *primitive,
+                                                                    GLTFMeshOptimizationOptions options,
+                                                                    GLTFMeshOptimizationStatistics *_Nullable outStatistics,
+                                                                    NSError **error);
+
+/// Optimizes `primitive` as `GLTFPrimitiveOptimizeVertexOrder` does, but rewrites its index, attribute, and morph
+/// target accessors in their existing storage when they are in `unsharedAccessors`, rather than copying them to new
+/// accessors. Each accessor in the set must be used by no other primitive or object in the asset, must be the only
+/// accessor in its buffer view, which must overlap no other, and must belong to a buffer whose data is mutable.
+/// Accessors outside the set are copied as before.
+GLTFKIT2_EXPORT
+NSArray<GLTFAccessor *> *_Nullable GLTFPrimitiveOptimizeVertexOrderInPlace(GLTFPrimitive *primitive,
+                                                                           GLTFMeshOptimizationOptions options,
+                                                                           NSSet<GLTFAccessor *> *_Nullable unsharedAccessors,
+                                                                           GLTFMeshOptimizationStatistics *_Nullable outStatistics,
+                                                                           NSError **error);
+
+/// Builds up to `levelCount` simplified versions of a triangle `primitive` by quadric-error edge collapse, each
+/// aiming for half the triangles of the one before, and stores them in its `levelOfDetailIndices` and
+/// `levelOfDetailErrors`. Levels index the primitive's own vertices. Open borders and attribute seams are preserved,
+/// and collapses are penalized for bending normals and for distorting TEXCOORD_0, and rejected if they flip
+/// triangles in space or in the TEXCOORD_0 domain. Simplification stops before introducing more than `targetError`, relative to the largest
+/// dimension of the primitive, so fewer levels may be built. The result is deterministic. Returns the new index
+/// accessors, or nil and sets `error` if the primitive's indices are invalid.
+GLTFKIT2_EXPORT
+NSArray<GLTFAccessor *> *_Nullable GLTFPrimitiveGenerateLevelsOfDetail(GLTFPrimitive *primitive,
+                                                                       NSInteger levelCount,
+                                                                       float targetError,
+                                                                       NSError **error);
+
+/// Partitions the triangles of `primitive` into meshlets of at most `maxVertexCount` vertices (up to 256) and
+/// `maxTriangleCount` triangles (up to 512), each with a bounding sphere and a normal cone for culling. Meshlets are
+/// grown across shared vertices so that they are compact and nearly full; 64 and 124 suit most GPUs. Returns nil and
+/// sets `error` if the limits are out of range or the primitive is not made of triangles or has invalid indices.
+GLTFKIT2_EXPORT
+GLTFMeshletSet *_Nullable GLTFMeshletSetForPrimitive(GLTFPrimitive *primitive,
+                                                     NSInteger maxVertexCount,
+                                                     NSInteger maxTriangleCount,
+                                                     NSError **error);
+
+/// Merges vertices of `primitive` that are identical in every attribute and morph target, and indexes the primitive
+/// with the result, using 16-bit indices when the welded vertex count allows. Float components are compared exactly
+/// if `epsilon` is zero, and otherwise after rounding to the nearest multiple of `epsilon`. Unindexed primitives
+/// become indexed; unreferenced vertices are dropped. Returns the accessors that were created, or an empty array if
+/// no vertices could be merged. Returns nil and sets `error` if the primitive's data is invalid.
+GLTFKIT2_EXPORT
+NSArray<GLTFAccessor *> *_Nullable GLTFPrimitiveWeldVertices(GLTFPrimitive *primitive, float epsilon, NSError **error);
+
+NS_ASSUME_NONNULL_END
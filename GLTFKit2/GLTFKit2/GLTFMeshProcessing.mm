@@ -0,0 +1,930 @@
+
+#import "GLTFMeshProcessing.h"
+#import "GLTFAccessorViewSupport.h"
+#import "GLTFLogging.h"
+
+#include "GLTFBoundsComputation.h"
+#include "GLTFIndexProcessing.h"
+#include "GLTFMeshOptimization.h"
+#include "GLTFMeshletBuilder.h"
+#include "GLTFNormalGeneration.h"
+#include "GLTFSimplification.h"
+#include "GLTFTangentGeneration.h"
+#include "GLTFVertexInterleaving.h"
+#include "GLTFVertexWelding.h"
+
+#include <numeric>
+#include <vector>
+
+static_assert(GLTF::VertexComponentFormatUInt32 == (int)GLTFVertexComponentFormatUInt32,
+              "GLTF::VertexComponentFormat must mirror GLTFVertexComponentFormat");
+static_assert(sizeof(GLTF::Meshlet) == sizeof(GLTFMeshlet) && sizeof(GLTF::MeshletBounds) == sizeof(GLTFMeshletBounds),
+              "Meshlet structures must match their public counterparts");
+static_assert(GLTF::PrimitiveTopologyTriangleFan == (int)GLTFPrimitiveTypeTriangleFan,
+              "GLTF::PrimitiveTopology must mirror GLTFPrimitiveType");
+
+static NSError *GLTFMeshProcessingError(NSString *description) {
+    return [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeInvalidOptions userInfo:@{
+        NSLocalizedDescriptionKey : description
+    }];
+}
+
+static NSInteger GLTFAlignUp(NSInteger value, NSInteger alignment) {
+    return ((value + alignment - 1) / alignment) * alignment;
+}
+
+@implementation GLTFVertexAttributeLayout
+
+- (instancetype)initWithSemantic:(NSString *)semantic
+                          format:(GLTFVertexComponentFormat)format
+                  componentCount:(NSInteger)componentCount
+{
+    if (self = [super init]) {
+        _semantic = [semantic copy];
+        _format = format;
+        _componentCount = componentCount;
+        _offset = NSNotFound;
+        _transform = GLTFVertexAttributeTransformNone;
+    }
+    return self;
+}
+
+@end
+
+@implementation GLTFVertexLayout
+
+- (instancetype)initWithAttributes:(NSArray<GLTFVertexAttributeLayout *> *)attributes {
+    if (self = [super init]) {
+        _attributes = [attributes copy];
+        _stride = 0;
+        _alignment = 4;
+    }
+    return self;
+}
+
+- (NSArray<NSNumber *> *)resolvedOffsets {
+    NSMutableArray<NSNumber *> *offsets = [NSMutableArray arrayWithCapacity:self.attributes.count];
+    NSInteger alignment = MAX(self.alignment, 1);
+    NSInteger nextOffset = 0;
+    for (GLTFVertexAttributeLayout *attribute in self.attributes) {
+        NSInteger offset = (attribute.offset == NSNotFound) ? GLTFAlignUp(nextOffset, alignment) : attribute.offset;
+        [offsets addObject:@(offset)];
+        size_t size = GLTF::BytesPerVertexComponent((int)attribute.format) * attribute.componentCount;
+        nextOffset = MAX(nextOffset, offset + (NSInteger)size);
+    }
+    return offsets;
+}
+
+- (NSInteger)resolvedStride {
+    if (self.stride > 0) {
+        return self.stride;
+    }
+    NSArray<NSNumber *> *offsets = [self resolvedOffsets];
+    NSInteger end = 0;
+    for (NSInteger i = 0; i < self.attributes.count; ++i) {
+        GLTFVertexAttributeLayout *attribute = self.attributes[i];
+        size_t size = GLTF::BytesPerVertexComponent((int)attribute.format) * attribute.componentCount;
+        end = MAX(end, offsets[i].integerValue + (NSInteger)size);
+    }
+    return GLTFAlignUp(end, MAX(self.alignment, 1));
+}
+
+@end
+
+NSData *GLTFInterleavedVertexDataForPrimitive(GLTFPrimitive *primitive, GLTFVertexLayout *layout, NSError **error) {
+    GLTFAccessor *vertexCountAccessor = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor ?:
+                                        primitive.attributes.firstObject.accessor;
+    const size_t vertexCount = MAX(vertexCountAccessor.count, 0);
+    const NSInteger stride = [layout resolvedStride];
+    NSArray<NSNumber *> *offsets = [layout resolvedOffsets];
+
+    std::vector<GLTF::VertexStream> streams;
+    NSMutableArray<NSData *> *storage = [NSMutableArray array];
+    for (NSInteger i = 0; i < layout.attributes.count; ++i) {
+        GLTFVertexAttributeLayout *attributeLayout = layout.attributes[i];
+        GLTF::VertexStream stream;
+        stream.format = (int)attributeLayout.format;
+        stream.componentCount = (int)attributeLayout.componentCount;
+        stream.offset = offsets[i].integerValue;
+        stream.flipTexCoordVertical = (attributeLayout.transform & GLTFVertexAttributeTransformFlipTexCoordVertical) != 0;
+
+        size_t size = GLTF::BytesPerVertexComponent(stream.format) * stream.componentCount;
+        if (size == 0 || stream.componentCount > 4 || offsets[i].integerValue < 0 ||
+            offsets[i].integerValue + (NSInteger)size > stride)
+        {
+            if (error) {
+                *error = GLTFMeshProcessingError([NSString stringWithFormat:@"Vertex attribute %@ does not fit in a "
+                                                  "vertex of stride %ld", attributeLayout.semantic, (long)stride]);
+            }
+            return nil;
+        }
+
+        GLTFAccessor *accessor = [primitive attributeForName:attributeLayout.semantic].accessor;
+        NSData *attributeStorage = nil;
+        stream.source = GLTFAccessorViewForAccessor(accessor, &attributeStorage);
+        if (attributeStorage) {
+            [storage addObject:attributeStorage];
+        }
+        if (accessor != nil && stream.source.count < vertexCount) {
+            GLTFLogWarning(@"[GLTFKit2] Attribute %@ has fewer elements (%ld) than the primitive has vertices (%ld).",
+                           attributeLayout.semantic, (long)stream.source.count, (long)vertexCount);
+        }
+        streams.push_back(stream);
+    }
+
+    size_t bufferLength = vertexCount * stride;
+    uint8_t *bytes = (uint8_t *)calloc(MAX(bufferLength, 1), 1);
+    if (bytes == NULL) {
+        GLTFLogError(@"[GLTFKit2] Failed to allocate %ld bytes for interleaved vertex data.", (long)bufferLength);
+        if (error) {
+            *error = [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeOutOfMemory userInfo:@{
+                NSLocalizedDescriptionKey : @"Failed to allocate interleaved vertex data"
+            }];
+        }
+        return nil;
+    }
+    GLTF::InterleaveVertexStreams(streams.data(), streams.size(), vertexCount, stride, bytes);
+    return [NSData dataWithBytesNoCopy:bytes length:bufferLength freeWhenDone:YES];
+}
+
+namespace {
+
+// Wraps memory owned by `owner` in a data object that keeps the owner alive, avoiding a copy.
+NSData *GLTFDataReferencingBytes(const void *bytes, size_t length, id owner) {
+    return [[NSData alloc] initWithBytesNoCopy:(void *)bytes length:length deallocator:^(void *, NSUInteger) {
+        (void)owner;
+    }];
+}
+
+template <typename Index_t>
+Index_t *GLTFAllocateIndices(size_t count) {
+    Index_t *indices = (Index_t *)malloc(MAX(count, (size_t)1) * sizeof(Index_t));
+    if (indices == NULL) {
+        GLTFLogError(@"[GLTFKit2] Failed to allocate %ld bytes for index data.", (long)(count * sizeof(Index_t)));
+    }
+    return indices;
+}
+
+template <typename Index_t>
+void GLTFConvertIndices(const Index_t *src, size_t count, Index_t *dst) {
+    memcpy(dst, src, count * sizeof(Index_t));
+}
+
+template <typename Src_t, typename Dst_t>
+void GLTFConvertIndices(const Src_t *src, size_t count, Dst_t *dst) {
+    GLTF::ConvertIndices(src, count, dst);
+}
+
+template <typename Src_t, typename Dst_t>
+NSData *GLTFConvertedIndexData(GLTF::PrimitiveTopology topology, bool convertTopology, const Src_t *src, size_t count,
+                               id owner, size_t *outCount)
+{
+    if (!convertTopology && sizeof(Src_t) == sizeof(Dst_t)) {
+        *outCount = count;
+        return GLTFDataReferencingBytes(src, count * sizeof(Dst_t), owner);
+    }
+    const size_t capacity = convertTopology ? GLTF::ListIndexCountUpperBound(topology, count) : count;
+    Dst_t *dst = GLTFAllocateIndices<Dst_t>(capacity);
+    if (dst == NULL) {
+        return nil;
+    }
+    if (convertTopology) {
+        *outCount = GLTF::ConvertIndicesToListTopology(topology, src, count, dst);
+        if (*outCount < capacity) {
+            dst = (Dst_t *)realloc(dst, MAX(*outCount, (size_t)1) * sizeof(Dst_t)) ?: dst;
+        }
+    } else {
+        *outCount = count;
+        GLTFConvertIndices(src, count, dst);
+    }
+    return [NSData dataWithBytesNoCopy:dst length:*outCount * sizeof(Dst_t) freeWhenDone:YES];
+}
+
+template <typename Src_t>
+NSData *GLTFListIndexData(GLTF::PrimitiveTopology topology, const Src_t *src, size_t count, id owner,
+                          GLTFIndexConversionOptions options, GLTF::PrimitiveTopology *outTopology,
+                          size_t *outCount, size_t *outBytesPerIndex)
+{
+    // A single scan tells us both whether the data contains restarts and whether it can be narrowed.
+    const uint32_t maxIndex = GLTF::MaxIndexValue(src, count);
+    const bool hasRestart = (maxIndex == GLTF::RestartIndex<Src_t>());
+    const bool preserveTopology = (topology == GLTF::ListTopologyForTopology(topology)) ||
+                                  ((topology == GLTF::PrimitiveTopologyTriangleStrip) &&
+                                   (options & GLTFIndexConversionOptionPreserveTriangleStrips));
+    const bool convertTopology = !preserveTopology || hasRestart;
+    const bool narrow = (sizeof(Src_t) == sizeof(uint32_t)) && !hasRestart && (maxIndex < 0xFFFF) &&
+                        (options & GLTFIndexConversionOptionNarrowTo16Bit);
+    *outTopology = convertTopology ? GLTF::ListTopologyForTopology(topology) : topology;
+    if (sizeof(Src_t) < sizeof(uint32_t) || narrow) {
+        *outBytesPerIndex = sizeof(uint16_t);
+        return GLTFConvertedIndexData<Src_t, uint16_t>(topology, convertTopology, src, count, owner, outCount);
+    } else {
+        *outBytesPerIndex = sizeof(uint32_t);
+        return GLTFConvertedIndexData<Src_t, uint32_t>(topology, convertTopology, src, count, owner, outCount);
+    }
+}
+
+template <typename Index_t>
+NSData *GLTFSequentialListIndexData(GLTF::PrimitiveTopology topology, size_t vertexCount,
+                                    GLTFIndexConversionOptions options, GLTF::PrimitiveTopology *outTopology,
+                                    size_t *outCount, size_t *outBytesPerIndex)
+{
+    Index_t *sequentialIndices = GLTFAllocateIndices<Index_t>(vertexCount);
+    if (sequentialIndices == NULL) {
+        return nil;
+    }
+    GLTF::GenerateSequentialIndices(vertexCount, sequentialIndices);
+    NSData *sequentialData = [NSData dataWithBytesNoCopy:sequentialIndices
+                                                  length:vertexCount * sizeof(Index_t)
+                                            freeWhenDone:YES];
+    return GLTFListIndexData(topology, (const Index_t *)sequentialIndices, vertexCount, sequentialData, options,
+                             outTopology, outCount, outBytesPerIndex);
+}
+
+} // namespace
+
+NSData *GLTFIndexDataForPrimitive(GLTFPrimitive *primitive, GLTFIndexConversionOptions options,
+                                  GLTFPrimitiveType *outPrimitiveType, NSInteger *outIndexCount,
+                                  NSInteger *outBytesPerIndex)
+{
+    const GLTF::PrimitiveTopology topology = (GLTF::PrimitiveTopology)primitive.primitiveType;
+    if (topology == GLTF::PrimitiveTopologyInvalid || topology > GLTF::PrimitiveTopologyTriangleFan) {
+        GLTFLogError(@"[GLTFKit2] Encountered primitive with invalid type. Will not create index data.");
+        return nil;
+    }
+
+    NSData *indexData = nil;
+    GLTF::PrimitiveTopology resultTopology = topology;
+    size_t indexCount = 0;
+    size_t bytesPerIndex = 0;
+    if (primitive.indices != nil) {
+        NSData *storage = nil;
+        GLTF::AccessorView view = GLTFAccessorViewForAccessor(primitive.indices, &storage);
+        const size_t elementSize = view.elementSize();
+        if (!view.isValid() || view.componentCount != 1 ||
+            (view.componentType != GLTF::ComponentTypeUnsignedByte &&
+             view.componentType != GLTF::ComponentTypeUnsignedShort &&
+             view.componentType != GLTF::ComponentTypeUnsignedInt))
+        {
+            GLTFLogError(@"[GLTFKit2] Primitive indices must be unsigned integer scalars. Will not create index data.");
+            return nil;
+        }
+        id owner = storage ?: primitive.indices.bufferView.buffer.data;
+        if (view.stride != elementSize) {
+            // Index buffer views must not have a stride, but pack the indices if they do.
+            NSMutableData *packed = [NSMutableData dataWithLength:view.count * elementSize];
+            for (size_t i = 0; i < view.count; ++i) {
+                memcpy((uint8_t *)packed.mutableBytes + i * elementSize, view.element(i), elementSize);
+            }
+            owner = packed;
+            view.data = (const uint8_t *)packed.bytes;
+            view.stride = elementSize;
+        }
+        switch (view.componentType) {
+            case GLTF::ComponentTypeUnsignedByte:
+                indexData = GLTFListIndexData(topology, view.data, view.count, owner, options,
+                                              &resultTopology, &indexCount, &bytesPerIndex);
+                break;
+            case GLTF::ComponentTypeUnsignedShort:
+                indexData = GLTFListIndexData(topology, (const uint16_t *)view.data, view.count, owner, options,
+                                              &resultTopology, &indexCount, &bytesPerIndex);
+                break;
+            default:
+                indexData = GLTFListIndexData(topology, (const uint32_t *)view.data, view.count, owner, options,
+                                              &resultTopology, &indexCount, &bytesPerIndex);
+                break;
+        }
+    } else {
+        // If we're not indexed, our "index" count is our vertex count
+        GLTFAccessor *positionAccessor = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+        const size_t vertexCount = MAX(positionAccessor.count, 0);
+        if (vertexCount <= 0xFFFF) {
+            indexData = GLTFSequentialListIndexData<uint16_t>(topology, vertexCount, options,
+                                                              &resultTopology, &indexCount, &bytesPerIndex);
+        } else {
+            indexData = GLTFSequentialListIndexData<uint32_t>(topology, vertexCount, options,
+                                                              &resultTopology, &indexCount, &bytesPerIndex);
+        }
+    }
+
+    if (indexData == nil || indexCount == 0) {
+        return nil;
+    }
+    if (outPrimitiveType) {
+        *outPrimitiveType = (GLTFPrimitiveType)resultTopology;
+    }
+    if (outIndexCount) {
+        *outIndexCount = indexCount;
+    }
+    if (outBytesPerIndex) {
+        *outBytesPerIndex = bytesPerIndex;
+    }
+    return indexData;
+}
+
+static NSArray<NSNumber *> *GLTFNumberArrayFromValues(const double *values, int count) {
+    NSMutableArray<NSNumber *> *numbers = [NSMutableArray arrayWithCapacity:count];
+    for (int i = 0; i < count; ++i) {
+        [numbers addObject:@(values[i])];
+    }
+    return numbers;
+}
+
+BOOL GLTFAccessorComputeBounds(GLTFAccessor *accessor,
+                               NSArray<NSNumber *> **outMinValues,
+                               NSArray<NSNumber *> **outMaxValues)
+{
+    NSData *storage = nil;
+    const GLTF::AccessorView view = GLTFAccessorViewForAccessor(accessor, &storage);
+    double minValues[GLTF::MaxComponentCount], maxValues[GLTF::MaxComponentCount];
+    if (!GLTF::ComputeComponentBounds(view, minValues, maxValues)) {
+        return NO;
+    }
+    if (outMinValues) {
+        *outMinValues = GLTFNumberArrayFromValues(minValues, view.componentCount);
+    }
+    if (outMaxValues) {
+        *outMaxValues = GLTFNumberArrayFromValues(maxValues, view.componentCount);
+    }
+    return YES;
+}
+
+// Applies the glTF decoding equations for normalized integers to a bound of a normalized accessor.
+static float GLTFDecodedBoundValue(double value, GLTFComponentType componentType, BOOL normalized) {
+    if (!normalized) {
+        return (float)value;
+    }
+    switch (componentType) {
+        case GLTFComponentTypeByte:
+            return (float)MAX(value / 127.0, -1.0);
+        case GLTFComponentTypeUnsignedByte:
+            return (float)(value / 255.0);
+        case GLTFComponentTypeShort:
+            return (float)MAX(value / 32767.0, -1.0);
+        case GLTFComponentTypeUnsignedShort:
+            return (float)(value / 65535.0);
+        default:
+            return (float)value;
+    }
+}
+
+GLTFBoundingBox GLTFBoundingBoxForPrimitive(GLTFPrimitive *primitive) {
+    GLTFAccessor *positionAccessor = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+    if (positionAccessor.minValues.count < 3 || positionAccessor.maxValues.count < 3) {
+        return GLTFBoundingBoxEmpty;
+    }
+    GLTFBoundingBox box = GLTFBoundingBoxEmpty;
+    for (int i = 0; i < 3; ++i) {
+        box.minPoint[i] = GLTFDecodedBoundValue(positionAccessor.minValues[i].doubleValue,
+                                                positionAccessor.componentType, positionAccessor.isNormalized);
+        box.maxPoint[i] = GLTFDecodedBoundValue(positionAccessor.maxValues[i].doubleValue,
+                                                positionAccessor.componentType, positionAccessor.isNormalized);
+    }
+    return box;
+}
+
+BOOL GLTFValidatePrimitiveIndices(GLTFPrimitive *primitive, NSError **error) {
+    GLTFAccessor *indexAccessor = primitive.indices;
+    if (indexAccessor == nil || indexAccessor.count == 0 || primitive.attributes.count == 0) {
+        return YES;
+    }
+    NSInteger vertexCount = NSIntegerMax;
+    for (GLTFAttribute *attribute in primitive.attributes) {
+        vertexCount = MIN(vertexCount, attribute.accessor.count);
+    }
+    NSData *storage = nil;
+    const GLTF::AccessorView view = GLTFAccessorViewForAccessor(indexAccessor, &storage);
+    double minIndex = 0.0, maxIndex = 0.0;
+    if (view.componentCount != 1 || view.componentType == GLTF::ComponentTypeFloat ||
+        !GLTF::ComputeComponentBounds(view, &minIndex, &maxIndex))
+    {
+        if (error) {
+            *error = [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeInvalidGLTF userInfo:@{
+                NSLocalizedDescriptionKey : @"Primitive indices are not readable unsigned integer scalars"
+            }];
+        }
+        return NO;
+    }
+    if (maxIndex >= (double)vertexCount) {
+        if (error) {
+            NSString *description = [NSString stringWithFormat:@"Primitive index %.0f is out of range for %ld vertices",
+                                     maxIndex, (long)vertexCount];
+            *error = [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeInvalidGLTF userInfo:@{
+                NSLocalizedDescriptionKey : description
+            }];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+// Creates an accessor whose elements are the elements of `accessor` at `sourceIndices`, in the same format.
+static GLTFAccessor *GLTFGatheredAccessor(GLTFAccessor *accessor, const std::vector<uint32_t> &sourceIndices) {
+    NSData *sourceData = GLTFPackedDataForAccessor(accessor);
+    const size_t elementSize = GLTFBytesPerComponentForComponentType(accessor.componentType) *
+                               GLTFComponentCountForDimension(accessor.dimension);
+    NSMutableData *data = [NSMutableData dataWithLength:sourceIndices.size() * elementSize];
+    const uint8_t *src = (const uint8_t *)sourceData.bytes;
+    uint8_t *dst = (uint8_t *)data.mutableBytes;
+    for (size_t i = 0; i < sourceIndices.size(); ++i) {
+        memcpy(dst + i * elementSize, src + sourceIndices[i] * elementSize, elementSize);
+    }
+    GLTFAccessor *gathered = GLTFNewAccessorWithData(data, accessor.componentType, accessor.dimension,
+                                                     accessor.isNormalized, sourceIndices.size());
+    gathered.name = accessor.name;
+    if (accessor.minValues.count > 0 && accessor.maxValues.count > 0) {
+        NSArray<NSNumber *> *minValues = nil, *maxValues = nil;
+        if (GLTFAccessorComputeBounds(gathered, &minValues, &maxValues)) {
+            gathered.minValues = minValues;
+            gathered.maxValues = maxValues;
+        }
+    }
+    return gathered;
+}
+
+// The writable storage of the elements of `accessor`, if it is in `unsharedAccessors`, has `elementCount` elements,
+// and is backed by a buffer view whose data is all present; otherwise NULL.
+static uint8_t *GLTFUnsharedAccessorBytes(GLTFAccessor *accessor, size_t elementCount,
+                                          NSSet<GLTFAccessor *> *_Nullable unsharedAccessors)
+{
+    GLTFBufferView *bufferView = accessor.bufferView;
+    if (![unsharedAccessors containsObject:accessor] || accessor.sparse != nil || bufferView == nil ||
+        (size_t)accessor.count != elementCount || elementCount == 0)
+    {
+        return NULL;
+    }
+    const size_t elementSize = GLTFBytesPerComponentForComponentType(accessor.componentType) *
+                               GLTFComponentCountForDimension(accessor.dimension);
+    const size_t stride = bufferView.stride ?: elementSize;
+    NSMutableData *data = (NSMutableData *)bufferView.buffer.data;
+    const size_t requiredLength = bufferView.offset + accessor.offset + (elementCount - 1) * stride + elementSize;
+    if (elementSize == 0 || data == nil || requiredLength > data.length) {
+        return NULL;
+    }
+    return (uint8_t *)data.mutableBytes + bufferView.offset + accessor.offset;
+}
+
+// Rearranges the elements of `accessor` in its own storage so that element i becomes the old element
+// sourceIndices[i], if it is unshared and `sourceIndices` is a permutation of its elements. Returns NO otherwise.
+static BOOL GLTFPermuteAccessorInPlace(GLTFAccessor *accessor, const std::vector<uint32_t> &sourceIndices,
+                                       NSSet<GLTFAccessor *> *_Nullable unsharedAccessors)
+{
+    uint8_t *bytes = GLTFUnsharedAccessorBytes(accessor, sourceIndices.size(), unsharedAccessors);
+    if (bytes == NULL) {
+        return NO;
+    }
+    const size_t elementSize = GLTFBytesPerComponentForComponentType(accessor.componentType) *
+                               GLTFComponentCountForDimension(accessor.dimension);
+    const size_t stride = accessor.bufferView.stride ?: elementSize;
+    NSData *sourceData = GLTFPackedDataForAccessor(accessor);
+    const uint8_t *src = (const uint8_t *)sourceData.bytes;
+    for (size_t i = 0; i < sourceIndices.size(); ++i) {
+        memcpy(bytes + i * stride, src + sourceIndices[i] * elementSize, elementSize);
+    }
+    return YES;
+}
+
+// Overwrites the elements of the index accessor `accessor` with `indices`, if it is unshared, has as many elements,
+// and its component type can represent every index. Returns NO otherwise.
+static BOOL GLTFWriteIndicesInPlace(GLTFAccessor *accessor, const std::vector<uint32_t> &indices,
+                                    NSSet<GLTFAccessor *> *_Nullable unsharedAccessors)
+{
+    uint8_t *bytes = GLTFUnsharedAccessorBytes(accessor, indices.size(), unsharedAccessors);
+    const uint32_t maxIndex = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+    const GLTFComponentType componentType = accessor.componentType;
+    if (bytes == NULL || accessor.dimension != GLTFValueDimensionScalar ||
+        !((componentType == GLTFComponentTypeUnsignedByte && maxIndex <= UINT8_MAX) ||
+          (componentType == GLTFComponentTypeUnsignedShort && maxIndex <= UINT16_MAX) ||
+          componentType == GLTFComponentTypeUnsignedInt))
+    {
+        return NO;
+    }
+    const size_t indexSize = GLTFBytesPerComponentForComponentType(componentType);
+    const size_t stride = accessor.bufferView.stride ?: indexSize;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (componentType == GLTFComponentTypeUnsignedByte) {
+            bytes[i * stride] = (uint8_t)indices[i];
+        } else if (componentType == GLTFComponentTypeUnsignedShort) {
+            GLTF::StoreUnaligned<uint16_t>(bytes + i * stride, (uint16_t)indices[i]);
+        } else {
+            GLTF::StoreUnaligned<uint32_t>(bytes + i * stride, indices[i]);
+        }
+    }
+    if (accessor.minValues.count > 0 && accessor.maxValues.count > 0) {
+        NSArray<NSNumber *> *minValues = nil, *maxValues = nil;
+        if (GLTFAccessorComputeBounds(accessor, &minValues, &maxValues)) {
+            accessor.minValues = minValues;
+            accessor.maxValues = maxValues;
+        }
+    }
+    return YES;
+}
+
+// Copies each attribute to a new accessor whose vertex i is the old vertex sourceVertices[i], or rearranges it in
+// place if it is in `unsharedAccessors` and `sourceVertices` is a permutation.
+static NSArray<GLTFAttribute *> *GLTFGatheredAttributes(NSArray<GLTFAttribute *> *attributes,
+                                                       const std::vector<uint32_t> &sourceVertices,
+                                                       NSMutableArray<GLTFAccessor *> *newAccessors,
+                                                       NSSet<GLTFAccessor *> *_Nullable unsharedAccessors = nil)
+{
+    NSMutableArray<GLTFAttribute *> *gatheredAttributes = [NSMutableArray arrayWithCapacity:attributes.count];
+    for (GLTFAttribute *attribute in attributes) {
+        if (GLTFPermuteAccessorInPlace(attribute.accessor, sourceVertices, unsharedAccessors)) {
+            [gatheredAttributes addObject:attribute];
+            continue;
+        }
+        GLTFAccessor *accessor = GLTFGatheredAccessor(attribute.accessor, sourceVertices);
+        [gatheredAttributes addObject:[[GLTFAttribute alloc] initWithName:attribute.name accessor:accessor]];
+        [newAccessors addObject:accessor];
+    }
+    return gatheredAttributes;
+}
+
+// Rebuilds every attribute and morph target of `primitive` so that vertex i is a copy of vertex sourceVertices[i].
+// Accessors in `unsharedAccessors` are rearranged in place when `sourceVertices` is a permutation. Levels of detail
+// are rewritten to use the new vertices, through `newVertexForVertex` if it is given and otherwise through the first
+// copy of each vertex; meshlets are discarded.
+static void GLTFGatherPrimitiveVertices(GLTFPrimitive *primitive, const std::vector<uint32_t> &sourceVertices,
+                                        NSMutableArray<GLTFAccessor *> *newAccessors,
+                                        const std::vector<uint32_t> *newVertexForVertex = nullptr,
+                                        NSSet<GLTFAccessor *> *_Nullable unsharedAccessors = nil)
+{
+    const size_t oldVertexCount = primitive.attributes.firstObject.accessor.count;
+    primitive.attributes = GLTFGatheredAttributes(primitive.attributes, sourceVertices, newAccessors,
+                                                  unsharedAccessors);
+    NSMutableArray<GLTFMorphTarget *> *targets = [NSMutableArray arrayWithCapacity:primitive.targets.count];
+    for (GLTFMorphTarget *target in primitive.targets) {
+        [targets addObject:GLTFGatheredAttributes(target, sourceVertices, newAccessors, unsharedAccessors)];
+    }
+    primitive.targets = targets;
+    primitive.meshlets = nil;
+
+    if (primitive.levelOfDetailIndices.count > 0) {
+        std::vector<uint32_t> firstCopyOfVertex;
+        if (newVertexForVertex == nullptr) {
+            firstCopyOfVertex.assign(oldVertexCount, 0);
+            for (size_t i = sourceVertices.size(); i-- > 0; ) {
+                firstCopyOfVertex[sourceVertices[i]] = (uint32_t)i;
+            }
+            newVertexForVertex = &firstCopyOfVertex;
+        }
+        NSMutableArray<GLTFAccessor *> *levelOfDetailIndices = [NSMutableArray array];
+        for (GLTFAccessor *levelAccessor in primitive.levelOfDetailIndices) {
+            NSData *storage = nil;
+            const GLTF::AccessorView view = GLTFAccessorViewForAccessor(levelAccessor, &storage);
+            std::vector<uint32_t> levelIndices(view.count);
+            for (size_t i = 0; i < view.count; ++i) {
+                const uint32_t oldIndex = GLTF::ReadUInt(view, i);
+                levelIndices[i] = (oldIndex < newVertexForVertex->size()) ? (*newVertexForVertex)[oldIndex] : 0;
+            }
+            GLTFAccessor *remapped = GLTFNewIndexAccessor(levelIndices, sourceVertices.size());
+            [levelOfDetailIndices addObject:remapped];
+            [newAccessors addObject:remapped];
+        }
+        primitive.levelOfDetailIndices = levelOfDetailIndices;
+    }
+}
+
+// Appends copies of `splitSourceVertices` to every attribute and morph target of `primitive`, which has
+// `vertexCount` vertices, and replaces its indices with the triangle list `indices`. Does nothing if no vertices
+// were split.
+static void GLTFSplitPrimitiveVertices(GLTFPrimitive *primitive, size_t vertexCount,
+                                       const std::vector<uint32_t> &splitSourceVertices,
+                                       const std::vector<uint32_t> &indices,
+                                       NSMutableArray<GLTFAccessor *> *newAccessors)
+{
+    if (splitSourceVertices.empty()) {
+        return;
+    }
+    std::vector<uint32_t> sourceVertices(vertexCount);
+    std::iota(sourceVertices.begin(), sourceVertices.end(), 0u);
+    sourceVertices.insert(sourceVertices.end(), splitSourceVertices.begin(), splitSourceVertices.end());
+    GLTFGatherPrimitiveVertices(primitive, sourceVertices, newAccessors);
+    GLTFAccessor *indexAccessor = GLTFNewIndexAccessor(indices, sourceVertices.size());
+    primitive.indices = indexAccessor;
+    primitive.primitiveType = GLTFPrimitiveTypeTriangles;
+    [newAccessors addObject:indexAccessor];
+}
+
+static bool GLTFGenerateNormalsForPrimitive(GLTFPrimitive *primitive, float creaseAngle,
+                                            GLTF::GeneratedNormals &generated, size_t *outVertexCount)
+{
+    GLTFAccessor *positionAccessor = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+    std::vector<uint32_t> indices;
+    if (positionAccessor == nil || !GLTFTriangleListIndicesForPrimitive(primitive, indices)) {
+        return false;
+    }
+    NSData *storage = nil;
+    const GLTF::AccessorView positions = GLTFAccessorViewForAccessor(positionAccessor, &storage);
+    *outVertexCount = positions.count;
+    return GLTF::GenerateNormals(positions, indices.data(), indices.size(), creaseAngle, generated);
+}
+
+NSData *GLTFSmoothNormalDataForPrimitive(GLTFPrimitive *primitive) {
+    GLTF::GeneratedNormals generated;
+    size_t vertexCount = 0;
+    if (!GLTFGenerateNormalsForPrimitive(primitive, (float)M_PI, generated, &vertexCount)) {
+        return nil;
+    }
+    return [NSData dataWithBytes:generated.normals.data() length:generated.normals.size() * sizeof(float)];
+}
+
+NSArray<GLTFAccessor *> *GLTFPrimitiveGenerateNormals(GLTFPrimitive *primitive, float creaseAngle, NSError **error) {
+    if ([primitive attributeForName:GLTFAttributeSemanticNormal] != nil ||
+        [primitive attributeForName:GLTFAttributeSemanticPosition] == nil ||
+        (primitive.primitiveType != GLTFPrimitiveTypeTriangles &&
+         primitive.primitiveType != GLTFPrimitiveTypeTriangleStrip &&
+         primitive.primitiveType != GLTFPrimitiveTypeTriangleFan))
+    {
+        return @[];
+    }
+    GLTF::GeneratedNormals generated;
+    size_t vertexCount = 0;
+    if (!GLTFGenerateNormalsForPrimitive(primitive, creaseAngle, generated, &vertexCount)) {
+        if (error) {
+            *error = [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeInvalidGLTF userInfo:@{
+                NSLocalizedDescriptionKey : @"Could not generate normals for a primitive with invalid positions or indices"
+            }];
+        }
+        return nil;
+    }
+
+    NSMutableArray<GLTFAccessor *> *newAccessors = [NSMutableArray array];
+    GLTFSplitPrimitiveVertices(primitive, vertexCount, generated.splitSourceVertices, generated.indices, newAccessors);
+
+    NSData *normalData = [NSData dataWithBytes:generated.normals.data() length:generated.normals.size() * sizeof(float)];
+    GLTFAccessor *normalAccessor = GLTFNewAccessorWithData(normalData, GLTFComponentTypeFloat, GLTFValueDimensionVector3,
+                                                           NO, generated.normals.size() / 3);
+    GLTFAttribute *normalAttribute = [[GLTFAttribute alloc] initWithName:GLTFAttributeSemanticNormal
+                                                                accessor:normalAccessor];
+    primitive.attributes = [primitive.attributes arrayByAddingObject:normalAttribute];
+    [newAccessors addObject:normalAccessor];
+    return newAccessors;
+}
+
+NSArray<GLTFAccessor *> *GLTFPrimitiveGenerateTangents(GLTFPrimitive *primitive, NSError **error) {
+    GLTFTextureParams *normalTexture = primitive.material.normalTexture;
+    NSString *texCoordName = [NSString stringWithFormat:@"TEXCOORD_%d", (int)normalTexture.texCoord];
+    GLTFAccessor *positionAccessor = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+    GLTFAccessor *normalAccessor = [primitive attributeForName:GLTFAttributeSemanticNormal].accessor;
+    GLTFAccessor *texCoordAccessor = [primitive attributeForName:texCoordName].accessor;
+    std::vector<uint32_t> indices;
+    if (normalTexture == nil || [primitive attributeForName:GLTFAttributeSemanticTangent] != nil ||
+        positionAccessor == nil || normalAccessor == nil || texCoordAccessor == nil ||
+        !GLTFTriangleListIndicesForPrimitive(primitive, indices))
+    {
+        return @[];
+    }
+    NSData *positionStorage = nil, *normalStorage = nil, *texCoordStorage = nil;
+    const GLTF::AccessorView positions = GLTFAccessorViewForAccessor(positionAccessor, &positionStorage);
+    const GLTF::AccessorView normals = GLTFAccessorViewForAccessor(normalAccessor, &normalStorage);
+    const GLTF::AccessorView texCoords = GLTFAccessorViewForAccessor(texCoordAccessor, &texCoordStorage);
+    GLTF::GeneratedTangents generated;
+    if (!GLTF::GenerateTangents(positions, normals, texCoords, indices.data(), indices.size(), generated)) {
+        if (error) {
+            *error = [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeInvalidGLTF userInfo:@{
+                NSLocalizedDescriptionKey : @"Could not generate tangents for a primitive with invalid attributes or indices"
+            }];
+        }
+        return nil;
+    }
+
+    NSMutableArray<GLTFAccessor *> *newAccessors = [NSMutableArray array];
+    GLTFSplitPrimitiveVertices(primitive, positions.count, generated.splitSourceVertices, generated.indices, newAccessors);
+
+    NSData *tangentData = [NSData dataWithBytes:generated.tangents.data() length:generated.tangents.size() * sizeof(float)];
+    GLTFAccessor *tangentAccessor = GLTFNewAccessorWithData(tangentData, GLTFComponentTypeFloat, GLTFValueDimensionVector4,
+                                                            NO, generated.tangents.size() / 4);
+    GLTFAttribute *tangentAttribute = [[GLTFAttribute alloc] initWithName:GLTFAttributeSemanticTangent
+                                                                 accessor:tangentAccessor];
+    primitive.attributes = [primitive.attributes arrayByAddingObject:tangentAttribute];
+    [newAccessors addObject:tangentAccessor];
+    return newAccessors;
+}
+
+// Overdraw optimization may make the cache miss ratio this much worse
+static const float GLTFOverdrawCacheThreshold = 1.05f;
+
+static GLTFVertexCacheStatistics GLTFVertexCacheStatisticsForIndices(const std::vector<uint32_t> &indices,
+                                                                     size_t vertexCount)
+{
+    const GLTF::VertexCacheStatistics statistics = GLTF::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+    return (GLTFVertexCacheStatistics){ statistics.acmr, statistics.atvr };
+}
+
+NSArray<GLTFAccessor *> *GLTFPrimitiveOptimizeVertexOrder(GLTFPrimitive *primitive,
+                                                          GLTFMeshOptimizationOptions options,
+                                                          GLTFMeshOptimizationStatistics *outStatistics,
+                                                          NSError **error)
+{
+    return GLTFPrimitiveOptimizeVertexOrderInPlace(primitive, options, nil, outStatistics, error);
+}
+
+NSArray<GLTFAccessor *> *GLTFPrimitiveOptimizeVertexOrderInPlace(GLTFPrimitive *primitive,
+                                                                 GLTFMeshOptimizationOptions options,
+                                                                 NSSet<GLTFAccessor *> *unsharedAccessors,
+                                                                 GLTFMeshOptimizationStatistics *outStatistics,
+                                                                 NSError **error)
+{
+    if (outStatistics) {
+        *outStatistics = (GLTFMeshOptimizationStatistics){};
+    }
+    GLTFAccessor *positionAccessor = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+    if (primitive.primitiveType != GLTFPrimitiveTypeTriangles || primitive.indices == nil || positionAccessor == nil) {
+        return @[];
+    }
+    if (!GLTFValidatePrimitiveIndices(primitive, error)) {
+        return nil;
+    }
+    std::vector<uint32_t> indices;
+    if (!GLTFTriangleListIndicesForPrimitive(primitive, indices)) {
+        return @[];
+    }
+    const size_t vertexCount = positionAccessor.count;
+    const GLTFVertexCacheStatistics before = GLTFVertexCacheStatisticsForIndices(indices, vertexCount);
+
+    if (options & (GLTFMeshOptimizationOptionVertexCache | GLTFMeshOptimizationOptionOverdraw)) {
+        std::vector<size_t> clusterStarts;
+        GLTF::OptimizeVertexCache(indices.data(), indices.size(), vertexCount, &clusterStarts);
+        if (options & GLTFMeshOptimizationOptionOverdraw) {
+            NSData *storage = nil;
+            const GLTF::AccessorView positions = GLTFAccessorViewForAccessor(positionAccessor, &storage);
+            if (positions.isValid() && positions.componentCount >= 3) {
+                GLTF::OptimizeOverdraw(indices.data(), indices.size(), positions, clusterStarts,
+                                       GLTFOverdrawCacheThreshold);
+            }
+        }
+    }
+    NSMutableArray<GLTFAccessor *> *newAccessors = [NSMutableArray array];
+    if (options & GLTFMeshOptimizationOptionVertexFetch) {
+        const std::vector<uint32_t> sourceVertices = GLTF::OptimizeVertexFetch(indices.data(), indices.size(), vertexCount);
+        GLTFGatherPrimitiveVertices(primitive, sourceVertices, newAccessors, nullptr, unsharedAccessors);
+    }
+    if (!GLTFWriteIndicesInPlace(primitive.indices, indices, unsharedAccessors)) {
+        GLTFAccessor *indexAccessor = GLTFNewIndexAccessor(indices, vertexCount);
+        primitive.indices = indexAccessor;
+        [newAccessors addObject:indexAccessor];
+    }
+
+    if (outStatistics) {
+        outStatistics->before = before;
+        outStatistics->after = GLTFVertexCacheStatisticsForIndices(indices, vertexCount);
+    }
+    return newAccessors;
+}
+
+NSArray<GLTFAccessor *> *GLTFPrimitiveGenerateLevelsOfDetail(GLTFPrimitive *primitive, NSInteger levelCount,
+                                                             float targetError, NSError **error)
+{
+    GLTFAccessor *positionAccessor = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+    std::vector<uint32_t> indices;
+    if (levelCount <= 0 || positionAccessor == nil || !GLTFTriangleListIndicesForPrimitive(primitive, indices)) {
+        return @[];
+    }
+    if (!GLTFValidatePrimitiveIndices(primitive, error)) {
+        return nil;
+    }
+    GLTFAccessor *normalAccessor = [primitive attributeForName:GLTFAttributeSemanticNormal].accessor;
+    GLTFAccessor *texCoordAccessor = [primitive attributeForName:GLTFAttributeSemanticTexcoord0].accessor;
+    NSData *positionStorage = nil, *normalStorage = nil, *texCoordStorage = nil;
+    const GLTF::AccessorView positions = GLTFAccessorViewForAccessor(positionAccessor, &positionStorage);
+    const GLTF::AccessorView normals = GLTFAccessorViewForAccessor(normalAccessor, &normalStorage);
+    const GLTF::AccessorView texCoords = GLTFAccessorViewForAccessor(texCoordAccessor, &texCoordStorage);
+
+    std::vector<size_t> targetIndexCounts;
+    size_t triangleCount = indices.size() / 3;
+    for (NSInteger level = 0; level < levelCount; ++level) {
+        triangleCount /= 2;
+        targetIndexCounts.push_back(3 * triangleCount);
+    }
+    std::vector<GLTF::SimplifiedLevel> levels = GLTF::SimplifyToLevels(positions, normals, texCoords, indices.data(),
+                                                                       indices.size(), targetIndexCounts, targetError);
+
+    NSMutableArray<GLTFAccessor *> *newAccessors = [NSMutableArray arrayWithCapacity:levels.size()];
+    NSMutableArray<NSNumber *> *errors = [NSMutableArray arrayWithCapacity:levels.size()];
+    for (GLTF::SimplifiedLevel &level : levels) {
+        GLTF::OptimizeVertexCache(level.indices.data(), level.indices.size(), positions.count);
+        [newAccessors addObject:GLTFNewIndexAccessor(level.indices, positions.count)];
+        [errors addObject:@(level.error)];
+    }
+    primitive.levelOfDetailIndices = newAccessors;
+    primitive.levelOfDetailErrors = errors;
+    return newAccessors;
+}
+
+GLTFMeshletSet *GLTFMeshletSetForPrimitive(GLTFPrimitive *primitive, NSInteger maxVertexCount,
+                                           NSInteger maxTriangleCount, NSError **error)
+{
+    if (maxVertexCount < 3 || maxVertexCount > (NSInteger)GLTF::MaxMeshletVertexCount ||
+        maxTriangleCount < 1 || maxTriangleCount > (NSInteger)GLTF::MaxMeshletTriangleCount)
+    {
+        if (error) {
+            *error = GLTFMeshProcessingError([NSString stringWithFormat:@"Meshlet limits of %ld vertices and %ld triangles are out of range",
+                                              (long)maxVertexCount, (long)maxTriangleCount]);
+        }
+        return nil;
+    }
+    GLTFAccessor *positionAccessor = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+    std::vector<uint32_t> indices;
+    if (positionAccessor == nil || !GLTFTriangleListIndicesForPrimitive(primitive, indices)) {
+        if (error) {
+            *error = GLTFMeshProcessingError(@"Meshlets can only be built for triangle primitives with positions");
+        }
+        return nil;
+    }
+    NSData *storage = nil;
+    const GLTF::AccessorView positions = GLTFAccessorViewForAccessor(positionAccessor, &storage);
+    GLTF::MeshletSet meshlets;
+    if (!GLTF::BuildMeshlets(positions, indices.data(), indices.size(), maxVertexCount, maxTriangleCount, meshlets)) {
+        if (error) {
+            *error = [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeInvalidGLTF userInfo:@{
+                NSLocalizedDescriptionKey : @"Could not build meshlets for a primitive with invalid positions or indices"
+            }];
+        }
+        return nil;
+    }
+    NSData *meshletData = [NSData dataWithBytes:meshlets.meshlets.data()
+                                         length:meshlets.meshlets.size() * sizeof(GLTFMeshlet)];
+    NSData *vertexIndexData = [NSData dataWithBytes:meshlets.vertices.data()
+                                             length:meshlets.vertices.size() * sizeof(uint32_t)];
+    NSData *triangleData = [NSData dataWithBytes:meshlets.triangles.data() length:meshlets.triangles.size()];
+    NSData *boundsData = [NSData dataWithBytes:meshlets.bounds.data()
+                                        length:meshlets.bounds.size() * sizeof(GLTFMeshletBounds)];
+    return [[GLTFMeshletSet alloc] initWithMeshletData:meshletData
+                                       vertexIndexData:vertexIndexData
+                                          triangleData:triangleData
+                                            boundsData:boundsData
+                                        maxVertexCount:maxVertexCount
+                                      maxTriangleCount:maxTriangleCount];
+}
+
+NSArray<GLTFAccessor *> *GLTFPrimitiveWeldVertices(GLTFPrimitive *primitive, float epsilon, NSError **error) {
+    const NSInteger vertexCount = primitive.attributes.firstObject.accessor.count;
+    if (vertexCount == 0) {
+        return @[];
+    }
+    if (!GLTFValidatePrimitiveIndices(primitive, error)) {
+        return nil;
+    }
+
+    // Every attribute and morph target takes part in the comparison
+    NSMutableArray<GLTFAccessor *> *accessors = [NSMutableArray array];
+    for (GLTFAttribute *attribute in primitive.attributes) {
+        [accessors addObject:attribute.accessor];
+    }
+    for (GLTFMorphTarget *target in primitive.targets) {
+        for (GLTFAttribute *attribute in target) {
+            [accessors addObject:attribute.accessor];
+        }
+    }
+    NSMutableArray<NSData *> *storage = [NSMutableArray arrayWithCapacity:accessors.count];
+    std::vector<GLTF::AccessorView> streams;
+    for (GLTFAccessor *accessor in accessors) {
+        NSData *accessorStorage = nil;
+        streams.push_back(GLTFAccessorViewForAccessor(accessor, &accessorStorage));
+        if (accessorStorage) {
+            [storage addObject:accessorStorage];
+        }
+    }
+
+    std::vector<uint32_t> indices;
+    if (primitive.indices) {
+        NSData *indexStorage = nil;
+        const GLTF::AccessorView indexView = GLTFAccessorViewForAccessor(primitive.indices, &indexStorage);
+        indices.resize(indexView.count);
+        for (size_t i = 0; i < indexView.count; ++i) {
+            indices[i] = GLTF::ReadUInt(indexView, i);
+        }
+    }
+    std::vector<uint32_t> sourceVertices, weldedIndices;
+    if (!GLTF::WeldVertices(streams, vertexCount, primitive.indices ? indices.data() : nullptr, indices.size(),
+                            epsilon, sourceVertices, weldedIndices))
+    {
+        if (error) {
+            *error = [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeInvalidGLTF userInfo:@{
+                NSLocalizedDescriptionKey : @"Could not weld a primitive whose attributes differ in length or are unreadable"
+            }];
+        }
+        return nil;
+    }
+    if (sourceVertices.size() == (size_t)vertexCount) {
+        return @[];
+    }
+
+    // Vertices that were welded away take the index of the vertex that replaced them
+    std::vector<uint32_t> newVertexForVertex(vertexCount, 0);
+    for (size_t i = 0; i < sourceVertices.size(); ++i) {
+        newVertexForVertex[sourceVertices[i]] = (uint32_t)i;
+    }
+    const uint32_t *originalIndices = primitive.indices ? indices.data() : nullptr;
+    for (size_t i = 0; i < weldedIndices.size(); ++i) {
+        newVertexForVertex[originalIndices ? originalIndices[i] : i] = weldedIndices[i];
+    }
+
+    NSMutableArray<GLTFAccessor *> *newAccessors = [NSMutableArray array];
+    GLTFGatherPrimitiveVertices(primitive, sourceVertices, newAccessors, &newVertexForVertex);
+    GLTFAccessor *indexAccessor = GLTFNewIndexAccessor(weldedIndices, sourceVertices.size());
+    primitive.indices = indexAccessor;
+    [newAccessors addObject:indexAccessor];
+    return newAccessors;
+}
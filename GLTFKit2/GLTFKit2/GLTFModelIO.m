@@ -308,13 +308,23 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
         return [NSData data];
     }
     NSUInteger elementCount = data.length / sizeof(float);
-    for (int i = 0; i < elementCount; i += 2) {
+    for (NSUInteger i = 0; i < elementCount; i += 2) {
         flippedUVs[i + 0] = uvs[i + 0];
         flippedUVs[i + 1] = 1.0f - uvs[i + 1];
     }
     return [NSData dataWithBytesNoCopy:flippedUVs length:data.length freeWhenDone:YES];
 }
 
+// Returns the entry for `object` in `sideTable`, which parallels `objects`, one of the arrays of its asset. Returns
+// nil if `object` is not among them, or if its entry is NSNull.
+static id GLTFMDLSideTableEntryForObject(NSArray *sideTable, GLTFObject *object, NSArray<GLTFObject *> *objects) {
+    NSInteger index = GLTFIndexOfObjectInArray(object, objects);
+    if (index == NSNotFound || sideTable[index] == [NSNull null]) {
+        return nil;
+    }
+    return sideTable[index];
+}
+
 @implementation MDLAsset (GLTFKit2)
 
 + (instancetype)assetWithGLTFAsset:(GLTFAsset *)asset {
@@ -327,7 +337,8 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
         bufferAllocator = [MDLMeshBufferDataAllocator new];
     }
 
-    NSMutableDictionary<NSUUID *, MDLTexture *> *texturesForImageIdenfiers = [NSMutableDictionary dictionary];
+    // Each of these arrays parallels one of the asset's, and is indexed by object index
+    NSMutableArray *texturesForImages = [NSMutableArray arrayWithCapacity:asset.images.count]; // NSNull if not loaded
     for (GLTFImage *image in asset.images) {
         MDLTexture *mdlTexture = nil;
         if (image.uri) {
@@ -348,10 +359,10 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
                                                    isCube:NO];
             CFRelease(cgImage);
         }
-        texturesForImageIdenfiers[image.identifier] = mdlTexture;
+        [texturesForImages addObject:mdlTexture ?: [NSNull null]];
     }
     
-    NSMutableDictionary <NSUUID *, MDLTextureFilter *> *filtersForSamplerIdentifiers = [NSMutableDictionary dictionary];
+    NSMutableArray<MDLTextureFilter *> *filtersForSamplers = [NSMutableArray arrayWithCapacity:asset.samplers.count];
     for (GLTFTextureSampler *sampler in asset.samplers) {
         MDLTextureFilter *filter = [MDLTextureFilter new];
         filter.magFilter = GLTFMDLTextureFilterModeForMagFilter(sampler.magFilter);
@@ -365,22 +376,22 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
         filter.sWrapMode = GLTFMDLTextureWrapModeForMode(sampler.wrapS);
         filter.tWrapMode = GLTFMDLTextureWrapModeForMode(sampler.wrapT);
         
-        filtersForSamplerIdentifiers[sampler.identifier] = filter;
+        [filtersForSamplers addObject:filter];
     }
 
-    NSMutableDictionary <NSUUID *, MDLTextureSampler *> *textureSamplersForTextureIdentifiers = [NSMutableDictionary dictionary];
+    NSMutableArray<MDLTextureSampler *> *samplersForTextures = [NSMutableArray arrayWithCapacity:asset.textures.count];
     for (GLTFTexture *texture in asset.textures) {
         MDLTextureSampler *mdlSampler = [MDLTextureSampler new];
-        mdlSampler.texture = texturesForImageIdenfiers[texture.source.identifier];
-        mdlSampler.hardwareFilter = filtersForSamplerIdentifiers[texture.sampler.identifier];
-        textureSamplersForTextureIdentifiers[texture.identifier] = mdlSampler;
+        mdlSampler.texture = GLTFMDLSideTableEntryForObject(texturesForImages, texture.source, asset.images);
+        mdlSampler.hardwareFilter = GLTFMDLSideTableEntryForObject(filtersForSamplers, texture.sampler, asset.samplers);
+        [samplersForTextures addObject:mdlSampler];
     }
 
-    NSMutableDictionary <NSUUID *, MDLMaterial *> *materialsForIdentifiers = [NSMutableDictionary dictionary];
+    NSMutableArray<MDLMaterial *> *materialsForMaterials = [NSMutableArray arrayWithCapacity:asset.materials.count];
     for (GLTFMaterial *material in asset.materials) {
         MDLPhysicallyPlausibleScatteringFunction *func = [MDLPhysicallyPlausibleScatteringFunction new];
         if (material.metallicRoughness.baseColorTexture) {
-            MDLTextureSampler *baseColorSampler = [textureSamplersForTextureIdentifiers[material.metallicRoughness.baseColorTexture.texture.identifier] GLTF_copy];
+            MDLTextureSampler *baseColorSampler = [GLTFMDLSideTableEntryForObject(samplersForTextures, material.metallicRoughness.baseColorTexture.texture, asset.textures) GLTF_copy];
             if (material.metallicRoughness.baseColorTexture.transform) {
                 baseColorSampler.transform = [[MDLTransform alloc] initWithMatrix:material.metallicRoughness.baseColorTexture.transform.matrix];
             }
@@ -390,7 +401,7 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
             func.baseColor.float4Value = material.metallicRoughness.baseColorFactor;
         }
         if (material.metallicRoughness.metallicRoughnessTexture) {
-            MDLTextureSampler *metallicRoughnessSampler = [textureSamplersForTextureIdentifiers[material.metallicRoughness.metallicRoughnessTexture.texture.identifier] GLTF_copy];
+            MDLTextureSampler *metallicRoughnessSampler = [GLTFMDLSideTableEntryForObject(samplersForTextures, material.metallicRoughness.metallicRoughnessTexture.texture, asset.textures) GLTF_copy];
             if (material.metallicRoughness.metallicRoughnessTexture.transform) {
                 metallicRoughnessSampler.transform = [[MDLTransform alloc] initWithMatrix:material.metallicRoughness.metallicRoughnessTexture.transform.matrix];
             }
@@ -413,7 +424,7 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
             func.roughness.floatValue = material.metallicRoughness.roughnessFactor;
         }
         if (material.normalTexture) {
-            MDLTextureSampler *normalSampler = [textureSamplersForTextureIdentifiers[material.normalTexture.texture.identifier] GLTF_copy];
+            MDLTextureSampler *normalSampler = [GLTFMDLSideTableEntryForObject(samplersForTextures, material.normalTexture.texture, asset.textures) GLTF_copy];
             if (material.normalTexture.transform) {
                 normalSampler.transform = [[MDLTransform alloc] initWithMatrix:material.normalTexture.transform.matrix];
             }
@@ -421,7 +432,7 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
             func.normal.textureSamplerValue = normalSampler;
         }
         if (material.emissive.emissiveTexture) {
-            MDLTextureSampler *emissiveSampler = [textureSamplersForTextureIdentifiers[material.emissive.emissiveTexture.texture.identifier] GLTF_copy];
+            MDLTextureSampler *emissiveSampler = [GLTFMDLSideTableEntryForObject(samplersForTextures, material.emissive.emissiveTexture.texture, asset.textures) GLTF_copy];
             if (material.emissive.emissiveTexture.transform) {
                 emissiveSampler.transform = [[MDLTransform alloc] initWithMatrix:material.emissive.emissiveTexture.transform.matrix];
             }
@@ -436,10 +447,10 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
 
         MDLMaterial *mdlMaterial = [[MDLMaterial alloc] initWithName:material.name scatteringFunction:func];
         mdlMaterial.materialFace = material.isDoubleSided ? MDLMaterialFaceDoubleSided : MDLMaterialFaceFront;
-        materialsForIdentifiers[material.identifier] = mdlMaterial;
+        [materialsForMaterials addObject:mdlMaterial];
     }
 
-    NSMutableDictionary <NSUUID *, NSArray<MDLMesh *> *> *meshArraysForIdentifiers = [NSMutableDictionary dictionary];
+    NSMutableArray<NSArray<MDLMesh *> *> *meshArraysForMeshes = [NSMutableArray arrayWithCapacity:asset.meshes.count];
     for (GLTFMesh *mesh in asset.meshes) {
         NSMutableArray<MDLMesh *> *mdlMeshes = [NSMutableArray array];
         for (GLTFPrimitive *primitive in mesh.primitives) {
@@ -452,7 +463,8 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
             assert(indexBufferView.stride == 0 || indexBufferView.stride == indexSize);
             NSData *indexData = GLTFPackedDataForAccessor(indexAccessor);
             id<MDLMeshBuffer> mdlIndexBuffer = [bufferAllocator newBufferWithData:indexData type:MDLMeshBufferTypeIndex];
-            MDLMaterial *material = materialsForIdentifiers[primitive.material.identifier];
+            MDLMaterial *material = GLTFMDLSideTableEntryForObject(materialsForMaterials, primitive.material,
+                                                                   asset.materials);
             MDLSubmesh *submesh = [[MDLSubmesh alloc] initWithName:primitive.name
                                                        indexBuffer:mdlIndexBuffer
                                                         indexCount:primitive.indices.count
@@ -462,7 +474,7 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
             
             MDLVertexDescriptor *vertexDescriptor = [MDLVertexDescriptor new];
             int attrIndex = 0;
-            int vertexCount = 0;
+            NSUInteger vertexCount = 0;
             NSMutableArray *vertexBuffers = [NSMutableArray arrayWithCapacity:primitive.attributes.count];
             for (GLTFAttribute *attribute in primitive.attributes) {
                 GLTFAccessor *attrAccessor = attribute.accessor;
@@ -475,7 +487,7 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
                 }
                 id<MDLMeshBuffer> vertexBuffer = [bufferAllocator newBufferWithData:attrData type:MDLMeshBufferTypeVertex];
                 [vertexBuffers addObject:vertexBuffer];
-                vertexCount = (int)attrAccessor.count;
+                vertexCount = attrAccessor.count;
                 vertexDescriptor.attributes[attrIndex].bufferIndex = attrIndex;
                 vertexDescriptor.attributes[attrIndex].format = mdlFormat;
                 vertexDescriptor.attributes[attrIndex].name = GLTFMDLVertexAttributeNameForSemantic(attribute.name);
@@ -491,10 +503,10 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
             mdlMesh.name = mesh.name;
             [mdlMeshes addObject:mdlMesh];
         }
-        meshArraysForIdentifiers[mesh.identifier] = mdlMeshes;
+        [meshArraysForMeshes addObject:mdlMeshes];
     }
     
-    NSMutableDictionary<NSUUID *, MDLCamera *> *camerasForIdentifiers = [NSMutableDictionary dictionary];
+    NSMutableArray<MDLCamera *> *camerasForCameras = [NSMutableArray arrayWithCapacity:asset.cameras.count];
     for (GLTFCamera *camera in asset.cameras) {
         MDLCamera *mdlCamera = [MDLCamera new];
         mdlCamera.name = camera.name;
@@ -510,13 +522,13 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
             }
             mdlCamera.fieldOfView = camera.perspective.yFOV;
         }
-        camerasForIdentifiers[camera.identifier] = mdlCamera;
+        [camerasForCameras addObject:mdlCamera];
     }
     
     // Light -> MDLLight
     CGColorSpaceRef colorSpaceLinearSRGB = CGColorSpaceCreateWithName(kCGColorSpaceLinearSRGB);
 
-    NSMutableDictionary<NSUUID *, MDLPhysicallyPlausibleLight *> *lightsForIdentifiers = [NSMutableDictionary dictionary];
+    NSMutableArray<MDLPhysicallyPlausibleLight *> *lightsForLights = [NSMutableArray arrayWithCapacity:asset.lights.count];
     for (GLTFLight *light in asset.lights) {
         MDLPhysicallyPlausibleLight *mdlLight = [MDLPhysicallyPlausibleLight new];
         mdlLight.name = light.name;
@@ -539,11 +551,11 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
                 break;
         }
         // TODO: Range and attenuation.
-        lightsForIdentifiers[light.identifier] = mdlLight;
+        [lightsForLights addObject:mdlLight];
     }
     
     // Node -> MDLObject
-    NSMutableDictionary<NSUUID *, MDLObject *> *nodesForIdentifiers = [NSMutableDictionary dictionary];
+    NSMutableArray<MDLObject *> *objectsForNodes = [NSMutableArray arrayWithCapacity:asset.nodes.count];
     for (GLTFNode *node in asset.nodes) {
         // We'd prefer to use MDLObject rather than MDLMesh for container nodes, but
         // Model I/O's USD exporter currently exports MDLObject as a Scope instead of
@@ -553,7 +565,7 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
         mdlNode.name = node.name;
         mdlNode.transform = [[MDLTransform alloc] initWithMatrix:node.matrix];
         if (node.mesh) {
-            NSArray<MDLMesh *> *meshes = meshArraysForIdentifiers[node.mesh.identifier];
+            NSArray<MDLMesh *> *meshes = GLTFMDLSideTableEntryForObject(meshArraysForMeshes, node.mesh, asset.meshes);
             for (MDLMesh *mdlMesh in meshes) {
                 // We would prefer not to copy here, but since each MDLObject can only have
                 // one parent, we have to do this to ensure every mesh instance is represented
@@ -561,22 +573,28 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
             }
         }
         if (node.light) {
-            MDLLight *light = lightsForIdentifiers[node.light.identifier];
-            [mdlNode addChild:light];
+            MDLLight *light = GLTFMDLSideTableEntryForObject(lightsForLights, node.light, asset.lights);
+            if (light) {
+                [mdlNode addChild:light];
+            }
         }
         if (node.camera) {
-            MDLCamera *camera = camerasForIdentifiers[node.camera.identifier];
-            [mdlNode addChild:camera];
+            MDLCamera *camera = GLTFMDLSideTableEntryForObject(camerasForCameras, node.camera, asset.cameras);
+            if (camera) {
+                [mdlNode addChild:camera];
+            }
         }
-        nodesForIdentifiers[node.identifier] = mdlNode;
+        [objectsForNodes addObject:mdlNode];
     }
 
     for (GLTFNode *node in asset.nodes) {
         if (node.childNodes.count > 0) {
-            MDLObject *mdlParent = nodesForIdentifiers[node.identifier];
+            MDLObject *mdlParent = objectsForNodes[GLTFIndexOfObjectInArray(node, asset.nodes)];
             for (GLTFNode *child in node.childNodes) {
-                MDLObject *mdlChild = nodesForIdentifiers[child.identifier];
-                [mdlParent addChild:mdlChild];
+                MDLObject *mdlChild = GLTFMDLSideTableEntryForObject(objectsForNodes, child, asset.nodes);
+                if (mdlChild) {
+                    [mdlParent addChild:mdlChild];
+                }
             }
         }
     }
@@ -590,8 +608,10 @@ static NSData *GLTFPackedFloat2DataFlipVertical(NSData *data) {
     GLTFScene *defaultScene = asset.defaultScene ?: asset.scenes.firstObject;
 
     for (GLTFNode *node in defaultScene.nodes) {
-        MDLObject *mdlNode = nodesForIdentifiers[node.identifier];
-        [mdlAsset addObject:mdlNode];
+        MDLObject *mdlNode = GLTFMDLSideTableEntryForObject(objectsForNodes, node, asset.nodes);
+        if (mdlNode) {
+            [mdlAsset addObject:mdlNode];
+        }
     }
 
     return mdlAsset;
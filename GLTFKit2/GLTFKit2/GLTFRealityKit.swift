@@ -379,8 +379,10 @@ class GLTFRealityKitResourceContext {
 
     let device: MTLDevice
     let commandQueue: MTLCommandQueue
-    private var cgImagesForImageIdentifiers = [UUID : CGImage]()
-    private var textureResourcesForImageIdentifiers = [UUID : [(RealityKit.TextureResource, ColorMask)]]()
+    // Keyed by identity rather than handle, since images not held by an asset all have the zero handle. The asset
+    // keeps its images alive for as long as the context is in use, so identifiers are not reused.
+    private var cgImagesForImages = [ObjectIdentifier : CGImage]()
+    private var textureResourcesForImages = [ObjectIdentifier : [(RealityKit.TextureResource, ColorMask)]]()
 
     var defaultMaterial: any Material {
         return RealityKit.SimpleMaterial(color: .init(white: 0.5, alpha: 1.0), isMetallic: false)
@@ -410,7 +412,8 @@ class GLTFRealityKitResourceContext {
     @MainActor func textureResource(for gltfImage: GLTFImage, channels: ColorMask,
                                     semantic: RealityKit.TextureResource.Semantic) -> RealityKit.TextureResource?
     {
-        let existingResources = textureResourcesForImageIdentifiers[gltfImage.identifier]
+        let imageKey = ObjectIdentifier(gltfImage)
+        let existingResources = textureResourcesForImages[imageKey]
         if let existingMatch = existingResources?.first(where: { $0.1 == channels })?.0 {
             return existingMatch
         }
@@ -440,10 +443,10 @@ class GLTFRealityKitResourceContext {
                         commandBuffer.commit()
                     }
                     let resource = try TextureResource(from: lowLevelTexture)
-                    if textureResourcesForImageIdentifiers[gltfImage.identifier] != nil {
-                        textureResourcesForImageIdentifiers[gltfImage.identifier]!.append((resource, channels))
+                    if textureResourcesForImages[imageKey] != nil {
+                        textureResourcesForImages[imageKey]!.append((resource, channels))
                     } else {
-                        textureResourcesForImageIdentifiers[gltfImage.identifier] = [(resource, channels)]
+                        textureResourcesForImages[imageKey] = [(resource, channels)]
                     }
                     return resource
                 } catch {
@@ -454,7 +457,7 @@ class GLTFRealityKitResourceContext {
         }
         #endif
 
-        var cgImage = cgImagesForImageIdentifiers[gltfImage.identifier]
+        var cgImage = cgImagesForImages[imageKey]
         if cgImage == nil {
             cgImage = gltfImage.newCGImage()?.takeRetainedValue()
             if cgImage != nil {
@@ -463,7 +466,7 @@ class GLTFRealityKitResourceContext {
                 // so we "pre-decode" here into a known-good image layout.
                 cgImage = decodeCGImage(cgImage!)
                 #endif
-                cgImagesForImageIdentifiers[gltfImage.identifier] = cgImage
+                cgImagesForImages[imageKey] = cgImage
             }
         }
         guard let originalImage = cgImage else { return nil }
@@ -473,10 +476,10 @@ class GLTFRealityKitResourceContext {
 
         let options = TextureResource.CreateOptions(semantic: semantic)
         guard let resource = try? TextureResource.generate(from: sourceImage, options: options) else { return nil }
-        if textureResourcesForImageIdentifiers[gltfImage.identifier] != nil {
-            textureResourcesForImageIdentifiers[gltfImage.identifier]!.append((resource, channels))
+        if textureResourcesForImages[imageKey] != nil {
+            textureResourcesForImages[imageKey]!.append((resource, channels))
         } else {
-            textureResourcesForImageIdentifiers[gltfImage.identifier] = [(resource, channels)]
+            textureResourcesForImages[imageKey] = [(resource, channels)]
         }
 
         return resource
@@ -691,9 +694,14 @@ public class GLTFRealityKitLoader {
         let skeletonName = gltfSkin.name ?? nameGenerator.nextUniqueName(prefix: "Skin")
         let jointNames = gltfSkin.joints.compactMap { return $0.name }
 
+        // Keyed by identity, since nodes outside the asset's array all have the index NSNotFound
+        var jointIndicesForNodes = [ObjectIdentifier: Int]()
+        for (jointIndex, jointNode) in gltfSkin.joints.enumerated() where jointIndicesForNodes[ObjectIdentifier(jointNode)] == nil {
+            jointIndicesForNodes[ObjectIdentifier(jointNode)] = jointIndex
+        }
         let jointParents = gltfSkin.joints.map { skeletonNode in
             if let parent = skeletonNode.parent {
-                return gltfSkin.joints.firstIndex(of: parent)
+                return jointIndicesForNodes[ObjectIdentifier(parent)]
             } else {
                 return nil
             }
@@ -960,12 +968,14 @@ public class GLTFRealityKitLoader {
     }
 
     func convert(animation: GLTFAnimation) throws -> AnimationResource {
-        let groupedChannels = animation.channels.reduce(into: [UUID : [GLTFAnimationChannel]]()) { partialResult, channel in
-            guard let targetIdentifier = channel.target.node?.identifier else { return }
-            if let _ = partialResult[targetIdentifier] {
-                partialResult[targetIdentifier]! += [channel]
+        // Grouped by node identity, since nodes not held by an asset all have the zero handle
+        let groupedChannels = animation.channels.reduce(into: [ObjectIdentifier : [GLTFAnimationChannel]]()) { partialResult, channel in
+            guard let targetNode = channel.target.node else { return }
+            let targetKey = ObjectIdentifier(targetNode)
+            if let _ = partialResult[targetKey] {
+                partialResult[targetKey]! += [channel]
             } else {
-                partialResult[targetIdentifier] = [channel]
+                partialResult[targetKey] = [channel]
             }
         }
         let name = animation.name ?? nameGenerator.nextUniqueName(prefix: "Animation")
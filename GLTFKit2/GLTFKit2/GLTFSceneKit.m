@@ -1,9 +1,9 @@
 
 #import "GLTFSceneKit.h"
 #import "GLTFLogging.h"
+#import "GLTFMeshProcessing.h"
 #import "GLTFWorkflowHelper.h"
 
-#import <SceneKit/ModelIO.h>
 #import <simd/simd.h>
 
 NSString *const GLTFAssetPropertyKeyCopyright = @"GLTFAssetPropertyKeyCopyright";
@@ -69,160 +69,43 @@ static SCNWrapMode GLTFSCNWrapModeForMode(GLTFAddressMode mode) {
     }
 }
 
-static NSData *GLTFLineIndexDataForLineLoopIndexData(NSData *_Nonnull lineLoopIndexData,
-                                                     int lineLoopIndexCount,
-                                                     int bytesPerIndex) {
-    if (lineLoopIndexCount < 2) {
+static SCNGeometryElement *GLTFSCNGeometryElementForPrimitive(GLTFPrimitive *primitive) {
+    // SceneKit supports neither 8-bit indices nor loops, line strips and fans, so we ask for lists and strips only
+    GLTFPrimitiveType indexPrimitiveType = GLTFPrimitiveTypeInvalid;
+    NSInteger indexCount = 0, bytesPerIndex = 0;
+    NSData *indexData = GLTFIndexDataForPrimitive(primitive,
+                                                  GLTFIndexConversionOptionPreserveTriangleStrips |
+                                                  GLTFIndexConversionOptionNarrowTo16Bit,
+                                                  &indexPrimitiveType, &indexCount, &bytesPerIndex);
+    if (indexData == nil) {
         return nil;
     }
 
-    int lineIndexCount = 2 * lineLoopIndexCount;
-    size_t bufferSize = lineIndexCount * bytesPerIndex;
-    unsigned char *lineIndices = malloc(bufferSize);
-    unsigned char *lineIndicesCursor = lineIndices;
-    unsigned char *lineLoopIndices = (unsigned char *)lineLoopIndexData.bytes;
-
-    // Create a line from the last index element to the first index element.
-    int lastLineIndexOffset = (lineIndexCount - 1) * bytesPerIndex;
-    memcpy(lineIndicesCursor, lineLoopIndices, bytesPerIndex);
-    memcpy(lineIndicesCursor + lastLineIndexOffset, lineLoopIndices, bytesPerIndex);
-    lineIndicesCursor += bytesPerIndex;
-
-    // Duplicate indices in-between to fill in the loop.
-    for (int i = 1; i < lineLoopIndexCount; ++i) {
-        memcpy(lineIndicesCursor, lineLoopIndices + (i * bytesPerIndex), bytesPerIndex);
-        lineIndicesCursor += bytesPerIndex;
-        memcpy(lineIndicesCursor, lineLoopIndices + (i * bytesPerIndex), bytesPerIndex);
-        lineIndicesCursor += bytesPerIndex;
-    }
-
-    return [NSData dataWithBytesNoCopy:lineIndices
-                                length:bufferSize
-                          freeWhenDone:YES];
-}
-
-static NSData *GLTFLineIndexDataForLineStripIndexData(NSData *_Nonnull lineStripIndexData,
-                                                      int lineStripIndexCount,
-                                                      int bytesPerIndex) {
-    if (lineStripIndexCount < 2) {
-        return nil;
-    }
-
-    int lineIndexCount = 2 * (lineStripIndexCount - 1);
-    size_t bufferSize = lineIndexCount * bytesPerIndex;
-    unsigned char *lineIndices = malloc(bufferSize);
-    unsigned char *lineIndicesCursor = lineIndices;
-    unsigned char *lineStripIndices = (unsigned char *)lineStripIndexData.bytes;
-
-    // Place the first and last indices.
-    int lastLineIndexOffset = (lineIndexCount - 1) * bytesPerIndex;
-    int lastLineStripIndexOffset = (lineStripIndexCount - 1) * bytesPerIndex;
-    memcpy(lineIndicesCursor, lineStripIndices, bytesPerIndex);
-    memcpy(lineIndicesCursor + lastLineIndexOffset,
-           lineStripIndices + lastLineStripIndexOffset,
-           bytesPerIndex);
-    lineIndicesCursor += bytesPerIndex;
-
-    // Duplicate all indices in-between.
-    for (int i = 1; i < lineStripIndexCount; ++i) {
-        memcpy(lineIndicesCursor, lineStripIndices + (i * bytesPerIndex), bytesPerIndex);
-        lineIndicesCursor += bytesPerIndex;
-        memcpy(lineIndicesCursor, lineStripIndices + (i * bytesPerIndex), bytesPerIndex);
-        lineIndicesCursor += bytesPerIndex;
-    }
-
-    return [NSData dataWithBytesNoCopy:lineIndices
-                                length:bufferSize
-                          freeWhenDone:YES];
-}
-
-static NSData *GLTFTrianglesIndexDataForTriangleFanIndexData(NSData *_Nonnull triangleFanIndexData,
-                                                             int triangleFanIndexCount,
-                                                             int bytesPerIndex) {
-    if (triangleFanIndexCount < 3) {
-        return nil;
-    }
-
-    int trianglesIndexCount = 3 * (triangleFanIndexCount - 2);
-    size_t bufferSize = trianglesIndexCount * bytesPerIndex;
-    unsigned char *trianglesIndices = malloc(bufferSize);
-    unsigned char *trianglesIndicesCursor = trianglesIndices;
-    unsigned char *triangleFanIndices = (unsigned char *)triangleFanIndexData.bytes;
-
-    for (int i = 1; i < triangleFanIndexCount; ++i) {
-        memcpy(trianglesIndicesCursor, triangleFanIndices, bytesPerIndex);
-        trianglesIndicesCursor += bytesPerIndex;
-        memcpy(trianglesIndicesCursor, triangleFanIndices + (i * bytesPerIndex), 2 * bytesPerIndex);
-        trianglesIndicesCursor += 2 * bytesPerIndex;
-    }
-
-    return [NSData dataWithBytesNoCopy:trianglesIndices
-                                length:bufferSize
-                          freeWhenDone:YES];
-}
-
-static SCNGeometryElement *GLTFSCNGeometryElementForIndexData(NSData *indexData,
-                                                              int indexCount,
-                                                              int bytesPerIndex,
-                                                              GLTFPrimitive *primitive) {
-    NSData *finalIndexData = indexData;
     SCNGeometryPrimitiveType primitiveType;
-    int primitiveCount;
-    switch (primitive.primitiveType) {
-        case GLTFPrimitiveTypeInvalid:
-            GLTFLogError(@"[GLTFKit2] Encountered primitive with invalid type. Will not create geometry element");
-            return nil;
+    NSInteger primitiveCount;
+    switch (indexPrimitiveType) {
         case GLTFPrimitiveTypePoints:
             primitiveType = SCNGeometryPrimitiveTypePoint;
             primitiveCount = indexCount;
             break;
         case GLTFPrimitiveTypeLines:
-            primitiveCount = indexCount / 2;
-            primitiveType = SCNGeometryPrimitiveTypeLine;
-            break;
-        case GLTFPrimitiveTypeLineLoop:
-            primitiveCount = indexCount;
-            primitiveType = SCNGeometryPrimitiveTypeLine;
-            if (indexData) {
-                finalIndexData = GLTFLineIndexDataForLineLoopIndexData(indexData, indexCount, bytesPerIndex);
-            }
-            break;
-        case GLTFPrimitiveTypeLineStrip:
-            primitiveCount = indexCount - 1;
             primitiveType = SCNGeometryPrimitiveTypeLine;
-            if (indexData) {
-                finalIndexData = GLTFLineIndexDataForLineStripIndexData(indexData, indexCount, bytesPerIndex);
-            }
+            primitiveCount = indexCount / 2;
             break;
         case GLTFPrimitiveTypeTriangles:
-            primitiveCount = indexCount / 3;
             primitiveType = SCNGeometryPrimitiveTypeTriangles;
+            primitiveCount = indexCount / 3;
             break;
         case GLTFPrimitiveTypeTriangleStrip:
-            primitiveCount = indexCount - 2; // TODO: Handle primitive restart?
             primitiveType = SCNGeometryPrimitiveTypeTriangleStrip;
-            break;
-        case GLTFPrimitiveTypeTriangleFan:
             primitiveCount = indexCount - 2;
-            primitiveType = SCNGeometryPrimitiveTypeTriangles;
-            if (indexData) {
-                finalIndexData = GLTFTrianglesIndexDataForTriangleFanIndexData(indexData, indexCount, bytesPerIndex);
-            }
             break;
+        default:
+            GLTFLogError(@"[GLTFKit2] Encountered primitive with unsupported type. Will not create geometry element");
+            return nil;
     }
 
-    if (finalIndexData.bytes == NULL) {
-        // Last resort. If we never had index data to begin with, fix up with an array of sequential indices
-        bytesPerIndex = 4;
-        size_t indexBufferLength = indexCount * bytesPerIndex;
-        uint32_t *indexStorage = (uint32_t *)malloc(indexCount * bytesPerIndex);
-        for (int i = 0; i < indexCount; ++i) {
-            indexStorage[i] = i;
-        }
-        finalIndexData = [NSData dataWithBytesNoCopy:indexStorage length:indexBufferLength freeWhenDone:YES];
-    }
-
-    SCNGeometryElement *element = [SCNGeometryElement geometryElementWithData:finalIndexData
+    SCNGeometryElement *element = [SCNGeometryElement geometryElementWithData:indexData
                                                                 primitiveType:primitiveType
                                                                primitiveCount:primitiveCount
                                                                 bytesPerIndex:bytesPerIndex];
@@ -234,18 +117,28 @@ static SCNGeometryElement *GLTFSCNGeometryElementForIndexData(NSData *indexData,
     return element;
 }
 
+// Returns the entry for `object` in `sideTable`, which parallels `objects`, or nil if `object` is not among them.
+static id GLTFSideTableEntryForObject(NSArray *sideTable, GLTFObject *object, NSArray<GLTFObject *> *objects) {
+    NSInteger index = GLTFIndexOfObjectInArray(object, objects);
+    return (index != NSNotFound) ? sideTable[index] : nil;
+}
+
 static BOOL GLTFAccessorGetMinMaxScalarValues(GLTFAccessor *accessor, float *minValue, float *maxValue) {
-    if (accessor == nil ||
-        accessor.minValues == nil || accessor.minValues.count < 1 ||
-        accessor.maxValues == nil || accessor.maxValues.count < 1)
-    {
+    if (accessor == nil) {
         return NO;
     }
+    NSArray<NSNumber *> *minValues = accessor.minValues, *maxValues = accessor.maxValues;
+    if (minValues.count < 1 || maxValues.count < 1) {
+        // Bounds are optional for most accessors, so fall back to scanning the data
+        if (!GLTFAccessorComputeBounds(accessor, &minValues, &maxValues)) {
+            return NO;
+        }
+    }
     if (minValue) {
-        *minValue = [accessor.minValues.firstObject floatValue];
+        *minValue = [minValues.firstObject floatValue];
     }
     if (maxValue) {
-        *maxValue = [accessor.maxValues.firstObject floatValue];
+        *maxValue = [maxValues.firstObject floatValue];
     }
     return YES;
 }
@@ -316,22 +209,12 @@ static void GLTFConfigureSCNMaterialProperty(SCNMaterialProperty *property, GLTF
     }
 }
 
-static NSData *GLTFPackedUInt16DataFromPackedUInt8(UInt8 *bytes, size_t count) {
-    size_t bufferSize = sizeof(UInt16) * count;
-    UInt16 *shorts = malloc(bufferSize);
-    // This is begging to be parallelized. Can this be done with Accelerate?
-    for (int i = 0; i < count; ++i) {
-        shorts[i] = (UInt16)bytes[i];
-    }
-    return [NSData dataWithBytesNoCopy:shorts length:bufferSize freeWhenDone:YES];
-}
-
 static NSArray<NSNumber *> *GLTFKeyTimeArrayForAccessor(GLTFAccessor *accessor, float minKeyTime, float maxKeyTime) {
     NSData *sourceData = GLTFPackedDataForAccessor(accessor);
     sourceData = GLTFTransformPackedDataToFloat(sourceData, accessor);
     NSMutableArray *values = [NSMutableArray arrayWithCapacity:accessor.count];
     float scale = (maxKeyTime > 0) ? (1.0f / maxKeyTime) : 1.0f;
-    for (int i = 0; i < accessor.count; ++i) {
+    for (NSInteger i = 0; i < accessor.count; ++i) {
         const float *x = sourceData.bytes + (i * sizeof(float));
         NSNumber *value = @((x[0] - minKeyTime) * scale);
         [values addObject:value];
@@ -388,7 +271,7 @@ static SCNGeometrySource *GLTFSCNGeometrySourceForAccessor(GLTFAccessor *accesso
             GLTFLogError(@"[GLTFKit2] Accessor for joint weights must be of VEC4 type");
             return nil;
         }
-        for (int i = 0; i < accessor.count; ++i) {
+        for (NSInteger i = 0; i < accessor.count; ++i) {
             float *weights = (float *)(attrData.bytes + i * elementSize);
             float sum = weights[0] + weights[1] + weights[2] + weights[3];
             if (sum != 1.0f) {
@@ -448,7 +331,7 @@ static NSArray<NSValue *> *GLTFSCNVector3ArrayForAccessor(GLTFAccessor *accessor
     sourceData = GLTFTransformPackedDataToFloat(sourceData, accessor);
     NSMutableArray *values = [NSMutableArray arrayWithCapacity:accessor.count];
     const size_t elementSize = sizeof(float) * 3;
-    for (int i = 0; i < accessor.count; ++i) {
+    for (NSInteger i = 0; i < accessor.count; ++i) {
         const float *xyz = sourceData.bytes + (i * elementSize);
         NSValue *value = [NSValue valueWithSCNVector3:SCNVector3Make(xyz[0], xyz[1], xyz[2])];
         [values addObject:value];
@@ -461,7 +344,7 @@ static NSArray<NSValue *> *GLTFSCNVector4ArrayForAccessor(GLTFAccessor *accessor
     sourceData = GLTFTransformPackedDataToFloat(sourceData, accessor);
     NSMutableArray *values = [NSMutableArray arrayWithCapacity:accessor.count];
     const size_t elementSize = sizeof(float) * 4;
-    for (int i = 0; i < accessor.count; ++i) {
+    for (NSInteger i = 0; i < accessor.count; ++i) {
         const float *xyzw = sourceData.bytes + (i * elementSize);
         NSValue *value = [NSValue valueWithSCNVector4:SCNVector4Make(xyzw[0], xyzw[1], xyzw[2], xyzw[3])];
         [values addObject:value];
@@ -474,12 +357,12 @@ static NSArray<NSArray<NSNumber *> *> *GLTFWeightsArraysForAccessor(GLTFAccessor
     sourceData = GLTFTransformPackedDataToFloat(sourceData, accessor);
     size_t keyframeCount = accessor.count / targetCount;
     NSMutableArray<NSMutableArray *> *weights = [NSMutableArray arrayWithCapacity:keyframeCount];
-    for (int t = 0; t < targetCount; ++t) {
-        [weights addObject:[NSMutableArray arrayWithCapacity:targetCount]];
+    for (NSUInteger t = 0; t < targetCount; ++t) {
+        [weights addObject:[NSMutableArray arrayWithCapacity:keyframeCount]];
     }
     const float *values = (float *)sourceData.bytes;
-    for (int k = 0; k < keyframeCount; ++k) {
-        for (int t = 0; t < targetCount; ++t) {
+    for (size_t k = 0; k < keyframeCount; ++k) {
+        for (NSUInteger t = 0; t < targetCount; ++t) {
             [weights[t] addObject:@(values[k * targetCount + t])];
         }
     }
@@ -492,7 +375,7 @@ static NSArray<NSValue *> *GLTFSCNMatrix4ArrayFromAccessor(GLTFAccessor *accesso
     NSMutableArray *values = [NSMutableArray arrayWithCapacity:accessor.count];
     const void *bufferViewBaseAddr = accessor.bufferView.buffer.data.bytes + accessor.bufferView.offset;
     const size_t elementSize = sizeof(float) * 16;
-    for (int i = 0; i < accessor.count; ++i) {
+    for (NSInteger i = 0; i < accessor.count; ++i) {
         const float *M = bufferViewBaseAddr + (i * (accessor.bufferView.stride ?: elementSize)) + accessor.offset;
         SCNMatrix4 m;
         m.m11 = M[ 0]; m.m12 = M[ 1]; m.m13 = M[ 2]; m.m14 = M[ 3];
@@ -527,7 +410,7 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
 @end
 
 @interface GLTFSCNSceneSource () {
-    NSMutableDictionary<NSUUID *, id> *_materialPropertyContentsCache;
+    NSMutableDictionary<id<NSCopying>, id> *_materialPropertyContentsCache; // Keyed by texture handle
 }
 @property (nonatomic, copy) NSDictionary *properties;
 @property (nonatomic, copy) NSArray<SCNMaterial *> *materials;
@@ -574,30 +457,32 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
         device = MTLCreateSystemDefaultDevice();
     });
 
-    if (_materialPropertyContentsCache[texture.identifier] != nil) {
-        return _materialPropertyContentsCache[texture.identifier];
+    // Textures that no asset holds have no handle, so they are keyed by address instead
+    id<NSCopying> cacheKey = (texture.handle != 0) ? @(texture.handle) : [NSValue valueWithNonretainedObject:texture];
+    if (_materialPropertyContentsCache[cacheKey] != nil) {
+        return _materialPropertyContentsCache[cacheKey];
     }
 #ifdef GLTF_BUILD_WITH_KTX2
     if (texture.basisUSource) {
         id<MTLTexture> metalTexture = [texture.basisUSource newTextureWithDevice:device];
-        _materialPropertyContentsCache[texture.identifier] = metalTexture;
+        _materialPropertyContentsCache[cacheKey] = metalTexture;
         return metalTexture;
     }
 #endif
     if (texture.webpSource) {
         CGImageRef webpCGImage = [texture.webpSource newCGImage];
-        _materialPropertyContentsCache[texture.identifier] = (__bridge_transfer id)webpCGImage;
+        _materialPropertyContentsCache[cacheKey] = (__bridge_transfer id)webpCGImage;
         return (__bridge id)webpCGImage;
     }
     CGImageRef cgImage = [texture.source newCGImage];
     if (cgImage) {
-        _materialPropertyContentsCache[texture.identifier] = (__bridge_transfer id)cgImage;
+        _materialPropertyContentsCache[cacheKey] = (__bridge_transfer id)cgImage;
         return (__bridge id)cgImage;
     } else {
         GLTFLogWarning(@"[GLTFKit2] Warning: Failed to create CGImage for material property. Will try to load as KTX2 as a last resort...");
         if ([[texture.source inferMediaType] isEqual:GLTFMediaTypeKTX2]) {
             id<MTLTexture> imageTexture = [texture.source newTextureWithDevice:device];
-            _materialPropertyContentsCache[texture.identifier] = imageTexture;
+            _materialPropertyContentsCache[cacheKey] = imageTexture;
             return imageTexture;
         }
     }
@@ -809,19 +694,16 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
         [materials addObject:scnMaterial];
     }
 
-    NSMutableDictionary <NSUUID *, SCNGeometry *> *geometryForIdentifiers = [NSMutableDictionary dictionary];
-    NSMutableDictionary <NSUUID *, SCNGeometryElement *> *geometryElementForIdentifiers = [NSMutableDictionary dictionary];
+    // The geometries of each mesh's primitives follow those of the meshes before it
+    NSMutableArray<SCNGeometry *> *geometries = [NSMutableArray array];
+    NSMutableArray *geometryElements = [NSMutableArray array]; // Holding NSNull for primitives without one
+    NSMutableArray<NSNumber *> *firstGeometryIndices = [NSMutableArray arrayWithCapacity:self.asset.meshes.count];
     for (GLTFMesh *mesh in self.asset.meshes) {
+        [firstGeometryIndices addObject:@(geometries.count)];
         for (GLTFPrimitive *primitive in mesh.primitives) {
-            int vertexCount = 0;
-            GLTFAttribute *positionAttribute = [primitive attributeForName:GLTFAttributeSemanticPosition];
-            GLTFAccessor *positionAccessor = positionAttribute.accessor;
-            if (positionAccessor != nil) {
-                vertexCount = (int)positionAccessor.count;
-            }
             SCNMaterial *material = nil;
             if (primitive.material) {
-                NSInteger materialIndex = [self.asset.materials indexOfObject:primitive.material];
+                NSInteger materialIndex = GLTFIndexOfObjectInArray(primitive.material, self.asset.materials);
                 if (materialIndex != NSNotFound) {
                     material = materials[materialIndex];
                 }
@@ -829,45 +711,17 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
             if (self.activeMaterialVariant != nil) {
                 GLTFMaterial *materialOverride = [primitive effectiveMaterialForVariant:self.activeMaterialVariant];
                 if (materialOverride) {
-                    NSInteger overrideMaterialIndex = [self.asset.materials indexOfObject:materialOverride];
-                    material = materials[overrideMaterialIndex];
-                }
-            }
-            NSData *indexData = nil;
-            int indexSize = 1;
-            int indexCount = vertexCount; // If we're not indexed (determined below), our "index" count is our vertex count
-            if (primitive.indices) {
-                GLTFAccessor *indexAccessor = primitive.indices;
-                GLTFBufferView *indexBufferView = indexAccessor.bufferView;
-                assert(indexBufferView.stride == 0 || indexBufferView.stride == indexSize);
-                GLTFBuffer *indexBuffer = indexBufferView.buffer;
-                indexCount = (int)primitive.indices.count;
-                if((indexAccessor.componentType == GLTFComponentTypeUnsignedShort) ||
-                   (indexAccessor.componentType == GLTFComponentTypeUnsignedInt))
-                {
-                    indexSize = indexAccessor.componentType == GLTFComponentTypeUnsignedInt ? sizeof(UInt32) : sizeof(UInt16);
-                    indexData = [NSData dataWithBytesNoCopy:(void *)indexBuffer.data.bytes + indexBufferView.offset + indexAccessor.offset
-                                                     length:indexCount * indexSize
-                                               freeWhenDone:NO];
-                }
-                else
-                {
-                    assert(indexAccessor.componentType == GLTFComponentTypeUnsignedByte);
-                    // We don't directly support 8-bit indices, but converting them is simple enough
-                    indexSize = sizeof(UInt16);
-                    void *bufferViewBaseAddr = (void *)indexBuffer.data.bytes + indexBufferView.offset;
-                    indexData = GLTFPackedUInt16DataFromPackedUInt8(bufferViewBaseAddr + indexAccessor.offset, indexCount);
+                    NSInteger overrideMaterialIndex = GLTFIndexOfObjectInArray(materialOverride, self.asset.materials);
+                    if (overrideMaterialIndex != NSNotFound) {
+                        material = materials[overrideMaterialIndex];
+                    }
                 }
             }
-            SCNGeometryElement *element = GLTFSCNGeometryElementForIndexData(indexData, indexCount, indexSize, primitive);
-            geometryElementForIdentifiers[primitive.identifier] = element;
+            SCNGeometryElement *element = GLTFSCNGeometryElementForPrimitive(primitive);
+            [geometryElements addObject:element ?: [NSNull null]];
 
             NSMutableArray *geometrySources = [NSMutableArray array];
             for (GLTFAttribute *attribute in primitive.attributes) {
-                // TODO: Retopologize geometry source if geometry element's data is `nil`.
-                // For primitive types not supported by SceneKit (line loops, line strips, triangle
-                // fans), we retopologize the primitive's indices. However, if they aren't present,
-                // we need to adjust the vertex data.
                 if ([attribute.name isEqual:@"WEIGHTS_0"] || [attribute.name isEqual:@"JOINTS_0"]) {
                     // Omit joint indices and weights; these are stored later on the skinner
                     continue;
@@ -888,10 +742,10 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
                 });
             }
 
-            SCNGeometry *geometry = [SCNGeometry geometryWithSources:geometrySources elements:@[element]];
+            SCNGeometry *geometry = [SCNGeometry geometryWithSources:geometrySources elements:element ? @[element] : @[]];
             geometry.name = mesh.name;
             geometry.firstMaterial = material ?: defaultMaterial;
-            geometryForIdentifiers[primitive.identifier] = geometry;
+            [geometries addObject:geometry];
         }
     }
 
@@ -963,32 +817,36 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
         node.name = legalizedName;
     }
 
-    NSMutableDictionary<NSUUID *, SCNNode *> *nodesForIdentifiers = [NSMutableDictionary dictionary];
+    NSMutableArray<SCNNode *> *scnNodes = [NSMutableArray arrayWithCapacity:self.asset.nodes.count];
     for (GLTFNode *node in self.asset.nodes) {
         SCNNode *scnNode = [SCNNode node];
         scnNode.name = node.name;
         scnNode.simdTransform = node.matrix;
-        nodesForIdentifiers[node.identifier] = scnNode;
+        [scnNodes addObject:scnNode];
     }
 
     for (GLTFNode *node in self.asset.nodes) {
-        SCNNode *scnNode = nodesForIdentifiers[node.identifier];
+        SCNNode *scnNode = scnNodes[GLTFIndexOfObjectInArray(node, self.asset.nodes)];
         for (GLTFNode *childNode in node.childNodes) {
-            SCNNode *scnChildNode = nodesForIdentifiers[childNode.identifier];
+            SCNNode *scnChildNode = GLTFSideTableEntryForObject(scnNodes, childNode, self.asset.nodes);
             [scnNode addChildNode:scnChildNode];
         }
     }
 
     for (GLTFNode *node in self.asset.nodes) {
-        SCNNode *scnNode = nodesForIdentifiers[node.identifier];
+        SCNNode *scnNode = scnNodes[GLTFIndexOfObjectInArray(node, self.asset.nodes)];
 
         if (node.camera) {
-            NSInteger cameraIndex = [self.asset.cameras indexOfObject:node.camera];
-            scnNode.camera = cameras[cameraIndex];
+            NSInteger cameraIndex = GLTFIndexOfObjectInArray(node.camera, self.asset.cameras);
+            if (cameraIndex != NSNotFound) {
+                scnNode.camera = cameras[cameraIndex];
+            }
         }
         if (node.light) {
-            NSInteger lightIndex = [self.asset.lights indexOfObject:node.light];
-            scnNode.light = lights[lightIndex];
+            NSInteger lightIndex = GLTFIndexOfObjectInArray(node.light, self.asset.lights);
+            if (lightIndex != NSNotFound) {
+                scnNode.light = lights[lightIndex];
+            }
         }
 
         // This collection holds the nodes to which any skin on this node should be applied,
@@ -996,7 +854,9 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
         // apply morph targets to the correct primitives.
         NSMutableArray<SCNNode *> *geometryNodes = [NSMutableArray array];
 
-        if (node.mesh) {
+        NSInteger meshIndex = node.mesh ? GLTFIndexOfObjectInArray(node.mesh, self.asset.meshes) : NSNotFound;
+        if (meshIndex != NSNotFound) {
+            NSInteger firstGeometryIndex = firstGeometryIndices[meshIndex].integerValue;
             NSArray<GLTFPrimitive *> *primitives = node.mesh.primitives;
             if (primitives.count == 1) {
                 [geometryNodes addObject:scnNode];
@@ -1012,17 +872,34 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
             for (int i = 0; i < primitives.count; ++i) {
                 GLTFPrimitive *primitive = primitives[i];
                 SCNNode *geometryNode = geometryNodes[i];
-                geometryNode.geometry = geometryForIdentifiers[primitive.identifier];
+                geometryNode.geometry = geometries[firstGeometryIndex + i];
 
                 if (primitive.targets.count > 0) {
-                    // If the base mesh doesn't contain normals, use Model I/O to generate them
-                    if ([geometryNode.geometry geometrySourcesForSemantic:SCNGeometrySourceSemanticNormal].count == 0) {
-                        MDLMesh *mdlMesh = [MDLMesh meshWithSCNGeometry:geometryNode.geometry];
-                        [mdlMesh addNormalsWithAttributeNamed:MDLVertexAttributeNormal creaseThreshold:0.0];
-                        geometryNode.geometry = [SCNGeometry geometryWithMDLMesh:mdlMesh];
+                    // If the base mesh doesn't contain normals, generate smooth ones so that morphing can
+                    // interpolate them. Normals are not split, so the vertices still match the morph targets.
+                    SCNGeometry *baseGeometry = geometryNode.geometry;
+                    NSData *normalData = nil;
+                    if ([baseGeometry geometrySourcesForSemantic:SCNGeometrySourceSemanticNormal].count == 0 &&
+                        (normalData = GLTFSmoothNormalDataForPrimitive(primitive)) != nil)
+                    {
+                        SCNGeometrySource *normalSource = [SCNGeometrySource geometrySourceWithData:normalData
+                                                                                           semantic:SCNGeometrySourceSemanticNormal
+                                                                                        vectorCount:normalData.length / (3 * sizeof(float))
+                                                                                    floatComponents:YES
+                                                                                componentsPerVector:3
+                                                                                  bytesPerComponent:sizeof(float)
+                                                                                         dataOffset:0
+                                                                                         dataStride:3 * sizeof(float)];
+                        NSArray *sources = [baseGeometry.geometrySources arrayByAddingObject:normalSource];
+                        SCNGeometry *geometry = [SCNGeometry geometryWithSources:sources
+                                                                        elements:baseGeometry.geometryElements];
+                        geometry.name = baseGeometry.name;
+                        geometry.materials = baseGeometry.materials;
+                        geometryNode.geometry = geometry;
                     }
 
-                    SCNGeometryElement *element = geometryElementForIdentifiers[primitive.identifier];
+                    id element = geometryElements[firstGeometryIndex + i];
+                    NSArray<SCNGeometryElement *> *targetElements = (element != [NSNull null]) ? @[element] : @[];
                     NSMutableArray<SCNGeometry *> *morphGeometries = [NSMutableArray arrayWithCapacity:primitive.targets.count];
                     int nameIndex = 0;
                     for (GLTFMorphTarget *target in primitive.targets) {
@@ -1055,7 +932,7 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
                             }
                         }
 
-                        SCNGeometry *targetGeometry = [SCNGeometry geometryWithSources:targetSources elements:@[element]];
+                        SCNGeometry *targetGeometry = [SCNGeometry geometryWithSources:targetSources elements:targetElements];
 
                         if (nameIndex < node.mesh.targetNames.count) {
                             targetGeometry.name = node.mesh.targetNames[nameIndex];
@@ -1077,7 +954,7 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
         if (node.skin) {
             NSMutableArray *bones = [NSMutableArray array];
             for (GLTFNode *jointNode in node.skin.joints) {
-                SCNNode *bone = nodesForIdentifiers[jointNode.identifier];
+                SCNNode *bone = GLTFSideTableEntryForObject(scnNodes, jointNode, self.asset.nodes);
                 [bones addObject:bone];
             }
             NSArray *ibmValues = GLTFSCNMatrix4ArrayFromAccessor(node.skin.inverseBindMatrices);
@@ -1102,7 +979,7 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
                                                               boneWeights:boneWeights
                                                               boneIndices:boneIndices];
                 if (node.skin.skeleton) {
-                    skinner.skeleton = nodesForIdentifiers[node.skin.skeleton.identifier];
+                    skinner.skeleton = GLTFSideTableEntryForObject(scnNodes, node.skin.skeleton, self.asset.nodes);
                 }
                 skinnedNode.skinner = skinner;
             }
@@ -1152,7 +1029,7 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
                 assert(targetCount > 0);
                 NSArray<NSArray<NSNumber *> *> *weightArrays = GLTFWeightsArraysForAccessor(channel.sampler.output, targetCount);
 
-                SCNNode *targetRoot = nodesForIdentifiers[channel.target.node.identifier];
+                SCNNode *targetRoot = GLTFSideTableEntryForObject(scnNodes, channel.target.node, self.asset.nodes);
                 NSMutableArray<SCNNode *> *geometryNodes = [NSMutableArray array];
                 if (targetRoot.geometry != nil) {
                     [geometryNodes addObject:targetRoot];
@@ -1247,7 +1124,7 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
     for (GLTFScene *scene in self.asset.scenes) {
         SCNScene *scnScene = [SCNScene scene];
         for (GLTFNode *rootNode in scene.nodes) {
-            SCNNode *scnChildNode = nodesForIdentifiers[rootNode.identifier];
+            SCNNode *scnChildNode = GLTFSideTableEntryForObject(scnNodes, rootNode, self.asset.nodes);
             [scnScene.rootNode addChildNode:scnChildNode];
         }
         [scenes addObject:scnScene];
@@ -1258,13 +1135,13 @@ static float GLTFLuminanceFromRGBA(simd_float4 rgba) {
     _materials = [materials copy];
     _lights = [lights copy];
     _cameras = [cameras copy];
-    _nodes = [nodesForIdentifiers allValues];
-    _geometries = [geometryForIdentifiers allValues];
+    _nodes = [scnNodes copy];
+    _geometries = [geometries copy];
     _scenes = [scenes copy];
     _animations = [animationPlayers copy];
 
     if (self.asset.defaultScene) {
-        NSInteger defaultSceneIndex = [self.asset.scenes indexOfObject:self.asset.defaultScene];
+        NSInteger defaultSceneIndex = GLTFIndexOfObjectInArray(self.asset.defaultScene, self.asset.scenes);
         if (defaultSceneIndex != NSNotFound) {
             _defaultScene = self.scenes[defaultSceneIndex];
         }
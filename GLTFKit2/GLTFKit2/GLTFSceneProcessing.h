@@ -0,0 +1,184 @@
+
+#import <GLTFKit2/GLTFAsset.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The vertices and indices of a static batch that came from one primitive of one node, for mapping a hit on the
+/// batch back to the object that was picked. Offsets and counts are in elements of the batched primitive.
+GLTFKIT2_EXPORT
+@interface GLTFStaticBatchRange : NSObject
+
+@property (nonatomic, readonly) GLTFNode *node;
+@property (nonatomic, readonly) GLTFPrimitive *sourcePrimitive;
+@property (nonatomic, readonly) NSInteger indexOffset;
+@property (nonatomic, readonly) NSInteger indexCount;
+@property (nonatomic, readonly) NSInteger vertexOffset;
+@property (nonatomic, readonly) NSInteger vertexCount;
+
+- (instancetype)initWithNode:(GLTFNode *)node
+             sourcePrimitive:(GLTFPrimitive *)sourcePrimitive
+                 indexOffset:(NSInteger)indexOffset
+                  indexCount:(NSInteger)indexCount
+                vertexOffset:(NSInteger)vertexOffset
+                 vertexCount:(NSInteger)vertexCount NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/// A primitive formed by merging primitives of several static nodes that share a material and vertex layout.
+GLTFKIT2_EXPORT
+@interface GLTFStaticBatch : NSObject
+
+/// The node that draws the batch: a root node of the scene with an identity transform
+@property (nonatomic, readonly) GLTFNode *node;
+@property (nonatomic, readonly) GLTFPrimitive *primitive;
+/// The source of each part of the batch, in increasing order of index offset
+@property (nonatomic, readonly) NSArray<GLTFStaticBatchRange *> *ranges;
+
+- (instancetype)initWithNode:(GLTFNode *)node
+                   primitive:(GLTFPrimitive *)primitive
+                      ranges:(NSArray<GLTFStaticBatchRange *> *)ranges NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Returns the range whose indices include the index at `indexOffset` of the batched primitive (for example, the
+/// first index of a picked triangle), or nil if the offset is beyond the batch.
+- (nullable GLTFStaticBatchRange *)rangeContainingIndexOffset:(NSInteger)indexOffset;
+
+@end
+
+/// Merges the primitives of static nodes in `scene` into batches, one for each combination of material, list
+/// topology and vertex layout that is shared by more than one primitive. A node is static if neither it nor any
+/// ancestor is the target of a transform animation or a skinning joint, it is not skinned or instanced, and it
+/// belongs to no other scene. Primitives with morph targets or material variants are not batched. Each node's world
+/// transform is baked into its positions, normals and tangents, reversing triangle winding for mirroring transforms,
+/// and indices are 32-bit when the batch needs them. Batched primitives are removed from their nodes (through new
+/// meshes, so that shared meshes are unaffected), and each batch is drawn by a new root node of `scene`. New
+/// accessors, meshes and nodes are added to `asset`. Returns the batches, or nil and sets `error` if a primitive's
+/// data is invalid, in which case the asset is left unchanged.
+GLTFKIT2_EXPORT
+NSArray<GLTFStaticBatch *> *_Nullable GLTFSceneBuildStaticBatches(GLTFAsset *asset, GLTFScene *scene, NSError **error);
+
+/// Finds meshes of `asset` whose primitives have identical contents (the same topologies and materials, and accessors
+/// with byte-identical data, though they may be different objects) and points every node of the asset, in every
+/// scene, at the first of each set of duplicates, removing the rest from the asset. Names are not compared, since
+/// exporters name copies apart (such as "Bolt" and "Bolt.001"); the first mesh keeps its name, and the nodes keep
+/// theirs. Accessor data is hashed once, in parallel, and candidates with equal hashes are compared in full. Returns
+/// the number of meshes removed.
+GLTFKIT2_EXPORT
+NSInteger GLTFAssetMergeDuplicateMeshes(GLTFAsset *asset);
+
+/// Replaces each set of at least `minimumInstanceCount` nodes of `scene` that draw the same mesh, and whose transforms
+/// relative to their nearest moving ancestor (or the scene root) are fixed, with a single node that draws the mesh once
+/// for each of them through `GLTFMeshInstances`, in the manner of EXT_mesh_gpu_instancing. Moving nodes and static
+/// nodes are as described for `GLTFSceneBuildStaticBatches`, except that nodes whose morph weights are animated also
+/// count as moving. Meshes with morph targets are not instanced, since instances share their weights. Only nodes of
+/// `scene` that belong to no other scene are changed. Distinct mesh objects with identical contents (as compared by
+/// `GLTFAssetMergeDuplicateMeshes`) count as the same mesh, and their instances draw the first of them; the other
+/// copies stay in the asset. The instancing node is a child of the common ancestor, and holds TRANSLATION, ROTATION and
+/// SCALE in separate float accessors; ROTATION and SCALE are omitted if every instance has the identity. Nodes whose
+/// transforms cannot be decomposed (such as those with shear) are not instanced. Instanced nodes keep their children,
+/// cameras and lights but no longer draw the mesh. Returns the new instancing nodes, which are also added to `asset`.
+GLTFKIT2_EXPORT
+NSArray<GLTFNode *> *GLTFSceneCreateMeshInstances(GLTFAsset *asset, GLTFScene *scene, NSInteger minimumInstanceCount);
+
+typedef NS_OPTIONS(NSUInteger, GLTFQuantizationOptions) {
+    /// Store positions as normalized 16-bit integers, moving their offset and scale into the nodes that draw them
+    GLTFQuantizationOptionPositions            = 1 << 0,
+    /// Store normals and tangents as normalized 8-bit integers
+    GLTFQuantizationOptionNormals              = 1 << 1,
+    /// Store texture coordinates as normalized unsigned 16-bit integers
+    GLTFQuantizationOptionTexCoords            = 1 << 2,
+    /// Store skinning weights as normalized unsigned 8-bit integers
+    GLTFQuantizationOptionWeights              = 1 << 3,
+    /// Store vertex colors as normalized unsigned 8-bit integers
+    GLTFQuantizationOptionColors               = 1 << 4,
+    GLTFQuantizationOptionAll                  = GLTFQuantizationOptionPositions |
+                                                 GLTFQuantizationOptionNormals |
+                                                 GLTFQuantizationOptionTexCoords |
+                                                 GLTFQuantizationOptionWeights |
+                                                 GLTFQuantizationOptionColors,
+    /// Store normals and tangents as 16-bit rather than 8-bit integers
+    GLTFQuantizationOptionHighPrecisionNormals = 1 << 5,
+};
+
+/// The largest difference between any component of an attribute and its quantized value, over all meshes. Position
+/// errors are in the units of each mesh; the rest are in the attributes' own units.
+typedef struct GLTFQuantizationErrors {
+    float position;
+    float normal;
+    float tangent;
+    float texCoord;
+    float weight;
+    float color;
+} GLTFQuantizationErrors;
+
+/// Rewrites the float vertex attributes of the meshes of `asset` as the normalized integers that KHR_mesh_quantization
+/// permits, which take a half to a quarter of the memory. Each mesh's positions are offset and uniformly scaled into
+/// the range of 16-bit integers, and every node that draws the mesh is given the inverse transform, directly if it is
+/// a static leaf node, or else through a new child node that takes over its mesh. Morph target positions are scaled
+/// to match. Meshes drawn with skins or instancing, or by no node, keep float positions. Texture coordinates outside
+/// [0, 1] are remapped into it, with the texture transforms of the materials that sample them compensating, so long
+/// as the material is not one of a primitive's variants and does not remap texture coordinate sets; otherwise they
+/// stay float. Skinning weights are rounded so that they still sum to one. Attributes that are already quantized are
+/// left alone. New accessors and nodes are added to `asset`, and the extensions are marked as used. Returns NO and
+/// sets `error` if an attribute's data is invalid, in which case the asset is left unchanged.
+GLTFKIT2_EXPORT
+BOOL GLTFAssetQuantizeMeshes(GLTFAsset *asset,
+                             GLTFQuantizationOptions options,
+                             GLTFQuantizationErrors *_Nullable outErrors,
+                             NSError **error);
+
+/// The nearest (or, for an any-hit query, some) triangle of a scene that a ray hits.
+GLTFKIT2_EXPORT
+@interface GLTFSceneRayHit : NSObject
+
+@property (nonatomic, readonly) GLTFNode *node;
+@property (nonatomic, readonly) GLTFPrimitive *primitive;
+/// The instance of `node.meshInstances` that was hit, or -1 if the node is not instanced
+@property (nonatomic, readonly) NSInteger instanceIndex;
+/// The index of the triangle among the primitive's triangles, counted as if the primitive were a triangle list
+@property (nonatomic, readonly) NSInteger triangleIndex;
+/// The distance to the hit in multiples of the ray's direction, so that `point` is `origin + distance * direction`
+@property (nonatomic, readonly) float distance;
+/// The weights of the triangle's three corners at the hit, which sum to one
+@property (nonatomic, readonly) simd_float3 barycentricCoordinates;
+/// The hit, in the space of the scene's root
+@property (nonatomic, readonly) simd_float3 point;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/// Answers ray queries, such as picking, against the triangles of every node in a scene, using a bounding volume
+/// hierarchy over the whole scene. Triangles are gathered in the space of the scene's root at the time the intersector
+/// is created; skinned and morphed meshes contribute their bind pose. Points and lines are ignored. Create a new
+/// intersector after changing the scene. Queries do not modify the intersector and may be made from any thread.
+GLTFKIT2_EXPORT
+@interface GLTFSceneRayIntersector : NSObject
+
+@property (nonatomic, readonly) GLTFScene *scene;
+@property (nonatomic, readonly) NSInteger triangleCount;
+
+/// Gathers the triangles of `scene` and builds the hierarchy over them, in parallel for large scenes. Returns nil
+/// and sets `error` if a primitive has invalid positions or indices.
+- (nullable instancetype)initWithScene:(GLTFScene *)scene error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Returns the nearest triangle, facing either way, that the ray from `origin` along `direction` hits within
+/// `maxDistance` multiples of `direction`, or nil if it hits none.
+- (nullable GLTFSceneRayHit *)closestHitWithOrigin:(simd_float3)origin
+                                         direction:(simd_float3)direction
+                                       maxDistance:(float)maxDistance;
+
+/// Returns the first triangle found that the ray hits within `maxDistance`, which need not be the nearest, or nil if
+/// it hits none. This is faster than `closestHitWithOrigin:direction:maxDistance:` for occlusion tests.
+- (nullable GLTFSceneRayHit *)anyHitWithOrigin:(simd_float3)origin
+                                     direction:(simd_float3)direction
+                                   maxDistance:(float)maxDistance;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,1466 @@
+
+#import "GLTFSceneProcessing.h"
+#import "GLTFAccessorViewSupport.h"
+#import "GLTFLogging.h"
+
+#include "GLTFBVH.h"
+#include "GLTFInstancing.h"
+#include "GLTFQuantization.h"
+#include "GLTFStaticBatching.h"
+#include "GLTFVectorMath.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+static NSString *const GLTFExtensionEXTMeshGPUInstancing = @"EXT_mesh_gpu_instancing";
+static NSString *const GLTFExtensionKHRMeshQuantization = @"KHR_mesh_quantization";
+static NSString *const GLTFExtensionKHRTextureTransform = @"KHR_texture_transform";
+
+static NSError *GLTFSceneProcessingError(NSString *description) {
+    return [NSError errorWithDomain:GLTFErrorDomain code:GLTFErrorCodeInvalidGLTF userInfo:@{
+        NSLocalizedDescriptionKey : description
+    }];
+}
+
+// Adds `accessors`, with their buffer views and buffers, to the asset's arrays.
+static void GLTFAssetAddAccessors(GLTFAsset *asset, NSArray<GLTFAccessor *> *newAccessors) {
+    NSMutableArray<GLTFAccessor *> *accessors = [asset.accessors mutableCopy];
+    NSMutableArray<GLTFBufferView *> *bufferViews = [asset.bufferViews mutableCopy];
+    NSMutableArray<GLTFBuffer *> *buffers = [asset.buffers mutableCopy];
+    for (GLTFAccessor *accessor in newAccessors) {
+        [accessors addObject:accessor];
+        [bufferViews addObject:accessor.bufferView];
+        [buffers addObject:accessor.bufferView.buffer];
+    }
+    asset.accessors = accessors;
+    asset.bufferViews = bufferViews;
+    asset.buffers = buffers;
+}
+
+static void GLTFCollectSubtree(GLTFNode *node, NSMutableSet<GLTFNode *> *nodes) {
+    [nodes addObject:node];
+    for (GLTFNode *child in node.childNodes) {
+        GLTFCollectSubtree(child, nodes);
+    }
+}
+
+// Returns the nodes whose transforms can change: those targeted by transform animations, and skinning joints. If
+// `includeMorphingNodes` is YES, nodes whose morph weights are animated are included too, for passes that would
+// otherwise freeze their weights; passes that only depend on transforms leave them out, so as not to give up the
+// nodes beneath them.
+static NSSet<GLTFNode *> *GLTFMovingNodesInAsset(GLTFAsset *asset, BOOL includeMorphingNodes) {
+    NSMutableSet<GLTFNode *> *movingNodes = [NSMutableSet set];
+    for (GLTFAnimation *animation in asset.animations) {
+        for (GLTFAnimationChannel *channel in animation.channels) {
+            if (channel.target.node &&
+                (includeMorphingNodes || ![channel.target.path isEqualToString:GLTFAnimationPathWeights]))
+            {
+                [movingNodes addObject:channel.target.node];
+            }
+        }
+    }
+    for (GLTFSkin *skin in asset.skins) {
+        [movingNodes addObjectsFromArray:skin.joints];
+    }
+    return movingNodes;
+}
+
+// Returns the nodes of every scene of `asset` other than `scene`, which a pass over `scene` must leave alone.
+static NSSet<GLTFNode *> *GLTFNodesInOtherScenes(GLTFAsset *asset, GLTFScene *scene) {
+    NSMutableSet<GLTFNode *> *nodes = [NSMutableSet set];
+    for (GLTFScene *otherScene in asset.scenes) {
+        if (otherScene != scene) {
+            for (GLTFNode *root in otherScene.nodes) {
+                GLTFCollectSubtree(root, nodes);
+            }
+        }
+    }
+    return nodes;
+}
+
+@implementation GLTFStaticBatchRange
+
+- (instancetype)initWithNode:(GLTFNode *)node
+             sourcePrimitive:(GLTFPrimitive *)sourcePrimitive
+                 indexOffset:(NSInteger)indexOffset
+                  indexCount:(NSInteger)indexCount
+                vertexOffset:(NSInteger)vertexOffset
+                 vertexCount:(NSInteger)vertexCount
+{
+    if (self = [super init]) {
+        _node = node;
+        _sourcePrimitive = sourcePrimitive;
+        _indexOffset = indexOffset;
+        _indexCount = indexCount;
+        _vertexOffset = vertexOffset;
+        _vertexCount = vertexCount;
+    }
+    return self;
+}
+
+@end
+
+@implementation GLTFStaticBatch
+
+- (instancetype)initWithNode:(GLTFNode *)node
+                   primitive:(GLTFPrimitive *)primitive
+                      ranges:(NSArray<GLTFStaticBatchRange *> *)ranges
+{
+    if (self = [super init]) {
+        _node = node;
+        _primitive = primitive;
+        _ranges = [ranges copy];
+    }
+    return self;
+}
+
+- (GLTFStaticBatchRange *)rangeContainingIndexOffset:(NSInteger)indexOffset {
+    NSInteger lo = 0, hi = (NSInteger)self.ranges.count;
+    while (lo < hi) {
+        NSInteger mid = (lo + hi) / 2;
+        if (self.ranges[mid].indexOffset + self.ranges[mid].indexCount <= indexOffset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < (NSInteger)self.ranges.count && self.ranges[lo].indexOffset <= indexOffset) {
+        return self.ranges[lo];
+    }
+    return nil;
+}
+
+@end
+
+// A primitive of a static node, with its indices as a list
+struct GLTFStaticBatchCandidate {
+    GLTFNode *node;
+    GLTFPrimitive *primitive;
+    simd_float4x4 transform;
+    std::vector<uint32_t> indices;
+};
+
+struct GLTFStaticBatchGroup {
+    GLTFMaterial *material;
+    GLTFPrimitiveType primitiveType;
+    NSArray<NSString *> *attributeNames;
+    std::vector<size_t> candidates;
+};
+
+// Returns the attribute names of `primitive` in a canonical order, or nil if its positions, normals or tangents
+// cannot be transformed in place.
+static NSArray<NSString *> *GLTFBatchableAttributeNames(GLTFPrimitive *primitive) {
+    GLTFAccessor *positions = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+    GLTFAccessor *normals = [primitive attributeForName:GLTFAttributeSemanticNormal].accessor;
+    GLTFAccessor *tangents = [primitive attributeForName:GLTFAttributeSemanticTangent].accessor;
+    if (positions == nil || positions.componentType != GLTFComponentTypeFloat ||
+        positions.dimension != GLTFValueDimensionVector3 ||
+        (normals && (normals.componentType != GLTFComponentTypeFloat || normals.dimension != GLTFValueDimensionVector3)) ||
+        (tangents && (tangents.componentType != GLTFComponentTypeFloat || tangents.dimension != GLTFValueDimensionVector4)))
+    {
+        return nil;
+    }
+    NSMutableArray<NSString *> *names = [NSMutableArray arrayWithCapacity:primitive.attributes.count];
+    for (GLTFAttribute *attribute in primitive.attributes) {
+        [names addObject:attribute.name];
+    }
+    return [names sortedArrayUsingSelector:@selector(compare:)];
+}
+
+// Returns a key that is equal for primitives that can share a batch.
+static NSString *GLTFStaticBatchKey(GLTFPrimitive *primitive, GLTFPrimitiveType listType,
+                                    NSArray<NSString *> *attributeNames)
+{
+    NSMutableString *key = [NSMutableString stringWithFormat:@"%p/%ld", primitive.material, (long)listType];
+    for (NSString *name in attributeNames) {
+        GLTFAccessor *accessor = [primitive attributeForName:name].accessor;
+        [key appendFormat:@"/%@:%ld:%ld:%d", name, (long)accessor.componentType, (long)accessor.dimension,
+                          (int)accessor.isNormalized];
+    }
+    return key;
+}
+
+static GLTF::BatchAttributeTransform GLTFBatchTransformForAttribute(NSString *name) {
+    if ([name isEqualToString:GLTFAttributeSemanticPosition]) {
+        return GLTF::BatchAttributeTransformPoint;
+    } else if ([name isEqualToString:GLTFAttributeSemanticNormal]) {
+        return GLTF::BatchAttributeTransformNormal;
+    } else if ([name isEqualToString:GLTFAttributeSemanticTangent]) {
+        return GLTF::BatchAttributeTransformTangent;
+    }
+    return GLTF::BatchAttributeTransformNone;
+}
+
+static bool GLTFListIndicesForPrimitive(GLTFPrimitive *primitive, GLTFPrimitiveType *outListType,
+                                        std::vector<uint32_t> &outIndices)
+{
+    NSInteger indexCount = 0, bytesPerIndex = 0;
+    NSData *indexData = GLTFIndexDataForPrimitive(primitive, GLTFIndexConversionOptionNone,
+                                                  outListType, &indexCount, &bytesPerIndex);
+    if (indexData == nil || indexCount == 0) {
+        return false;
+    }
+    outIndices.resize(indexCount);
+    if (bytesPerIndex == sizeof(uint16_t)) {
+        GLTF::ConvertIndices((const uint16_t *)indexData.bytes, indexCount, outIndices.data());
+    } else {
+        memcpy(outIndices.data(), indexData.bytes, indexCount * sizeof(uint32_t));
+    }
+    return true;
+}
+
+struct GLTFStaticBatchCollector {
+    NSSet<GLTFNode *> *movingNodes;
+    NSSet<GLTFNode *> *sharedNodes;
+    NSMutableDictionary<NSString *, NSNumber *> *groupIndexForKey;
+    std::vector<GLTFStaticBatchCandidate> candidates;
+    std::vector<GLTFStaticBatchGroup> groups;
+};
+
+// Adds the batchable primitives of the static nodes in the subtree at `node` to `collector`, grouped by batch key.
+// Returns false and sets `error` if a primitive has invalid indices.
+static bool GLTFCollectStaticBatchCandidates(GLTFNode *node, simd_float4x4 parentTransform,
+                                             GLTFStaticBatchCollector &collector, NSError **error)
+{
+    if ([collector.movingNodes containsObject:node]) {
+        return true;
+    }
+    const simd_float4x4 transform = simd_mul(parentTransform, node.matrix);
+    if (node.mesh && node.skin == nil && node.meshInstances == nil && ![collector.sharedNodes containsObject:node]) {
+        for (GLTFPrimitive *primitive in node.mesh.primitives) {
+            if (primitive.targets.count > 0 || primitive.materialMappings.count > 0) {
+                continue;
+            }
+            NSArray<NSString *> *attributeNames = GLTFBatchableAttributeNames(primitive);
+            if (attributeNames == nil) {
+                continue;
+            }
+            if (!GLTFValidatePrimitiveIndices(primitive, error)) {
+                return false;
+            }
+            GLTFStaticBatchCandidate candidate;
+            GLTFPrimitiveType listType = GLTFPrimitiveTypeInvalid;
+            if (!GLTFListIndicesForPrimitive(primitive, &listType, candidate.indices)) {
+                continue;
+            }
+            candidate.node = node;
+            candidate.primitive = primitive;
+            candidate.transform = transform;
+            NSString *key = GLTFStaticBatchKey(primitive, listType, attributeNames);
+            NSNumber *groupIndex = collector.groupIndexForKey[key];
+            if (groupIndex == nil) {
+                groupIndex = @(collector.groups.size());
+                collector.groupIndexForKey[key] = groupIndex;
+                GLTFStaticBatchGroup group;
+                group.material = primitive.material;
+                group.primitiveType = listType;
+                group.attributeNames = attributeNames;
+                collector.groups.push_back(group);
+            }
+            collector.groups[groupIndex.unsignedIntegerValue].candidates.push_back(collector.candidates.size());
+            collector.candidates.push_back(std::move(candidate));
+        }
+    }
+    for (GLTFNode *child in node.childNodes) {
+        if (!GLTFCollectStaticBatchCandidates(child, transform, collector, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+NSArray<GLTFStaticBatch *> *GLTFSceneBuildStaticBatches(GLTFAsset *asset, GLTFScene *scene, NSError **error) {
+    // Nodes that move, or that are shared with other scenes, cannot be baked into this scene's batches
+    GLTFStaticBatchCollector collector;
+    collector.movingNodes = GLTFMovingNodesInAsset(asset, NO);
+    collector.sharedNodes = GLTFNodesInOtherScenes(asset, scene);
+    collector.groupIndexForKey = [NSMutableDictionary dictionary];
+    for (GLTFNode *root in scene.nodes) {
+        if (!GLTFCollectStaticBatchCandidates(root, matrix_identity_float4x4, collector, error)) {
+            return nil;
+        }
+    }
+    const std::vector<GLTFStaticBatchCandidate> &candidates = collector.candidates;
+
+    // Build every batch before changing the asset, so that a failure leaves it untouched
+    NSMutableArray<GLTFStaticBatch *> *batches = [NSMutableArray array];
+    NSMutableArray<GLTFAccessor *> *newAccessors = [NSMutableArray array];
+    NSMapTable<GLTFNode *, NSMutableSet<GLTFPrimitive *> *> *batchedPrimitivesForNode = [NSMapTable strongToStrongObjectsMapTable];
+    NSUInteger batchedPrimitiveCount = 0;
+    for (const GLTFStaticBatchGroup &group : collector.groups) {
+        if (group.candidates.size() < 2) {
+            continue;
+        }
+        NSMutableArray<NSData *> *storage = [NSMutableArray array];
+        std::vector<GLTF::BatchSource> sources(group.candidates.size());
+        std::vector<GLTF::BatchAttributeTransform> transforms;
+        for (NSString *name in group.attributeNames) {
+            transforms.push_back(GLTFBatchTransformForAttribute(name));
+        }
+        for (size_t s = 0; s < sources.size(); ++s) {
+            const GLTFStaticBatchCandidate &candidate = candidates[group.candidates[s]];
+            GLTF::BatchSource &source = sources[s];
+            for (NSString *name in group.attributeNames) {
+                NSData *accessorStorage = nil;
+                GLTFAccessor *accessor = [candidate.primitive attributeForName:name].accessor;
+                source.attributes.push_back(GLTFAccessorViewForAccessor(accessor, &accessorStorage));
+                if (accessorStorage) {
+                    [storage addObject:accessorStorage];
+                }
+            }
+            source.indices = candidate.indices.data();
+            source.indexCount = candidate.indices.size();
+            memcpy(source.transform, &candidate.transform, sizeof(source.transform));
+        }
+        GLTF::StaticBatch staticBatch;
+        if (!GLTF::BuildStaticBatch(sources, transforms, (group.primitiveType == GLTFPrimitiveTypeTriangles) ? 3 : 1,
+                                    staticBatch))
+        {
+            if (error) {
+                *error = GLTFSceneProcessingError(@"Could not batch primitives whose attributes are unreadable, "
+                                                  @"differ in length, or exceed 32-bit indexing");
+            }
+            return nil;
+        }
+
+        const size_t vertexCount = staticBatch.ranges.back().vertexOffset + staticBatch.ranges.back().vertexCount;
+        NSMutableArray<GLTFAttribute *> *attributes = [NSMutableArray array];
+        for (size_t a = 0; a < group.attributeNames.count; ++a) {
+            GLTFAccessor *sourceAccessor = [candidates[group.candidates[0]].primitive attributeForName:group.attributeNames[a]].accessor;
+            const std::vector<uint8_t> &bytes = staticBatch.attributes[a];
+            GLTFAccessor *accessor = GLTFNewAccessorWithData([NSData dataWithBytes:bytes.data() length:bytes.size()],
+                                                             sourceAccessor.componentType, sourceAccessor.dimension,
+                                                             sourceAccessor.isNormalized, vertexCount);
+            if (transforms[a] == GLTF::BatchAttributeTransformPoint) {
+                NSArray<NSNumber *> *minValues = nil, *maxValues = nil;
+                if (GLTFAccessorComputeBounds(accessor, &minValues, &maxValues)) {
+                    accessor.minValues = minValues;
+                    accessor.maxValues = maxValues;
+                }
+            }
+            [attributes addObject:[[GLTFAttribute alloc] initWithName:group.attributeNames[a] accessor:accessor]];
+            [newAccessors addObject:accessor];
+        }
+        GLTFAccessor *indexAccessor = GLTFNewIndexAccessor(staticBatch.indices, vertexCount);
+        [newAccessors addObject:indexAccessor];
+
+        GLTFPrimitive *primitive = [[GLTFPrimitive alloc] initWithPrimitiveType:group.primitiveType
+                                                                     attributes:attributes
+                                                                        indices:indexAccessor];
+        primitive.material = group.material;
+        primitive.boundingBox = GLTFBoundingBoxForPrimitive(primitive);
+
+        NSMutableArray<GLTFStaticBatchRange *> *ranges = [NSMutableArray arrayWithCapacity:sources.size()];
+        for (size_t s = 0; s < sources.size(); ++s) {
+            const GLTFStaticBatchCandidate &candidate = candidates[group.candidates[s]];
+            const GLTF::BatchRange &range = staticBatch.ranges[s];
+            [ranges addObject:[[GLTFStaticBatchRange alloc] initWithNode:candidate.node
+                                                         sourcePrimitive:candidate.primitive
+                                                             indexOffset:range.indexOffset
+                                                              indexCount:range.indexCount
+                                                            vertexOffset:range.vertexOffset
+                                                             vertexCount:range.vertexCount]];
+            NSMutableSet<GLTFPrimitive *> *batchedPrimitives = [batchedPrimitivesForNode objectForKey:candidate.node];
+            if (batchedPrimitives == nil) {
+                batchedPrimitives = [NSMutableSet set];
+                [batchedPrimitivesForNode setObject:batchedPrimitives forKey:candidate.node];
+            }
+            [batchedPrimitives addObject:candidate.primitive];
+        }
+
+        batchedPrimitiveCount += sources.size();
+
+        NSString *name = [NSString stringWithFormat:@"Static Batch %lu", (unsigned long)batches.count];
+        GLTFMesh *mesh = [[GLTFMesh alloc] initWithPrimitives:@[ primitive ]];
+        mesh.name = name;
+        GLTFNode *node = [[GLTFNode alloc] init];
+        node.name = name;
+        node.mesh = mesh;
+        [batches addObject:[[GLTFStaticBatch alloc] initWithNode:node primitive:primitive ranges:ranges]];
+    }
+    if (batches.count == 0) {
+        return batches;
+    }
+
+    // Detach batched primitives from their nodes, giving each node a mesh of whatever remains
+    NSMutableArray<GLTFMesh *> *meshes = [asset.meshes mutableCopy];
+    for (GLTFNode *node in batchedPrimitivesForNode) {
+        NSSet<GLTFPrimitive *> *batchedPrimitives = [batchedPrimitivesForNode objectForKey:node];
+        NSMutableArray<GLTFPrimitive *> *remainingPrimitives = [NSMutableArray array];
+        for (GLTFPrimitive *primitive in node.mesh.primitives) {
+            if (![batchedPrimitives containsObject:primitive]) {
+                [remainingPrimitives addObject:primitive];
+            }
+        }
+        if (remainingPrimitives.count == 0) {
+            node.mesh = nil;
+            continue;
+        }
+        GLTFMesh *remainingMesh = [[GLTFMesh alloc] initWithPrimitives:remainingPrimitives];
+        remainingMesh.name = node.mesh.name;
+        remainingMesh.weights = node.mesh.weights;
+        remainingMesh.targetNames = node.mesh.targetNames;
+        node.mesh = remainingMesh;
+        [meshes addObject:remainingMesh];
+    }
+    NSMutableArray<GLTFNode *> *nodes = [asset.nodes mutableCopy];
+    NSMutableArray<GLTFNode *> *sceneNodes = [scene.nodes mutableCopy];
+    for (GLTFStaticBatch *batch in batches) {
+        [meshes addObject:batch.node.mesh];
+        [nodes addObject:batch.node];
+        [sceneNodes addObject:batch.node];
+    }
+    asset.meshes = meshes;
+    asset.nodes = nodes;
+    scene.nodes = sceneNodes;
+    GLTFAssetAddAccessors(asset, newAccessors);
+
+    GLTFLogInfo(@"[GLTFKit2] Merged %lu static primitives into %lu batches",
+                (unsigned long)batchedPrimitiveCount, (unsigned long)batches.count);
+    return batches;
+}
+
+// Content hashes of the accessors used by meshes, computed once each and in parallel
+class GLTFAccessorHashTable {
+public:
+    explicit GLTFAccessorHashTable(NSArray<GLTFMesh *> *meshes) {
+        accessorIndices = [NSMapTable strongToStrongObjectsMapTable];
+        accessors = [NSMutableArray array];
+        for (GLTFMesh *mesh in meshes) {
+            for (GLTFPrimitive *primitive in mesh.primitives) {
+                add(primitive.indices);
+                for (GLTFAttribute *attribute in primitive.attributes) {
+                    add(attribute.accessor);
+                }
+                for (GLTFMorphTarget *target in primitive.targets) {
+                    for (GLTFAttribute *attribute in target) {
+                        add(attribute.accessor);
+                    }
+                }
+            }
+        }
+        hashes.resize(accessors.count);
+        NSArray<GLTFAccessor *> *allAccessors = accessors;
+        uint64_t *hashData = hashes.data();
+        dispatch_apply(allAccessors.count, DISPATCH_APPLY_AUTO, ^(size_t i) {
+            NSData *storage = nil;
+            hashData[i] = GLTF::HashAccessorData(GLTFAccessorViewForAccessor(allAccessors[i], &storage));
+        });
+    }
+
+    uint64_t hashForAccessor(GLTFAccessor *accessor) const {
+        NSNumber *index = (accessor != nil) ? [accessorIndices objectForKey:accessor] : nil;
+        return (index != nil) ? hashes[index.unsignedIntegerValue] : 0;
+    }
+
+private:
+    NSMapTable<GLTFAccessor *, NSNumber *> *accessorIndices;
+    NSMutableArray<GLTFAccessor *> *accessors;
+    std::vector<uint64_t> hashes;
+
+    void add(GLTFAccessor *accessor) {
+        if (accessor != nil && [accessorIndices objectForKey:accessor] == nil) {
+            [accessorIndices setObject:@(accessors.count) forKey:accessor];
+            [accessors addObject:accessor];
+        }
+    }
+};
+
+static inline uint64_t GLTFCombineHash(uint64_t hash, uint64_t value) {
+    return (hash ^ value) * 0x100000001b3ull + (hash >> 29);
+}
+
+static uint64_t GLTFAttributesHash(NSArray<GLTFAttribute *> *attributes, const GLTFAccessorHashTable &table) {
+    uint64_t hash = attributes.count;
+    for (GLTFAttribute *attribute in attributes) {
+        hash = GLTFCombineHash(hash, attribute.name.hash);
+        hash = GLTFCombineHash(hash, table.hashForAccessor(attribute.accessor));
+    }
+    return hash;
+}
+
+static uint64_t GLTFMeshContentHash(GLTFMesh *mesh, const GLTFAccessorHashTable &table) {
+    uint64_t hash = GLTFCombineHash(mesh.primitives.count, mesh.weights.hash);
+    for (GLTFPrimitive *primitive in mesh.primitives) {
+        hash = GLTFCombineHash(hash, (uint64_t)primitive.primitiveType);
+        hash = GLTFCombineHash(hash, (uint64_t)(uintptr_t)(__bridge void *)primitive.material);
+        hash = GLTFCombineHash(hash, table.hashForAccessor(primitive.indices));
+        hash = GLTFCombineHash(hash, GLTFAttributesHash(primitive.attributes, table));
+        for (GLTFMorphTarget *target in primitive.targets) {
+            hash = GLTFCombineHash(hash, GLTFAttributesHash(target, table));
+        }
+    }
+    return hash;
+}
+
+static BOOL GLTFAccessorContentsEqual(GLTFAccessor *a, GLTFAccessor *b) {
+    if (a == b) {
+        return YES;
+    }
+    if (a == nil || b == nil) {
+        return NO;
+    }
+    NSData *storageA = nil, *storageB = nil;
+    return GLTF::AccessorDataEqual(GLTFAccessorViewForAccessor(a, &storageA), GLTFAccessorViewForAccessor(b, &storageB));
+}
+
+static BOOL GLTFAttributesEqual(NSArray<GLTFAttribute *> *a, NSArray<GLTFAttribute *> *b) {
+    if (a.count != b.count) {
+        return NO;
+    }
+    for (GLTFAttribute *attribute in a) {
+        GLTFAttribute *other = nil;
+        for (GLTFAttribute *candidate in b) {
+            if ([candidate.name isEqualToString:attribute.name]) {
+                other = candidate;
+                break;
+            }
+        }
+        if (other == nil || !GLTFAccessorContentsEqual(attribute.accessor, other.accessor)) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+static BOOL GLTFMaterialMappingsEqual(NSArray<GLTFMaterialMapping *> *a, NSArray<GLTFMaterialMapping *> *b) {
+    if (a.count != b.count) {
+        return NO;
+    }
+    for (NSUInteger i = 0; i < a.count; ++i) {
+        if (a[i].material != b[i].material || a[i].variant != b[i].variant) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+static BOOL GLTFMeshContentsEqual(GLTFMesh *a, GLTFMesh *b) {
+    if (a.primitives.count != b.primitives.count || !(a.weights == b.weights || [a.weights isEqualToArray:b.weights])) {
+        return NO;
+    }
+    for (NSUInteger i = 0; i < a.primitives.count; ++i) {
+        GLTFPrimitive *p = a.primitives[i], *q = b.primitives[i];
+        if (p.primitiveType != q.primitiveType || p.material != q.material || p.targets.count != q.targets.count ||
+            !GLTFMaterialMappingsEqual(p.materialMappings, q.materialMappings) ||
+            !GLTFAccessorContentsEqual(p.indices, q.indices) || !GLTFAttributesEqual(p.attributes, q.attributes))
+        {
+            return NO;
+        }
+        for (NSUInteger t = 0; t < p.targets.count; ++t) {
+            if (!GLTFAttributesEqual(p.targets[t], q.targets[t])) {
+                return NO;
+            }
+        }
+    }
+    return YES;
+}
+
+// Maps each mesh of `meshes` whose contents equal those of an earlier mesh to the first such mesh. Names are not
+// compared, since exporters give copies distinct names (such as "Bolt" and "Bolt.001").
+static NSMapTable<GLTFMesh *, GLTFMesh *> *GLTFCanonicalMeshesForDuplicates(NSArray<GLTFMesh *> *meshes) {
+    const GLTFAccessorHashTable table(meshes);
+    NSMutableDictionary<NSNumber *, NSMutableArray<GLTFMesh *> *> *canonicalMeshesForHash = [NSMutableDictionary dictionary];
+    NSMapTable<GLTFMesh *, GLTFMesh *> *canonicalMeshForMesh = [NSMapTable strongToStrongObjectsMapTable];
+    for (GLTFMesh *mesh in meshes) {
+        NSNumber *hash = @(GLTFMeshContentHash(mesh, table));
+        NSMutableArray<GLTFMesh *> *candidates = canonicalMeshesForHash[hash];
+        if (candidates == nil) {
+            candidates = [NSMutableArray array];
+            canonicalMeshesForHash[hash] = candidates;
+        }
+        GLTFMesh *canonicalMesh = nil;
+        for (GLTFMesh *candidate in candidates) {
+            if (GLTFMeshContentsEqual(mesh, candidate)) {
+                canonicalMesh = candidate;
+                break;
+            }
+        }
+        if (canonicalMesh) {
+            [canonicalMeshForMesh setObject:canonicalMesh forKey:mesh];
+        } else {
+            [candidates addObject:mesh];
+        }
+    }
+    return canonicalMeshForMesh;
+}
+
+NSInteger GLTFAssetMergeDuplicateMeshes(GLTFAsset *asset) {
+    NSMapTable<GLTFMesh *, GLTFMesh *> *canonicalMeshForMesh = GLTFCanonicalMeshesForDuplicates(asset.meshes);
+    if (canonicalMeshForMesh.count == 0) {
+        return 0;
+    }
+    for (GLTFNode *node in asset.nodes) {
+        GLTFMesh *canonicalMesh = node.mesh ? [canonicalMeshForMesh objectForKey:node.mesh] : nil;
+        if (canonicalMesh) {
+            node.mesh = canonicalMesh;
+        }
+    }
+    NSMutableArray<GLTFMesh *> *meshes = [NSMutableArray arrayWithCapacity:asset.meshes.count];
+    for (GLTFMesh *mesh in asset.meshes) {
+        if ([canonicalMeshForMesh objectForKey:mesh] == nil) {
+            [meshes addObject:mesh];
+        }
+    }
+    asset.meshes = meshes;
+    GLTFLogInfo(@"[GLTFKit2] Merged %lu meshes with duplicate contents", (unsigned long)canonicalMeshForMesh.count);
+    return (NSInteger)canonicalMeshForMesh.count;
+}
+
+// Decompositions that reproduce a transform to within this fraction of its largest element are exact enough
+static const float GLTFInstanceTransformTolerance = 1e-4f;
+
+// Nodes that draw the same mesh, with their transforms relative to a common anchor
+struct GLTFInstanceGroup {
+    GLTFNode *anchor; // The nearest moving ancestor, or nil for the scene root
+    GLTFMesh *mesh;
+    NSMutableArray<GLTFNode *> *nodes;
+    std::vector<simd_float4x4> transforms;
+};
+
+// Instances share one set of morph weights, so meshes with morph targets are never instanced
+static BOOL GLTFMeshHasMorphTargets(GLTFMesh *mesh) {
+    for (GLTFPrimitive *primitive in mesh.primitives) {
+        if (primitive.targets.count > 0) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+struct GLTFInstanceCollector {
+    NSSet<GLTFNode *> *movingNodes;
+    NSSet<GLTFNode *> *sharedNodes;
+    NSMutableDictionary<NSString *, NSNumber *> *groupIndexForKey;
+    std::vector<GLTFInstanceGroup> groups;
+};
+
+// Groups the nodes in the subtree at `node` that can become instances. `transform` is the transform of the parent
+// of `node` relative to `anchor`, which is constant because no node between them moves.
+static void GLTFCollectInstanceCandidates(GLTFNode *node, GLTFNode *anchor, simd_float4x4 transform,
+                                          GLTFInstanceCollector &collector)
+{
+    if ([collector.sharedNodes containsObject:node]) {
+        return;
+    }
+    const BOOL moves = [collector.movingNodes containsObject:node];
+    transform = simd_mul(transform, node.matrix);
+    if (node.mesh && !moves && node.skin == nil && node.meshInstances == nil && !GLTFMeshHasMorphTargets(node.mesh)) {
+        NSString *key = [NSString stringWithFormat:@"%p/%p", anchor, node.mesh];
+        NSNumber *groupIndex = collector.groupIndexForKey[key];
+        if (groupIndex == nil) {
+            groupIndex = @(collector.groups.size());
+            collector.groupIndexForKey[key] = groupIndex;
+            GLTFInstanceGroup group;
+            group.anchor = anchor;
+            group.mesh = node.mesh;
+            group.nodes = [NSMutableArray array];
+            collector.groups.push_back(group);
+        }
+        GLTFInstanceGroup &group = collector.groups[groupIndex.unsignedIntegerValue];
+        [group.nodes addObject:node];
+        group.transforms.push_back(transform);
+    }
+    for (GLTFNode *child in node.childNodes) {
+        if (moves) {
+            GLTFCollectInstanceCandidates(child, node, matrix_identity_float4x4, collector);
+        } else {
+            GLTFCollectInstanceCandidates(child, anchor, transform, collector);
+        }
+    }
+}
+
+// Joins the groups under the same anchor whose meshes have identical contents, so that copies of a mesh (which
+// exporters often write as separate meshes) are instanced together. Each joined group draws its first mesh.
+static void GLTFMergeInstanceGroupsOfDuplicateMeshes(std::vector<GLTFInstanceGroup> &groups) {
+    NSMutableArray<GLTFMesh *> *meshes = [NSMutableArray array];
+    NSMutableSet<GLTFMesh *> *seenMeshes = [NSMutableSet set];
+    for (const GLTFInstanceGroup &group : groups) {
+        if (![seenMeshes containsObject:group.mesh]) {
+            [seenMeshes addObject:group.mesh];
+            [meshes addObject:group.mesh];
+        }
+    }
+    NSMapTable<GLTFMesh *, GLTFMesh *> *canonicalMeshForMesh = GLTFCanonicalMeshesForDuplicates(meshes);
+    if (canonicalMeshForMesh.count == 0) {
+        return;
+    }
+    std::vector<GLTFInstanceGroup> mergedGroups;
+    NSMutableDictionary<NSString *, NSNumber *> *groupIndexForKey = [NSMutableDictionary dictionary];
+    for (const GLTFInstanceGroup &group : groups) {
+        GLTFMesh *mesh = [canonicalMeshForMesh objectForKey:group.mesh] ?: group.mesh;
+        NSString *key = [NSString stringWithFormat:@"%p/%p", group.anchor, mesh];
+        NSNumber *groupIndex = groupIndexForKey[key];
+        if (groupIndex == nil) {
+            groupIndexForKey[key] = @(mergedGroups.size());
+            GLTFInstanceGroup mergedGroup = group;
+            mergedGroup.mesh = mesh;
+            mergedGroup.nodes = [group.nodes mutableCopy];
+            mergedGroups.push_back(mergedGroup);
+            continue;
+        }
+        GLTFInstanceGroup &mergedGroup = mergedGroups[groupIndex.unsignedIntegerValue];
+        [mergedGroup.nodes addObjectsFromArray:group.nodes];
+        mergedGroup.transforms.insert(mergedGroup.transforms.end(), group.transforms.begin(), group.transforms.end());
+    }
+    groups.swap(mergedGroups);
+}
+
+static GLTFAccessor *GLTFNewFloatAccessor(const std::vector<float> &values, GLTFValueDimension dimension,
+                                          NSInteger count)
+{
+    NSData *data = [NSData dataWithBytes:values.data() length:values.size() * sizeof(float)];
+    return GLTFNewAccessorWithData(data, GLTFComponentTypeFloat, dimension, NO, count);
+}
+
+NSArray<GLTFNode *> *GLTFSceneCreateMeshInstances(GLTFAsset *asset, GLTFScene *scene, NSInteger minimumInstanceCount) {
+    GLTFInstanceCollector collector;
+    collector.movingNodes = GLTFMovingNodesInAsset(asset, YES);
+    collector.sharedNodes = GLTFNodesInOtherScenes(asset, scene);
+    collector.groupIndexForKey = [NSMutableDictionary dictionary];
+    for (GLTFNode *root in scene.nodes) {
+        GLTFCollectInstanceCandidates(root, nil, matrix_identity_float4x4, collector);
+    }
+    GLTFMergeInstanceGroupsOfDuplicateMeshes(collector.groups);
+
+    minimumInstanceCount = MAX(minimumInstanceCount, 2);
+    NSMutableArray<GLTFNode *> *instancingNodes = [NSMutableArray array];
+    NSMutableArray<GLTFAccessor *> *newAccessors = [NSMutableArray array];
+    NSMutableArray<GLTFNode *> *sceneNodes = [scene.nodes mutableCopy];
+    for (const GLTFInstanceGroup &group : collector.groups) {
+        if ((NSInteger)group.nodes.count < minimumInstanceCount) {
+            continue;
+        }
+        GLTF::InstanceTransforms decomposition;
+        GLTF::DecomposeTransforms((const float *)group.transforms.data(), group.transforms.size(),
+                                  GLTFInstanceTransformTolerance, decomposition);
+        // Nodes whose transforms shear stay as they are
+        std::vector<float> translations, rotations, scales;
+        NSMutableArray<GLTFNode *> *instancedNodes = [NSMutableArray array];
+        for (size_t i = 0; i < group.transforms.size(); ++i) {
+            if (decomposition.decomposed[i]) {
+                translations.insert(translations.end(), &decomposition.translations[3 * i], &decomposition.translations[3 * i + 3]);
+                rotations.insert(rotations.end(), &decomposition.rotations[4 * i], &decomposition.rotations[4 * i + 4]);
+                scales.insert(scales.end(), &decomposition.scales[3 * i], &decomposition.scales[3 * i + 3]);
+                [instancedNodes addObject:group.nodes[i]];
+            }
+        }
+        const NSInteger instanceCount = (NSInteger)instancedNodes.count;
+        if (instanceCount < minimumInstanceCount) {
+            continue;
+        }
+
+        NSMutableArray<GLTFAttribute *> *attributes = [NSMutableArray array];
+        GLTFAccessor *translationAccessor = GLTFNewFloatAccessor(translations, GLTFValueDimensionVector3, instanceCount);
+        [attributes addObject:[[GLTFAttribute alloc] initWithName:@"TRANSLATION" accessor:translationAccessor]];
+        [newAccessors addObject:translationAccessor];
+        if (decomposition.hasRotation) {
+            GLTFAccessor *rotationAccessor = GLTFNewFloatAccessor(rotations, GLTFValueDimensionVector4, instanceCount);
+            [attributes addObject:[[GLTFAttribute alloc] initWithName:@"ROTATION" accessor:rotationAccessor]];
+            [newAccessors addObject:rotationAccessor];
+        }
+        if (decomposition.hasScale) {
+            GLTFAccessor *scaleAccessor = GLTFNewFloatAccessor(scales, GLTFValueDimensionVector3, instanceCount);
+            [attributes addObject:[[GLTFAttribute alloc] initWithName:@"SCALE" accessor:scaleAccessor]];
+            [newAccessors addObject:scaleAccessor];
+        }
+        GLTFMeshInstances *meshInstances = [GLTFMeshInstances new];
+        meshInstances.attributes = attributes;
+
+        GLTFNode *instancingNode = [[GLTFNode alloc] init];
+        instancingNode.name = [NSString stringWithFormat:@"%@ Instances", group.mesh.name ?: @"Mesh"];
+        instancingNode.mesh = group.mesh;
+        instancingNode.meshInstances = meshInstances;
+        // The instanced nodes keep their children, cameras and lights, but no longer draw the mesh
+        for (GLTFNode *node in instancedNodes) {
+            node.mesh = nil;
+        }
+        if (group.anchor) {
+            group.anchor.childNodes = [group.anchor.childNodes arrayByAddingObject:instancingNode];
+        } else {
+            [sceneNodes addObject:instancingNode];
+        }
+        [instancingNodes addObject:instancingNode];
+    }
+    if (instancingNodes.count == 0) {
+        return instancingNodes;
+    }
+
+    scene.nodes = sceneNodes;
+    asset.nodes = [asset.nodes arrayByAddingObjectsFromArray:instancingNodes];
+    GLTFAssetAddAccessors(asset, newAccessors);
+    if (![asset.extensionsUsed containsObject:GLTFExtensionEXTMeshGPUInstancing]) {
+        asset.extensionsUsed = [asset.extensionsUsed arrayByAddingObject:GLTFExtensionEXTMeshGPUInstancing];
+    }
+    GLTFLogInfo(@"[GLTFKit2] Created %lu instanced nodes", (unsigned long)instancingNodes.count);
+    return instancingNodes;
+}
+
+// The texture coordinate sets at or above this index are not considered for quantization
+static const NSInteger GLTFMaxTexCoordSetCount = 8;
+
+static GLTFComponentType GLTFComponentTypeForQuantizedFormat(int format) {
+    switch (format) {
+        case GLTF::VertexComponentFormatSNorm8:  return GLTFComponentTypeByte;
+        case GLTF::VertexComponentFormatUNorm8:  return GLTFComponentTypeUnsignedByte;
+        case GLTF::VertexComponentFormatSNorm16: return GLTFComponentTypeShort;
+        default:                                 return GLTFComponentTypeUnsignedShort;
+    }
+}
+
+// Returns the index of the texture coordinate set named by `name`, or -1 if it doesn't name one.
+static NSInteger GLTFTexCoordSetForAttributeName(NSString *name) {
+    static NSString *const prefix = @"TEXCOORD_";
+    if (![name hasPrefix:prefix] || name.length == prefix.length) {
+        return -1;
+    }
+    NSInteger set = [name substringFromIndex:prefix.length].integerValue;
+    return (set < GLTFMaxTexCoordSetCount) ? set : -1;
+}
+
+static NSArray<GLTFTextureParams *> *GLTFTextureParamsForMaterial(GLTFMaterial *material) {
+    GLTFTextureParams *candidates[] = {
+        material.metallicRoughness.baseColorTexture, material.metallicRoughness.metallicRoughnessTexture,
+        material.specularGlossiness.diffuseTexture, material.specularGlossiness.specularGlossinessTexture,
+        material.specular.specularTexture, material.specular.specularColorTexture,
+        material.emissive.emissiveTexture, material.transmission.transmissionTexture,
+        material.diffuseTransmission.diffuseTransmissionTexture,
+        material.diffuseTransmission.diffuseTransmissionColorTexture, material.volume.thicknessTexture,
+        material.clearcoat.clearcoatTexture, material.clearcoat.clearcoatRoughnessTexture,
+        material.clearcoat.clearcoatNormalTexture, material.sheen.sheenColorTexture,
+        material.sheen.sheenRoughnessTexture, material.iridescence.iridescenceTexture,
+        material.iridescence.iridescenceThicknessTexture, material.anisotropy.anisotropyTexture,
+        material.normalTexture, material.occlusionTexture,
+    };
+    NSMutableArray<GLTFTextureParams *> *params = [NSMutableArray array];
+    for (GLTFTextureParams *candidate : candidates) {
+        if (candidate) {
+            [params addObject:candidate];
+        }
+    }
+    return params;
+}
+
+// Returns a new accessor holding `accessor`'s elements quantized with `parameters`, reusing one made earlier with
+// the same parameters, and raises `largestError` to the quantization error. Returns nil and sets `error` if the
+// accessor's data is invalid.
+static GLTFAccessor *GLTFQuantizedAccessor(GLTFAccessor *accessor, const GLTF::QuantizationParameters &parameters,
+                                           NSMutableDictionary<NSString *, GLTFAccessor *> *quantizedAccessors,
+                                           float &largestError, NSError **error)
+{
+    NSString *key = [NSString stringWithFormat:@"%p/%d/%g,%g,%g,%g/%g,%g,%g,%g", accessor, parameters.format,
+                     parameters.offset[0], parameters.offset[1], parameters.offset[2], parameters.offset[3],
+                     parameters.scale[0], parameters.scale[1], parameters.scale[2], parameters.scale[3]];
+    GLTFAccessor *quantized = quantizedAccessors[key];
+    if (quantized) {
+        return quantized;
+    }
+    NSData *storage = nil;
+    const GLTF::AccessorView view = GLTFAccessorViewForAccessor(accessor, &storage);
+    if (!view.isValid() || view.componentCount > 4) {
+        if (error) {
+            *error = GLTFSceneProcessingError(@"Vertex attribute has invalid data");
+        }
+        return nil;
+    }
+    const size_t stride = GLTF::QuantizedStride(parameters.format, view.componentCount);
+    NSMutableData *data = [NSMutableData dataWithLength:stride * view.count];
+    largestError = std::max(largestError,
+                            GLTF::QuantizeVertexStream(view, parameters, (uint8_t *)data.mutableBytes));
+    GLTFBuffer *buffer = [[GLTFBuffer alloc] initWithData:data];
+    GLTFBufferView *bufferView = [[GLTFBufferView alloc] initWithBuffer:buffer
+                                                                 length:data.length
+                                                                 offset:0
+                                                                 stride:(NSInteger)stride];
+    quantized = [[GLTFAccessor alloc] initWithBufferView:bufferView
+                                                  offset:0
+                                           componentType:GLTFComponentTypeForQuantizedFormat(parameters.format)
+                                               dimension:accessor.dimension
+                                                   count:(NSInteger)view.count
+                                              normalized:YES];
+    NSArray<NSNumber *> *minValues = nil, *maxValues = nil;
+    if (GLTFAccessorComputeBounds(quantized, &minValues, &maxValues)) {
+        quantized.minValues = minValues;
+        quantized.maxValues = maxValues;
+    }
+    quantizedAccessors[key] = quantized;
+    return quantized;
+}
+
+// Returns a float accessor holding the positions of `accessor` scaled by `scale`, or nil if its data is invalid.
+static GLTFAccessor *GLTFScaledPositionAccessor(GLTFAccessor *accessor, float scale) {
+    NSData *storage = nil;
+    const GLTF::AccessorView view = GLTFAccessorViewForAccessor(accessor, &storage);
+    if (!view.isValid()) {
+        return nil;
+    }
+    std::vector<GLTF::Vec3> positions = GLTF::ReadVec3s(view);
+    for (GLTF::Vec3 &p : positions) {
+        p = p * scale;
+    }
+    NSData *data = [NSData dataWithBytes:positions.data() length:positions.size() * sizeof(GLTF::Vec3)];
+    GLTFAccessor *scaled = GLTFNewAccessorWithData(data, GLTFComponentTypeFloat, GLTFValueDimensionVector3, NO,
+                                                   (NSInteger)positions.size());
+    NSArray<NSNumber *> *minValues = nil, *maxValues = nil;
+    if (GLTFAccessorComputeBounds(scaled, &minValues, &maxValues)) {
+        scaled.minValues = minValues;
+        scaled.maxValues = maxValues;
+    }
+    return scaled;
+}
+
+// Maps meshlet bounds into the space of positions quantized about `center` with `scale`; cones are unaffected.
+static GLTFMeshletSet *GLTFMeshletSetWithQuantizedBounds(GLTFMeshletSet *meshlets, simd_float3 center, float scale) {
+    NSMutableData *boundsData = [meshlets.boundsData mutableCopy];
+    GLTFMeshletBounds *bounds = (GLTFMeshletBounds *)boundsData.mutableBytes;
+    for (NSInteger i = 0; i < meshlets.meshletCount; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            bounds[i].center[c] = (bounds[i].center[c] - center[c]) * scale;
+            bounds[i].coneApex[c] = (bounds[i].coneApex[c] - center[c]) * scale;
+        }
+        bounds[i].radius *= scale;
+    }
+    return [[GLTFMeshletSet alloc] initWithMeshletData:meshlets.meshletData
+                                       vertexIndexData:meshlets.vertexIndexData
+                                          triangleData:meshlets.triangleData
+                                            boundsData:boundsData
+                                        maxVertexCount:meshlets.maxVertexCount
+                                      maxTriangleCount:meshlets.maxTriangleCount];
+}
+
+// The union of the ranges of one texture coordinate set over the primitives that draw with one material
+struct GLTFTexCoordRange {
+    simd_float2 minimum = simd_make_float2(FLT_MAX, FLT_MAX);
+    simd_float2 maximum = simd_make_float2(-FLT_MAX, -FLT_MAX);
+    bool compensable = true; // Whether the material's texture transforms can absorb a remapping of the set
+};
+
+struct GLTFMeshQuantization {
+    bool positionsEligible = true;
+    bool drawn = false;
+    simd_float3 center = simd_make_float3(0.0f, 0.0f, 0.0f);
+    float halfExtent = 1.0f;
+};
+
+static bool GLTFTexCoordRangeIsUnit(simd_float2 minimum, simd_float2 maximum) {
+    return minimum.x >= 0.0f && minimum.y >= 0.0f && maximum.x <= 1.0f && maximum.y <= 1.0f;
+}
+
+BOOL GLTFAssetQuantizeMeshes(GLTFAsset *asset,
+                             GLTFQuantizationOptions options,
+                             GLTFQuantizationErrors *outErrors,
+                             NSError **error)
+{
+    GLTFQuantizationErrors errors = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+    // Positions can only be quantized if every node that draws the mesh can carry the dequantization transform
+    std::unordered_map<void *, GLTFMeshQuantization> meshStates;
+    for (GLTFNode *node in asset.nodes) {
+        if (node.mesh) {
+            GLTFMeshQuantization &state = meshStates[(__bridge void *)node.mesh];
+            state.drawn = true;
+            state.positionsEligible = state.positionsEligible && node.skin == nil && node.meshInstances == nil;
+        }
+    }
+    for (GLTFMesh *mesh in asset.meshes) {
+        GLTFMeshQuantization &state = meshStates[(__bridge void *)mesh];
+        state.positionsEligible = state.positionsEligible && state.drawn && (options & GLTFQuantizationOptionPositions);
+        simd_float3 minimum = simd_make_float3(FLT_MAX, FLT_MAX, FLT_MAX);
+        simd_float3 maximum = -minimum;
+        for (GLTFPrimitive *primitive in mesh.primitives) {
+            GLTFAccessor *positions = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+            NSArray<NSNumber *> *minValues = nil, *maxValues = nil;
+            if (positions.componentType != GLTFComponentTypeFloat || positions.dimension != GLTFValueDimensionVector3 ||
+                !GLTFAccessorComputeBounds(positions, &minValues, &maxValues))
+            {
+                state.positionsEligible = false;
+                break;
+            }
+            for (int c = 0; c < 3; ++c) {
+                minimum[c] = std::min(minimum[c], minValues[c].floatValue);
+                maximum[c] = std::max(maximum[c], maxValues[c].floatValue);
+            }
+        }
+        if (state.positionsEligible && mesh.primitives.count > 0) {
+            // A uniform scale keeps the dequantization transform from skewing normals
+            state.center = (minimum + maximum) * 0.5f;
+            const simd_float3 halfExtents = (maximum - minimum) * 0.5f;
+            state.halfExtent = std::max(std::max(halfExtents.x, halfExtents.y), halfExtents.z);
+            if (state.halfExtent <= 0.0f) {
+                state.halfExtent = 1.0f;
+            }
+        } else {
+            state.positionsEligible = false;
+        }
+    }
+
+    // Texture coordinates outside [0, 1] are remapped into it, and each material that samples them is compensated
+    // through its texture transforms, so every primitive that draws with the material must share the remapping
+    std::map<std::pair<void *, NSInteger>, GLTFTexCoordRange> texCoordRanges;
+    if (options & GLTFQuantizationOptionTexCoords) {
+        for (GLTFMesh *mesh in asset.meshes) {
+            for (GLTFPrimitive *primitive in mesh.primitives) {
+                NSMutableArray<GLTFMaterial *> *variantMaterials = [NSMutableArray array];
+                for (GLTFMaterialMapping *mapping in primitive.materialMappings) {
+                    [variantMaterials addObject:mapping.material];
+                }
+                for (GLTFAttribute *attribute in primitive.attributes) {
+                    const NSInteger set = GLTFTexCoordSetForAttributeName(attribute.name);
+                    if (set < 0) {
+                        continue;
+                    }
+                    GLTFTexCoordRange &range = texCoordRanges[std::make_pair((__bridge void *)primitive.material, set)];
+                    NSArray<NSNumber *> *minValues = nil, *maxValues = nil;
+                    if (attribute.accessor.componentType != GLTFComponentTypeFloat ||
+                        attribute.accessor.dimension != GLTFValueDimensionVector2 ||
+                        !GLTFAccessorComputeBounds(attribute.accessor, &minValues, &maxValues))
+                    {
+                        // Coordinates that stay as they are can't have the material's transforms changed under them
+                        range.compensable = false;
+                        continue;
+                    }
+                    range.minimum = simd_min(range.minimum, simd_make_float2(minValues[0].floatValue, minValues[1].floatValue));
+                    range.maximum = simd_max(range.maximum, simd_make_float2(maxValues[0].floatValue, maxValues[1].floatValue));
+                    range.compensable = range.compensable && primitive.material && variantMaterials.count == 0;
+                    for (GLTFMaterial *material in variantMaterials) {
+                        texCoordRanges[std::make_pair((__bridge void *)material, set)].compensable = false;
+                    }
+                }
+            }
+        }
+        for (auto &entry : texCoordRanges) {
+            GLTFMaterial *material = (__bridge GLTFMaterial *)entry.first.first;
+            if (material == nil || !entry.second.compensable) {
+                entry.second.compensable = false;
+                continue;
+            }
+            bool sampled = false;
+            for (GLTFTextureParams *params in GLTFTextureParamsForMaterial(material)) {
+                if (params.transform.hasTexCoord) {
+                    entry.second.compensable = false;
+                }
+                sampled = sampled || params.texCoord == entry.first.second;
+            }
+            entry.second.compensable = entry.second.compensable && sampled;
+        }
+    }
+
+    // Build every replacement before changing the asset, so that a failure leaves it untouched
+    NSMutableDictionary<NSString *, GLTFAccessor *> *quantizedAccessors = [NSMutableDictionary dictionary];
+    NSMutableArray<GLTFAccessor *> *newAccessors = [NSMutableArray array];
+    NSMapTable<GLTFPrimitive *, NSArray<GLTFAttribute *> *> *newAttributes = [NSMapTable strongToStrongObjectsMapTable];
+    NSMapTable<GLTFPrimitive *, NSArray<GLTFMorphTarget *> *> *newTargets = [NSMapTable strongToStrongObjectsMapTable];
+    const int normalFormat = (options & GLTFQuantizationOptionHighPrecisionNormals) ? GLTF::VertexComponentFormatSNorm16
+                                                                                    : GLTF::VertexComponentFormatSNorm8;
+    for (GLTFMesh *mesh in asset.meshes) {
+        const GLTFMeshQuantization &state = meshStates[(__bridge void *)mesh];
+        for (GLTFPrimitive *primitive in mesh.primitives) {
+            NSMutableArray<GLTFAttribute *> *attributes = [NSMutableArray arrayWithCapacity:primitive.attributes.count];
+            BOOL changed = NO;
+            for (GLTFAttribute *attribute in primitive.attributes) {
+                GLTFAccessor *accessor = attribute.accessor;
+                NSString *name = attribute.name;
+                GLTF::QuantizationParameters parameters;
+                float *largestError = nullptr;
+                if (accessor.componentType != GLTFComponentTypeFloat) {
+                    // Already quantized, or integral
+                } else if ([name isEqualToString:GLTFAttributeSemanticPosition] && state.positionsEligible) {
+                    parameters.format = GLTF::VertexComponentFormatSNorm16;
+                    for (int c = 0; c < 3; ++c) {
+                        parameters.offset[c] = state.center[c];
+                        parameters.scale[c] = 1.0f / state.halfExtent;
+                    }
+                    largestError = &errors.position;
+                } else if ((options & GLTFQuantizationOptionNormals) && [name isEqualToString:GLTFAttributeSemanticNormal]) {
+                    parameters.format = normalFormat;
+                    largestError = &errors.normal;
+                } else if ((options & GLTFQuantizationOptionNormals) && [name isEqualToString:GLTFAttributeSemanticTangent]) {
+                    parameters.format = normalFormat;
+                    largestError = &errors.tangent;
+                } else if ((options & GLTFQuantizationOptionWeights) && [name hasPrefix:@"WEIGHTS_"]) {
+                    parameters.format = GLTF::VertexComponentFormatUNorm8;
+                    parameters.preservesSum = true;
+                    largestError = &errors.weight;
+                } else if ((options & GLTFQuantizationOptionColors) && [name hasPrefix:@"COLOR_"]) {
+                    parameters.format = GLTF::VertexComponentFormatUNorm8;
+                    largestError = &errors.color;
+                } else if ((options & GLTFQuantizationOptionTexCoords) && GLTFTexCoordSetForAttributeName(name) >= 0 &&
+                           accessor.dimension == GLTFValueDimensionVector2)
+                {
+                    auto found = texCoordRanges.find(std::make_pair((__bridge void *)primitive.material,
+                                                                    GLTFTexCoordSetForAttributeName(name)));
+                    NSArray<NSNumber *> *minValues = nil, *maxValues = nil;
+                    if (found != texCoordRanges.end() && found->second.compensable &&
+                        !GLTFTexCoordRangeIsUnit(found->second.minimum, found->second.maximum))
+                    {
+                        const simd_float2 extent = found->second.maximum - found->second.minimum;
+                        for (int c = 0; c < 2; ++c) {
+                            parameters.offset[c] = found->second.minimum[c];
+                            parameters.scale[c] = (extent[c] > 0.0f) ? 1.0f / extent[c] : 1.0f;
+                        }
+                        parameters.format = GLTF::VertexComponentFormatUNorm16;
+                        largestError = &errors.texCoord;
+                    } else if (GLTFAccessorComputeBounds(accessor, &minValues, &maxValues) &&
+                               GLTFTexCoordRangeIsUnit(simd_make_float2(minValues[0].floatValue, minValues[1].floatValue),
+                                                       simd_make_float2(maxValues[0].floatValue, maxValues[1].floatValue)))
+                    {
+                        parameters.format = GLTF::VertexComponentFormatUNorm16;
+                        largestError = &errors.texCoord;
+                    }
+                }
+                if (largestError == nullptr) {
+                    [attributes addObject:attribute];
+                    continue;
+                }
+                GLTFAccessor *quantized = GLTFQuantizedAccessor(accessor, parameters, quantizedAccessors,
+                                                                *largestError, error);
+                if (quantized == nil) {
+                    return NO;
+                }
+                [attributes addObject:[[GLTFAttribute alloc] initWithName:name accessor:quantized]];
+                changed = YES;
+            }
+            if (changed) {
+                [newAttributes setObject:attributes forKey:primitive];
+            }
+            if (state.positionsEligible && primitive.targets.count > 0) {
+                // Morph targets are added to the quantized positions, so their displacements must be scaled alike
+                NSMutableArray<GLTFMorphTarget *> *targets = [NSMutableArray arrayWithCapacity:primitive.targets.count];
+                for (GLTFMorphTarget *target in primitive.targets) {
+                    NSMutableArray<GLTFAttribute *> *targetAttributes = [NSMutableArray arrayWithCapacity:target.count];
+                    for (GLTFAttribute *attribute in target) {
+                        if (![attribute.name isEqualToString:GLTFAttributeSemanticPosition]) {
+                            [targetAttributes addObject:attribute];
+                            continue;
+                        }
+                        GLTFAccessor *scaled = GLTFScaledPositionAccessor(attribute.accessor, 1.0f / state.halfExtent);
+                        if (scaled == nil) {
+                            if (error) {
+                                *error = GLTFSceneProcessingError(@"Morph target has invalid positions");
+                            }
+                            return NO;
+                        }
+                        [newAccessors addObject:scaled];
+                        [targetAttributes addObject:[[GLTFAttribute alloc] initWithName:attribute.name accessor:scaled]];
+                    }
+                    [targets addObject:targetAttributes];
+                }
+                [newTargets setObject:targets forKey:primitive];
+            }
+        }
+    }
+    [newAccessors addObjectsFromArray:quantizedAccessors.allValues];
+    if (newAccessors.count == 0) {
+        if (outErrors) {
+            *outErrors = errors;
+        }
+        return YES;
+    }
+
+    // Replace the attributes
+    for (GLTFMesh *mesh in asset.meshes) {
+        const GLTFMeshQuantization &state = meshStates[(__bridge void *)mesh];
+        for (GLTFPrimitive *primitive in mesh.primitives) {
+            NSArray<GLTFAttribute *> *attributes = [newAttributes objectForKey:primitive];
+            if (attributes) {
+                primitive.attributes = attributes;
+            }
+            NSArray<GLTFMorphTarget *> *targets = [newTargets objectForKey:primitive];
+            if (targets) {
+                primitive.targets = targets;
+            }
+            if (state.positionsEligible) {
+                primitive.boundingBox = GLTFBoundingBoxForPrimitive(primitive);
+                if (primitive.meshlets) {
+                    primitive.meshlets = GLTFMeshletSetWithQuantizedBounds(primitive.meshlets, state.center,
+                                                                           1.0f / state.halfExtent);
+                }
+            }
+        }
+    }
+
+    // Give every node that draws a mesh with quantized positions the transform that restores them
+    NSSet<GLTFNode *> *movingNodes = GLTFMovingNodesInAsset(asset, NO);
+    NSMutableArray<GLTFNode *> *meshNodes = [NSMutableArray array];
+    for (GLTFNode *node in asset.nodes) {
+        if (node.mesh == nil || !meshStates[(__bridge void *)node.mesh].positionsEligible) {
+            continue;
+        }
+        const GLTFMeshQuantization &state = meshStates[(__bridge void *)node.mesh];
+        const float s = state.halfExtent;
+        simd_float4x4 dequantization = matrix_identity_float4x4;
+        dequantization.columns[0].x = dequantization.columns[1].y = dequantization.columns[2].z = s;
+        dequantization.columns[3] = simd_make_float4(state.center, 1.0f);
+        if (node.childNodes.count == 0 && node.camera == nil && node.light == nil && ![movingNodes containsObject:node]) {
+            node.matrix = simd_mul(node.matrix, dequantization);
+            node.translation = node.translation + simd_act(node.rotation, node.scale * state.center);
+            node.scale = node.scale * s;
+            continue;
+        }
+        GLTFNode *meshNode = [[GLTFNode alloc] init];
+        meshNode.name = node.name;
+        meshNode.mesh = node.mesh;
+        meshNode.weights = node.weights;
+        meshNode.matrix = dequantization;
+        meshNode.translation = state.center;
+        meshNode.scale = simd_make_float3(s, s, s);
+        node.mesh = nil;
+        node.weights = nil;
+        node.childNodes = [node.childNodes arrayByAddingObject:meshNode];
+        for (GLTFAnimation *animation in asset.animations) {
+            for (GLTFAnimationChannel *channel in animation.channels) {
+                if (channel.target.node == node && [channel.target.path isEqualToString:GLTFAnimationPathWeights]) {
+                    channel.target.node = meshNode;
+                }
+            }
+        }
+        [meshNodes addObject:meshNode];
+    }
+    asset.nodes = [asset.nodes arrayByAddingObjectsFromArray:meshNodes];
+
+    // Compensate the texture transforms of materials whose texture coordinates were remapped
+    BOOL addedTextureTransforms = NO;
+    for (const auto &entry : texCoordRanges) {
+        const GLTFTexCoordRange &range = entry.second;
+        if (!range.compensable || GLTFTexCoordRangeIsUnit(range.minimum, range.maximum)) {
+            continue;
+        }
+        GLTFMaterial *material = (__bridge GLTFMaterial *)entry.first.first;
+        simd_float2 extent = range.maximum - range.minimum;
+        extent = simd_make_float2(extent.x > 0.0f ? extent.x : 1.0f, extent.y > 0.0f ? extent.y : 1.0f);
+        for (GLTFTextureParams *params in GLTFTextureParamsForMaterial(material)) {
+            if (params.texCoord != entry.first.second) {
+                continue;
+            }
+            // T(o) R S T(m) S(e) = T(o + R S m) R S(S e), so the remapping folds into the existing transform
+            GLTFTextureTransform *transform = params.transform ?: [GLTFTextureTransform new];
+            const float c = cosf(transform.rotation), s = sinf(transform.rotation);
+            const simd_float2 m = transform.scale * range.minimum;
+            transform.offset = transform.offset + simd_make_float2(c * m.x + s * m.y, -s * m.x + c * m.y);
+            transform.scale = transform.scale * extent;
+            params.transform = transform;
+            addedTextureTransforms = YES;
+        }
+    }
+
+    GLTFAssetAddAccessors(asset, newAccessors);
+    NSMutableArray<NSString *> *extensionsUsed = [asset.extensionsUsed mutableCopy] ?: [NSMutableArray array];
+    NSMutableArray<NSString *> *extensionsRequired = [asset.extensionsRequired mutableCopy] ?: [NSMutableArray array];
+    if (![extensionsUsed containsObject:GLTFExtensionKHRMeshQuantization]) {
+        [extensionsUsed addObject:GLTFExtensionKHRMeshQuantization];
+    }
+    if (![extensionsRequired containsObject:GLTFExtensionKHRMeshQuantization]) {
+        [extensionsRequired addObject:GLTFExtensionKHRMeshQuantization];
+    }
+    if (addedTextureTransforms && ![extensionsUsed containsObject:GLTFExtensionKHRTextureTransform]) {
+        [extensionsUsed addObject:GLTFExtensionKHRTextureTransform];
+    }
+    asset.extensionsUsed = extensionsUsed;
+    asset.extensionsRequired = extensionsRequired;
+
+    GLTFLogInfo(@"[GLTFKit2] Quantized %lu accessors; largest errors: position %g, normal %g, tangent %g, "
+                @"texture coordinate %g, weight %g, color %g", (unsigned long)quantizedAccessors.count,
+                errors.position, errors.normal, errors.tangent, errors.texCoord, errors.weight, errors.color);
+    if (outErrors) {
+        *outErrors = errors;
+    }
+    return YES;
+}
+
+@interface GLTFSceneRayHit ()
+- (instancetype)initWithNode:(GLTFNode *)node
+                   primitive:(GLTFPrimitive *)primitive
+               instanceIndex:(NSInteger)instanceIndex
+               triangleIndex:(NSInteger)triangleIndex
+                    distance:(float)distance
+      barycentricCoordinates:(simd_float3)barycentricCoordinates
+                       point:(simd_float3)point;
+@end
+
+@implementation GLTFSceneRayHit
+
+- (instancetype)initWithNode:(GLTFNode *)node
+                   primitive:(GLTFPrimitive *)primitive
+               instanceIndex:(NSInteger)instanceIndex
+               triangleIndex:(NSInteger)triangleIndex
+                    distance:(float)distance
+      barycentricCoordinates:(simd_float3)barycentricCoordinates
+                       point:(simd_float3)point
+{
+    if (self = [super init]) {
+        _node = node;
+        _primitive = primitive;
+        _instanceIndex = instanceIndex;
+        _triangleIndex = triangleIndex;
+        _distance = distance;
+        _barycentricCoordinates = barycentricCoordinates;
+        _point = point;
+    }
+    return self;
+}
+
+@end
+
+// The positions and list indices of a primitive, read once however many nodes draw it
+struct GLTFRayPrimitiveGeometry {
+    std::vector<GLTF::Vec3> positions;
+    std::vector<uint32_t> indices;
+};
+
+// A run of consecutive triangles of the hierarchy that came from one primitive of one node (or instance)
+struct GLTFRayTriangleSource {
+    GLTFNode *node;
+    GLTFPrimitive *primitive;
+    NSInteger instanceIndex;
+    size_t firstTriangle;
+};
+
+struct GLTFRayTriangleCollector {
+    std::unordered_map<void *, GLTFRayPrimitiveGeometry> geometryForPrimitive;
+    std::vector<GLTFRayTriangleSource> sources;
+    std::vector<float> corners;
+};
+
+static bool GLTFReadRayPrimitiveGeometry(GLTFPrimitive *primitive, GLTFRayPrimitiveGeometry &geometry,
+                                         NSError **error)
+{
+    GLTFAccessor *positionAccessor = [primitive attributeForName:GLTFAttributeSemanticPosition].accessor;
+    if (positionAccessor == nil || !GLTFTriangleListIndicesForPrimitive(primitive, geometry.indices)) {
+        return true;
+    }
+    if (!GLTFValidatePrimitiveIndices(primitive, error)) {
+        return false;
+    }
+    NSData *storage = nil;
+    const GLTF::AccessorView view = GLTFAccessorViewForAccessor(positionAccessor, &storage);
+    if (!view.isValid()) {
+        if (error) {
+            *error = GLTFSceneProcessingError(@"Primitive has invalid positions");
+        }
+        return false;
+    }
+    geometry.positions = GLTF::ReadVec3s(view);
+    return true;
+}
+
+static void GLTFAppendRayTriangles(const GLTFRayPrimitiveGeometry &geometry, simd_float4x4 transform,
+                                   std::vector<float> &corners)
+{
+    std::vector<simd_float3> transformed(geometry.positions.size());
+    for (size_t i = 0; i < geometry.positions.size(); ++i) {
+        const GLTF::Vec3 p = geometry.positions[i];
+        transformed[i] = simd_mul(transform, simd_make_float4(p.x, p.y, p.z, 1.0f)).xyz;
+    }
+    for (uint32_t index : geometry.indices) {
+        corners.push_back(transformed[index].x);
+        corners.push_back(transformed[index].y);
+        corners.push_back(transformed[index].z);
+    }
+}
+
+// Appends the triangles of the nodes in the subtree at `node` to `collector`, in the space of the scene's root.
+// Returns false and sets `error` if a primitive's data is invalid.
+static bool GLTFCollectRayTriangles(GLTFNode *node, simd_float4x4 parentTransform,
+                                    GLTFRayTriangleCollector &collector, NSError **error)
+{
+    const simd_float4x4 transform = simd_mul(parentTransform, node.matrix);
+    for (GLTFPrimitive *primitive in node.mesh.primitives) {
+        void *key = (__bridge void *)primitive;
+        auto found = collector.geometryForPrimitive.find(key);
+        if (found == collector.geometryForPrimitive.end()) {
+            GLTFRayPrimitiveGeometry geometry;
+            if (!GLTFReadRayPrimitiveGeometry(primitive, geometry, error)) {
+                return false;
+            }
+            found = collector.geometryForPrimitive.emplace(key, std::move(geometry)).first;
+        }
+        const GLTFRayPrimitiveGeometry &geometry = found->second;
+        if (geometry.positions.empty() || geometry.indices.empty()) {
+            continue;
+        }
+        const NSInteger instanceCount = node.meshInstances ? node.meshInstances.instanceCount : 1;
+        for (NSInteger instance = 0; instance < instanceCount; ++instance) {
+            GLTFRayTriangleSource source;
+            source.node = node;
+            source.primitive = primitive;
+            source.instanceIndex = node.meshInstances ? instance : -1;
+            source.firstTriangle = collector.corners.size() / 9;
+            collector.sources.push_back(source);
+            const simd_float4x4 instanceTransform =
+                node.meshInstances ? simd_mul(transform, [node.meshInstances transformAtIndex:instance]) : transform;
+            GLTFAppendRayTriangles(geometry, instanceTransform, collector.corners);
+        }
+    }
+    for (GLTFNode *child in node.childNodes) {
+        if (!GLTFCollectRayTriangles(child, transform, collector, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+@implementation GLTFSceneRayIntersector {
+    GLTF::BVH _hierarchy;
+    std::vector<GLTFRayTriangleSource> _sources;
+}
+
+- (instancetype)initWithScene:(GLTFScene *)scene error:(NSError **)error {
+    if (self = [super init]) {
+        _scene = scene;
+        GLTFRayTriangleCollector collector;
+        for (GLTFNode *root in scene.nodes) {
+            if (!GLTFCollectRayTriangles(root, matrix_identity_float4x4, collector, error)) {
+                return nil;
+            }
+        }
+        _triangleCount = (NSInteger)(collector.corners.size() / 9);
+        _hierarchy.build(collector.corners.data(), (size_t)_triangleCount);
+        _sources = std::move(collector.sources);
+    }
+    return self;
+}
+
+- (GLTFSceneRayHit *)hitForHierarchyHit:(const GLTF::BVHHit &)bvhHit
+                                 origin:(simd_float3)origin
+                              direction:(simd_float3)direction
+{
+    auto source = std::upper_bound(_sources.begin(), _sources.end(), (size_t)bvhHit.triangle,
+                                   [](size_t triangle, const GLTFRayTriangleSource &s) {
+        return triangle < s.firstTriangle;
+    }) - 1;
+    return [[GLTFSceneRayHit alloc] initWithNode:source->node
+                                       primitive:source->primitive
+                                   instanceIndex:source->instanceIndex
+                                   triangleIndex:(NSInteger)(bvhHit.triangle - source->firstTriangle)
+                                        distance:bvhHit.distance
+                          barycentricCoordinates:simd_make_float3(1.0f - bvhHit.u - bvhHit.v, bvhHit.u, bvhHit.v)
+                                           point:origin + bvhHit.distance * direction];
+}
+
+- (GLTFSceneRayHit *)closestHitWithOrigin:(simd_float3)origin
+                                direction:(simd_float3)direction
+                              maxDistance:(float)maxDistance
+{
+    const float o[3] = { origin.x, origin.y, origin.z }, d[3] = { direction.x, direction.y, direction.z };
+    GLTF::BVHHit hit;
+    if (!_hierarchy.intersectClosest(o, d, 0.0f, maxDistance, hit)) {
+        return nil;
+    }
+    return [self hitForHierarchyHit:hit origin:origin direction:direction];
+}
+
+- (GLTFSceneRayHit *)anyHitWithOrigin:(simd_float3)origin
+                            direction:(simd_float3)direction
+                          maxDistance:(float)maxDistance
+{
+    const float o[3] = { origin.x, origin.y, origin.z }, d[3] = { direction.x, direction.y, direction.z };
+    GLTF::BVHHit hit;
+    if (!_hierarchy.intersectAny(o, d, 0.0f, maxDistance, hit)) {
+        return nil;
+    }
+    return [self hitForHierarchyHit:hit origin:origin direction:direction];
+}
+
+@end
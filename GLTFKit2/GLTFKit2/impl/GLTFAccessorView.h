@@ -0,0 +1,212 @@
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Portable (Foundation-free) description of accessor data, shared by the C++ processing kernels.
+
+namespace GLTF {
+
+// These mirror the values of GLTFComponentType so that they can be passed through unchanged.
+enum ComponentType : int {
+    ComponentTypeInvalid,
+    ComponentTypeByte,
+    ComponentTypeUnsignedByte,
+    ComponentTypeShort,
+    ComponentTypeUnsignedShort,
+    ComponentTypeUnsignedInt,
+    ComponentTypeFloat
+};
+
+inline size_t BytesPerComponent(int componentType) {
+    switch (componentType) {
+        case ComponentTypeByte:
+        case ComponentTypeUnsignedByte:
+            return 1;
+        case ComponentTypeShort:
+        case ComponentTypeUnsignedShort:
+            return 2;
+        case ComponentTypeUnsignedInt:
+        case ComponentTypeFloat:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+struct AccessorView {
+    const uint8_t *data = nullptr; // Address of the first element
+    size_t stride = 0;             // Distance in bytes between consecutive elements
+    size_t count = 0;
+    int componentType = ComponentTypeInvalid;
+    int componentCount = 0;
+    bool normalized = false;
+
+    bool isValid() const {
+        return data != nullptr && componentCount > 0 && BytesPerComponent(componentType) != 0;
+    }
+
+    size_t elementSize() const {
+        return BytesPerComponent(componentType) * componentCount;
+    }
+
+    const uint8_t *element(size_t index) const {
+        return data + index * stride;
+    }
+};
+
+template <typename T>
+inline T LoadUnaligned(const uint8_t *p) {
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+template <typename T>
+inline void StoreUnaligned(uint8_t *p, T value) {
+    memcpy(p, &value, sizeof(T));
+}
+
+/// Decodes a single component to float. Normalized integers use the decoding equations
+/// given in the glTF specification; other integers are converted by value.
+inline float ReadComponent(const uint8_t *p, int componentType, bool normalized) {
+    switch (componentType) {
+        case ComponentTypeByte: {
+            const float c = static_cast<float>(static_cast<int8_t>(*p));
+            return normalized ? std::max(c / 127.0f, -1.0f) : c;
+        }
+        case ComponentTypeUnsignedByte: {
+            const float c = static_cast<float>(*p);
+            return normalized ? c / 255.0f : c;
+        }
+        case ComponentTypeShort: {
+            const float c = static_cast<float>(LoadUnaligned<int16_t>(p));
+            return normalized ? std::max(c / 32767.0f, -1.0f) : c;
+        }
+        case ComponentTypeUnsignedShort: {
+            const float c = static_cast<float>(LoadUnaligned<uint16_t>(p));
+            return normalized ? c / 65535.0f : c;
+        }
+        case ComponentTypeUnsignedInt:
+            return static_cast<float>(LoadUnaligned<uint32_t>(p));
+        case ComponentTypeFloat:
+            return LoadUnaligned<float>(p);
+        default:
+            return 0.0f;
+    }
+}
+
+/// Reads up to `maxComponents` components of element `index` as floats, returning the number read.
+inline int ReadFloats(const AccessorView &view, size_t index, float *out, int maxComponents) {
+    const int n = std::min(view.componentCount, maxComponents);
+    const size_t componentSize = BytesPerComponent(view.componentType);
+    const uint8_t *p = view.element(index);
+    if (view.componentType == ComponentTypeFloat) {
+        memcpy(out, p, n * sizeof(float));
+        return n;
+    }
+    for (int c = 0; c < n; ++c) {
+        out[c] = ReadComponent(p + c * componentSize, view.componentType, view.normalized);
+    }
+    return n;
+}
+
+/// Reads an unsigned integer scalar (such as an index or a joint index) from element `index`, component `component`.
+inline uint32_t ReadUInt(const AccessorView &view, size_t index, int component = 0) {
+    const uint8_t *p = view.element(index) + component * BytesPerComponent(view.componentType);
+    switch (view.componentType) {
+        case ComponentTypeUnsignedByte:
+        case ComponentTypeByte:
+            return *p;
+        case ComponentTypeUnsignedShort:
+        case ComponentTypeShort:
+            return LoadUnaligned<uint16_t>(p);
+        case ComponentTypeUnsignedInt:
+            return LoadUnaligned<uint32_t>(p);
+        case ComponentTypeFloat:
+            return static_cast<uint32_t>(LoadUnaligned<float>(p));
+        default:
+            return 0;
+    }
+}
+
+/// Converts a float to IEEE 754 binary16, rounding to nearest even.
+inline uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t absBits = bits & 0x7FFFFFFFu;
+    if (absBits >= 0x7F800000u) { // Inf or NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | ((absBits > 0x7F800000u) ? 0x0200u : 0u));
+    }
+    if (absBits >= 0x477FF000u) { // Rounds to a value too large to represent
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (absBits < 0x38800000u) { // Subnormal or zero in half precision
+        if (absBits < 0x33000000u) {
+            return static_cast<uint16_t>(sign);
+        }
+        const uint32_t exponent = absBits >> 23;
+        const uint32_t mantissa = (absBits & 0x007FFFFFu) | 0x00800000u;
+        const uint32_t shift = 126u - exponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = ((absBits - 0x38000000u) >> 13);
+    const uint32_t remainder = absBits & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+inline float HalfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0x1Fu) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    } else if (mantissa != 0) {
+        exponent = 113u;
+        while ((mantissa & 0x400u) == 0) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+    } else {
+        bits = sign;
+    }
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline int8_t FloatToSNorm8(float v) {
+    return static_cast<int8_t>(std::lround(std::min(std::max(v, -1.0f), 1.0f) * 127.0f));
+}
+
+inline uint8_t FloatToUNorm8(float v) {
+    return static_cast<uint8_t>(std::lround(std::min(std::max(v, 0.0f), 1.0f) * 255.0f));
+}
+
+inline int16_t FloatToSNorm16(float v) {
+    return static_cast<int16_t>(std::lround(std::min(std::max(v, -1.0f), 1.0f) * 32767.0f));
+}
+
+inline uint16_t FloatToUNorm16(float v) {
+    return static_cast<uint16_t>(std::lround(std::min(std::max(v, 0.0f), 1.0f) * 65535.0f));
+}
+
+} // namespace GLTF
@@ -0,0 +1,113 @@
+
+#import <GLTFKit2/GLTFAsset.h>
+#import <GLTFKit2/GLTFMeshProcessing.h>
+#import "GLTFLogging.h"
+
+#include "GLTFAccessorView.h"
+#include "GLTFIndexProcessing.h"
+
+#include <vector>
+
+NS_ASSUME_NONNULL_BEGIN
+
+static_assert(GLTF::ComponentTypeFloat == (int)GLTFComponentTypeFloat &&
+              GLTF::ComponentTypeUnsignedInt == (int)GLTFComponentTypeUnsignedInt &&
+              GLTF::ComponentTypeByte == (int)GLTFComponentTypeByte,
+              "GLTF::ComponentType must mirror GLTFComponentType");
+
+/// Describes the elements of `accessor` for the portable processing kernels. Sparse accessors and accessors
+/// without a buffer view are materialized; when that happens, the materialized data is returned through
+/// `outStorage`, which must be kept alive for as long as the view is in use. If the accessor's data does not fit
+/// within its buffer, an error is logged and an invalid (empty) view is returned.
+inline GLTF::AccessorView GLTFAccessorViewForAccessor(GLTFAccessor *_Nullable accessor, NSData *_Nullable __strong *_Nonnull outStorage) {
+    GLTF::AccessorView view;
+    *outStorage = nil;
+    if (accessor == nil || accessor.count <= 0) {
+        return view;
+    }
+    view.componentType = (int)accessor.componentType;
+    view.componentCount = GLTFComponentCountForDimension(accessor.dimension);
+    view.normalized = accessor.isNormalized;
+    view.count = accessor.count;
+    const size_t elementSize = view.elementSize();
+    if (elementSize == 0) {
+        return GLTF::AccessorView();
+    }
+    GLTFBufferView *bufferView = accessor.bufferView;
+    if (accessor.sparse != nil || bufferView == nil) {
+        NSData *packedData = GLTFPackedDataForAccessor(accessor);
+        if (packedData.length < view.count * elementSize) {
+            return GLTF::AccessorView();
+        }
+        *outStorage = packedData;
+        view.data = (const uint8_t *)packedData.bytes;
+        view.stride = elementSize;
+        return view;
+    }
+    NSData *bufferData = bufferView.buffer.data;
+    view.stride = bufferView.stride ?: elementSize;
+    const size_t requiredLength = bufferView.offset + accessor.offset + (view.count - 1) * view.stride + elementSize;
+    if (bufferData == nil || requiredLength > bufferData.length) {
+        GLTFLogError(@"[GLTFKit2] Accessor data extends beyond the end of its buffer; ignoring accessor.");
+        return GLTF::AccessorView();
+    }
+    view.data = (const uint8_t *)bufferData.bytes + bufferView.offset + accessor.offset;
+    return view;
+}
+
+// Returns the indices of `primitive` as a triangle list, rewriting strips and fans and synthesizing indices for
+// non-indexed primitives. Returns false if the primitive is not made of triangles.
+inline bool GLTFTriangleListIndicesForPrimitive(GLTFPrimitive *primitive, std::vector<uint32_t> &outIndices) {
+    if (primitive.primitiveType != GLTFPrimitiveTypeTriangles &&
+        primitive.primitiveType != GLTFPrimitiveTypeTriangleStrip &&
+        primitive.primitiveType != GLTFPrimitiveTypeTriangleFan)
+    {
+        return false;
+    }
+    GLTFPrimitiveType listType = GLTFPrimitiveTypeInvalid;
+    NSInteger indexCount = 0, bytesPerIndex = 0;
+    NSData *indexData = GLTFIndexDataForPrimitive(primitive, GLTFIndexConversionOptionNone,
+                                                  &listType, &indexCount, &bytesPerIndex);
+    if (indexData == nil || listType != GLTFPrimitiveTypeTriangles) {
+        return false;
+    }
+    outIndices.resize(indexCount);
+    if (bytesPerIndex == sizeof(uint16_t)) {
+        GLTF::ConvertIndices((const uint16_t *)indexData.bytes, indexCount, outIndices.data());
+    } else {
+        memcpy(outIndices.data(), indexData.bytes, indexCount * sizeof(uint32_t));
+    }
+    return true;
+}
+
+// Creates an accessor over tightly packed `data`, with a buffer view and buffer of its own.
+inline GLTFAccessor *GLTFNewAccessorWithData(NSData *data, GLTFComponentType componentType,
+                                             GLTFValueDimension dimension, BOOL normalized, NSInteger count)
+{
+    GLTFBuffer *buffer = [[GLTFBuffer alloc] initWithData:data];
+    GLTFBufferView *bufferView = [[GLTFBufferView alloc] initWithBuffer:buffer length:data.length offset:0 stride:0];
+    return [[GLTFAccessor alloc] initWithBufferView:bufferView
+                                             offset:0
+                                      componentType:componentType
+                                          dimension:dimension
+                                              count:count
+                                         normalized:normalized];
+}
+
+// Creates an index accessor for `indices`, with 16-bit indices if they can address every vertex.
+inline GLTFAccessor *GLTFNewIndexAccessor(const std::vector<uint32_t> &indices, size_t vertexCount) {
+    NSData *indexData = nil;
+    GLTFComponentType componentType;
+    if (vertexCount <= 0xFFFF) {
+        NSMutableData *shortIndexData = [NSMutableData dataWithLength:indices.size() * sizeof(uint16_t)];
+        GLTF::ConvertIndices(indices.data(), indices.size(), (uint16_t *)shortIndexData.mutableBytes);
+        indexData = shortIndexData;
+        componentType = GLTFComponentTypeUnsignedShort;
+    } else {
+        indexData = [NSData dataWithBytes:indices.data() length:indices.size() * sizeof(uint32_t)];
+        componentType = GLTFComponentTypeUnsignedInt;
+    }
+    return GLTFNewAccessorWithData(indexData, componentType, GLTFValueDimensionScalar, NO, indices.size());
+}
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,609 @@
+
+#include "GLTFAnimationCompression.h"
+#include "GLTFParallel.h"
+
+#include <cmath>
+
+namespace GLTF {
+
+namespace {
+
+// Samples per unit of parallel work when sampling the source clip or measuring error
+const size_t SampleGrainSize = 64;
+
+// Tracks per unit of parallel work when choosing bit widths and encoding
+const size_t TrackGrainSize = 4;
+
+// Instances per unit of parallel work when sampling many
+const size_t InstanceGrainSize = 16;
+
+// Samples at which the compressed clip is compared with its source, per sample interval
+const uint32_t ErrorSamplesPerInterval = 4;
+
+const uint32_t MaxQuantizedBitWidth = 24;
+const uint32_t RawBitWidth = 32;
+const uint32_t RotationBitWidth = 48;
+
+// Each of the three smallest components of a unit quaternion lies within ±1/√2, and is stored in 15 bits after the
+// 2-bit index of the largest
+const uint32_t RotationComponentBits = 15;
+const float RotationComponentLimit = 0.70710678f;
+const float RotationComponentMax = 32767.0f;
+
+// Segment ranges are fractions of the track's clip-wide range, in 8 bits
+const float SegmentRangeMax = 255.0f;
+
+// Room after the last segment for reading a whole 64-bit word at any byte
+const size_t DataPadding = sizeof(uint64_t);
+
+typedef float Float4 __attribute__((vector_size(16)));
+
+inline Float4 splat(float f) {
+    Float4 v = { f, f, f, f };
+    return v;
+}
+
+inline uint64_t readBits(const uint8_t *bytes, size_t bit, uint32_t width) {
+    const uint64_t word = LoadUnaligned<uint64_t>(bytes + bit / 8);
+    return (word >> (bit % 8)) & ((uint64_t(1) << width) - 1);
+}
+
+// Ors `value` into the `width` bits at `bit`, which must be clear; `bytes` needs room for a 64-bit word there.
+inline void writeBits(uint8_t *bytes, size_t bit, uint64_t value) {
+    uint64_t word = LoadUnaligned<uint64_t>(bytes + bit / 8);
+    word |= value << (bit % 8);
+    memcpy(bytes + bit / 8, &word, sizeof(word));
+}
+
+// The angle between the rotations of two unit quaternions, accurate when small
+float rotationAngle(const float *a, const float *b) {
+    const float cosine = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    const float sign = (cosine < 0.0f) ? -1.0f : 1.0f;
+    float differenceSquared = 0.0f, sumSquared = 0.0f;
+    for (int c = 0; c < 4; ++c) {
+        differenceSquared += (a[c] - sign * b[c]) * (a[c] - sign * b[c]);
+        sumSquared += (a[c] + sign * b[c]) * (a[c] + sign * b[c]);
+    }
+    return 4.0f * std::atan2(std::sqrt(differenceSquared), std::sqrt(sumSquared));
+}
+
+void normalizeQuaternion(float *q) {
+    const float lengthSquared = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+    if (lengthSquared > 0.0f) {
+        const float scale = 1.0f / std::sqrt(lengthSquared);
+        for (int c = 0; c < 4; ++c) {
+            q[c] *= scale;
+        }
+    } else {
+        q[0] = q[1] = q[2] = 0.0f;
+        q[3] = 1.0f;
+    }
+}
+
+// Packs a unit quaternion as the index of its largest component, which is made positive by negating the quaternion
+// if need be, followed by the other three components.
+uint64_t packRotation(const float *q) {
+    uint32_t largest = 0;
+    for (uint32_t c = 1; c < 4; ++c) {
+        if (std::fabs(q[c]) > std::fabs(q[largest])) {
+            largest = c;
+        }
+    }
+    const float sign = (q[largest] < 0.0f) ? -1.0f : 1.0f;
+    uint64_t bits = largest;
+    uint32_t shift = 2;
+    for (uint32_t c = 0; c < 4; ++c) {
+        if (c == largest) {
+            continue;
+        }
+        const float unit = std::min(std::max(sign * q[c] / RotationComponentLimit, -1.0f), 1.0f);
+        const uint64_t component = static_cast<uint64_t>(std::lround((unit * 0.5f + 0.5f) * RotationComponentMax));
+        bits |= component << shift;
+        shift += RotationComponentBits;
+    }
+    return bits;
+}
+
+void unpackRotation(uint64_t bits, float *q) {
+    const uint32_t largest = static_cast<uint32_t>(bits & 3);
+    float sumSquared = 0.0f;
+    uint32_t shift = 2;
+    for (uint32_t c = 0; c < 4; ++c) {
+        if (c == largest) {
+            continue;
+        }
+        const float component = static_cast<float>((bits >> shift) & 0x7fff);
+        q[c] = (component / RotationComponentMax * 2.0f - 1.0f) * RotationComponentLimit;
+        sumSquared += q[c] * q[c];
+        shift += RotationComponentBits;
+    }
+    q[largest] = std::sqrt(std::max(1.0f - sumSquared, 0.0f));
+}
+
+// The bytes a track occupies in a segment of `sampleCount` samples
+uint32_t trackSegmentByteCount(const CompressedAnimationTrack &track, uint32_t sampleCount) {
+    const uint32_t n = track.componentCount;
+    if (track.bitWidth == 0) {
+        return 0;
+    } else if (track.bitWidth == RotationBitWidth) {
+        return 6 * sampleCount;
+    } else if (track.bitWidth == RawBitWidth) {
+        return 4 * n * sampleCount;
+    }
+    return 2 * n + (sampleCount * n * track.bitWidth + 7) / 8;
+}
+
+// The dequantization of component `c` of a quantized track in a segment, whose data begins with the 8-bit minima
+// and extents of the segment's range within the clip range
+inline void componentDequantization(const float *clipRange, const uint8_t *trackData, uint32_t n, uint32_t c,
+                                    uint32_t bitWidth, float &base, float &scale)
+{
+    const float clipMin = clipRange[c], clipExtent = clipRange[n + c];
+    base = clipMin + clipExtent * (trackData[c] / SegmentRangeMax);
+    scale = clipExtent * (trackData[n + c] / SegmentRangeMax) / static_cast<float>((1u << bitWidth) - 1);
+}
+
+// Reads component `c` of sample `k` of a quantized or raw track, before dequantization
+inline float readComponent(const uint8_t *trackData, uint32_t n, uint32_t bitWidth, uint32_t k, uint32_t c) {
+    if (bitWidth == RawBitWidth) {
+        return LoadUnaligned<float>(trackData + 4 * (k * n + c));
+    }
+    return static_cast<float>(readBits(trackData + 2 * n, size_t(k * n + c) * bitWidth, bitWidth));
+}
+
+// Encodes `sampleCount` samples of a quantized or raw track into `out` (which must be zeroed and padded), and
+// returns the largest error of any decoded component.
+float encodeVectorSegment(const float *samples, uint32_t sampleCount, uint32_t n, const float *clipRange,
+                          uint32_t bitWidth, uint8_t *out)
+{
+    if (bitWidth == RawBitWidth) {
+        memcpy(out, samples, sizeof(float) * n * sampleCount);
+        return 0.0f;
+    }
+    for (uint32_t c = 0; c < n; ++c) {
+        float low = samples[c], high = samples[c];
+        for (uint32_t k = 1; k < sampleCount; ++k) {
+            low = std::min(low, samples[k * n + c]);
+            high = std::max(high, samples[k * n + c]);
+        }
+        const float clipMin = clipRange[c], clipExtent = clipRange[n + c];
+        const float lowFraction = (clipExtent > 0.0f) ? (low - clipMin) / clipExtent : 0.0f;
+        const float highFraction = (clipExtent > 0.0f) ? (high - clipMin) / clipExtent : 0.0f;
+        const float first = std::min(std::max(std::floor(lowFraction * SegmentRangeMax), 0.0f), SegmentRangeMax);
+        const float last = std::min(std::max(std::ceil(highFraction * SegmentRangeMax), first), SegmentRangeMax);
+        out[c] = static_cast<uint8_t>(first);
+        out[n + c] = static_cast<uint8_t>(last - first);
+    }
+    const float maxQuantized = static_cast<float>((1u << bitWidth) - 1);
+    float error = 0.0f;
+    for (uint32_t c = 0; c < n; ++c) {
+        float base, scale;
+        componentDequantization(clipRange, out, n, c, bitWidth, base, scale);
+        for (uint32_t k = 0; k < sampleCount; ++k) {
+            const float value = samples[k * n + c];
+            const float q = (scale > 0.0f) ? std::min(std::max(std::round((value - base) / scale), 0.0f),
+                                                      maxQuantized) : 0.0f;
+            writeBits(out + 2 * n, size_t(k * n + c) * bitWidth, static_cast<uint64_t>(q));
+            error = std::max(error, std::fabs(base + scale * q - value));
+        }
+    }
+    return error;
+}
+
+void encodeRotationSegment(const float *samples, uint32_t sampleCount, uint8_t *out) {
+    for (uint32_t k = 0; k < sampleCount; ++k) {
+        writeBits(out, size_t(k) * RotationBitWidth, packRotation(samples + 4 * k));
+    }
+}
+
+float *trackDestination(AnimationPose &pose, int path, uint32_t target) {
+    switch (path) {
+        case AnimationPathTranslation: return pose.translations.data() + 3 * target;
+        case AnimationPathRotation:    return pose.rotations.data() + 4 * target;
+        case AnimationPathScale:       return pose.scales.data() + 3 * target;
+        default:                       return pose.weights.data() + target;
+    }
+}
+
+void resizePose(AnimationPose &pose, size_t nodeCount, size_t weightCount) {
+    pose.translations.assign(3 * nodeCount, 0.0f);
+    pose.rotations.assign(4 * nodeCount, 0.0f);
+    pose.scales.assign(3 * nodeCount, 1.0f);
+    pose.weights.assign(weightCount, 0.0f);
+}
+
+void normalizeLanes(Float4 *components) {
+    const Float4 lengthSquared = components[0] * components[0] + components[1] * components[1] +
+        components[2] * components[2] + components[3] * components[3];
+    Float4 scale;
+    for (int lane = 0; lane < 4; ++lane) {
+        scale[lane] = (lengthSquared[lane] > 0.0f) ? 1.0f / std::sqrt(lengthSquared[lane]) : 0.0f;
+    }
+    for (int c = 0; c < 4; ++c) {
+        components[c] *= scale;
+    }
+}
+
+// The segment and samples around a time, and how far the time is from the first sample toward the second
+struct SamplePosition {
+    uint32_t segment;
+    uint32_t sample;     // Within the segment
+    uint32_t nextSample; // Within the segment
+    float fraction;
+};
+
+} // namespace
+
+bool CompressedAnimationClip::build(const AnimationClip &source, const AnimationCompressionSettings &settings,
+                                    AnimationCompressionReport *report)
+{
+    *this = CompressedAnimationClip();
+    const std::vector<AnimationTrack> &sourceTracks = source.tracks();
+    const double sampleCountEstimate = std::ceil(double(source.duration()) * settings.sampleRate) + 1.0;
+    if (sourceTracks.empty() || !(settings.sampleRate > 0.0f) || !std::isfinite(settings.sampleRate) ||
+        !(settings.positionTolerance >= 0.0f) || !(settings.angleTolerance >= 0.0f) ||
+        !(sampleCountEstimate < double(UINT32_MAX)))
+    {
+        return false;
+    }
+    clipDuration = source.duration();
+    rate = settings.sampleRate;
+    sampleCount = static_cast<uint32_t>(sampleCountEstimate);
+    segmentCount = std::max<uint32_t>((sampleCount - 1 + SegmentIntervalCount - 1) / SegmentIntervalCount, 1);
+
+    size_t sourceByteCount = 0;
+    for (const AnimationTrack &track : sourceTracks) {
+        const size_t elementsPerKey = (track.interpolation == InterpolationCubic) ? 3 : 1;
+        sourceByteCount += sizeof(float) * track.keyCount * (1 + elementsPerKey * track.componentCount);
+        if (track.path == AnimationPathWeights) {
+            requiredWeightCount = std::max<size_t>(requiredWeightCount, size_t(track.target) + track.componentCount);
+        } else {
+            requiredNodeCount = std::max<size_t>(requiredNodeCount, size_t(track.target) + 1);
+        }
+    }
+
+    // Sample every track of the source on the grid
+    const size_t trackCount = sourceTracks.size();
+    std::vector<std::vector<float>> samples(trackCount);
+    for (size_t t = 0; t < trackCount; ++t) {
+        samples[t].resize(size_t(sampleCount) * sourceTracks[t].componentCount);
+    }
+    ParallelFor(sampleCount, SampleGrainSize, [&](size_t begin, size_t end) {
+        AnimationPose pose;
+        resizePose(pose, requiredNodeCount, requiredWeightCount);
+        AnimationCursor cursor;
+        for (size_t i = begin; i < end; ++i) {
+            source.sample(std::min(static_cast<float>(static_cast<double>(i) / rate), clipDuration), cursor, pose);
+            for (size_t t = 0; t < trackCount; ++t) {
+                const uint32_t n = sourceTracks[t].componentCount;
+                memcpy(&samples[t][i * n], trackDestination(pose, sourceTracks[t].path, sourceTracks[t].target),
+                       sizeof(float) * n);
+            }
+        }
+    });
+
+    // Choose how each track is stored: as a constant, as smallest-three rotations, or quantized to the fewest bits
+    // that meet the tolerance
+    const uint32_t fullSampleCount = SegmentIntervalCount + 1;
+    const uint32_t lastSampleCount = sampleCount - (segmentCount - 1) * SegmentIntervalCount;
+    trackStorage.resize(trackCount);
+    std::vector<std::vector<float>> trackRanges(trackCount);
+    ParallelFor(trackCount, TrackGrainSize, [&](size_t begin, size_t end) {
+        std::vector<uint8_t> scratch;
+        for (size_t t = begin; t < end; ++t) {
+            const AnimationTrack &sourceTrack = sourceTracks[t];
+            CompressedAnimationTrack &track = trackStorage[t];
+            track.path = sourceTrack.path;
+            track.step = (sourceTrack.interpolation == InterpolationStep);
+            track.target = sourceTrack.target;
+            track.componentCount = sourceTrack.componentCount;
+            const uint32_t n = track.componentCount;
+            float *values = samples[t].data();
+            std::vector<float> &range = trackRanges[t];
+            if (track.path == AnimationPathRotation) {
+                bool constant = true;
+                for (uint32_t i = 0; i < sampleCount; ++i) {
+                    normalizeQuaternion(values + 4 * i);
+                    constant = constant && rotationAngle(values, values + 4 * i) <= settings.angleTolerance;
+                }
+                track.bitWidth = constant ? 0 : RotationBitWidth;
+                if (constant) {
+                    range.assign(values, values + 4);
+                }
+                continue;
+            }
+            range.assign(2 * n, 0.0f);
+            bool constant = true;
+            for (uint32_t c = 0; c < n; ++c) {
+                float low = values[c], high = values[c];
+                for (uint32_t i = 1; i < sampleCount; ++i) {
+                    low = std::min(low, values[i * n + c]);
+                    high = std::max(high, values[i * n + c]);
+                }
+                range[c] = low;
+                range[n + c] = high - low;
+                constant = constant && (high - low) * 0.5f <= settings.positionTolerance;
+            }
+            if (constant) {
+                for (uint32_t c = 0; c < n; ++c) {
+                    range[c] += range[n + c] * 0.5f;
+                }
+                range.resize(n);
+                track.bitWidth = 0;
+                continue;
+            }
+            track.bitWidth = RawBitWidth;
+            for (uint32_t bitWidth = 1; bitWidth <= MaxQuantizedBitWidth; ++bitWidth) {
+                float error = 0.0f;
+                for (uint32_t s = 0; s < segmentCount && error <= settings.positionTolerance; ++s) {
+                    const uint32_t segmentSamples = (s + 1 == segmentCount) ? lastSampleCount : fullSampleCount;
+                    scratch.assign(2 * n + (segmentSamples * n * bitWidth + 7) / 8 + DataPadding, 0);
+                    error = std::max(error, encodeVectorSegment(values + size_t(s) * SegmentIntervalCount * n,
+                                                                segmentSamples, n, range.data(), bitWidth,
+                                                                scratch.data()));
+                }
+                if (error <= settings.positionTolerance) {
+                    track.bitWidth = bitWidth;
+                    break;
+                }
+            }
+        }
+    });
+
+    // Lay out the segments, then encode each track into them
+    fullLayout.sampleCount = fullSampleCount;
+    lastLayout.sampleCount = lastSampleCount;
+    SegmentLayout *layouts[2] = { &fullLayout, &lastLayout };
+    for (SegmentLayout *layout : layouts) {
+        layout->trackOffsets.resize(trackCount);
+        for (size_t t = 0; t < trackCount; ++t) {
+            layout->trackOffsets[t] = layout->byteCount;
+            layout->byteCount += trackSegmentByteCount(trackStorage[t], layout->sampleCount);
+        }
+    }
+    for (size_t t = 0; t < trackCount; ++t) {
+        CompressedAnimationTrack &track = trackStorage[t];
+        track.firstRange = static_cast<uint32_t>(ranges.size());
+        ranges.insert(ranges.end(), trackRanges[t].begin(), trackRanges[t].end());
+    }
+    data.assign(size_t(segmentCount - 1) * fullLayout.byteCount + lastLayout.byteCount + DataPadding, 0);
+    ParallelFor(trackCount, TrackGrainSize, [&](size_t begin, size_t end) {
+        std::vector<uint8_t> scratch;
+        for (size_t t = begin; t < end; ++t) {
+            const CompressedAnimationTrack &track = trackStorage[t];
+            if (track.bitWidth == 0) {
+                continue;
+            }
+            const uint32_t n = track.componentCount;
+            for (uint32_t s = 0; s < segmentCount; ++s) {
+                const SegmentLayout &layout = (s + 1 == segmentCount) ? lastLayout : fullLayout;
+                const float *segmentSamples = samples[t].data() + size_t(s) * SegmentIntervalCount * n;
+                const uint32_t byteCount = trackSegmentByteCount(track, layout.sampleCount);
+                // Bits are written a word at a time, so encode apart from the neighbouring tracks
+                scratch.assign(byteCount + DataPadding, 0);
+                if (track.bitWidth == RotationBitWidth) {
+                    encodeRotationSegment(segmentSamples, layout.sampleCount, scratch.data());
+                } else {
+                    encodeVectorSegment(segmentSamples, layout.sampleCount, n, ranges.data() + track.firstRange,
+                                        track.bitWidth, scratch.data());
+                }
+                memcpy(data.data() + size_t(s) * fullLayout.byteCount + layout.trackOffsets[t], scratch.data(),
+                       byteCount);
+            }
+        }
+    });
+
+    for (uint32_t t = 0; t < trackCount; ++t) {
+        const CompressedAnimationTrack &track = trackStorage[t];
+        if (track.bitWidth == 0) {
+            constantTracks.push_back(t);
+        } else if (track.path == AnimationPathRotation) {
+            rotationTracks.push_back(t);
+        } else if (track.path == AnimationPathWeights) {
+            weightTracks.push_back(t);
+        } else {
+            vectorTracks.push_back(t);
+        }
+    }
+
+    if (report) {
+        *report = AnimationCompressionReport();
+        report->sourceByteCount = sourceByteCount;
+        report->compressedByteCount = byteCount();
+        report->trackCount = static_cast<uint32_t>(trackCount);
+        for (const CompressedAnimationTrack &track : trackStorage) {
+            report->constantTrackCount += (track.bitWidth == 0) ? 1 : 0;
+            report->rawTrackCount += (track.bitWidth == RawBitWidth) ? 1 : 0;
+        }
+        // Compare with the source between samples as well as at them, one chunk of times per slot
+        const size_t errorSampleCount = size_t(sampleCount - 1) * ErrorSamplesPerInterval + 1;
+        const size_t chunkCount = (errorSampleCount + SampleGrainSize - 1) / SampleGrainSize;
+        std::vector<AnimationCompressionReport> chunkErrors(chunkCount);
+        ParallelFor(errorSampleCount, SampleGrainSize, [&](size_t begin, size_t end) {
+            AnimationPose expected, actual;
+            resizePose(expected, requiredNodeCount, requiredWeightCount);
+            resizePose(actual, requiredNodeCount, requiredWeightCount);
+            AnimationCursor cursor;
+            AnimationCompressionReport &errors = chunkErrors[begin / SampleGrainSize];
+            for (size_t j = begin; j < end; ++j) {
+                const double errorRate = double(rate) * ErrorSamplesPerInterval;
+                const float time = std::min(static_cast<float>(static_cast<double>(j) / errorRate), clipDuration);
+                source.sample(time, cursor, expected);
+                sample(time, actual);
+                for (const CompressedAnimationTrack &track : trackStorage) {
+                    const float *a = trackDestination(expected, track.path, track.target);
+                    const float *b = trackDestination(actual, track.path, track.target);
+                    if (track.path == AnimationPathRotation) {
+                        errors.maxRotationError = std::max(errors.maxRotationError, rotationAngle(a, b));
+                        continue;
+                    }
+                    float error = 0.0f;
+                    for (uint32_t c = 0; c < track.componentCount; ++c) {
+                        error = std::max(error, std::fabs(a[c] - b[c]));
+                    }
+                    float &maxError = (track.path == AnimationPathTranslation) ? errors.maxTranslationError :
+                        (track.path == AnimationPathScale) ? errors.maxScaleError : errors.maxWeightError;
+                    maxError = std::max(maxError, error);
+                }
+            }
+        });
+        for (const AnimationCompressionReport &errors : chunkErrors) {
+            report->maxTranslationError = std::max(report->maxTranslationError, errors.maxTranslationError);
+            report->maxRotationError = std::max(report->maxRotationError, errors.maxRotationError);
+            report->maxScaleError = std::max(report->maxScaleError, errors.maxScaleError);
+            report->maxWeightError = std::max(report->maxWeightError, errors.maxWeightError);
+        }
+    }
+    return true;
+}
+
+size_t CompressedAnimationClip::byteCount() const {
+    return sizeof(*this) + data.size() + sizeof(float) * ranges.size() +
+        sizeof(CompressedAnimationTrack) * trackStorage.size() +
+        sizeof(uint32_t) * (fullLayout.trackOffsets.size() + lastLayout.trackOffsets.size() + constantTracks.size() +
+                            vectorTracks.size() + rotationTracks.size() + weightTracks.size());
+}
+
+bool CompressedAnimationClip::sample(float time, AnimationPose &pose) const {
+    if (sampleCount == 0 || pose.translations.size() < 3 * requiredNodeCount ||
+        pose.rotations.size() < 4 * requiredNodeCount || pose.scales.size() < 3 * requiredNodeCount ||
+        pose.weights.size() < requiredWeightCount)
+    {
+        return false;
+    }
+
+    SamplePosition position = { 0, 0, 0, 0.0f };
+    if (sampleCount > 1) {
+        const float t = std::min(std::max(time, 0.0f), clipDuration);
+        const uint32_t i = std::min(static_cast<uint32_t>(t * rate), sampleCount - 2);
+        const float start = static_cast<float>(i / double(rate));
+        const float end = std::min(static_cast<float>((i + 1) / double(rate)), clipDuration);
+        position.segment = i / SegmentIntervalCount;
+        position.sample = i - position.segment * SegmentIntervalCount;
+        position.nextSample = position.sample + 1;
+        position.fraction = (end > start) ? std::min(std::max((t - start) / (end - start), 0.0f), 1.0f) : 0.0f;
+    }
+    const SegmentLayout &layout = (position.segment + 1 == segmentCount) ? lastLayout : fullLayout;
+    const uint8_t *segmentData = data.data() + size_t(position.segment) * fullLayout.byteCount;
+
+    for (uint32_t t : constantTracks) {
+        const CompressedAnimationTrack &track = trackStorage[t];
+        memcpy(trackDestination(pose, track.path, track.target), ranges.data() + track.firstRange,
+               sizeof(float) * track.componentCount);
+    }
+
+    // Translations and scales, four tracks at a time: gather the quantized components and their dequantization
+    // into lanes, then dequantize and interpolate together
+    for (size_t first = 0; first < vectorTracks.size(); first += 4) {
+        const int laneCount = static_cast<int>(std::min<size_t>(4, vectorTracks.size() - first));
+        Float4 base[3], scale[3], from[3], to[3];
+        for (int c = 0; c < 3; ++c) {
+            base[c] = scale[c] = from[c] = to[c] = splat(0.0f);
+        }
+        Float4 fraction = splat(0.0f);
+        float *destinations[4] = { nullptr, nullptr, nullptr, nullptr };
+        for (int lane = 0; lane < laneCount; ++lane) {
+            const uint32_t t = vectorTracks[first + lane];
+            const CompressedAnimationTrack &track = trackStorage[t];
+            const uint8_t *trackData = segmentData + layout.trackOffsets[t];
+            for (uint32_t c = 0; c < 3; ++c) {
+                if (track.bitWidth == RawBitWidth) {
+                    base[c][lane] = 0.0f;
+                    scale[c][lane] = 1.0f;
+                } else {
+                    float b, s;
+                    componentDequantization(ranges.data() + track.firstRange, trackData, 3, c, track.bitWidth, b, s);
+                    base[c][lane] = b;
+                    scale[c][lane] = s;
+                }
+                from[c][lane] = readComponent(trackData, 3, track.bitWidth, position.sample, c);
+                to[c][lane] = readComponent(trackData, 3, track.bitWidth, position.nextSample, c);
+            }
+            fraction[lane] = track.step ? 0.0f : position.fraction;
+            destinations[lane] = trackDestination(pose, track.path, track.target);
+        }
+        Float4 result[3];
+        for (int c = 0; c < 3; ++c) {
+            const Float4 a = base[c] + scale[c] * from[c], b = base[c] + scale[c] * to[c];
+            result[c] = a + (b - a) * fraction;
+        }
+        for (int lane = 0; lane < laneCount; ++lane) {
+            for (int c = 0; c < 3; ++c) {
+                destinations[lane][c] = result[c][lane];
+            }
+        }
+    }
+
+    // Rotations, four tracks at a time: unpack the smallest three components, restore the largest, and interpolate
+    // along the shorter arc
+    for (size_t first = 0; first < rotationTracks.size(); first += 4) {
+        const int laneCount = static_cast<int>(std::min<size_t>(4, rotationTracks.size() - first));
+        Float4 from[4], to[4];
+        for (int c = 0; c < 4; ++c) {
+            from[c] = to[c] = splat(0.0f);
+        }
+        Float4 fraction = splat(0.0f);
+        float *destinations[4] = { nullptr, nullptr, nullptr, nullptr };
+        for (int lane = 0; lane < laneCount; ++lane) {
+            const uint32_t t = rotationTracks[first + lane];
+            const CompressedAnimationTrack &track = trackStorage[t];
+            const uint8_t *trackData = segmentData + layout.trackOffsets[t];
+            float a[4], b[4];
+            unpackRotation(readBits(trackData, size_t(position.sample) * RotationBitWidth, RotationBitWidth), a);
+            unpackRotation(readBits(trackData, size_t(position.nextSample) * RotationBitWidth, RotationBitWidth), b);
+            for (int c = 0; c < 4; ++c) {
+                from[c][lane] = a[c];
+                to[c][lane] = b[c];
+            }
+            fraction[lane] = track.step ? 0.0f : position.fraction;
+            destinations[lane] = trackDestination(pose, track.path, track.target);
+        }
+        const Float4 cosine = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+        Float4 toWeight;
+        for (int lane = 0; lane < 4; ++lane) {
+            toWeight[lane] = (cosine[lane] < 0.0f) ? -fraction[lane] : fraction[lane];
+        }
+        const Float4 fromWeight = splat(1.0f) - fraction;
+        Float4 result[4];
+        for (int c = 0; c < 4; ++c) {
+            result[c] = from[c] * fromWeight + to[c] * toWeight;
+        }
+        normalizeLanes(result);
+        for (int lane = 0; lane < laneCount; ++lane) {
+            for (int c = 0; c < 4; ++c) {
+                destinations[lane][c] = result[c][lane];
+            }
+        }
+    }
+
+    for (uint32_t t : weightTracks) {
+        const CompressedAnimationTrack &track = trackStorage[t];
+        const uint32_t n = track.componentCount;
+        const uint8_t *trackData = segmentData + layout.trackOffsets[t];
+        const float fraction = track.step ? 0.0f : position.fraction;
+        float *destination = trackDestination(pose, track.path, track.target);
+        for (uint32_t c = 0; c < n; ++c) {
+            float base = 0.0f, scale = 1.0f;
+            if (track.bitWidth != RawBitWidth) {
+                componentDequantization(ranges.data() + track.firstRange, trackData, n, c, track.bitWidth, base,
+                                        scale);
+            }
+            const float a = base + scale * readComponent(trackData, n, track.bitWidth, position.sample, c);
+            const float b = base + scale * readComponent(trackData, n, track.bitWidth, position.nextSample, c);
+            destination[c] = a + (b - a) * fraction;
+        }
+    }
+    return true;
+}
+
+void SampleCompressedAnimationInstances(const CompressedAnimationClip &clip, const float *times,
+                                        AnimationPose *const *poses, size_t count)
+{
+    ParallelFor(count, InstanceGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            clip.sample(times[i], *poses[i]);
+        }
+    });
+}
+
+} // namespace GLTF
@@ -0,0 +1,97 @@
+
+#pragma once
+
+#include "GLTFAnimationSampling.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GLTF {
+
+struct AnimationCompressionSettings {
+    float sampleRate = 30.0f;        // Samples per second
+    float positionTolerance = 1e-4f; // The largest quantization error in translation, scale or a morph weight
+    float angleTolerance = 1e-3f;    // The largest change, in radians, for which a rotation track counts as constant
+};
+
+/// The size and accuracy of a compressed clip. Errors are measured against the source clip at four times the sample
+/// rate, so they include the error of interpolating between samples as well as that of quantization.
+struct AnimationCompressionReport {
+    size_t sourceByteCount = 0;     // The key times and values of the source clip
+    size_t compressedByteCount = 0; // Everything the compressed clip stores
+    uint32_t trackCount = 0;
+    uint32_t constantTrackCount = 0;
+    uint32_t rawTrackCount = 0;     // Tracks that no width up to 24 bits reproduces, stored as floats
+    float maxTranslationError = 0.0f;
+    float maxRotationError = 0.0f;  // In radians
+    float maxScaleError = 0.0f;
+    float maxWeightError = 0.0f;
+};
+
+/// A track of a compressed clip. Its values are the constant in the clip's ranges, or are stored per segment:
+/// rotations as 48-bit smallest-three quaternions, and other tracks as components of `bitWidth` bits relative to an
+/// 8-bit range within the track's clip-wide range (or as raw floats when `bitWidth` is 32).
+struct CompressedAnimationTrack {
+    int path = AnimationPathTranslation;
+    bool step = false;           // Whether each sample holds until the next, rather than interpolating
+    uint32_t target = 0;         // As for AnimationTrack
+    uint32_t componentCount = 0;
+    uint32_t bitWidth = 0;       // 0 for constant tracks
+    uint32_t firstRange = 0;     // The index in the clip's ranges of the constant, or of the minima and extents
+};
+
+/// An animation clip resampled at a fixed rate and quantized, typically to a third or less of the size of its float
+/// keys. Samples are stored in segments of a fixed number of intervals, each holding one extra sample so that no
+/// interval spans two segments; any time is decoded from one segment without search or a cursor. Tracks are decoded
+/// four at a time, and rotations are interpolated between samples by normalized linear interpolation, which at the
+/// sample rates used for playback is indistinguishable from slerp. The clip is immutable once built.
+class CompressedAnimationClip {
+public:
+    /// The number of sample intervals in a segment
+    static const uint32_t SegmentIntervalCount = 16;
+
+    /// Compresses `source`, which must not be empty. Returns false, leaving the clip empty, if the settings are
+    /// invalid. If `report` is given, the clip is decoded against the source to measure its accuracy.
+    bool build(const AnimationClip &source, const AnimationCompressionSettings &settings,
+               AnimationCompressionReport *report);
+
+    float duration() const { return clipDuration; }
+    float sampleRate() const { return rate; }
+    size_t byteCount() const;
+    const std::vector<CompressedAnimationTrack> &tracks() const { return trackStorage; }
+
+    /// Evaluates every track at `time`, clamped to the clip's duration, and writes the results to `pose`, leaving
+    /// properties that no track animates unchanged. Returns false, writing nothing, if `pose` is too small.
+    bool sample(float time, AnimationPose &pose) const;
+
+private:
+    // The offset in bytes of each track's data within a segment, and the size of the segment
+    struct SegmentLayout {
+        std::vector<uint32_t> trackOffsets;
+        uint32_t byteCount = 0;
+        uint32_t sampleCount = 0;
+    };
+
+    std::vector<CompressedAnimationTrack> trackStorage;
+    std::vector<float> ranges;
+    std::vector<uint8_t> data; // Segments of fullLayout, then one of lastLayout, then padding for 64-bit reads
+    SegmentLayout fullLayout;
+    SegmentLayout lastLayout;
+    // Indices of tracks by the way they are decoded
+    std::vector<uint32_t> constantTracks;
+    std::vector<uint32_t> vectorTracks;
+    std::vector<uint32_t> rotationTracks;
+    std::vector<uint32_t> weightTracks;
+    float clipDuration = 0.0f;
+    float rate = 0.0f;
+    uint32_t sampleCount = 0;
+    uint32_t segmentCount = 0;
+    size_t requiredNodeCount = 0;
+    size_t requiredWeightCount = 0;
+};
+
+/// Samples `clip` at `times[i]` into `*poses[i]` for `count` instances, in parallel.
+void SampleCompressedAnimationInstances(const CompressedAnimationClip &clip, const float *times,
+                                        AnimationPose *const *poses, size_t count);
+
+} // namespace GLTF
@@ -0,0 +1,350 @@
+
+#include "GLTFAnimationSampling.h"
+#include "GLTFParallel.h"
+
+namespace GLTF {
+
+namespace {
+
+// Instances per unit of parallel work when sampling many
+const size_t InstanceGrainSize = 16;
+
+// Above this cosine of the angle between two rotations, slerp is replaced by normalized linear interpolation, which
+// is indistinguishable there and avoids dividing by a vanishing sine
+const float SlerpThreshold = 0.9995f;
+
+typedef float Float4 __attribute__((vector_size(16)));
+
+inline Float4 splat(float f) {
+    Float4 v = { f, f, f, f };
+    return v;
+}
+
+inline Float4 load4(const float *p) {
+    Float4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// The keys on either side of a sample time, which are the same key before the first key or after the last
+struct KeyInterval {
+    uint32_t key;
+    uint32_t nextKey;
+    float fraction; // How far the sample time is from the first key toward the next, from 0 to 1
+    float length;   // The time between the keys
+};
+
+// Finds the keys around `time`, starting from the interval in `cursor` and updating it. Sample times that advance
+// (or retreat) by at most one interval are found without a search.
+KeyInterval locateKeys(const float *keyTimes, uint32_t keyCount, float time, uint32_t &cursor) {
+    KeyInterval interval = { 0, 0, 0.0f, 0.0f };
+    if (keyCount < 2 || !(time > keyTimes[0])) {
+        return interval;
+    }
+    if (time >= keyTimes[keyCount - 1]) {
+        interval.key = interval.nextKey = keyCount - 1;
+        return interval;
+    }
+    // From here, keyTimes[0] < time < keyTimes[keyCount - 1], so the interval exists and is not the last key
+    uint32_t k = std::min(cursor, keyCount - 2);
+    if (keyTimes[k] <= time) {
+        if (time >= keyTimes[k + 1]) {
+            if (time < keyTimes[k + 2]) {
+                k += 1;
+            } else {
+                k = static_cast<uint32_t>(std::upper_bound(keyTimes + k + 2, keyTimes + keyCount, time) - keyTimes) - 1;
+            }
+        }
+    } else if (k > 0 && keyTimes[k - 1] <= time) {
+        k -= 1;
+    } else {
+        k = static_cast<uint32_t>(std::upper_bound(keyTimes, keyTimes + k, time) - keyTimes) - 1;
+    }
+    cursor = k;
+    interval.key = k;
+    interval.nextKey = k + 1;
+    interval.length = keyTimes[k + 1] - keyTimes[k];
+    interval.fraction = (interval.length > 0.0f) ? (time - keyTimes[k]) / interval.length : 0.0f;
+    return interval;
+}
+
+float *trackDestination(AnimationPose &pose, const AnimationTrack &track) {
+    switch (track.path) {
+        case AnimationPathTranslation: return pose.translations.data() + 3 * track.target;
+        case AnimationPathRotation:    return pose.rotations.data() + 4 * track.target;
+        case AnimationPathScale:       return pose.scales.data() + 3 * track.target;
+        default:                       return pose.weights.data() + track.target;
+    }
+}
+
+void normalizeLanes(Float4 *components, int componentCount) {
+    Float4 lengthSquared = splat(0.0f);
+    for (int c = 0; c < componentCount; ++c) {
+        lengthSquared += components[c] * components[c];
+    }
+    Float4 scale;
+    for (int lane = 0; lane < 4; ++lane) {
+        scale[lane] = (lengthSquared[lane] > 0.0f) ? 1.0f / std::sqrt(lengthSquared[lane]) : 0.0f;
+    }
+    for (int c = 0; c < componentCount; ++c) {
+        components[c] *= scale;
+    }
+}
+
+// The state of one batch of up to four tracks of the same kind, with components transposed into lanes
+struct TrackLanes {
+    int laneCount = 0;
+    float *destinations[4] = { nullptr, nullptr, nullptr, nullptr };
+    Float4 fraction = splat(0.0f);
+    Float4 length = splat(0.0f);
+};
+
+// Evaluates linearly interpolated translation, scale (componentCount 3) or rotation (componentCount 4) tracks,
+// four at a time.
+void sampleLinearTracks(const std::vector<uint32_t> &trackIndices, const std::vector<AnimationTrack> &tracks,
+                        const float *times, const float *values, float time, int componentCount,
+                        uint32_t *cursorKeys, AnimationPose &pose)
+{
+    const bool isRotation = (componentCount == 4);
+    for (size_t first = 0; first < trackIndices.size(); first += 4) {
+        TrackLanes lanes;
+        Float4 from[4] = { splat(0.0f), splat(0.0f), splat(0.0f), splat(0.0f) };
+        Float4 to[4] = { splat(0.0f), splat(0.0f), splat(0.0f), splat(0.0f) };
+        lanes.laneCount = static_cast<int>(std::min<size_t>(4, trackIndices.size() - first));
+        for (int lane = 0; lane < lanes.laneCount; ++lane) {
+            const uint32_t t = trackIndices[first + lane];
+            const AnimationTrack &track = tracks[t];
+            const KeyInterval interval = locateKeys(times + track.firstKey, track.keyCount, time, cursorKeys[t]);
+            const float *a = values + track.firstValue + interval.key * componentCount;
+            const float *b = values + track.firstValue + interval.nextKey * componentCount;
+            for (int c = 0; c < componentCount; ++c) {
+                from[c][lane] = a[c];
+                to[c][lane] = b[c];
+            }
+            lanes.fraction[lane] = interval.fraction;
+            lanes.destinations[lane] = trackDestination(pose, track);
+        }
+        Float4 result[4];
+        if (isRotation) {
+            const Float4 cosine = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+            Float4 fromWeight, toWeight;
+            for (int lane = 0; lane < 4; ++lane) {
+                // Take the shorter way around
+                const float sign = (cosine[lane] < 0.0f) ? -1.0f : 1.0f;
+                const float c = std::fabs(cosine[lane]), u = lanes.fraction[lane];
+                if (c > SlerpThreshold) {
+                    fromWeight[lane] = 1.0f - u;
+                    toWeight[lane] = u * sign;
+                } else {
+                    const float angle = std::acos(c), inverseSine = 1.0f / std::sin(angle);
+                    fromWeight[lane] = std::sin((1.0f - u) * angle) * inverseSine;
+                    toWeight[lane] = std::sin(u * angle) * inverseSine * sign;
+                }
+            }
+            for (int c = 0; c < 4; ++c) {
+                result[c] = from[c] * fromWeight + to[c] * toWeight;
+            }
+            normalizeLanes(result, 4);
+        } else {
+            for (int c = 0; c < componentCount; ++c) {
+                result[c] = from[c] + (to[c] - from[c]) * lanes.fraction;
+            }
+        }
+        for (int lane = 0; lane < lanes.laneCount; ++lane) {
+            for (int c = 0; c < componentCount; ++c) {
+                lanes.destinations[lane][c] = result[c][lane];
+            }
+        }
+    }
+}
+
+// Evaluates cubic spline translation, scale or rotation tracks four at a time, as Hermite curves through the key
+// values with the keys' out- and in-tangents, which glTF stores before and after each value.
+void sampleCubicTracks(const std::vector<uint32_t> &trackIndices, const std::vector<AnimationTrack> &tracks,
+                       const float *times, const float *values, float time, int componentCount,
+                       uint32_t *cursorKeys, AnimationPose &pose)
+{
+    for (size_t first = 0; first < trackIndices.size(); first += 4) {
+        TrackLanes lanes;
+        Float4 from[4], outTangent[4], to[4], inTangent[4];
+        for (int c = 0; c < 4; ++c) {
+            from[c] = outTangent[c] = to[c] = inTangent[c] = splat(0.0f);
+        }
+        lanes.laneCount = static_cast<int>(std::min<size_t>(4, trackIndices.size() - first));
+        for (int lane = 0; lane < lanes.laneCount; ++lane) {
+            const uint32_t t = trackIndices[first + lane];
+            const AnimationTrack &track = tracks[t];
+            const KeyInterval interval = locateKeys(times + track.firstKey, track.keyCount, time, cursorKeys[t]);
+            const float *keyValues = values + track.firstValue;
+            const float *a = keyValues + (3 * interval.key + 1) * componentCount;
+            const float *aOut = keyValues + (3 * interval.key + 2) * componentCount;
+            const float *bIn = keyValues + (3 * interval.nextKey) * componentCount;
+            const float *b = keyValues + (3 * interval.nextKey + 1) * componentCount;
+            for (int c = 0; c < componentCount; ++c) {
+                from[c][lane] = a[c];
+                outTangent[c][lane] = aOut[c];
+                inTangent[c][lane] = bIn[c];
+                to[c][lane] = b[c];
+            }
+            lanes.fraction[lane] = interval.fraction;
+            lanes.length[lane] = interval.length;
+            lanes.destinations[lane] = trackDestination(pose, track);
+        }
+        const Float4 s = lanes.fraction, s2 = s * s, s3 = s2 * s;
+        const Float4 h00 = splat(2.0f) * s3 - splat(3.0f) * s2 + splat(1.0f);
+        const Float4 h10 = (s3 - splat(2.0f) * s2 + s) * lanes.length;
+        const Float4 h01 = splat(3.0f) * s2 - splat(2.0f) * s3;
+        const Float4 h11 = (s3 - s2) * lanes.length;
+        Float4 result[4];
+        for (int c = 0; c < componentCount; ++c) {
+            result[c] = h00 * from[c] + h10 * outTangent[c] + h01 * to[c] + h11 * inTangent[c];
+        }
+        if (componentCount == 4) {
+            normalizeLanes(result, 4);
+        }
+        for (int lane = 0; lane < lanes.laneCount; ++lane) {
+            for (int c = 0; c < componentCount; ++c) {
+                lanes.destinations[lane][c] = result[c][lane];
+            }
+        }
+    }
+}
+
+// Evaluates one step track, or one morph weight track of any interpolation.
+void sampleScalarTrack(const AnimationTrack &track, const float *times, const float *values, float time,
+                       uint32_t &cursorKey, AnimationPose &pose)
+{
+    const KeyInterval interval = locateKeys(times + track.firstKey, track.keyCount, time, cursorKey);
+    const uint32_t n = track.componentCount;
+    const float *keyValues = values + track.firstValue;
+    float *destination = trackDestination(pose, track);
+    switch (track.interpolation) {
+        case InterpolationStep:
+            memcpy(destination, keyValues + interval.key * n, n * sizeof(float));
+            break;
+        case InterpolationCubic: {
+            const float s = interval.fraction, s2 = s * s, s3 = s2 * s;
+            const float h00 = 2.0f * s3 - 3.0f * s2 + 1.0f, h10 = (s3 - 2.0f * s2 + s) * interval.length;
+            const float h01 = 3.0f * s2 - 2.0f * s3, h11 = (s3 - s2) * interval.length;
+            const float *a = keyValues + (3 * interval.key + 1) * n, *aOut = keyValues + (3 * interval.key + 2) * n;
+            const float *bIn = keyValues + 3 * interval.nextKey * n, *b = keyValues + (3 * interval.nextKey + 1) * n;
+            for (uint32_t c = 0; c < n; ++c) {
+                destination[c] = h00 * a[c] + h10 * aOut[c] + h01 * b[c] + h11 * bIn[c];
+            }
+            break;
+        }
+        default: {
+            const float *a = keyValues + interval.key * n, *b = keyValues + interval.nextKey * n;
+            for (uint32_t c = 0; c < n; ++c) {
+                destination[c] = a[c] + (b[c] - a[c]) * interval.fraction;
+            }
+            break;
+        }
+    }
+    if (track.path == AnimationPathRotation) {
+        float lengthSquared = 0.0f;
+        for (int c = 0; c < 4; ++c) {
+            lengthSquared += destination[c] * destination[c];
+        }
+        if (lengthSquared > 0.0f) {
+            const float scale = 1.0f / std::sqrt(lengthSquared);
+            for (int c = 0; c < 4; ++c) {
+                destination[c] *= scale;
+            }
+        }
+    }
+}
+
+} // namespace
+
+bool AnimationClip::addTrack(int path, int interpolation, uint32_t target, uint32_t componentCount,
+                             const AccessorView &input, const AccessorView &output)
+{
+    if (path < AnimationPathTranslation || path > AnimationPathWeights ||
+        interpolation < InterpolationLinear || interpolation > InterpolationCubic)
+    {
+        return false;
+    }
+    const uint32_t expectedComponentCount = (path == AnimationPathRotation) ? 4 : 3;
+    if (path != AnimationPathWeights && componentCount != expectedComponentCount) {
+        return false;
+    }
+    const size_t elementsPerKey = (interpolation == InterpolationCubic) ? 3 : 1;
+    if (!input.isValid() || !output.isValid() || input.count == 0 || componentCount == 0 ||
+        output.count * output.componentCount != input.count * elementsPerKey * componentCount)
+    {
+        return false;
+    }
+
+    AnimationTrack track;
+    track.path = path;
+    track.interpolation = interpolation;
+    track.target = target;
+    track.componentCount = componentCount;
+    track.firstKey = static_cast<uint32_t>(times.size());
+    track.keyCount = static_cast<uint32_t>(input.count);
+    track.firstValue = static_cast<uint32_t>(values.size());
+
+    std::vector<float> keyTimes(input.count);
+    for (size_t k = 0; k < input.count; ++k) {
+        ReadFloats(input, k, &keyTimes[k], 1);
+        if (!std::isfinite(keyTimes[k]) || (k > 0 && keyTimes[k] < keyTimes[k - 1])) {
+            return false;
+        }
+    }
+    times.insert(times.end(), keyTimes.begin(), keyTimes.end());
+    values.resize(values.size() + output.count * output.componentCount);
+    float *destination = values.data() + track.firstValue;
+    for (size_t e = 0; e < output.count; ++e) {
+        destination += ReadFloats(output, e, destination, output.componentCount);
+    }
+
+    const uint32_t trackIndex = static_cast<uint32_t>(trackStorage.size());
+    trackStorage.push_back(track);
+    if (path == AnimationPathWeights || interpolation == InterpolationStep) {
+        scalarTracks.push_back(trackIndex);
+    } else if (interpolation == InterpolationLinear) {
+        (path == AnimationPathRotation ? linearRotationTracks : linearVectorTracks).push_back(trackIndex);
+    } else {
+        (path == AnimationPathRotation ? cubicRotationTracks : cubicVectorTracks).push_back(trackIndex);
+    }
+    lastKeyTime = std::max(lastKeyTime, keyTimes.back());
+    if (path == AnimationPathWeights) {
+        requiredWeightCount = std::max<size_t>(requiredWeightCount, size_t(target) + componentCount);
+    } else {
+        requiredNodeCount = std::max<size_t>(requiredNodeCount, size_t(target) + 1);
+    }
+    return true;
+}
+
+bool AnimationClip::sample(float time, AnimationCursor &cursor, AnimationPose &pose) const {
+    if (pose.translations.size() < 3 * requiredNodeCount || pose.rotations.size() < 4 * requiredNodeCount ||
+        pose.scales.size() < 3 * requiredNodeCount || pose.weights.size() < requiredWeightCount)
+    {
+        return false;
+    }
+    if (cursor.keys.size() != trackStorage.size()) {
+        cursor.keys.assign(trackStorage.size(), 0);
+    }
+    uint32_t *cursorKeys = cursor.keys.data();
+    sampleLinearTracks(linearVectorTracks, trackStorage, times.data(), values.data(), time, 3, cursorKeys, pose);
+    sampleLinearTracks(linearRotationTracks, trackStorage, times.data(), values.data(), time, 4, cursorKeys, pose);
+    sampleCubicTracks(cubicVectorTracks, trackStorage, times.data(), values.data(), time, 3, cursorKeys, pose);
+    sampleCubicTracks(cubicRotationTracks, trackStorage, times.data(), values.data(), time, 4, cursorKeys, pose);
+    for (uint32_t t : scalarTracks) {
+        sampleScalarTrack(trackStorage[t], times.data(), values.data(), time, cursorKeys[t], pose);
+    }
+    return true;
+}
+
+void SampleAnimationInstances(const AnimationClip &clip, const float *times, AnimationCursor *const *cursors,
+                              AnimationPose *const *poses, size_t count)
+{
+    ParallelFor(count, InstanceGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            clip.sample(times[i], *cursors[i], *poses[i]);
+        }
+    });
+}
+
+} // namespace GLTF
@@ -0,0 +1,93 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+// These mirror the values of GLTFInterpolationMode.
+enum Interpolation : int {
+    InterpolationLinear,
+    InterpolationStep,
+    InterpolationCubic,
+};
+
+enum AnimationPath : int {
+    AnimationPathTranslation,
+    AnimationPathRotation,
+    AnimationPathScale,
+    AnimationPathWeights,
+};
+
+/// The local transforms and morph weights of a set of nodes, each kind in one flat array indexed by node.
+struct AnimationPose {
+    std::vector<float> translations; // 3 floats per node
+    std::vector<float> rotations;    // 4 floats (a unit quaternion, x y z w) per node
+    std::vector<float> scales;       // 3 floats per node
+    std::vector<float> weights;      // Morph target weights, in a run per node
+
+    size_t nodeCount() const { return translations.size() / 3; }
+};
+
+/// An animation channel, whose keys and values are runs of the clip's shared arrays.
+struct AnimationTrack {
+    int path = AnimationPathTranslation;
+    int interpolation = InterpolationLinear;
+    uint32_t target = 0;         // The node, or for weights the index of the node's first weight in the pose
+    uint32_t componentCount = 0; // 3 for translation and scale, 4 for rotation, or the number of morph weights
+    uint32_t firstKey = 0;       // The index of the track's first key time
+    uint32_t keyCount = 0;
+    uint32_t firstValue = 0;     // The index of the track's first value component
+};
+
+/// The key interval at which each track of a clip was last sampled. During playback, time moves by less than a key
+/// interval between samples, so keys are found in constant time rather than by search. Each instance of a clip
+/// being played needs a cursor of its own.
+struct AnimationCursor {
+    std::vector<uint32_t> keys;
+};
+
+/// Animation channels prepared for evaluation, with their key times and values in two arrays shared by all tracks.
+/// Tracks are grouped by how they are interpolated, so that linear and cubic transform tracks are evaluated four
+/// at a time. Sampling does not modify the clip, so one clip can drive any number of instances concurrently.
+class AnimationClip {
+public:
+    /// Adds a track that animates `path` of `target` (see AnimationTrack) with `componentCount` components, reading
+    /// key times from `input` and values from `output`, which holds an in-tangent, a value and an out-tangent for
+    /// each key when `interpolation` is cubic, and may be normalized. Returns false, adding nothing, if the accessors
+    /// disagree in count, or the key times are not increasing.
+    bool addTrack(int path, int interpolation, uint32_t target, uint32_t componentCount,
+                  const AccessorView &input, const AccessorView &output);
+
+    /// The time of the last key of any track
+    float duration() const { return lastKeyTime; }
+
+    const std::vector<AnimationTrack> &tracks() const { return trackStorage; }
+
+    /// Evaluates every track at `time` and writes the results to `pose`, leaving properties that no track animates
+    /// unchanged. Times outside a track's keys take its first or last value. Returns false, writing nothing, if
+    /// `pose` is too small for the tracks' targets.
+    bool sample(float time, AnimationCursor &cursor, AnimationPose &pose) const;
+
+private:
+    std::vector<float> times;
+    std::vector<float> values;
+    std::vector<AnimationTrack> trackStorage;
+    // Indices of tracks by the way they are evaluated
+    std::vector<uint32_t> linearVectorTracks;
+    std::vector<uint32_t> linearRotationTracks;
+    std::vector<uint32_t> cubicVectorTracks;
+    std::vector<uint32_t> cubicRotationTracks;
+    std::vector<uint32_t> scalarTracks; // Step interpolation and morph weights
+    float lastKeyTime = 0.0f;
+    size_t requiredNodeCount = 0;
+    size_t requiredWeightCount = 0;
+};
+
+/// Samples `clip` at `times[i]` into `*poses[i]` with `*cursors[i]` for `count` instances, in parallel.
+void SampleAnimationInstances(const AnimationClip &clip, const float *times, AnimationCursor *const *cursors,
+                              AnimationPose *const *poses, size_t count);
+
+} // namespace GLTF
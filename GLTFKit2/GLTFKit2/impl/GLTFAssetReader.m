@@ -1,6 +1,10 @@
 
 #import "GLTFAssetReader.h"
+#import "GLTFAnimationRuntime.h"
+#import "GLTFLogging.h"
+#import "GLTFMeshProcessing.h"
 #import "GLTFMeshoptSupport.h"
+#import "GLTFSceneProcessing.h"
 
 #define CGLTF_IMPLEMENTATION
 #import "cgltf.h"
@@ -22,8 +26,28 @@ static NSString *const GLTFExtensionEXTMeshoptCompression = @"EXT_meshopt_compre
 @property (nonatomic, nullable, strong) NSURL *assetURL;
 @property (nonatomic, nullable, strong) NSURL *assetDirectoryURL;
 @property (nonatomic, nullable, strong) NSString *lastAccessedPath;
+@property (nonatomic, assign) BOOL computesMissingBounds;
+@property (nonatomic, assign) BOOL validatesIndices;
+@property (nonatomic, assign) BOOL createsNormalsIfAbsent;
+@property (nonatomic, assign) float normalCreaseAngle;
+@property (nonatomic, assign) BOOL createsTangentsIfAbsent;
+@property (nonatomic, assign) BOOL optimizesMeshes;
+@property (nonatomic, assign) NSInteger levelOfDetailCount;
+@property (nonatomic, assign) float levelOfDetailTargetError;
+@property (nonatomic, assign) BOOL buildsMeshlets;
+@property (nonatomic, assign) NSInteger meshletMaxVertexCount;
+@property (nonatomic, assign) NSInteger meshletMaxTriangleCount;
+@property (nonatomic, assign) BOOL weldsVertices;
+@property (nonatomic, assign) float weldEpsilon;
+@property (nonatomic, assign) BOOL quantizesMeshes;
+@property (nonatomic, assign) BOOL reducesKeyframes;
+@property (nonatomic, assign) double keyframeSampleRate;
+@property (nonatomic, assign) float keyframePositionTolerance;
+@property (nonatomic, assign) float keyframeAngleTolerance;
 @property (nonatomic, strong) GLTFAsset *asset;
 @property (nonatomic, strong) GLTFUniqueNameGenerator *nameGenerator;
+/// Buffers whose data the reader created as NSMutableData, and which processing may therefore rewrite in place
+@property (nonatomic, strong) NSMutableSet<GLTFBuffer *> *mutableBuffers;
 @end
 
 @implementation GLTFUniqueNameGenerator
@@ -413,6 +437,7 @@ NSDictionary *GLTFConvertExtensions(cgltf_extension *extensions, size_t count, N
 - (instancetype)init {
     if (self = [super init]) {
         _nameGenerator = [GLTFUniqueNameGenerator new];
+        _mutableBuffers = [NSMutableSet set];
     }
     return self;
 }
@@ -424,6 +449,30 @@ NSDictionary *GLTFConvertExtensions(cgltf_extension *extensions, size_t count, N
 {
     self.assetURL = assetURL;
     self.assetDirectoryURL = options[GLTFAssetAssetDirectoryURLKey];
+    self.computesMissingBounds = [options[GLTFAssetComputeMissingBoundsKey] boolValue];
+    self.validatesIndices = [options[GLTFAssetValidateIndicesKey] boolValue];
+    self.createsNormalsIfAbsent = [options[GLTFAssetCreateNormalsIfAbsentKey] boolValue];
+    self.normalCreaseAngle = [options[GLTFAssetNormalCreaseAngleKey] floatValue];
+    self.createsTangentsIfAbsent = [options[GLTFAssetCreateTangentsIfAbsentKey] boolValue];
+    self.optimizesMeshes = [options[GLTFAssetOptimizeMeshesKey] boolValue];
+    self.levelOfDetailCount = [options[GLTFAssetLevelOfDetailCountKey] integerValue];
+    self.levelOfDetailTargetError = options[GLTFAssetLevelOfDetailTargetErrorKey] ?
+        [options[GLTFAssetLevelOfDetailTargetErrorKey] floatValue] : 0.01f;
+    self.buildsMeshlets = [options[GLTFAssetBuildMeshletsKey] boolValue];
+    self.meshletMaxVertexCount = options[GLTFAssetMeshletMaxVertexCountKey] ?
+        [options[GLTFAssetMeshletMaxVertexCountKey] integerValue] : 64;
+    self.meshletMaxTriangleCount = options[GLTFAssetMeshletMaxTriangleCountKey] ?
+        [options[GLTFAssetMeshletMaxTriangleCountKey] integerValue] : 124;
+    self.weldsVertices = [options[GLTFAssetWeldVerticesKey] boolValue];
+    self.weldEpsilon = [options[GLTFAssetWeldEpsilonKey] floatValue];
+    self.quantizesMeshes = [options[GLTFAssetQuantizeMeshesKey] boolValue];
+    self.reducesKeyframes = [options[GLTFAssetReduceKeyframesKey] boolValue];
+    self.keyframeSampleRate = options[GLTFAssetKeyframeSampleRateKey] ?
+        [options[GLTFAssetKeyframeSampleRateKey] doubleValue] : 30.0;
+    self.keyframePositionTolerance = options[GLTFAssetKeyframePositionToleranceKey] ?
+        [options[GLTFAssetKeyframePositionToleranceKey] floatValue] : 1e-4f;
+    self.keyframeAngleTolerance = options[GLTFAssetKeyframeAngleToleranceKey] ?
+        [options[GLTFAssetKeyframeAngleToleranceKey] floatValue] : 1e-3f;
 
     if (assetURL) {
         self.lastAccessedPath = assetURL.path;
@@ -498,7 +547,8 @@ NSDictionary *GLTFConvertExtensions(cgltf_extension *extensions, size_t count, N
         cgltf_buffer *b = gltf->buffers + i;
         GLTFBuffer *buffer = nil;
         if (b->data) {
-            buffer = [[GLTFBuffer alloc] initWithData:[NSData dataWithBytes:b->data length:b->size]];
+            buffer = [[GLTFBuffer alloc] initWithData:[NSMutableData dataWithBytes:b->data length:b->size]];
+            [self.mutableBuffers addObject:buffer];
         } else {
             buffer = [[GLTFBuffer alloc] initWithLength:b->size];
         }
@@ -527,10 +577,10 @@ NSDictionary *GLTFConvertExtensions(cgltf_extension *extensions, size_t count, N
     // by a buffer view has a byte length large enough to hold any buffer views that reference it.
     // If a fallback buffer has pre-existing data (an unusual configuration), we ignore its contents
     // and create ad-hoc buffers for each meshopt-compressed buffer view.
-    NSMutableDictionary *mutableDatasForBuffers = [NSMutableDictionary dictionary];
+    NSMutableDictionary<NSNumber *, NSMutableData *> *mutableDatasForBuffers = [NSMutableDictionary dictionary];
     for (GLTFBuffer *buffer in self.asset.buffers) {
         if (buffer.isMeshoptFallback && (buffer.data == nil)) {
-            mutableDatasForBuffers[buffer.identifier] = [NSMutableData dataWithLength:buffer.length];
+            mutableDatasForBuffers[@(buffer.handle)] = [NSMutableData dataWithLength:buffer.length];
         }
     }
 
@@ -560,7 +610,7 @@ NSDictionary *GLTFConvertExtensions(cgltf_extension *extensions, size_t count, N
             bufferView.meshoptCompression = meshopt;
 
             NSError *error = nil;
-            NSMutableData *targetBufferData = mutableDatasForBuffers[bufferView.buffer.identifier];
+            NSMutableData *targetBufferData = mutableDatasForBuffers[@(bufferView.buffer.handle)];
             if (targetBufferData) {
                 uint8_t *targetBufferViewPtr = targetBufferData.mutableBytes + bufferView.offset;
                 GLTFMeshoptDecodeBufferView(bufferView, targetBufferViewPtr, &error);
@@ -572,6 +622,7 @@ NSDictionary *GLTFConvertExtensions(cgltf_extension *extensions, size_t count, N
                 // Create a new ad-hoc buffer to wrap the buffer view's decompressed storage and patch the buffer view
                 GLTFBuffer *adhocBuffer = [[GLTFBuffer alloc] initWithData:targetBufferData];
                 adhocBuffer.meshoptFallback = YES;
+                [self.mutableBuffers addObject:adhocBuffer];
                 bufferView.buffer = adhocBuffer;
                 bufferView.offset = 0;
 
@@ -586,7 +637,8 @@ NSDictionary *GLTFConvertExtensions(cgltf_extension *extensions, size_t count, N
     // been populated by its referencing meshopt-compressed buffer views
     for (GLTFBuffer *buffer in self.asset.buffers) {
         if (buffer.isMeshoptFallback && buffer.data == nil) {
-            buffer.data = mutableDatasForBuffers[buffer.identifier];
+            buffer.data = mutableDatasForBuffers[@(buffer.handle)];
+            [self.mutableBuffers addObject:buffer];
         }
     }
 
@@ -1348,6 +1400,350 @@ NSDictionary *GLTFConvertExtensions(cgltf_extension *extensions, size_t count, N
     return (unsupportedExtensions.count == 0);
 }
 
+// Runs `processor` on every primitive, concurrently since each call only touches its own primitive, and adds the
+// accessors it creates, along with their buffer views and buffers, to the asset.
+- (void)processPrimitives:(NSArray<GLTFAccessor *> *_Nullable (^)(GLTFPrimitive *primitive, NSError **error))processor
+{
+    NSMutableArray<GLTFPrimitive *> *primitives = [NSMutableArray array];
+    NSMutableArray<GLTFMesh *> *primitiveMeshes = [NSMutableArray array];
+    for (GLTFMesh *mesh in self.asset.meshes) {
+        for (GLTFPrimitive *primitive in mesh.primitives) {
+            [primitives addObject:primitive];
+            [primitiveMeshes addObject:mesh];
+        }
+    }
+    // Each slot receives either the array of new accessors or the error that prevented generation
+    NSMutableArray *results = [NSMutableArray arrayWithCapacity:primitives.count];
+    for (NSUInteger i = 0; i < primitives.count; ++i) {
+        [results addObject:[NSNull null]];
+    }
+    dispatch_apply(primitives.count, DISPATCH_APPLY_AUTO, ^(size_t i) {
+        NSError *error = nil;
+        id result = processor(primitives[i], &error) ?: error;
+        @synchronized (results) {
+            results[i] = result ?: [NSNull null];
+        }
+    });
+
+    NSMutableArray<GLTFAccessor *> *accessors = [self.asset.accessors mutableCopy];
+    NSMutableArray<GLTFBufferView *> *bufferViews = [self.asset.bufferViews mutableCopy];
+    NSMutableArray<GLTFBuffer *> *buffers = [self.asset.buffers mutableCopy];
+    for (NSUInteger i = 0; i < primitives.count; ++i) {
+        if (![results[i] isKindOfClass:[NSArray class]]) {
+            NSError *error = [results[i] isKindOfClass:[NSError class]] ? results[i] : nil;
+            GLTFLogWarning(@"[GLTFKit2] %@ in mesh %@", error.localizedDescription ?: @"Primitive processing failed",
+                           primitiveMeshes[i].name ?: @"(unnamed)");
+            continue;
+        }
+        for (GLTFAccessor *accessor in results[i]) {
+            [accessors addObject:accessor];
+            [bufferViews addObject:accessor.bufferView];
+            [buffers addObject:accessor.bufferView.buffer];
+        }
+    }
+    self.asset.accessors = accessors;
+    self.asset.bufferViews = bufferViews;
+    self.asset.buffers = buffers;
+}
+
+- (void)weldVertices
+{
+    if (!self.weldsVertices) {
+        return;
+    }
+    float epsilon = self.weldEpsilon;
+    [self processPrimitives:^NSArray<GLTFAccessor *> *(GLTFPrimitive *primitive, NSError **error) {
+        return GLTFPrimitiveWeldVertices(primitive, epsilon, error);
+    }];
+}
+
+- (void)createMissingNormals
+{
+    if (!self.createsNormalsIfAbsent) {
+        return;
+    }
+    float creaseAngle = self.normalCreaseAngle;
+    [self processPrimitives:^NSArray<GLTFAccessor *> *(GLTFPrimitive *primitive, NSError **error) {
+        return GLTFPrimitiveGenerateNormals(primitive, creaseAngle, error);
+    }];
+}
+
+- (void)createMissingTangents
+{
+    if (!self.createsTangentsIfAbsent) {
+        return;
+    }
+    [self processPrimitives:^NSArray<GLTFAccessor *> *(GLTFPrimitive *primitive, NSError **error) {
+        return GLTFPrimitiveGenerateTangents(primitive, error);
+    }];
+}
+
+// Accessors that mesh processing may rewrite in place. Each is used exactly once in the asset, is the only accessor in
+// its buffer view, which overlaps no other buffer view and is not meshopt-compressed, and lives in a buffer whose data
+// the reader created as mutable. Runs before nodes, skins, and animations are converted, so their uses are counted
+// from the source document.
+- (NSSet<GLTFAccessor *> *)unsharedAccessors
+{
+    NSCountedSet<GLTFAccessor *> *accessorUses = [NSCountedSet set];
+    for (GLTFMesh *mesh in self.asset.meshes) {
+        for (GLTFPrimitive *primitive in mesh.primitives) {
+            for (GLTFAttribute *attribute in primitive.attributes) {
+                [accessorUses addObject:attribute.accessor];
+            }
+            for (GLTFMorphTarget *target in primitive.targets) {
+                for (GLTFAttribute *attribute in target) {
+                    [accessorUses addObject:attribute.accessor];
+                }
+            }
+            if (primitive.indices) {
+                [accessorUses addObject:primitive.indices];
+            }
+            for (GLTFAccessor *accessor in primitive.levelOfDetailIndices) {
+                [accessorUses addObject:accessor];
+            }
+        }
+    }
+    NSArray<GLTFAccessor *> *documentAccessors = self.asset.accessors;
+    for (int i = 0; i < gltf->nodes_count; ++i) {
+        cgltf_node *n = gltf->nodes + i;
+        for (int j = 0; n->has_mesh_gpu_instancing && j < n->mesh_gpu_instancing.attributes_count; ++j) {
+            cgltf_accessor *a = n->mesh_gpu_instancing.attributes[j].data;
+            [accessorUses addObject:documentAccessors[cgltf_accessor_index(gltf, a)]];
+        }
+    }
+    for (int i = 0; i < gltf->skins_count; ++i) {
+        cgltf_accessor *a = gltf->skins[i].inverse_bind_matrices;
+        if (a) {
+            [accessorUses addObject:documentAccessors[cgltf_accessor_index(gltf, a)]];
+        }
+    }
+    for (int i = 0; i < gltf->animations_count; ++i) {
+        cgltf_animation *a = gltf->animations + i;
+        for (int j = 0; j < a->samplers_count; ++j) {
+            [accessorUses addObject:documentAccessors[cgltf_accessor_index(gltf, a->samplers[j].input)]];
+            [accessorUses addObject:documentAccessors[cgltf_accessor_index(gltf, a->samplers[j].output)]];
+        }
+    }
+
+    NSMutableSet<GLTFAccessor *> *accessors = [NSMutableSet setWithArray:documentAccessors];
+    [accessors unionSet:accessorUses];
+    NSCountedSet<GLTFBufferView *> *bufferViewUses = [NSCountedSet set];
+    for (GLTFAccessor *accessor in accessors) {
+        if (accessor.bufferView) {
+            [bufferViewUses addObject:accessor.bufferView];
+        }
+        if (accessor.sparse) {
+            [bufferViewUses addObject:accessor.sparse.indices];
+            [bufferViewUses addObject:accessor.sparse.values];
+        }
+    }
+    for (GLTFImage *image in self.asset.images) {
+        if (image.bufferView) {
+            [bufferViewUses addObject:image.bufferView];
+        }
+    }
+    NSMutableSet<GLTFBufferView *> *bufferViews = [NSMutableSet setWithArray:self.asset.bufferViews];
+    [bufferViews unionSet:bufferViewUses];
+
+    // Buffer views that share bytes with another, found by sorting each buffer's views by offset
+    NSMutableSet<GLTFBufferView *> *overlappingBufferViews = [NSMutableSet set];
+    NSArray<GLTFBufferView *> *sortedBufferViews = [bufferViews.allObjects sortedArrayUsingComparator:
+                                                    ^NSComparisonResult(GLTFBufferView *a, GLTFBufferView *b) {
+        if (a.buffer != b.buffer) {
+            return ((uintptr_t)a.buffer < (uintptr_t)b.buffer) ? NSOrderedAscending : NSOrderedDescending;
+        }
+        return (a.offset < b.offset) ? NSOrderedAscending : ((a.offset > b.offset) ? NSOrderedDescending : NSOrderedSame);
+    }];
+    GLTFBufferView *furthest = nil;
+    for (GLTFBufferView *bufferView in sortedBufferViews) {
+        if (furthest && furthest.buffer == bufferView.buffer &&
+            furthest.offset + (NSInteger)furthest.length > bufferView.offset)
+        {
+            [overlappingBufferViews addObject:furthest];
+            [overlappingBufferViews addObject:bufferView];
+        }
+        if (furthest == nil || furthest.buffer != bufferView.buffer ||
+            bufferView.offset + (NSInteger)bufferView.length > furthest.offset + (NSInteger)furthest.length)
+        {
+            furthest = bufferView;
+        }
+    }
+
+    NSMutableSet<GLTFAccessor *> *unsharedAccessors = [NSMutableSet set];
+    for (GLTFAccessor *accessor in accessorUses) {
+        GLTFBufferView *bufferView = accessor.bufferView;
+        if ([accessorUses countForObject:accessor] == 1 && accessor.sparse == nil && bufferView != nil &&
+            [bufferViewUses countForObject:bufferView] == 1 && ![overlappingBufferViews containsObject:bufferView] &&
+            bufferView.meshoptCompression == nil && [self.mutableBuffers containsObject:bufferView.buffer])
+        {
+            [unsharedAccessors addObject:accessor];
+        }
+    }
+    return unsharedAccessors;
+}
+
+- (void)optimizeMeshes
+{
+    if (!self.optimizesMeshes) {
+        return;
+    }
+    NSSet<GLTFAccessor *> *unsharedAccessors = [self unsharedAccessors];
+    // Cache statistics of all optimized primitives, weighted by their triangle counts
+    __block double acmrBefore = 0.0, acmrAfter = 0.0, atvrBefore = 0.0, atvrAfter = 0.0;
+    __block NSInteger primitiveCount = 0, triangleCount = 0;
+    NSObject *totalsLock = [NSObject new];
+    [self processPrimitives:^NSArray<GLTFAccessor *> *(GLTFPrimitive *primitive, NSError **error) {
+        GLTFMeshOptimizationStatistics statistics;
+        NSArray<GLTFAccessor *> *newAccessors = GLTFPrimitiveOptimizeVertexOrderInPlace(primitive,
+                                                                                        GLTFMeshOptimizationOptionAll,
+                                                                                        unsharedAccessors,
+                                                                                        &statistics, error);
+        if (newAccessors != nil && statistics.before.acmr > 0.0f) {
+            const NSInteger triangles = primitive.indices.count / 3;
+            @synchronized (totalsLock) {
+                acmrBefore += statistics.before.acmr * (double)triangles;
+                acmrAfter += statistics.after.acmr * (double)triangles;
+                atvrBefore += statistics.before.atvr * (double)triangles;
+                atvrAfter += statistics.after.atvr * (double)triangles;
+                primitiveCount += 1;
+                triangleCount += triangles;
+            }
+        }
+        return newAccessors;
+    }];
+    if (triangleCount > 0) {
+        GLTFLogInfo(@"[GLTFKit2] Optimized vertex order of %ld primitives (%ld triangles): "
+                    @"ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+                    (long)primitiveCount, (long)triangleCount, acmrBefore / triangleCount, acmrAfter / triangleCount,
+                    atvrBefore / triangleCount, atvrAfter / triangleCount);
+    }
+}
+
+- (void)generateLevelsOfDetail
+{
+    if (self.levelOfDetailCount <= 0) {
+        return;
+    }
+    NSInteger levelCount = self.levelOfDetailCount;
+    float targetError = self.levelOfDetailTargetError;
+    [self processPrimitives:^NSArray<GLTFAccessor *> *(GLTFPrimitive *primitive, NSError **error) {
+        return GLTFPrimitiveGenerateLevelsOfDetail(primitive, levelCount, targetError, error);
+    }];
+}
+
+- (void)buildMeshlets
+{
+    if (!self.buildsMeshlets) {
+        return;
+    }
+    NSInteger maxVertexCount = self.meshletMaxVertexCount, maxTriangleCount = self.meshletMaxTriangleCount;
+    [self processPrimitives:^NSArray<GLTFAccessor *> *(GLTFPrimitive *primitive, NSError **error) {
+        if (primitive.primitiveType != GLTFPrimitiveTypeTriangles &&
+            primitive.primitiveType != GLTFPrimitiveTypeTriangleStrip &&
+            primitive.primitiveType != GLTFPrimitiveTypeTriangleFan)
+        {
+            return @[];
+        }
+        primitive.meshlets = GLTFMeshletSetForPrimitive(primitive, maxVertexCount, maxTriangleCount, error);
+        return primitive.meshlets ? @[] : nil;
+    }];
+}
+
+- (void)resolveMeshBounds
+{
+    if (self.computesMissingBounds) {
+        // Decompressed primitives have accessors of their own, which aren't in the asset's accessor list
+        NSMutableArray<GLTFAccessor *> *accessors = [self.asset.accessors mutableCopy];
+        for (GLTFMesh *mesh in self.asset.meshes) {
+            for (GLTFPrimitive *primitive in mesh.primitives) {
+                for (GLTFAttribute *attribute in primitive.attributes) {
+                    [accessors addObject:attribute.accessor];
+                }
+                if (primitive.indices) {
+                    [accessors addObject:primitive.indices];
+                }
+            }
+        }
+        for (GLTFAccessor *accessor in accessors) {
+            if (accessor.minValues.count > 0 && accessor.maxValues.count > 0) {
+                continue;
+            }
+            NSArray<NSNumber *> *minValues = nil, *maxValues = nil;
+            if (GLTFAccessorComputeBounds(accessor, &minValues, &maxValues)) {
+                accessor.minValues = minValues;
+                accessor.maxValues = maxValues;
+            }
+        }
+    }
+    for (GLTFMesh *mesh in self.asset.meshes) {
+        for (GLTFPrimitive *primitive in mesh.primitives) {
+            NSError *error = nil;
+            if (self.validatesIndices && !GLTFValidatePrimitiveIndices(primitive, &error)) {
+                GLTFLogWarning(@"[GLTFKit2] %@ in mesh %@", error.localizedDescription, mesh.name ?: @"(unnamed)");
+            }
+            primitive.boundingBox = GLTFBoundingBoxForPrimitive(primitive);
+        }
+    }
+}
+
+- (void)reduceKeyframes
+{
+    if (!self.reducesKeyframes) {
+        return;
+    }
+    NSMutableArray<GLTFAccessor *> *accessors = [self.asset.accessors mutableCopy];
+    NSMutableArray<GLTFBufferView *> *bufferViews = [self.asset.bufferViews mutableCopy];
+    NSMutableArray<GLTFBuffer *> *buffers = [self.asset.buffers mutableCopy];
+    GLTFKeyframeReductionStatistics totals = { 0, 0, 0, 0, 0, 0, 0 };
+    for (GLTFAnimation *animation in self.asset.animations) {
+        GLTFKeyframeReductionStatistics statistics;
+        NSError *error = nil;
+        NSArray<GLTFAccessor *> *newAccessors = GLTFAnimationReduceKeyframes(animation, self.keyframeSampleRate,
+                                                                             self.keyframePositionTolerance,
+                                                                             self.keyframeAngleTolerance,
+                                                                             &statistics, &error);
+        if (newAccessors == nil) {
+            GLTFLogWarning(@"[GLTFKit2] %@ in animation %@", error.localizedDescription,
+                           animation.name ?: @"(unnamed)");
+            continue;
+        }
+        for (GLTFAccessor *accessor in newAccessors) {
+            [accessors addObject:accessor];
+            [bufferViews addObject:accessor.bufferView];
+            [buffers addObject:accessor.bufferView.buffer];
+        }
+        totals.samplerCount += statistics.samplerCount;
+        totals.constantSamplerCount += statistics.constantSamplerCount;
+        totals.convertedCubicSamplerCount += statistics.convertedCubicSamplerCount;
+        totals.keyCountBefore += statistics.keyCountBefore;
+        totals.keyCountAfter += statistics.keyCountAfter;
+        totals.byteCountBefore += statistics.byteCountBefore;
+        totals.byteCountAfter += statistics.byteCountAfter;
+    }
+    self.asset.accessors = accessors;
+    self.asset.bufferViews = bufferViews;
+    self.asset.buffers = buffers;
+    if (totals.samplerCount > 0) {
+        GLTFLogInfo(@"[GLTFKit2] Reduced %ld animation samplers from %ld to %ld keys (%ld to %ld bytes); "
+                    @"%ld were constant and %ld cubic samplers became linear",
+                    (long)totals.samplerCount, (long)totals.keyCountBefore, (long)totals.keyCountAfter,
+                    (long)totals.byteCountBefore, (long)totals.byteCountAfter,
+                    (long)totals.constantSamplerCount, (long)totals.convertedCubicSamplerCount);
+    }
+}
+
+// Quantization moves dequantization transforms into nodes, so unlike the primitive stages it runs once they exist
+- (void)quantizeMeshes
+{
+    if (!self.quantizesMeshes) {
+        return;
+    }
+    NSError *error = nil;
+    if (!GLTFAssetQuantizeMeshes(self.asset, GLTFQuantizationOptionAll, NULL, &error)) {
+        GLTFLogWarning(@"[GLTFKit2] Meshes were not quantized: %@", error.localizedDescription);
+    }
+}
+
 - (BOOL)convertAsset:(NSError **)error {
     self.asset = [GLTFAsset new];
     self.asset.url = self.assetURL;
@@ -1396,12 +1792,21 @@ NSDictionary *GLTFConvertExtensions(cgltf_extension *extensions, size_t count, N
     self.asset.materials = [self convertMaterials];
     self.asset.materialVariants = [self convertMaterialVariants];
     self.asset.meshes = [self convertMeshes];
+    [self weldVertices];
+    [self createMissingNormals];
+    [self createMissingTangents];
+    [self optimizeMeshes];
+    [self generateLevelsOfDetail];
+    [self buildMeshlets];
+    [self resolveMeshBounds];
     self.asset.cameras = [self convertCameras];
     self.asset.lights = [self convertLights];
     self.asset.nodes = [self convertNodes];
     self.asset.skins = [self convertSkins];
     self.asset.animations = [self convertAnimations];
+    [self reduceKeyframes];
     self.asset.scenes = [self convertScenes];
+    [self quantizeMeshes];
     if (gltf->scene) {
         size_t sceneIndex = cgltf_scene_index(gltf, gltf->scene);
         GLTFScene *scene = self.asset.scenes[sceneIndex];
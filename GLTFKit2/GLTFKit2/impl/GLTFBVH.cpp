@@ -0,0 +1,521 @@
+
+#include "GLTFBVH.h"
+#include "GLTFParallel.h"
+#include "GLTFVectorMath.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace GLTF {
+
+namespace {
+
+// Centroid bins per axis when evaluating the surface area heuristic
+const int BinCount = 16;
+
+// Ranges with at least this many triangles are bounded and binned in parallel
+const size_t ParallelBinningThreshold = 1 << 15;
+
+// Triangles per unit of parallel work when bounding and binning
+const size_t TriangleGrainSize = 1 << 14;
+
+// Below this depth, ranges are split at their median so that no path through the tree is longer than this plus the
+// logarithm of the triangle count, which bounds the traversal stack
+const uint32_t MaxSurfaceAreaDepth = 48;
+
+const size_t MaxTraversalDepth = 128;
+
+typedef float Float4 __attribute__((vector_size(16)));
+typedef int32_t Int4 __attribute__((vector_size(16)));
+
+struct Bounds {
+    Vec3 lo, hi;
+
+    static Bounds empty() {
+        const float inf = std::numeric_limits<float>::infinity();
+        Bounds b = { MakeVec3(inf, inf, inf), MakeVec3(-inf, -inf, -inf) };
+        return b;
+    }
+
+    void grow(Vec3 p) {
+        lo = Min(lo, p);
+        hi = Max(hi, p);
+    }
+
+    void grow(const Bounds &b) {
+        lo = Min(lo, b.lo);
+        hi = Max(hi, b.hi);
+    }
+
+    float halfArea() const {
+        const Vec3 d = hi - lo;
+        return (d.x < 0.0f) ? 0.0f : d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+};
+
+inline float component(Vec3 v, int axis) {
+    return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+struct Bin {
+    Bounds bounds;
+    uint32_t count;
+};
+
+struct BinSet {
+    Bin bins[3][BinCount];
+};
+
+struct Split {
+    int axis;
+    int bin; // Triangles in bins below this one go left
+    float cost;
+};
+
+// A triangle's bounds and centroid, stored together and partitioned in place so that each range is contiguous
+struct Reference {
+    Bounds bounds;
+    Vec3 centroid;
+    uint32_t triangle;
+};
+
+struct Task {
+    uint32_t begin, end;
+    uint32_t nodeIndex;
+    uint32_t depth;
+};
+
+class Builder {
+public:
+    Builder(const float *triangleCorners, size_t triangleCount)
+        : corners(triangleCorners), references(triangleCount)
+    {
+        ParallelFor(triangleCount, TriangleGrainSize, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                const float *c = corners + 9 * t;
+                Bounds b = Bounds::empty();
+                for (int k = 0; k < 3; ++k) {
+                    b.grow(MakeVec3(c[3 * k], c[3 * k + 1], c[3 * k + 2]));
+                }
+                references[t].bounds = b;
+                references[t].centroid = (b.lo + b.hi) * 0.5f;
+                references[t].triangle = static_cast<uint32_t>(t);
+            }
+        });
+    }
+
+    void build(std::vector<BVHNode> &nodes, std::vector<BVHTrianglePacket> &packets) {
+        nodes.clear();
+        packets.clear();
+        if (references.empty()) {
+            return;
+        }
+
+        // Split the largest ranges near the root, binning in parallel, until there are enough subtrees to keep
+        // every worker busy
+        nodes.push_back(BVHNode());
+        std::vector<Task> tasks(1);
+        tasks[0].begin = 0;
+        tasks[0].end = static_cast<uint32_t>(references.size());
+        tasks[0].nodeIndex = 0;
+        tasks[0].depth = 0;
+        const size_t desiredTaskCount = 4 * ParallelWorkerCount();
+        while (tasks.size() < desiredTaskCount) {
+            size_t largest = 0;
+            for (size_t i = 1; i < tasks.size(); ++i) {
+                if (tasks[i].end - tasks[i].begin > tasks[largest].end - tasks[largest].begin) {
+                    largest = i;
+                }
+            }
+            const Task task = tasks[largest];
+            if (task.end - task.begin < ParallelBinningThreshold) {
+                break;
+            }
+            uint32_t middle;
+            Bounds bounds;
+            splitRange(task.begin, task.end, true, task.depth, bounds, middle);
+            const uint32_t left = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(BVHNode());
+            nodes.push_back(BVHNode());
+            setInterior(nodes[task.nodeIndex], bounds, left);
+            tasks[largest].end = middle;
+            tasks[largest].nodeIndex = left;
+            tasks[largest].depth = task.depth + 1;
+            Task right = { middle, task.end, left + 1, task.depth + 1 };
+            tasks.push_back(right);
+        }
+
+        std::vector<std::vector<BVHNode>> subtreeNodes(tasks.size());
+        std::vector<std::vector<BVHTrianglePacket>> subtreePackets(tasks.size());
+        ParallelFor(tasks.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                subtreeNodes[i].push_back(BVHNode());
+                buildSubtree(tasks[i].begin, tasks[i].end, 0, tasks[i].depth, subtreeNodes[i], subtreePackets[i]);
+            }
+        });
+
+        // Splice each subtree in place of its task's node, relocating its children and packets
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            const uint32_t nodeBase = static_cast<uint32_t>(nodes.size()) - 1;
+            const uint32_t packetBase = static_cast<uint32_t>(packets.size());
+            std::vector<BVHNode> &local = subtreeNodes[i];
+            for (BVHNode &node : local) {
+                node.leftOrFirst += (node.count == 0) ? nodeBase : packetBase;
+            }
+            nodes[tasks[i].nodeIndex] = local[0];
+            nodes.insert(nodes.end(), local.begin() + 1, local.end());
+            packets.insert(packets.end(), subtreePackets[i].begin(), subtreePackets[i].end());
+        }
+    }
+
+private:
+    const float *corners;
+    std::vector<Reference> references;
+
+    static void setInterior(BVHNode &node, const Bounds &bounds, uint32_t left) {
+        node.boundsMin[0] = bounds.lo.x;
+        node.boundsMin[1] = bounds.lo.y;
+        node.boundsMin[2] = bounds.lo.z;
+        node.boundsMax[0] = bounds.hi.x;
+        node.boundsMax[1] = bounds.hi.y;
+        node.boundsMax[2] = bounds.hi.z;
+        node.leftOrFirst = left;
+        node.count = 0;
+    }
+
+    // Computes the bounds of the triangles and of the centroids of a range
+    void boundRange(uint32_t begin, uint32_t end, bool parallel, Bounds &bounds, Bounds &centroidBounds) const {
+        bounds = Bounds::empty();
+        centroidBounds = Bounds::empty();
+        if (!parallel) {
+            for (uint32_t i = begin; i < end; ++i) {
+                bounds.grow(references[i].bounds);
+                centroidBounds.grow(references[i].centroid);
+            }
+            return;
+        }
+        const size_t chunkCount = (end - begin + TriangleGrainSize - 1) / TriangleGrainSize;
+        std::vector<Bounds> chunkBounds(chunkCount), chunkCentroidBounds(chunkCount);
+        ParallelFor(chunkCount, 1, [&](size_t chunkBegin, size_t chunkEnd) {
+            for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+                const size_t first = begin + chunk * TriangleGrainSize;
+                boundRange(static_cast<uint32_t>(first),
+                           static_cast<uint32_t>(std::min(first + TriangleGrainSize, static_cast<size_t>(end))),
+                           false, chunkBounds[chunk], chunkCentroidBounds[chunk]);
+            }
+        });
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            bounds.grow(chunkBounds[chunk]);
+            centroidBounds.grow(chunkCentroidBounds[chunk]);
+        }
+    }
+
+    static int binIndex(Vec3 centroid, int axis, float lo, float scale) {
+        const int bin = static_cast<int>((component(centroid, axis) - lo) * scale);
+        return std::min(std::max(bin, 0), BinCount - 1);
+    }
+
+    // Bins the triangles of a range along all three axes in one pass
+    void binRange(uint32_t begin, uint32_t end, Vec3 lo, const float scale[3], BinSet &binSet) const {
+        for (int axis = 0; axis < 3; ++axis) {
+            for (int b = 0; b < BinCount; ++b) {
+                binSet.bins[axis][b].bounds = Bounds::empty();
+                binSet.bins[axis][b].count = 0;
+            }
+        }
+        for (uint32_t i = begin; i < end; ++i) {
+            const Reference &reference = references[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                Bin &bin = binSet.bins[axis][binIndex(reference.centroid, axis, component(lo, axis), scale[axis])];
+                bin.bounds.grow(reference.bounds);
+                ++bin.count;
+            }
+        }
+    }
+
+    // Finds the cheapest binned split of a range by the surface area heuristic
+    Split findSplit(uint32_t begin, uint32_t end, const Bounds &centroidBounds, bool parallel) const {
+        const Vec3 extent = centroidBounds.hi - centroidBounds.lo;
+        const float scale[3] = {
+            (extent.x > 0.0f) ? BinCount / extent.x : 0.0f,
+            (extent.y > 0.0f) ? BinCount / extent.y : 0.0f,
+            (extent.z > 0.0f) ? BinCount / extent.z : 0.0f,
+        };
+        BinSet binSet;
+        if (parallel) {
+            const size_t chunkCount = (end - begin + TriangleGrainSize - 1) / TriangleGrainSize;
+            std::vector<BinSet> chunkBinSets(chunkCount);
+            ParallelFor(chunkCount, 1, [&](size_t chunkBegin, size_t chunkEnd) {
+                for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+                    const size_t first = begin + chunk * TriangleGrainSize;
+                    binRange(static_cast<uint32_t>(first),
+                             static_cast<uint32_t>(std::min(first + TriangleGrainSize, static_cast<size_t>(end))),
+                             centroidBounds.lo, scale, chunkBinSets[chunk]);
+                }
+            });
+            binSet = chunkBinSets[0];
+            for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    for (int b = 0; b < BinCount; ++b) {
+                        binSet.bins[axis][b].bounds.grow(chunkBinSets[chunk].bins[axis][b].bounds);
+                        binSet.bins[axis][b].count += chunkBinSets[chunk].bins[axis][b].count;
+                    }
+                }
+            }
+        } else {
+            binRange(begin, end, centroidBounds.lo, scale, binSet);
+        }
+
+        Split best = { -1, 0, std::numeric_limits<float>::infinity() };
+        for (int axis = 0; axis < 3; ++axis) {
+            if (scale[axis] == 0.0f) {
+                continue;
+            }
+            const Bin *bins = binSet.bins[axis];
+
+            // Sweep from the right to gather suffix areas, then from the left to evaluate each split
+            float rightArea[BinCount];
+            uint32_t rightCount[BinCount];
+            Bounds right = Bounds::empty();
+            uint32_t rightTotal = 0;
+            for (int b = BinCount - 1; b > 0; --b) {
+                right.grow(bins[b].bounds);
+                rightTotal += bins[b].count;
+                rightArea[b] = right.halfArea();
+                rightCount[b] = rightTotal;
+            }
+            Bounds left = Bounds::empty();
+            uint32_t leftTotal = 0;
+            for (int b = 1; b < BinCount; ++b) {
+                left.grow(bins[b - 1].bounds);
+                leftTotal += bins[b - 1].count;
+                if (leftTotal == 0 || rightCount[b] == 0) {
+                    continue;
+                }
+                const float cost = left.halfArea() * packetCount(leftTotal) + rightArea[b] * packetCount(rightCount[b]);
+                if (cost < best.cost) {
+                    best.axis = axis;
+                    best.bin = b;
+                    best.cost = cost;
+                }
+            }
+        }
+        return best;
+    }
+
+    static float packetCount(uint32_t triangleCount) {
+        return static_cast<float>((triangleCount + BVH::MaxLeafSize - 1) / BVH::MaxLeafSize);
+    }
+
+    // Partitions a range in two, by the best binned split or, deep in the tree or if the centroids coincide, at the
+    // median centroid along the widest axis
+    void splitRange(uint32_t begin, uint32_t end, bool parallel, uint32_t depth, Bounds &bounds, uint32_t &middle) {
+        Bounds centroidBounds;
+        boundRange(begin, end, parallel, bounds, centroidBounds);
+        if (depth < MaxSurfaceAreaDepth) {
+            const Split split = findSplit(begin, end, centroidBounds, parallel);
+            if (split.axis >= 0) {
+                const float lo = component(centroidBounds.lo, split.axis);
+                const float scale = BinCount / (component(centroidBounds.hi, split.axis) - lo);
+                Reference *partitioned = std::partition(references.data() + begin, references.data() + end,
+                                                        [&](const Reference &reference) {
+                    return binIndex(reference.centroid, split.axis, lo, scale) < split.bin;
+                });
+                middle = static_cast<uint32_t>(partitioned - references.data());
+                return;
+            }
+        }
+        const Vec3 extent = centroidBounds.hi - centroidBounds.lo;
+        const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+        middle = begin + (end - begin) / 2;
+        std::nth_element(references.data() + begin, references.data() + middle, references.data() + end,
+                         [&](const Reference &a, const Reference &b) {
+            return component(a.centroid, axis) < component(b.centroid, axis);
+        });
+    }
+
+    void buildSubtree(uint32_t begin, uint32_t end, uint32_t nodeIndex, uint32_t depth, std::vector<BVHNode> &nodes,
+                      std::vector<BVHTrianglePacket> &packets)
+    {
+        if (end - begin <= BVH::MaxLeafSize) {
+            makeLeaf(begin, end, nodes[nodeIndex], packets);
+            return;
+        }
+        uint32_t middle;
+        Bounds bounds;
+        splitRange(begin, end, false, depth, bounds, middle);
+        const uint32_t left = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(BVHNode());
+        nodes.push_back(BVHNode());
+        setInterior(nodes[nodeIndex], bounds, left);
+        buildSubtree(begin, middle, left, depth + 1, nodes, packets);
+        buildSubtree(middle, end, left + 1, depth + 1, nodes, packets);
+    }
+
+    void makeLeaf(uint32_t begin, uint32_t end, BVHNode &node, std::vector<BVHTrianglePacket> &packets) const {
+        BVHTrianglePacket packet;
+        memset(&packet, 0, sizeof(packet));
+        Bounds bounds = Bounds::empty();
+        for (uint32_t lane = 0; lane < BVH::MaxLeafSize; ++lane) {
+            packet.triangles[lane] = UINT32_MAX;
+            if (begin + lane >= end) {
+                continue;
+            }
+            const uint32_t t = references[begin + lane].triangle;
+            const float *c = corners + 9 * t;
+            for (int axis = 0; axis < 3; ++axis) {
+                packet.v0[axis][lane] = c[axis];
+                packet.e1[axis][lane] = c[3 + axis] - c[axis];
+                packet.e2[axis][lane] = c[6 + axis] - c[axis];
+            }
+            packet.triangles[lane] = t;
+            bounds.grow(references[begin + lane].bounds);
+        }
+        setInterior(node, bounds, static_cast<uint32_t>(packets.size()));
+        node.count = end - begin;
+        packets.push_back(packet);
+    }
+};
+
+inline Float4 load4(const float *p) {
+    Float4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline Float4 splat(float f) {
+    Float4 v = { f, f, f, f };
+    return v;
+}
+
+// Returns the distance at which the ray enters the node's bounds, or infinity if it misses them within (tMin, tMax)
+inline float enterBounds(const BVHNode &node, const float origin[3], const float inverseDirection[3], float tMin,
+                         float tMax)
+{
+    float enter = tMin, exit = tMax;
+    for (int axis = 0; axis < 3; ++axis) {
+        float t0 = (node.boundsMin[axis] - origin[axis]) * inverseDirection[axis];
+        float t1 = (node.boundsMax[axis] - origin[axis]) * inverseDirection[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        enter = std::max(enter, t0);
+        exit = std::min(exit, t1);
+    }
+    return (enter <= exit) ? enter : std::numeric_limits<float>::infinity();
+}
+
+// Intersects the ray with the four triangles of a packet at once (Möller and Trumbore), updating `hit` if one is
+// nearer than `tMax`
+inline bool intersectPacket(const BVHTrianglePacket &packet, const float origin[3], const float direction[3],
+                            float tMin, float tMax, BVHHit &hit)
+{
+    const Float4 dx = splat(direction[0]), dy = splat(direction[1]), dz = splat(direction[2]);
+    const Float4 e1x = load4(packet.e1[0]), e1y = load4(packet.e1[1]), e1z = load4(packet.e1[2]);
+    const Float4 e2x = load4(packet.e2[0]), e2y = load4(packet.e2[1]), e2z = load4(packet.e2[2]);
+    const Float4 px = dy * e2z - dz * e2y, py = dz * e2x - dx * e2z, pz = dx * e2y - dy * e2x;
+    const Float4 det = e1x * px + e1y * py + e1z * pz;
+    const Float4 inverseDet = splat(1.0f) / det;
+    const Float4 sx = splat(origin[0]) - load4(packet.v0[0]);
+    const Float4 sy = splat(origin[1]) - load4(packet.v0[1]);
+    const Float4 sz = splat(origin[2]) - load4(packet.v0[2]);
+    const Float4 u = (sx * px + sy * py + sz * pz) * inverseDet;
+    const Float4 qx = sy * e1z - sz * e1y, qy = sz * e1x - sx * e1z, qz = sx * e1y - sy * e1x;
+    const Float4 v = (dx * qx + dy * qy + dz * qz) * inverseDet;
+    const Float4 t = (e2x * qx + e2y * qy + e2z * qz) * inverseDet;
+    const Int4 mask = (det != splat(0.0f)) & (u >= splat(0.0f)) & (v >= splat(0.0f)) & (u + v <= splat(1.0f)) &
+                      (t > splat(tMin)) & (t < splat(tMax));
+    bool found = false;
+    for (int lane = 0; lane < 4; ++lane) {
+        if (mask[lane] && t[lane] < tMax) {
+            tMax = t[lane];
+            hit.distance = t[lane];
+            hit.u = u[lane];
+            hit.v = v[lane];
+            hit.triangle = packet.triangles[lane];
+            found = true;
+        }
+    }
+    return found;
+}
+
+} // namespace
+
+const size_t BVH::MaxLeafSize;
+
+void BVH::build(const float *corners, size_t triangleCount) {
+    Builder builder(corners, triangleCount);
+    builder.build(nodeStorage, packetStorage);
+}
+
+bool BVH::intersectClosest(const float origin[3], const float direction[3], float tMin, float tMax,
+                           BVHHit &hit) const
+{
+    return traverse(origin, direction, tMin, tMax, false, hit);
+}
+
+bool BVH::intersectAny(const float origin[3], const float direction[3], float tMin, float tMax, BVHHit &hit) const {
+    return traverse(origin, direction, tMin, tMax, true, hit);
+}
+
+bool BVH::traverse(const float origin[3], const float direction[3], float tMin, float tMax, bool anyHit,
+                   BVHHit &hit) const
+{
+    if (nodeStorage.empty()) {
+        return false;
+    }
+    // Nudge zero direction components so that the slab test never multiplies zero by infinity
+    float inverseDirection[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        const float d = direction[axis];
+        inverseDirection[axis] = 1.0f / ((std::fabs(d) > 1e-30f) ? d : std::copysign(1e-30f, d));
+    }
+
+    struct Entry {
+        uint32_t node;
+        float distance;
+    };
+    Entry stack[MaxTraversalDepth];
+    size_t depth = 0;
+    bool found = false;
+    const float rootDistance = enterBounds(nodeStorage[0], origin, inverseDirection, tMin, tMax);
+    if (rootDistance == std::numeric_limits<float>::infinity()) {
+        return false;
+    }
+    stack[depth++] = Entry { 0, rootDistance };
+    while (depth > 0) {
+        const Entry entry = stack[--depth];
+        if (entry.distance >= tMax) {
+            continue;
+        }
+        const BVHNode &node = nodeStorage[entry.node];
+        if (node.count > 0) {
+            if (intersectPacket(packetStorage[node.leftOrFirst], origin, direction, tMin, tMax, hit)) {
+                tMax = hit.distance;
+                found = true;
+                if (anyHit) {
+                    return true;
+                }
+            }
+            continue;
+        }
+        uint32_t near = node.leftOrFirst, far = node.leftOrFirst + 1;
+        float nearDistance = enterBounds(nodeStorage[near], origin, inverseDirection, tMin, tMax);
+        float farDistance = enterBounds(nodeStorage[far], origin, inverseDirection, tMin, tMax);
+        if (farDistance < nearDistance) {
+            std::swap(near, far);
+            std::swap(nearDistance, farDistance);
+        }
+        // The nearer child is popped first. The stack never holds more entries than the depth of the tree, which
+        // the builder bounds.
+        if (farDistance < tMax) {
+            stack[depth++] = Entry { far, farDistance };
+        }
+        if (nearDistance < tMax) {
+            stack[depth++] = Entry { near, nearDistance };
+        }
+    }
+    return found;
+}
+
+} // namespace GLTF
@@ -0,0 +1,66 @@
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GLTF {
+
+/// A node of a bounding volume hierarchy, packed into 32 bytes. Interior nodes (count == 0) have their children at
+/// leftOrFirst and leftOrFirst + 1; leaves hold the triangle packet at index leftOrFirst.
+struct BVHNode {
+    float boundsMin[3];
+    uint32_t leftOrFirst;
+    float boundsMax[3];
+    uint32_t count; // The number of triangles in a leaf, or 0 for an interior node
+};
+
+static_assert(sizeof(BVHNode) == 32, "BVH nodes must be 32 bytes");
+
+/// The triangles of a leaf, stored as one vertex and two edges each, four wide, for four-at-a-time intersection.
+/// Unused lanes are degenerate and have the identifier UINT32_MAX.
+struct BVHTrianglePacket {
+    float v0[3][4];
+    float e1[3][4];
+    float e2[3][4];
+    uint32_t triangles[4];
+};
+
+struct BVHHit {
+    float distance;
+    float u, v;        // Barycentric coordinates of the hit with respect to the second and third corners
+    uint32_t triangle; // The index of the triangle in the array the hierarchy was built from
+};
+
+class BVH {
+public:
+    /// The greatest number of triangles in a leaf, which is the width of a triangle packet.
+    static const size_t MaxLeafSize = 4;
+
+    /// Builds the hierarchy over `triangleCount` triangles, whose corners are given as nine consecutive floats per
+    /// triangle in `corners`. Splits are chosen by the surface area heuristic over binned centroids; large ranges
+    /// are binned in parallel, and the subtrees below them are built in parallel.
+    void build(const float *corners, size_t triangleCount);
+
+    /// Finds the nearest triangle that the ray from `origin` along `direction` hits at a distance in
+    /// (tMin, tMax), measured in multiples of `direction`. Both faces of each triangle are hit. Returns false if the
+    /// ray misses.
+    bool intersectClosest(const float origin[3], const float direction[3], float tMin, float tMax, BVHHit &hit) const;
+
+    /// Finds any triangle that the ray hits within (tMin, tMax), stopping at the first one found. Returns false if
+    /// the ray misses.
+    bool intersectAny(const float origin[3], const float direction[3], float tMin, float tMax, BVHHit &hit) const;
+
+    const std::vector<BVHNode> &nodes() const { return nodeStorage; }
+    const std::vector<BVHTrianglePacket> &packets() const { return packetStorage; }
+
+private:
+    std::vector<BVHNode> nodeStorage;
+    std::vector<BVHTrianglePacket> packetStorage;
+
+    bool traverse(const float origin[3], const float direction[3], float tMin, float tMax, bool anyHit,
+                  BVHHit &hit) const;
+};
+
+} // namespace GLTF
@@ -0,0 +1,224 @@
+
+#include "GLTFBoundsComputation.h"
+#include "GLTFParallel.h"
+
+#include <limits>
+#include <vector>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define GLTF_BOUNDS_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GLTF_BOUNDS_SSE2 1
+#endif
+
+namespace GLTF {
+
+namespace {
+
+// Elements per unit of parallel work. Below this, bounds are computed on the calling thread.
+const size_t BoundsGrainSize = 1 << 16;
+
+// The number of lanes in a 128-bit vector of T.
+template <typename T>
+struct VectorLanes {
+    static const size_t value = 16 / sizeof(T);
+};
+
+template <typename T>
+struct ComponentBounds {
+    T lo[MaxComponentCount];
+    T hi[MaxComponentCount];
+
+    explicit ComponentBounds(int componentCount) {
+        for (int c = 0; c < componentCount; ++c) {
+            lo[c] = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                         : std::numeric_limits<T>::max();
+            hi[c] = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                         : std::numeric_limits<T>::lowest();
+        }
+    }
+
+    // Comparisons are arranged so that NaN values never replace a bound.
+    void include(int component, T value) {
+        if (value < lo[component]) {
+            lo[component] = value;
+        }
+        if (value > hi[component]) {
+            hi[component] = value;
+        }
+    }
+
+    void includeRange(int component, T rangeLo, T rangeHi) {
+        if (rangeLo < lo[component]) {
+            lo[component] = rangeLo;
+        }
+        if (rangeHi > hi[component]) {
+            hi[component] = rangeHi;
+        }
+    }
+
+    void merge(const ComponentBounds &other, int componentCount) {
+        for (int c = 0; c < componentCount; ++c) {
+            includeRange(c, other.lo[c], other.hi[c]);
+        }
+    }
+};
+
+template <typename T>
+void accumulateStrided(const AccessorView &view, size_t begin, size_t end, ComponentBounds<T> &bounds) {
+    for (size_t i = begin; i < end; ++i) {
+        const uint8_t *p = view.element(i);
+        for (int c = 0; c < view.componentCount; ++c) {
+            bounds.include(c, LoadUnaligned<T>(p + c * sizeof(T)));
+        }
+    }
+}
+
+// In tightly packed data, component c of every element lands in the same lanes of each block of
+// componentCount vectors, so the block can be reduced lane-wise without shuffles and the lanes
+// folded back into components at the end. The inner loop has no cross-iteration dependencies,
+// which lets the compiler vectorize it for every component type.
+template <typename T>
+void accumulatePacked(const uint8_t *bytes, size_t valueCount, int componentCount, ComponentBounds<T> &bounds) {
+    const size_t blockSize = componentCount * VectorLanes<T>::value;
+    T blockLo[MaxComponentCount * VectorLanes<T>::value];
+    T blockHi[MaxComponentCount * VectorLanes<T>::value];
+    for (size_t k = 0; k < blockSize; ++k) {
+        blockLo[k] = bounds.lo[k % componentCount];
+        blockHi[k] = bounds.hi[k % componentCount];
+    }
+    size_t i = 0;
+    for (; i + blockSize <= valueCount; i += blockSize) {
+        const uint8_t *p = bytes + i * sizeof(T);
+        for (size_t k = 0; k < blockSize; ++k) {
+            const T value = LoadUnaligned<T>(p + k * sizeof(T));
+            blockLo[k] = (value < blockLo[k]) ? value : blockLo[k];
+            blockHi[k] = (value > blockHi[k]) ? value : blockHi[k];
+        }
+    }
+    for (size_t k = 0; k < blockSize; ++k) {
+        bounds.includeRange(static_cast<int>(k % componentCount), blockLo[k], blockHi[k]);
+    }
+    for (size_t k = 0; i < valueCount; ++i, ++k) {
+        bounds.include(static_cast<int>(k % componentCount), LoadUnaligned<T>(bytes + i * sizeof(T)));
+    }
+}
+
+#if GLTF_BOUNDS_NEON || GLTF_BOUNDS_SSE2
+
+// Floats are the common case (positions, key times), so they get explicit vector code rather than relying
+// on the vectorizer, which must otherwise preserve the NaN semantics of the scalar comparisons.
+template <>
+void accumulatePacked<float>(const uint8_t *bytes, size_t valueCount, int componentCount, ComponentBounds<float> &bounds) {
+    const size_t blockSize = componentCount * 4;
+    float blockLo[MaxComponentCount * 4];
+    float blockHi[MaxComponentCount * 4];
+    for (size_t k = 0; k < blockSize; ++k) {
+        blockLo[k] = bounds.lo[k % componentCount];
+        blockHi[k] = bounds.hi[k % componentCount];
+    }
+    size_t i = 0;
+#if GLTF_BOUNDS_NEON
+    float32x4_t vlo[MaxComponentCount], vhi[MaxComponentCount];
+    for (int v = 0; v < componentCount; ++v) {
+        vlo[v] = vld1q_f32(blockLo + v * 4);
+        vhi[v] = vld1q_f32(blockHi + v * 4);
+    }
+    for (; i + blockSize <= valueCount; i += blockSize) {
+        const float *p = reinterpret_cast<const float *>(bytes) + i;
+        for (int v = 0; v < componentCount; ++v) {
+            const float32x4_t values = vreinterpretq_f32_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(p + v * 4)));
+            // The "number" variants return the non-NaN operand
+            vlo[v] = vminnmq_f32(vlo[v], values);
+            vhi[v] = vmaxnmq_f32(vhi[v], values);
+        }
+    }
+    for (int v = 0; v < componentCount; ++v) {
+        vst1q_f32(blockLo + v * 4, vlo[v]);
+        vst1q_f32(blockHi + v * 4, vhi[v]);
+    }
+#else
+    __m128 vlo[MaxComponentCount], vhi[MaxComponentCount];
+    for (int v = 0; v < componentCount; ++v) {
+        vlo[v] = _mm_loadu_ps(blockLo + v * 4);
+        vhi[v] = _mm_loadu_ps(blockHi + v * 4);
+    }
+    for (; i + blockSize <= valueCount; i += blockSize) {
+        const float *p = reinterpret_cast<const float *>(bytes) + i;
+        for (int v = 0; v < componentCount; ++v) {
+            const __m128 values = _mm_loadu_ps(p + v * 4);
+            // minps and maxps return their second operand when either is NaN
+            vlo[v] = _mm_min_ps(values, vlo[v]);
+            vhi[v] = _mm_max_ps(values, vhi[v]);
+        }
+    }
+    for (int v = 0; v < componentCount; ++v) {
+        _mm_storeu_ps(blockLo + v * 4, vlo[v]);
+        _mm_storeu_ps(blockHi + v * 4, vhi[v]);
+    }
+#endif
+    for (size_t k = 0; k < blockSize; ++k) {
+        bounds.includeRange(static_cast<int>(k % componentCount), blockLo[k], blockHi[k]);
+    }
+    for (size_t k = 0; i < valueCount; ++i, ++k) {
+        bounds.include(static_cast<int>(k % componentCount), LoadUnaligned<float>(bytes + i * sizeof(float)));
+    }
+}
+
+#endif
+
+template <typename T>
+bool computeComponentBounds(const AccessorView &view, double *outMin, double *outMax) {
+    const int componentCount = view.componentCount;
+    const bool packed = (view.stride == view.elementSize());
+    const size_t chunkCount = (view.count + BoundsGrainSize - 1) / BoundsGrainSize;
+    std::vector<ComponentBounds<T>> partialBounds(chunkCount, ComponentBounds<T>(componentCount));
+    ParallelFor(view.count, BoundsGrainSize, [&](size_t begin, size_t end) {
+        ComponentBounds<T> &bounds = partialBounds[begin / BoundsGrainSize];
+        if (packed) {
+            accumulatePacked(view.element(begin), (end - begin) * componentCount, componentCount, bounds);
+        } else {
+            accumulateStrided(view, begin, end, bounds);
+        }
+    });
+    ComponentBounds<T> bounds(componentCount);
+    for (const ComponentBounds<T> &partial : partialBounds) {
+        bounds.merge(partial, componentCount);
+    }
+    for (int c = 0; c < componentCount; ++c) {
+        if (bounds.lo[c] > bounds.hi[c]) {
+            return false;
+        }
+        outMin[c] = static_cast<double>(bounds.lo[c]);
+        outMax[c] = static_cast<double>(bounds.hi[c]);
+    }
+    return true;
+}
+
+} // namespace
+
+bool ComputeComponentBounds(const AccessorView &view, double *outMin, double *outMax) {
+    if (!view.isValid() || view.count == 0 || view.componentCount > MaxComponentCount) {
+        return false;
+    }
+    switch (view.componentType) {
+        case ComponentTypeByte:
+            return computeComponentBounds<int8_t>(view, outMin, outMax);
+        case ComponentTypeUnsignedByte:
+            return computeComponentBounds<uint8_t>(view, outMin, outMax);
+        case ComponentTypeShort:
+            return computeComponentBounds<int16_t>(view, outMin, outMax);
+        case ComponentTypeUnsignedShort:
+            return computeComponentBounds<uint16_t>(view, outMin, outMax);
+        case ComponentTypeUnsignedInt:
+            return computeComponentBounds<uint32_t>(view, outMin, outMax);
+        case ComponentTypeFloat:
+            return computeComponentBounds<float>(view, outMin, outMax);
+        default:
+            return false;
+    }
+}
+
+} // namespace GLTF
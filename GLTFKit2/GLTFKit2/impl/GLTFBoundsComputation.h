@@ -0,0 +1,17 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+namespace GLTF {
+
+/// The greatest number of components in an accessor element (that of a 4x4 matrix).
+const int MaxComponentCount = 16;
+
+/// Computes the per-component minimum and maximum of the elements of `view`. As with accessor min and max in glTF,
+/// the bounds are raw component values, even if the view is normalized. NaN components are ignored. `outMin` and
+/// `outMax` must have room for view.componentCount values. Large views are scanned in parallel. Returns false if the
+/// view is invalid or empty, or if some component has no non-NaN values.
+bool ComputeComponentBounds(const AccessorView &view, double *outMin, double *outMax);
+
+} // namespace GLTF
@@ -0,0 +1,419 @@
+
+#include "GLTFIndexProcessing.h"
+#include "GLTFParallel.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GLTF_INDEX_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GLTF_INDEX_SSE2 1
+#endif
+
+namespace GLTF {
+
+namespace {
+
+// Indices per unit of parallel work. Below this, conversions run on the calling thread.
+const size_t IndexGrainSize = 1 << 18;
+
+uint32_t maxIndexValue(const uint8_t *indices, size_t count) {
+    size_t i = 0;
+    uint32_t result = 0;
+#if GLTF_INDEX_NEON
+    uint8x16_t vmax = vdupq_n_u8(0);
+    for (; i + 16 <= count; i += 16) {
+        vmax = vmaxq_u8(vmax, vld1q_u8(indices + i));
+    }
+    uint8_t lanes[16];
+    vst1q_u8(lanes, vmax);
+    result = *std::max_element(lanes, lanes + 16);
+#elif GLTF_INDEX_SSE2
+    __m128i vmax = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        vmax = _mm_max_epu8(vmax, _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i)));
+    }
+    uint8_t lanes[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vmax);
+    result = *std::max_element(lanes, lanes + 16);
+#endif
+    for (; i < count; ++i) {
+        result = std::max<uint32_t>(result, indices[i]);
+    }
+    return result;
+}
+
+uint32_t maxIndexValue(const uint16_t *indices, size_t count) {
+    size_t i = 0;
+    uint32_t result = 0;
+#if GLTF_INDEX_NEON
+    uint16x8_t vmax = vdupq_n_u16(0);
+    for (; i + 8 <= count; i += 8) {
+        vmax = vmaxq_u16(vmax, vld1q_u16(indices + i));
+    }
+    uint16_t lanes[8];
+    vst1q_u16(lanes, vmax);
+    result = *std::max_element(lanes, lanes + 8);
+#elif GLTF_INDEX_SSE2
+    // SSE2 only has a signed 16-bit max, so bias the values into signed range and back.
+    const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+    __m128i vmax = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i)), bias);
+        vmax = _mm_max_epi16(vmax, v);
+    }
+    uint16_t lanes[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), _mm_xor_si128(vmax, bias));
+    result = *std::max_element(lanes, lanes + 8);
+#endif
+    for (; i < count; ++i) {
+        result = std::max<uint32_t>(result, indices[i]);
+    }
+    return result;
+}
+
+uint32_t maxIndexValue(const uint32_t *indices, size_t count) {
+    size_t i = 0;
+    uint32_t result = 0;
+#if GLTF_INDEX_NEON
+    uint32x4_t vmax = vdupq_n_u32(0);
+    for (; i + 4 <= count; i += 4) {
+        vmax = vmaxq_u32(vmax, vld1q_u32(indices + i));
+    }
+    uint32_t lanes[4];
+    vst1q_u32(lanes, vmax);
+    result = *std::max_element(lanes, lanes + 4);
+#elif GLTF_INDEX_SSE2
+    // SSE2 lacks an unsigned 32-bit max, so compare biased values and select.
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    __m128i vmax = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i));
+        __m128i greater = _mm_cmpgt_epi32(_mm_xor_si128(v, bias), _mm_xor_si128(vmax, bias));
+        vmax = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, vmax));
+    }
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vmax);
+    result = *std::max_element(lanes, lanes + 4);
+#endif
+    for (; i < count; ++i) {
+        result = std::max(result, indices[i]);
+    }
+    return result;
+}
+
+template <typename Index_t>
+uint32_t parallelMaxIndexValue(const Index_t *indices, size_t count) {
+    const size_t chunkCount = (count + IndexGrainSize - 1) / IndexGrainSize;
+    std::vector<uint32_t> chunkMaxima(std::max<size_t>(chunkCount, 1), 0);
+    ParallelFor(count, IndexGrainSize, [&](size_t begin, size_t end) {
+        chunkMaxima[begin / IndexGrainSize] = maxIndexValue(indices + begin, end - begin);
+    });
+    return *std::max_element(chunkMaxima.begin(), chunkMaxima.end());
+}
+
+#if GLTF_INDEX_NEON
+// Zero-extends each lane, mapping the narrow restart index (all ones) to the wide one.
+inline uint16x8_t widenRestartPreserving(uint8x8_t v) {
+    return vorrq_u16(vmovl_u8(v), vshlq_n_u16(vmovl_u8(vceq_u8(v, vdup_n_u8(0xFF))), 8));
+}
+
+inline uint32x4_t widenRestartPreserving(uint16x4_t v) {
+    return vorrq_u32(vmovl_u16(v), vshlq_n_u32(vmovl_u16(vceq_u16(v, vdup_n_u16(0xFFFF))), 16));
+}
+#endif
+
+void convertIndices(const uint8_t *src, size_t count, uint16_t *dst) {
+    size_t i = 0;
+#if GLTF_INDEX_NEON
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        vst1q_u16(dst + i, widenRestartPreserving(vget_low_u8(v)));
+        vst1q_u16(dst + i + 8, widenRestartPreserving(vget_high_u8(v)));
+    }
+#elif GLTF_INDEX_SSE2
+    // Interleaving each byte with its restart mask, rather than with zero, widens 0xFF to 0xFFFF.
+    const __m128i restart = _mm_set1_epi8(static_cast<char>(0xFF));
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i isRestart = _mm_cmpeq_epi8(v, restart);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi8(v, isRestart));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 8), _mm_unpackhi_epi8(v, isRestart));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = (src[i] == RestartIndex<uint8_t>()) ? RestartIndex<uint16_t>() : src[i];
+    }
+}
+
+void convertIndices(const uint16_t *src, size_t count, uint32_t *dst) {
+    size_t i = 0;
+#if GLTF_INDEX_NEON
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t v = vld1q_u16(src + i);
+        vst1q_u32(dst + i, widenRestartPreserving(vget_low_u16(v)));
+        vst1q_u32(dst + i + 4, widenRestartPreserving(vget_high_u16(v)));
+    }
+#elif GLTF_INDEX_SSE2
+    const __m128i restart = _mm_set1_epi16(static_cast<short>(0xFFFF));
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i isRestart = _mm_cmpeq_epi16(v, restart);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi16(v, isRestart));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 4), _mm_unpackhi_epi16(v, isRestart));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = (src[i] == RestartIndex<uint16_t>()) ? RestartIndex<uint32_t>() : src[i];
+    }
+}
+
+void convertIndices(const uint8_t *src, size_t count, uint32_t *dst) {
+    size_t i = 0;
+#if GLTF_INDEX_NEON
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        uint16x8_t lo = widenRestartPreserving(vget_low_u8(v));
+        uint16x8_t hi = widenRestartPreserving(vget_high_u8(v));
+        vst1q_u32(dst + i, widenRestartPreserving(vget_low_u16(lo)));
+        vst1q_u32(dst + i + 4, widenRestartPreserving(vget_high_u16(lo)));
+        vst1q_u32(dst + i + 8, widenRestartPreserving(vget_low_u16(hi)));
+        vst1q_u32(dst + i + 12, widenRestartPreserving(vget_high_u16(hi)));
+    }
+#elif GLTF_INDEX_SSE2
+    const __m128i restart = _mm_set1_epi8(static_cast<char>(0xFF));
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i isRestart8 = _mm_cmpeq_epi8(v, restart);
+        __m128i lo = _mm_unpacklo_epi8(v, isRestart8);
+        __m128i hi = _mm_unpackhi_epi8(v, isRestart8);
+        __m128i isRestartLo = _mm_unpacklo_epi8(isRestart8, isRestart8);
+        __m128i isRestartHi = _mm_unpackhi_epi8(isRestart8, isRestart8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi16(lo, isRestartLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 4), _mm_unpackhi_epi16(lo, isRestartLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 8), _mm_unpacklo_epi16(hi, isRestartHi));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 12), _mm_unpackhi_epi16(hi, isRestartHi));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = (src[i] == RestartIndex<uint8_t>()) ? RestartIndex<uint32_t>() : src[i];
+    }
+}
+
+void convertIndices(const uint32_t *src, size_t count, uint16_t *dst) {
+    // Truncation maps in-range indices to themselves and the 32-bit restart index to the 16-bit one.
+    size_t i = 0;
+#if GLTF_INDEX_NEON
+    for (; i + 8 <= count; i += 8) {
+        uint16x4_t lo = vmovn_u32(vld1q_u32(src + i));
+        uint16x4_t hi = vmovn_u32(vld1q_u32(src + i + 4));
+        vst1q_u16(dst + i, vcombine_u16(lo, hi));
+    }
+#elif GLTF_INDEX_SSE2
+    for (; i + 8 <= count; i += 8) {
+        // Sign-extend the low 16 bits of each lane so that the saturating pack is an exact truncation.
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 4));
+        lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+        hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = static_cast<uint16_t>(src[i]);
+    }
+}
+
+template <typename Src_t, typename Dst_t>
+void parallelConvertIndices(const Src_t *src, size_t count, Dst_t *dst) {
+    ParallelFor(count, IndexGrainSize, [&](size_t begin, size_t end) {
+        convertIndices(src + begin, end - begin, dst + begin);
+    });
+}
+
+template <typename Dst_t>
+void generateSequentialIndices(size_t count, Dst_t *dst) {
+    ParallelFor(count, IndexGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] = static_cast<Dst_t>(i);
+        }
+    });
+}
+
+template <typename Dst_t, typename Src_t>
+inline Dst_t convertIndex(Src_t index) {
+    return (index == RestartIndex<Src_t>()) ? RestartIndex<Dst_t>() : static_cast<Dst_t>(index);
+}
+
+// Calls `body(begin, end)` for each run of indices between restart indices.
+template <typename Src_t, typename Body>
+void forEachRestartSegment(const Src_t *src, size_t count, const Body &body) {
+    size_t begin = 0;
+    for (size_t i = 0; i <= count; ++i) {
+        if (i == count || src[i] == RestartIndex<Src_t>()) {
+            if (i > begin) {
+                body(begin, i);
+            }
+            begin = i + 1;
+        }
+    }
+}
+
+template <typename Src_t, typename Dst_t>
+size_t convertList(const Src_t *src, size_t count, size_t verticesPerPrimitive, Dst_t *dst) {
+    size_t written = 0;
+    for (size_t i = 0; i + verticesPerPrimitive <= count; i += verticesPerPrimitive) {
+        bool hasRestart = false;
+        for (size_t v = 0; v < verticesPerPrimitive; ++v) {
+            hasRestart = hasRestart || (src[i + v] == RestartIndex<Src_t>());
+        }
+        if (hasRestart) {
+            continue;
+        }
+        for (size_t v = 0; v < verticesPerPrimitive; ++v) {
+            dst[written++] = static_cast<Dst_t>(src[i + v]);
+        }
+    }
+    return written;
+}
+
+} // namespace
+
+PrimitiveTopology ListTopologyForTopology(PrimitiveTopology topology) {
+    switch (topology) {
+        case PrimitiveTopologyLineLoop:
+        case PrimitiveTopologyLineStrip:
+            return PrimitiveTopologyLines;
+        case PrimitiveTopologyTriangleStrip:
+        case PrimitiveTopologyTriangleFan:
+            return PrimitiveTopologyTriangles;
+        default:
+            return topology;
+    }
+}
+
+size_t ListIndexCountUpperBound(PrimitiveTopology topology, size_t indexCount) {
+    switch (topology) {
+        case PrimitiveTopologyLineLoop:
+            return 2 * indexCount;
+        case PrimitiveTopologyLineStrip:
+            return (indexCount > 1) ? 2 * (indexCount - 1) : 0;
+        case PrimitiveTopologyTriangleStrip:
+        case PrimitiveTopologyTriangleFan:
+            return (indexCount > 2) ? 3 * (indexCount - 2) : 0;
+        default:
+            return indexCount;
+    }
+}
+
+uint32_t MaxIndexValue(const uint8_t *indices, size_t count) {
+    return parallelMaxIndexValue(indices, count);
+}
+
+uint32_t MaxIndexValue(const uint16_t *indices, size_t count) {
+    return parallelMaxIndexValue(indices, count);
+}
+
+uint32_t MaxIndexValue(const uint32_t *indices, size_t count) {
+    return parallelMaxIndexValue(indices, count);
+}
+
+void ConvertIndices(const uint8_t *src, size_t count, uint16_t *dst) {
+    parallelConvertIndices(src, count, dst);
+}
+
+void ConvertIndices(const uint8_t *src, size_t count, uint32_t *dst) {
+    parallelConvertIndices(src, count, dst);
+}
+
+void ConvertIndices(const uint16_t *src, size_t count, uint32_t *dst) {
+    parallelConvertIndices(src, count, dst);
+}
+
+void ConvertIndices(const uint32_t *src, size_t count, uint16_t *dst) {
+    parallelConvertIndices(src, count, dst);
+}
+
+void GenerateSequentialIndices(size_t count, uint16_t *dst) {
+    generateSequentialIndices(count, dst);
+}
+
+void GenerateSequentialIndices(size_t count, uint32_t *dst) {
+    generateSequentialIndices(count, dst);
+}
+
+template <typename Src_t, typename Dst_t>
+size_t ConvertIndicesToListTopology(PrimitiveTopology topology, const Src_t *src, size_t count, Dst_t *dst) {
+    size_t written = 0;
+    switch (topology) {
+        case PrimitiveTopologyPoints:
+            return convertList(src, count, 1, dst);
+        case PrimitiveTopologyLines:
+            return convertList(src, count, 2, dst);
+        case PrimitiveTopologyTriangles:
+            return convertList(src, count, 3, dst);
+        case PrimitiveTopologyLineStrip:
+            forEachRestartSegment(src, count, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i + 1 < end; ++i) {
+                    dst[written++] = convertIndex<Dst_t>(src[i]);
+                    dst[written++] = convertIndex<Dst_t>(src[i + 1]);
+                }
+            });
+            return written;
+        case PrimitiveTopologyLineLoop:
+            forEachRestartSegment(src, count, [&](size_t begin, size_t end) {
+                if (end - begin < 2) {
+                    return;
+                }
+                for (size_t i = begin; i + 1 < end; ++i) {
+                    dst[written++] = convertIndex<Dst_t>(src[i]);
+                    dst[written++] = convertIndex<Dst_t>(src[i + 1]);
+                }
+                dst[written++] = convertIndex<Dst_t>(src[end - 1]);
+                dst[written++] = convertIndex<Dst_t>(src[begin]);
+            });
+            return written;
+        case PrimitiveTopologyTriangleStrip:
+            forEachRestartSegment(src, count, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i + 2 < end; ++i) {
+                    const Src_t a = src[i], b = src[i + 1], c = src[i + 2];
+                    if (a == b || b == c || a == c) {
+                        continue;
+                    }
+                    // Every other triangle in a strip has its first two vertices swapped to preserve winding.
+                    const bool isOdd = ((i - begin) & 1) != 0;
+                    dst[written++] = convertIndex<Dst_t>(isOdd ? b : a);
+                    dst[written++] = convertIndex<Dst_t>(isOdd ? a : b);
+                    dst[written++] = convertIndex<Dst_t>(c);
+                }
+            });
+            return written;
+        case PrimitiveTopologyTriangleFan:
+            forEachRestartSegment(src, count, [&](size_t begin, size_t end) {
+                for (size_t i = begin + 1; i + 1 < end; ++i) {
+                    const Src_t a = src[begin], b = src[i], c = src[i + 1];
+                    if (a == b || b == c || a == c) {
+                        continue;
+                    }
+                    dst[written++] = convertIndex<Dst_t>(a);
+                    dst[written++] = convertIndex<Dst_t>(b);
+                    dst[written++] = convertIndex<Dst_t>(c);
+                }
+            });
+            return written;
+        default:
+            return 0;
+    }
+}
+
+template size_t ConvertIndicesToListTopology(PrimitiveTopology, const uint8_t *, size_t, uint16_t *);
+template size_t ConvertIndicesToListTopology(PrimitiveTopology, const uint8_t *, size_t, uint32_t *);
+template size_t ConvertIndicesToListTopology(PrimitiveTopology, const uint16_t *, size_t, uint16_t *);
+template size_t ConvertIndicesToListTopology(PrimitiveTopology, const uint16_t *, size_t, uint32_t *);
+template size_t ConvertIndicesToListTopology(PrimitiveTopology, const uint32_t *, size_t, uint16_t *);
+template size_t ConvertIndicesToListTopology(PrimitiveTopology, const uint32_t *, size_t, uint32_t *);
+
+} // namespace GLTF
@@ -0,0 +1,58 @@
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace GLTF {
+
+// These mirror the values of GLTFPrimitiveType.
+enum PrimitiveTopology : int {
+    PrimitiveTopologyInvalid,
+    PrimitiveTopologyPoints,
+    PrimitiveTopologyLines,
+    PrimitiveTopologyLineLoop,
+    PrimitiveTopologyLineStrip,
+    PrimitiveTopologyTriangles,
+    PrimitiveTopologyTriangleStrip,
+    PrimitiveTopologyTriangleFan
+};
+
+/// Returns the list topology (points, lines or triangles) that `topology` is drawn as.
+PrimitiveTopology ListTopologyForTopology(PrimitiveTopology topology);
+
+/// Returns the greatest number of indices that converting `indexCount` indices of `topology` to its list topology can produce.
+size_t ListIndexCountUpperBound(PrimitiveTopology topology, size_t indexCount);
+
+/// The index value that marks a primitive restart. glTF forbids this value in index data, so when it does occur
+/// the converters below treat it as a restart rather than as a vertex reference.
+template <typename Index_t>
+inline Index_t RestartIndex() {
+    return std::numeric_limits<Index_t>::max();
+}
+
+/// Returns the largest value in `indices`. If the result is RestartIndex<Index_t>(), the data contains restarts.
+uint32_t MaxIndexValue(const uint8_t *indices, size_t count);
+uint32_t MaxIndexValue(const uint16_t *indices, size_t count);
+uint32_t MaxIndexValue(const uint32_t *indices, size_t count);
+
+/// Converts indices between widths in a single vectorized pass. When narrowing, every index must fit in
+/// the destination type; restart indices are preserved as restart indices of the destination type.
+void ConvertIndices(const uint8_t *src, size_t count, uint16_t *dst);
+void ConvertIndices(const uint8_t *src, size_t count, uint32_t *dst);
+void ConvertIndices(const uint16_t *src, size_t count, uint32_t *dst);
+void ConvertIndices(const uint32_t *src, size_t count, uint16_t *dst);
+
+/// Writes the indices 0, 1, ..., count - 1.
+void GenerateSequentialIndices(size_t count, uint16_t *dst);
+void GenerateSequentialIndices(size_t count, uint32_t *dst);
+
+/// Rewrites `count` indices of `topology` as its list topology, splitting strips, fans and loops at restart indices
+/// and dropping list primitives that reference a restart index. Triangle strips keep a consistent winding, and
+/// degenerate triangles (such as those used to stitch strips together) are dropped. `dst` must have room for
+/// ListIndexCountUpperBound(topology, count) indices. Returns the number of indices written.
+template <typename Src_t, typename Dst_t>
+size_t ConvertIndicesToListTopology(PrimitiveTopology topology, const Src_t *src, size_t count, Dst_t *dst);
+
+} // namespace GLTF
@@ -0,0 +1,180 @@
+
+#include "GLTFInstancing.h"
+#include "GLTFParallel.h"
+#include "GLTFVectorMath.h"
+
+namespace GLTF {
+
+namespace {
+
+// Transforms per unit of parallel work when decomposing
+const size_t TransformGrainSize = 1024;
+
+inline uint64_t mixHash(uint64_t hash, uint64_t word) {
+    word *= 0x87c37b91114253d5ull;
+    word = (word << 31) | (word >> 33);
+    word *= 0x4cf5ad432745937full;
+    hash ^= word;
+    hash = (hash << 27) | (hash >> 37);
+    return hash * 5 + 0x52dce729;
+}
+
+inline uint64_t finalizeHash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    return hash ^ (hash >> 33);
+}
+
+// Returns the rotation of the orthonormal, right-handed basis with columns c0, c1 and c2 as a quaternion (x y z w).
+void quaternionFromBasis(Vec3 c0, Vec3 c1, Vec3 c2, float *q) {
+    const float trace = c0.x + c1.y + c2.z;
+    if (trace > 0.0f) {
+        const float s = std::sqrt(trace + 1.0f) * 2.0f;
+        q[0] = (c1.z - c2.y) / s;
+        q[1] = (c2.x - c0.z) / s;
+        q[2] = (c0.y - c1.x) / s;
+        q[3] = 0.25f * s;
+    } else if (c0.x > c1.y && c0.x > c2.z) {
+        const float s = std::sqrt(1.0f + c0.x - c1.y - c2.z) * 2.0f;
+        q[0] = 0.25f * s;
+        q[1] = (c1.x + c0.y) / s;
+        q[2] = (c2.x + c0.z) / s;
+        q[3] = (c1.z - c2.y) / s;
+    } else if (c1.y > c2.z) {
+        const float s = std::sqrt(1.0f + c1.y - c0.x - c2.z) * 2.0f;
+        q[0] = (c1.x + c0.y) / s;
+        q[1] = 0.25f * s;
+        q[2] = (c2.y + c1.z) / s;
+        q[3] = (c2.x - c0.z) / s;
+    } else {
+        const float s = std::sqrt(1.0f + c2.z - c0.x - c1.y) * 2.0f;
+        q[0] = (c2.x + c0.z) / s;
+        q[1] = (c2.y + c1.z) / s;
+        q[2] = 0.25f * s;
+        q[3] = (c0.y - c1.x) / s;
+    }
+    const float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int i = 0; i < 4; ++i) {
+        q[i] /= length;
+    }
+}
+
+// Returns the columns of the rotation matrix of the unit quaternion q (x y z w).
+void basisFromQuaternion(const float *q, Vec3 *columns) {
+    const float x = q[0], y = q[1], z = q[2], w = q[3];
+    columns[0] = MakeVec3(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w));
+    columns[1] = MakeVec3(2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w));
+    columns[2] = MakeVec3(2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y));
+}
+
+bool decomposeTransform(const float *m, float tolerance, float *translation, float *rotation, float *scale) {
+    float largest = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        largest = std::max(largest, std::fabs(m[i]));
+    }
+    const float limit = tolerance * std::max(largest, 1.0f);
+    if (std::fabs(m[3]) > limit || std::fabs(m[7]) > limit || std::fabs(m[11]) > limit ||
+        std::fabs(m[15] - 1.0f) > limit)
+    {
+        return false;
+    }
+    const Vec3 columns[3] = { MakeVec3(m[0], m[1], m[2]), MakeVec3(m[4], m[5], m[6]), MakeVec3(m[8], m[9], m[10]) };
+    float s[3] = { Length(columns[0]), Length(columns[1]), Length(columns[2]) };
+    if (Dot(columns[0], Cross(columns[1], columns[2])) < 0.0f) {
+        s[0] = -s[0];
+    }
+    Vec3 basis[3];
+    for (int c = 0; c < 3; ++c) {
+        if (std::fabs(s[c]) <= 1e-20f) {
+            return false;
+        }
+        basis[c] = columns[c] * (1.0f / s[c]);
+    }
+    quaternionFromBasis(basis[0], basis[1], basis[2], rotation);
+
+    // Shear survives normalization of the columns, so check that the decomposition reproduces the matrix
+    Vec3 rotated[3];
+    basisFromQuaternion(rotation, rotated);
+    for (int c = 0; c < 3; ++c) {
+        const Vec3 d = rotated[c] * s[c] - columns[c];
+        if (std::fabs(d.x) > limit || std::fabs(d.y) > limit || std::fabs(d.z) > limit) {
+            return false;
+        }
+    }
+    translation[0] = m[12];
+    translation[1] = m[13];
+    translation[2] = m[14];
+    scale[0] = s[0];
+    scale[1] = s[1];
+    scale[2] = s[2];
+    return true;
+}
+
+} // namespace
+
+uint64_t HashAccessorData(const AccessorView &view) {
+    const size_t elementSize = view.elementSize();
+    uint64_t h = mixHash(mixHash(mixHash(0, static_cast<uint64_t>(view.componentType)),
+                                 static_cast<uint64_t>(view.componentCount) | (view.normalized ? 0x100u : 0u)),
+                         static_cast<uint64_t>(view.count));
+    if (!view.isValid()) {
+        return finalizeHash(h);
+    }
+    for (size_t i = 0; i < view.count; ++i) {
+        const uint8_t *element = view.element(i);
+        size_t offset = 0;
+        for (; offset + sizeof(uint64_t) <= elementSize; offset += sizeof(uint64_t)) {
+            h = mixHash(h, LoadUnaligned<uint64_t>(element + offset));
+        }
+        uint64_t tail = 0;
+        memcpy(&tail, element + offset, elementSize - offset);
+        h = mixHash(h, tail);
+    }
+    return finalizeHash(h);
+}
+
+bool AccessorDataEqual(const AccessorView &a, const AccessorView &b) {
+    if (a.componentType != b.componentType || a.componentCount != b.componentCount ||
+        a.normalized != b.normalized || a.count != b.count || !a.isValid() || !b.isValid())
+    {
+        return false;
+    }
+    const size_t elementSize = a.elementSize();
+    if (a.stride == elementSize && b.stride == elementSize) {
+        return memcmp(a.data, b.data, elementSize * a.count) == 0;
+    }
+    for (size_t i = 0; i < a.count; ++i) {
+        if (memcmp(a.element(i), b.element(i), elementSize) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DecomposeTransforms(const float *matrices, size_t count, float tolerance, InstanceTransforms &result) {
+    result = InstanceTransforms();
+    result.translations.assign(3 * count, 0.0f);
+    result.rotations.assign(4 * count, 0.0f);
+    result.scales.assign(3 * count, 1.0f);
+    std::vector<uint8_t> decomposed(count, 0);
+    ParallelFor(count, TransformGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            decomposed[i] = decomposeTransform(matrices + 16 * i, tolerance, &result.translations[3 * i],
+                                               &result.rotations[4 * i], &result.scales[3 * i]);
+            if (!decomposed[i]) {
+                result.rotations[4 * i + 3] = 1.0f;
+            }
+        }
+    });
+    result.decomposed.assign(decomposed.begin(), decomposed.end());
+    for (size_t i = 0; i < count; ++i) {
+        const float *r = &result.rotations[4 * i];
+        const float *s = &result.scales[3 * i];
+        result.hasRotation = result.hasRotation || r[0] != 0.0f || r[1] != 0.0f || r[2] != 0.0f || r[3] != 1.0f;
+        result.hasScale = result.hasScale || s[0] != 1.0f || s[1] != 1.0f || s[2] != 1.0f;
+    }
+}
+
+} // namespace GLTF
@@ -0,0 +1,31 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+/// Returns a 64-bit hash of the format and element bytes of `view`, ignoring its stride, so that accessors with equal
+/// contents hash equally however they are laid out.
+uint64_t HashAccessorData(const AccessorView &view);
+
+/// Returns true if `a` and `b` have the same format and count and byte-identical elements.
+bool AccessorDataEqual(const AccessorView &a, const AccessorView &b);
+
+struct InstanceTransforms {
+    std::vector<float> translations; // 3 floats per instance
+    std::vector<float> rotations;    // 4 floats (a unit quaternion, x y z w) per instance
+    std::vector<float> scales;       // 3 floats per instance
+    std::vector<bool> decomposed;    // Whether each transform is exactly (to within tolerance) a TRS transform
+    bool hasRotation = false;        // Whether any rotation is not the identity
+    bool hasScale = false;           // Whether any scale is not one
+};
+
+/// Decomposes `count` column-major 4x4 matrices into translation, rotation and scale, in parallel. Mirroring is
+/// expressed as a negative scale. A matrix that is not reproduced to within `tolerance` (relative to its largest
+/// element) by its decomposition, such as one with shear or projection, is marked as not decomposed.
+void DecomposeTransforms(const float *matrices, size_t count, float tolerance, InstanceTransforms &result);
+
+} // namespace GLTF
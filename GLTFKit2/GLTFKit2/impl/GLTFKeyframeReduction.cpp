@@ -0,0 +1,232 @@
+
+#include "GLTFKeyframeReduction.h"
+#include "GLTFAnimationSampling.h"
+#include "GLTFParallel.h"
+
+#include <utility>
+
+namespace GLTF {
+
+namespace {
+
+// Samples of a cubic spline per key interval when sampling at the existing key times
+const int CubicSubdivisions = 4;
+
+AccessorView floatView(const std::vector<float> &values, int componentCount) {
+    AccessorView view;
+    view.data = reinterpret_cast<const uint8_t *>(values.data());
+    view.stride = sizeof(float) * componentCount;
+    view.count = values.size() / componentCount;
+    view.componentType = ComponentTypeFloat;
+    view.componentCount = componentCount;
+    return view;
+}
+
+// How far `b` is from `a`, as a fraction of the tolerance that applies to the track's path
+float relativeError(const float *a, const float *b, const KeyframeTrack &track,
+                    const KeyframeReductionSettings &settings)
+{
+    const uint32_t n = track.componentCount;
+    if (track.path == AnimationPathRotation) {
+        // The angle between unit quaternions, which unlike an arc cosine of their dot product is accurate when small
+        float cosine = 0.0f;
+        for (uint32_t c = 0; c < 4; ++c) {
+            cosine += a[c] * b[c];
+        }
+        const float sign = (cosine < 0.0f) ? -1.0f : 1.0f;
+        float differenceSquared = 0.0f, sumSquared = 0.0f;
+        for (uint32_t c = 0; c < 4; ++c) {
+            differenceSquared += (a[c] - sign * b[c]) * (a[c] - sign * b[c]);
+            sumSquared += (a[c] + sign * b[c]) * (a[c] + sign * b[c]);
+        }
+        const float angle = 4.0f * std::atan2(std::sqrt(differenceSquared), std::sqrt(sumSquared));
+        return angle / std::max(settings.angleTolerance, 1e-12f);
+    }
+    float error = 0.0f;
+    if (track.path == AnimationPathWeights) {
+        for (uint32_t c = 0; c < n; ++c) {
+            error = std::max(error, std::fabs(a[c] - b[c]));
+        }
+    } else {
+        for (uint32_t c = 0; c < n; ++c) {
+            error += (a[c] - b[c]) * (a[c] - b[c]);
+        }
+        error = std::sqrt(error);
+    }
+    return error / std::max(settings.positionTolerance, 1e-12f);
+}
+
+// Interpolates between `a` and `b` as the track's linear interpolation does.
+void interpolate(const float *a, const float *b, float u, const KeyframeTrack &track, float *result) {
+    const uint32_t n = track.componentCount;
+    if (track.path != AnimationPathRotation) {
+        for (uint32_t c = 0; c < n; ++c) {
+            result[c] = a[c] + (b[c] - a[c]) * u;
+        }
+        return;
+    }
+    float cosine = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    const float sign = (cosine < 0.0f) ? -1.0f : 1.0f;
+    cosine = std::fabs(cosine);
+    float wa = 1.0f - u, wb = u;
+    if (cosine < 0.9995f) {
+        const float angle = std::acos(cosine), inverseSine = 1.0f / std::sin(angle);
+        wa = std::sin((1.0f - u) * angle) * inverseSine;
+        wb = std::sin(u * angle) * inverseSine;
+    }
+    float lengthSquared = 0.0f;
+    for (uint32_t c = 0; c < 4; ++c) {
+        result[c] = wa * a[c] + sign * wb * b[c];
+        lengthSquared += result[c] * result[c];
+    }
+    const float scale = (lengthSquared > 0.0f) ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+    for (uint32_t c = 0; c < 4; ++c) {
+        result[c] *= scale;
+    }
+}
+
+// Removes keys that repeat the value of the key before them, which is all a step track can lose.
+void reduceStepTrack(KeyframeTrack &track, const KeyframeReductionSettings &settings) {
+    const uint32_t n = track.componentCount;
+    size_t kept = 1;
+    for (size_t k = 1; k < track.times.size(); ++k) {
+        const float *value = &track.values[k * n];
+        if (relativeError(&track.values[(kept - 1) * n], value, track, settings) > 1.0f) {
+            track.times[kept] = track.times[k];
+            std::copy(value, value + n, track.values.begin() + kept * n);
+            ++kept;
+        }
+    }
+    track.times.resize(kept);
+    track.values.resize(kept * n);
+}
+
+} // namespace
+
+bool ReduceKeyframes(KeyframeTrack &track, const KeyframeReductionSettings &settings) {
+    const uint32_t n = track.componentCount;
+    const size_t elementsPerKey = (track.interpolation == InterpolationCubic) ? 3 : 1;
+    if (track.times.empty() || n == 0 || track.values.size() != track.times.size() * elementsPerKey * n) {
+        return false;
+    }
+    if (track.interpolation == InterpolationStep) {
+        reduceStepTrack(track, settings);
+        return true;
+    }
+
+    // Evaluate the track exactly with the runtime sampler, as a one-node clip
+    AnimationClip clip;
+    const int outputComponents = (track.path == AnimationPathWeights) ? 1 : static_cast<int>(n);
+    if (!clip.addTrack(track.path, track.interpolation, 0, n, floatView(track.times, 1),
+                       floatView(track.values, outputComponents)))
+    {
+        return false;
+    }
+    AnimationPose pose;
+    pose.translations.assign(3, 0.0f);
+    pose.rotations.assign(4, 0.0f);
+    pose.scales.assign(3, 0.0f);
+    pose.weights.assign(n, 0.0f);
+    const float *sampled = (track.path == AnimationPathTranslation) ? pose.translations.data() :
+                           (track.path == AnimationPathRotation) ? pose.rotations.data() :
+                           (track.path == AnimationPathScale) ? pose.scales.data() : pose.weights.data();
+
+    std::vector<float> sampleTimes;
+    const float start = track.times.front(), end = track.times.back();
+    if (settings.sampleRate > 0.0f) {
+        const size_t intervalCount = static_cast<size_t>(std::floor((end - start) * settings.sampleRate + 1e-3f));
+        for (size_t i = 0; i <= intervalCount; ++i) {
+            sampleTimes.push_back(std::min(start + static_cast<float>(i) / settings.sampleRate, end));
+        }
+        if (sampleTimes.back() < end) {
+            sampleTimes.push_back(end);
+        }
+    } else {
+        const int subdivisions = (track.interpolation == InterpolationCubic) ? CubicSubdivisions : 1;
+        for (size_t k = 0; k + 1 < track.times.size(); ++k) {
+            for (int s = 0; s < subdivisions; ++s) {
+                sampleTimes.push_back(track.times[k] + (track.times[k + 1] - track.times[k]) * static_cast<float>(s) / static_cast<float>(subdivisions));
+            }
+        }
+        sampleTimes.push_back(end);
+    }
+
+    const size_t sampleCount = sampleTimes.size();
+    std::vector<float> samples(sampleCount * n);
+    AnimationCursor cursor;
+    for (size_t i = 0; i < sampleCount; ++i) {
+        clip.sample(sampleTimes[i], cursor, pose);
+        float *sample = &samples[i * n];
+        std::copy(sampled, sampled + n, sample);
+        // Keep neighbouring rotations in the same hemisphere, so that the kept keys interpolate the short way
+        if (track.path == AnimationPathRotation && i > 0) {
+            const float *previous = sample - n;
+            if (previous[0] * sample[0] + previous[1] * sample[1] + previous[2] * sample[2] + previous[3] * sample[3] < 0.0f) {
+                for (uint32_t c = 0; c < 4; ++c) {
+                    sample[c] = -sample[c];
+                }
+            }
+        }
+    }
+
+    std::vector<uint8_t> kept(sampleCount, 0);
+    kept[0] = 1;
+    bool constant = true;
+    for (size_t i = 1; i < sampleCount && constant; ++i) {
+        constant = relativeError(&samples[0], &samples[i * n], track, settings) <= 1.0f;
+    }
+    if (!constant) {
+        kept[sampleCount - 1] = 1;
+        std::vector<float> interpolated(n);
+        std::vector<std::pair<size_t, size_t>> spans(1, std::make_pair(size_t(0), sampleCount - 1));
+        while (!spans.empty()) {
+            const size_t a = spans.back().first, b = spans.back().second;
+            spans.pop_back();
+            float largestError = 1.0f;
+            size_t worst = 0;
+            for (size_t i = a + 1; i < b; ++i) {
+                const float span = sampleTimes[b] - sampleTimes[a];
+                const float u = (span > 0.0f) ? (sampleTimes[i] - sampleTimes[a]) / span : 0.0f;
+                interpolate(&samples[a * n], &samples[b * n], u, track, interpolated.data());
+                const float error = relativeError(interpolated.data(), &samples[i * n], track, settings);
+                if (error > largestError) {
+                    largestError = error;
+                    worst = i;
+                }
+            }
+            if (worst != 0) {
+                kept[worst] = 1;
+                spans.push_back(std::make_pair(a, worst));
+                spans.push_back(std::make_pair(worst, b));
+            }
+        }
+    }
+
+    // A spline with few keys can take more linear keys to follow than it had, in which case it stays as it was
+    const size_t keptCount = static_cast<size_t>(std::count(kept.begin(), kept.end(), 1));
+    if (keptCount * (n + 1) > track.times.size() + track.values.size()) {
+        return true;
+    }
+    track.interpolation = InterpolationLinear;
+    track.times.clear();
+    track.values.clear();
+    for (size_t i = 0; i < sampleCount; ++i) {
+        if (kept[i]) {
+            track.times.push_back(sampleTimes[i]);
+            track.values.insert(track.values.end(), samples.begin() + i * n, samples.begin() + (i + 1) * n);
+        }
+    }
+    return true;
+}
+
+std::vector<bool> ReduceKeyframeTracks(std::vector<KeyframeTrack> &tracks, const KeyframeReductionSettings &settings) {
+    std::vector<uint8_t> reduced(tracks.size(), 0);
+    ParallelFor(tracks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            reduced[i] = ReduceKeyframes(tracks[i], settings);
+        }
+    });
+    return std::vector<bool>(reduced.begin(), reduced.end());
+}
+
+} // namespace GLTF
@@ -0,0 +1,37 @@
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace GLTF {
+
+struct KeyframeReductionSettings {
+    float sampleRate = 30.0f;         // Samples per second, or 0 to sample at the existing key times
+    float positionTolerance = 1e-4f;  // The largest error in translation, scale or a morph weight
+    float angleTolerance = 1e-3f;     // The largest error in rotation, in radians
+};
+
+/// The keys of one animation channel, with values as glTF stores them for the interpolation (an in-tangent, a
+/// value and an out-tangent per key for cubic splines).
+struct KeyframeTrack {
+    int path = 0;                    // An AnimationPath
+    int interpolation = 0;           // An Interpolation
+    uint32_t componentCount = 0;     // 3 or 4 for transforms, or the number of morph weights
+    std::vector<float> times;
+    std::vector<float> values;
+};
+
+/// Replaces the keys of `track` with as few linearly interpolated keys as reproduce it within the tolerances.
+/// The track is first sampled at `settings.sampleRate`, evaluating cubic splines exactly, and keys are then removed
+/// Ramer–Douglas–Peucker style: the sample that linear (or, for rotations, spherical) interpolation between the
+/// kept keys misses by the most is kept, until none is missed by more than the tolerance. A track that never leaves
+/// its first value by more than the tolerance collapses to one key. A track that would need more storage than it
+/// had (as a cubic spline with few keys may) is left unchanged. Step tracks keep their key times, losing only keys
+/// that repeat the previous value. Returns false, leaving the track unchanged, if its keys are invalid.
+bool ReduceKeyframes(KeyframeTrack &track, const KeyframeReductionSettings &settings);
+
+/// Reduces each of `tracks` as `ReduceKeyframes` does, in parallel. Returns false for any track that is invalid.
+std::vector<bool> ReduceKeyframeTracks(std::vector<KeyframeTrack> &tracks, const KeyframeReductionSettings &settings);
+
+} // namespace GLTF
@@ -0,0 +1,273 @@
+
+#include "GLTFMeshOptimization.h"
+#include "GLTFVectorMath.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace GLTF {
+
+namespace {
+
+// A FIFO post-transform cache, modeled with per-vertex timestamps: a vertex is resident if it entered the cache
+// fewer than `cacheSize` misses ago.
+class FIFOCacheSimulator {
+public:
+    FIFOCacheSimulator(size_t vertexCount, size_t cacheSize)
+        : timestamps(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+    // Returns true on a miss
+    bool access(uint32_t v) {
+        if (time - timestamps[v] > size) {
+            timestamps[v] = time++;
+            return true;
+        }
+        return false;
+    }
+
+    void reset() {
+        time += size + 1;
+    }
+
+private:
+    std::vector<size_t> timestamps;
+    size_t time;
+    size_t size;
+};
+
+// Triangles incident to each vertex, in compressed sparse row form
+struct VertexTriangleAdjacency {
+    std::vector<uint32_t> firstTriangle;
+    std::vector<uint32_t> triangles;
+
+    VertexTriangleAdjacency(const uint32_t *indices, size_t indexCount, size_t vertexCount)
+        : firstTriangle(vertexCount + 1, 0), triangles(indexCount)
+    {
+        for (size_t i = 0; i < indexCount; ++i) {
+            ++firstTriangle[indices[i] + 1];
+        }
+        for (size_t v = 0; v < vertexCount; ++v) {
+            firstTriangle[v + 1] += firstTriangle[v];
+        }
+        std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (size_t i = 0; i < indexCount; ++i) {
+            triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+};
+
+} // namespace
+
+VertexCacheStatistics AnalyzeVertexCache(const uint32_t *indices, size_t indexCount, size_t vertexCount,
+                                         size_t cacheSize)
+{
+    VertexCacheStatistics statistics;
+    if (indexCount < 3 || vertexCount == 0) {
+        return statistics;
+    }
+    FIFOCacheSimulator cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t misses = 0, referencedCount = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        const uint32_t v = indices[i];
+        misses += cache.access(v) ? 1 : 0;
+        if (!referenced[v]) {
+            referenced[v] = true;
+            ++referencedCount;
+        }
+    }
+    statistics.acmr = static_cast<float>(misses) / static_cast<float>(indexCount / 3);
+    statistics.atvr = static_cast<float>(misses) / static_cast<float>(referencedCount);
+    return statistics;
+}
+
+void OptimizeVertexCache(uint32_t *indices, size_t indexCount, size_t vertexCount,
+                         std::vector<size_t> *clusterStarts, size_t cacheSize)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+    const VertexTriangleAdjacency adjacency(indices, indexCount, vertexCount);
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        liveTriangles[v] = adjacency.firstTriangle[v + 1] - adjacency.firstTriangle[v];
+    }
+    std::vector<size_t> cacheTimestamps(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEndStack;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(indexCount);
+
+    const size_t k = cacheSize;
+    size_t time = k + 1;
+    size_t cursor = 0;
+    const uint32_t None = UINT32_MAX;
+    uint32_t fanningVertex = None;
+    while (true) {
+        if (fanningVertex == None) {
+            // Dead end: resume from the most recently used vertex with work left, or else the next unfinished one
+            while (!deadEndStack.empty() && fanningVertex == None) {
+                const uint32_t v = deadEndStack.back();
+                deadEndStack.pop_back();
+                if (liveTriangles[v] > 0) {
+                    fanningVertex = v;
+                }
+            }
+            while (fanningVertex == None && cursor < vertexCount) {
+                if (liveTriangles[cursor] > 0) {
+                    fanningVertex = static_cast<uint32_t>(cursor);
+                }
+                ++cursor;
+            }
+            if (fanningVertex == None) {
+                break;
+            }
+            if (clusterStarts) {
+                clusterStarts->push_back(output.size());
+            }
+        }
+
+        // Emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        for (uint32_t i = adjacency.firstTriangle[fanningVertex]; i < adjacency.firstTriangle[fanningVertex + 1]; ++i) {
+            const uint32_t t = adjacency.triangles[i];
+            if (emitted[t]) {
+                continue;
+            }
+            emitted[t] = true;
+            for (int j = 0; j < 3; ++j) {
+                const uint32_t v = indices[3 * t + j];
+                output.push_back(v);
+                deadEndStack.push_back(v);
+                candidates.push_back(v);
+                --liveTriangles[v];
+                if (time - cacheTimestamps[v] > k) {
+                    cacheTimestamps[v] = time++;
+                }
+            }
+        }
+
+        // Fan next around the candidate that will still be in the cache after its remaining triangles are emitted,
+        // preferring the one that has been in the cache longest
+        fanningVertex = None;
+        size_t bestPriority = 0;
+        for (uint32_t v : candidates) {
+            if (liveTriangles[v] == 0) {
+                continue;
+            }
+            size_t priority = 0;
+            if (time - cacheTimestamps[v] + 2 * liveTriangles[v] <= k) {
+                priority = time - cacheTimestamps[v];
+            }
+            if (fanningVertex == None || priority > bestPriority) {
+                bestPriority = priority;
+                fanningVertex = v;
+            }
+        }
+    }
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void OptimizeOverdraw(uint32_t *indices, size_t indexCount, const AccessorView &positions,
+                      const std::vector<size_t> &clusterStarts, float threshold)
+{
+    const size_t vertexCount = positions.count;
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || clusterStarts.empty()) {
+        return;
+    }
+
+    // Split the hard clusters wherever the cache miss ratio from the start of the cluster is already within the
+    // threshold of the mesh as a whole, since the cache is effectively cold at any cluster boundary after sorting
+    const float limit = AnalyzeVertexCache(indices, indexCount, vertexCount).acmr * threshold;
+    std::vector<size_t> starts;
+    FIFOCacheSimulator cache(vertexCount, DefaultVertexCacheSize);
+    for (size_t c = 0; c < clusterStarts.size(); ++c) {
+        const size_t clusterEnd = (c + 1 < clusterStarts.size()) ? clusterStarts[c + 1] : indexCount;
+        size_t start = clusterStarts[c];
+        size_t misses = 0;
+        starts.push_back(start);
+        cache.reset();
+        for (size_t i = start; i < clusterEnd; i += 3) {
+            for (size_t j = i; j < i + 3; ++j) {
+                misses += cache.access(indices[j]) ? 1 : 0;
+            }
+            const size_t next = i + 3;
+            const float acmr = static_cast<float>(misses) / static_cast<float>((next - start) / 3);
+            if (next < clusterEnd && acmr <= limit) {
+                starts.push_back(next);
+                start = next;
+                misses = 0;
+                cache.reset();
+            }
+        }
+    }
+
+    const std::vector<Vec3> points = ReadVec3s(positions);
+    Vec3 meshCentroid = MakeVec3(0.0f, 0.0f, 0.0f);
+    float meshArea = 0.0f;
+    std::vector<float> sortKeys(starts.size());
+    std::vector<Vec3> clusterCentroids(starts.size());
+    std::vector<Vec3> clusterNormals(starts.size());
+    for (size_t c = 0; c < starts.size(); ++c) {
+        const size_t end = (c + 1 < starts.size()) ? starts[c + 1] : indexCount;
+        Vec3 centroid = MakeVec3(0.0f, 0.0f, 0.0f), normal = MakeVec3(0.0f, 0.0f, 0.0f);
+        float area = 0.0f;
+        for (size_t i = starts[c]; i < end; i += 3) {
+            const Vec3 a = points[indices[i]], b = points[indices[i + 1]], d = points[indices[i + 2]];
+            const Vec3 faceNormal = Cross(b - a, d - a); // Twice the area, in the direction of the normal
+            const float faceArea = Length(faceNormal);
+            centroid += (a + b + d) * (faceArea / 3.0f);
+            normal += faceNormal;
+            area += faceArea;
+        }
+        meshCentroid += centroid;
+        meshArea += area;
+        clusterCentroids[c] = (area > 0.0f) ? centroid * (1.0f / area) : points[indices[starts[c]]];
+        clusterNormals[c] = Normalize(normal, MakeVec3(0.0f, 0.0f, 0.0f));
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid = meshCentroid * (1.0f / meshArea);
+    }
+    for (size_t c = 0; c < starts.size(); ++c) {
+        sortKeys[c] = Dot(clusterCentroids[c] - meshCentroid, clusterNormals[c]);
+    }
+
+    std::vector<size_t> order(starts.size());
+    std::iota(order.begin(), order.end(), static_cast<size_t>(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return sortKeys[lhs] > sortKeys[rhs];
+    });
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indexCount);
+    for (size_t c : order) {
+        const size_t end = (c + 1 < starts.size()) ? starts[c + 1] : indexCount;
+        sorted.insert(sorted.end(), indices + starts[c], indices + end);
+    }
+    std::copy(sorted.begin(), sorted.end(), indices);
+}
+
+std::vector<uint32_t> OptimizeVertexFetch(uint32_t *indices, size_t indexCount, size_t vertexCount) {
+    const uint32_t Unassigned = UINT32_MAX;
+    std::vector<uint32_t> newIndexForVertex(vertexCount, Unassigned);
+    std::vector<uint32_t> sourceVertices;
+    sourceVertices.reserve(vertexCount);
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t &newIndex = newIndexForVertex[indices[i]];
+        if (newIndex == Unassigned) {
+            newIndex = static_cast<uint32_t>(sourceVertices.size());
+            sourceVertices.push_back(indices[i]);
+        }
+        indices[i] = newIndex;
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (newIndexForVertex[v] == Unassigned) {
+            sourceVertices.push_back(static_cast<uint32_t>(v));
+        }
+    }
+    return sourceVertices;
+}
+
+} // namespace GLTF
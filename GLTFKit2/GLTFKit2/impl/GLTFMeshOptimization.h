@@ -0,0 +1,40 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+/// The post-transform cache size assumed by the optimizers and by AnalyzeVertexCache.
+const size_t DefaultVertexCacheSize = 16;
+
+struct VertexCacheStatistics {
+    float acmr = 0.0f; // Average cache miss ratio: transformed vertices per triangle (0.5 to 3; lower is better)
+    float atvr = 0.0f; // Average transformed vertex ratio: transformed vertices per referenced vertex (1 is optimal)
+};
+
+/// Simulates a FIFO post-transform vertex cache of `cacheSize` entries over the triangle list `indices`.
+VertexCacheStatistics AnalyzeVertexCache(const uint32_t *indices, size_t indexCount, size_t vertexCount,
+                                         size_t cacheSize = DefaultVertexCacheSize);
+
+/// Reorders the triangles of the triangle list `indices` in place for post-transform vertex cache locality, using
+/// the Tipsify algorithm of Sander, Nehab, and Barczak. The start offsets (in indices) of the clusters that
+/// Tipsify emits between dead ends are appended to `clusterStarts`, if it is non-null; they are the hard
+/// boundaries used by OptimizeOverdraw. All indices must be less than `vertexCount`.
+void OptimizeVertexCache(uint32_t *indices, size_t indexCount, size_t vertexCount,
+                         std::vector<size_t> *clusterStarts = nullptr, size_t cacheSize = DefaultVertexCacheSize);
+
+/// Reorders clusters of triangles in the cache-optimized triangle list `indices` so that outward-facing clusters
+/// are drawn first, which reduces overdraw for most viewpoints. Clusters are split further wherever doing so
+/// keeps the cache miss ratio within `threshold` times that of the input (1.05 allows 5% worse), so larger
+/// thresholds trade vertex cache efficiency for less overdraw.
+void OptimizeOverdraw(uint32_t *indices, size_t indexCount, const AccessorView &positions,
+                      const std::vector<size_t> &clusterStarts, float threshold);
+
+/// Renumbers vertices in the order the triangle list `indices` first references them, for vertex fetch locality,
+/// and rewrites `indices` accordingly. Returns the new-to-old vertex map, which lists unreferenced vertices last.
+std::vector<uint32_t> OptimizeVertexFetch(uint32_t *indices, size_t indexCount, size_t vertexCount);
+
+} // namespace GLTF
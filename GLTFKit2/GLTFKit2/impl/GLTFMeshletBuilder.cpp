@@ -0,0 +1,246 @@
+
+#include "GLTFMeshletBuilder.h"
+#include "GLTFParallel.h"
+#include "GLTFVectorMath.h"
+
+#include <limits>
+
+namespace GLTF {
+
+namespace {
+
+// Meshlets per unit of parallel work when computing bounds
+const size_t MeshletGrainSize = 256;
+
+// Cones whose normals spread further than this from the axis (by cosine) are not worth testing
+const float MinimumConeSpread = 0.1f;
+
+void computeMeshletBounds(const std::vector<Vec3> &points, const MeshletSet &set, const Meshlet &meshlet,
+                          MeshletBounds &bounds)
+{
+    const uint32_t *vertices = &set.vertices[meshlet.vertexOffset];
+    const uint8_t *triangles = &set.triangles[meshlet.triangleOffset];
+
+    Vec3 lo = points[vertices[0]], hi = lo;
+    for (uint32_t i = 1; i < meshlet.vertexCount; ++i) {
+        lo = Min(lo, points[vertices[i]]);
+        hi = Max(hi, points[vertices[i]]);
+    }
+    const Vec3 center = (lo + hi) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+        const Vec3 d = points[vertices[i]] - center;
+        radiusSquared = std::max(radiusSquared, Dot(d, d));
+    }
+
+    Vec3 normals[MaxMeshletTriangleCount];
+    Vec3 axis = MakeVec3(0.0f, 0.0f, 0.0f);
+    for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+        const Vec3 a = points[vertices[triangles[3 * t]]];
+        const Vec3 b = points[vertices[triangles[3 * t + 1]]];
+        const Vec3 c = points[vertices[triangles[3 * t + 2]]];
+        normals[t] = Normalize(Cross(b - a, c - a), MakeVec3(0.0f, 0.0f, 0.0f));
+        axis += normals[t];
+    }
+    axis = Normalize(axis, MakeVec3(0.0f, 0.0f, 0.0f));
+    float minimumDot = (Dot(axis, axis) > 0.0f) ? 1.0f : -1.0f;
+    for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+        if (Dot(normals[t], normals[t]) > 0.0f) {
+            minimumDot = std::min(minimumDot, Dot(axis, normals[t]));
+        }
+    }
+
+    Vec3 apex = center;
+    float cutoff = 1.0f;
+    if (minimumDot > MinimumConeSpread) {
+        // Move the apex back along the axis until it is behind the plane of every triangle
+        float maximumT = 0.0f;
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+            if (Dot(normals[t], normals[t]) > 0.0f) {
+                const Vec3 a = points[vertices[triangles[3 * t]]];
+                maximumT = std::max(maximumT, Dot(center - a, normals[t]) / Dot(axis, normals[t]));
+            }
+        }
+        apex = center - axis * maximumT;
+        cutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+    }
+
+    bounds.center[0] = center.x;
+    bounds.center[1] = center.y;
+    bounds.center[2] = center.z;
+    bounds.radius = std::sqrt(radiusSquared);
+    bounds.coneAxis[0] = axis.x;
+    bounds.coneAxis[1] = axis.y;
+    bounds.coneAxis[2] = axis.z;
+    bounds.coneCutoff = cutoff;
+    bounds.coneApex[0] = apex.x;
+    bounds.coneApex[1] = apex.y;
+    bounds.coneApex[2] = apex.z;
+}
+
+} // namespace
+
+bool BuildMeshlets(const AccessorView &positions, const uint32_t *indices, size_t indexCount,
+                   size_t maxVertices, size_t maxTriangles, MeshletSet &result)
+{
+    result = MeshletSet();
+    if (!positions.isValid() || positions.componentCount < 3 ||
+        maxVertices < 3 || maxVertices > MaxMeshletVertexCount || maxTriangles < 1 || maxTriangles > MaxMeshletTriangleCount)
+    {
+        return false;
+    }
+    const size_t vertexCount = positions.count;
+    for (size_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            return false;
+        }
+    }
+    const std::vector<Vec3> points = ReadVec3s(positions);
+    const size_t triangleCount = indexCount / 3;
+
+    // Triangles incident to each vertex, in compressed sparse row form
+    std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+    for (size_t i = 0; i < 3 * triangleCount; ++i) {
+        ++firstTriangle[indices[i] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        firstTriangle[v + 1] += firstTriangle[v];
+    }
+    std::vector<uint32_t> incidentTriangles(3 * triangleCount);
+    std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+    for (size_t i = 0; i < 3 * triangleCount; ++i) {
+        incidentTriangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+    std::vector<Vec3> centroids(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        centroids[t] = (points[indices[3 * t]] + points[indices[3 * t + 1]] + points[indices[3 * t + 2]]) * (1.0f / 3.0f);
+    }
+
+    const uint32_t None = UINT32_MAX;
+    std::vector<uint32_t> localIndex(vertexCount, None);
+    std::vector<bool> emitted(triangleCount, false);
+    size_t cursor = 0;
+    Meshlet meshlet = { 0, 0, 0, 0 };
+    Vec3 centroidSum = MakeVec3(0.0f, 0.0f, 0.0f);
+
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        liveTriangles[v] = firstTriangle[v + 1] - firstTriangle[v];
+    }
+    std::vector<uint32_t> previousVertices;
+
+    auto finishMeshlet = [&]() {
+        previousVertices.assign(result.vertices.begin() + meshlet.vertexOffset, result.vertices.end());
+        for (uint32_t v : previousVertices) {
+            localIndex[v] = None;
+        }
+        result.meshlets.push_back(meshlet);
+        meshlet.vertexOffset = static_cast<uint32_t>(result.vertices.size());
+        meshlet.triangleOffset = static_cast<uint32_t>(result.triangles.size());
+        meshlet.vertexCount = 0;
+        meshlet.triangleCount = 0;
+        centroidSum = MakeVec3(0.0f, 0.0f, 0.0f);
+    };
+
+    while (true) {
+        uint32_t best = None;
+        if (meshlet.triangleCount == 0) {
+            // Seed next to the previous meshlet, at the triangle with the fewest unemitted neighbors, so that
+            // meshlets sweep across the surface without leaving isolated islands behind. Fall back to the first
+            // unemitted triangle.
+            uint32_t bestLiveCount = UINT32_MAX;
+            for (uint32_t v : previousVertices) {
+                for (uint32_t j = firstTriangle[v]; j < firstTriangle[v + 1]; ++j) {
+                    const uint32_t t = incidentTriangles[j];
+                    if (emitted[t]) {
+                        continue;
+                    }
+                    const uint32_t liveCount = liveTriangles[indices[3 * t]] + liveTriangles[indices[3 * t + 1]] +
+                                               liveTriangles[indices[3 * t + 2]];
+                    if (liveCount < bestLiveCount || (liveCount == bestLiveCount && t < best)) {
+                        best = t;
+                        bestLiveCount = liveCount;
+                    }
+                }
+            }
+            if (best == None) {
+                while (cursor < triangleCount && emitted[cursor]) {
+                    ++cursor;
+                }
+                if (cursor == triangleCount) {
+                    break;
+                }
+                best = static_cast<uint32_t>(cursor);
+            }
+        } else {
+            // Grow across the meshlet's vertices to the triangle that adds the fewest vertices, then the one with the
+            // fewest unemitted neighbors (so that no slivers are left behind), then the closest
+            const Vec3 center = centroidSum * (1.0f / static_cast<float>(meshlet.triangleCount));
+            int bestNewVertices = 4;
+            uint32_t bestLiveCount = UINT32_MAX;
+            float bestDistance = std::numeric_limits<float>::infinity();
+            for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+                const uint32_t v = result.vertices[meshlet.vertexOffset + i];
+                for (uint32_t j = firstTriangle[v]; j < firstTriangle[v + 1]; ++j) {
+                    const uint32_t t = incidentTriangles[j];
+                    if (emitted[t]) {
+                        continue;
+                    }
+                    const int newVertices = (localIndex[indices[3 * t]] == None) +
+                                            (localIndex[indices[3 * t + 1]] == None) +
+                                            (localIndex[indices[3 * t + 2]] == None);
+                    if (meshlet.vertexCount + newVertices > maxVertices) {
+                        continue;
+                    }
+                    const uint32_t liveCount = liveTriangles[indices[3 * t]] + liveTriangles[indices[3 * t + 1]] +
+                                               liveTriangles[indices[3 * t + 2]];
+                    const Vec3 d = centroids[t] - center;
+                    const float distance = Dot(d, d);
+                    if (newVertices < bestNewVertices ||
+                        (newVertices == bestNewVertices &&
+                         (liveCount < bestLiveCount ||
+                          (liveCount == bestLiveCount && (distance < bestDistance ||
+                                                          (distance == bestDistance && t < best))))))
+                    {
+                        best = t;
+                        bestNewVertices = newVertices;
+                        bestLiveCount = liveCount;
+                        bestDistance = distance;
+                    }
+                }
+            }
+            if (best == None) {
+                finishMeshlet();
+                continue;
+            }
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t v = indices[3 * best + k];
+            if (localIndex[v] == None) {
+                localIndex[v] = meshlet.vertexCount++;
+                result.vertices.push_back(v);
+            }
+            result.triangles.push_back(static_cast<uint8_t>(localIndex[v]));
+            --liveTriangles[v];
+        }
+        emitted[best] = true;
+        centroidSum += centroids[best];
+        if (++meshlet.triangleCount == maxTriangles) {
+            finishMeshlet();
+        }
+    }
+    if (meshlet.triangleCount > 0) {
+        finishMeshlet();
+    }
+
+    result.bounds.resize(result.meshlets.size());
+    ParallelFor(result.meshlets.size(), MeshletGrainSize, [&](size_t begin, size_t end) {
+        for (size_t m = begin; m < end; ++m) {
+            computeMeshletBounds(points, result, result.meshlets[m], result.bounds[m]);
+        }
+    });
+    return true;
+}
+
+} // namespace GLTF
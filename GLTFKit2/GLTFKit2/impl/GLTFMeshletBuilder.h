@@ -0,0 +1,45 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+/// The greatest vertex count of a meshlet, since local indices are bytes.
+const size_t MaxMeshletVertexCount = 256;
+
+/// The greatest triangle count of a meshlet.
+const size_t MaxMeshletTriangleCount = 512;
+
+struct Meshlet {
+    uint32_t vertexOffset;   // Offset of the meshlet's first entry in MeshletSet::vertices
+    uint32_t triangleOffset; // Offset of the meshlet's first local index in MeshletSet::triangles
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+};
+
+struct MeshletBounds {
+    float center[3]; // Bounding sphere
+    float radius;
+    float coneAxis[3];  // The meshlet can be culled if dot(normalize(coneApex - eye), coneAxis) >= coneCutoff
+    float coneCutoff;   // 1 if the normals are too spread out for the cone to cull anything
+    float coneApex[3];
+};
+
+struct MeshletSet {
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices; // Primitive vertex indices, in runs of Meshlet::vertexCount
+    std::vector<uint8_t> triangles; // Triangles of indices into a meshlet's vertex run, in runs of 3 * Meshlet::triangleCount
+    std::vector<MeshletBounds> bounds;
+};
+
+/// Partitions the triangle list `indices` into meshlets of at most `maxVertices` (up to MaxMeshletVertexCount)
+/// vertices and `maxTriangles` (up to MaxMeshletTriangleCount) triangles. Meshlets grow across shared vertices, preferring triangles that add the
+/// fewest new vertices and then those nearest the meshlet's center, so they are compact and nearly full.
+/// Bounds are computed in parallel. Returns false if the limits are out of range or an index is out of range.
+bool BuildMeshlets(const AccessorView &positions, const uint32_t *indices, size_t indexCount,
+                   size_t maxVertices, size_t maxTriangles, MeshletSet &result);
+
+} // namespace GLTF
@@ -52,23 +52,23 @@ BOOL GLTFMeshoptDecodeVertexBuffer(const uint8_t *source, size_t sourceLength,
     const size_t maxBlockElements = std::min((0x2000 / byteStride) & ~0x000F, 0x100ul);
     std::array<uint8_t, 16> deltas;
     ssize_t srcOffset = 1;
-    for (int dstElemBase = 0; dstElemBase < elementCount; dstElemBase += maxBlockElements) {
+    for (size_t dstElemBase = 0; dstElemBase < elementCount; dstElemBase += maxBlockElements) {
         const size_t attrBlockElementCount = MIN(elementCount - dstElemBase, maxBlockElements);
         const size_t groupCount = ((attrBlockElementCount + 0x0F) & ~0x0F) >> 4;
         const size_t headerByteCount = ((groupCount + 0x03) & ~0x03) >> 2;
 
-        for (int byte = 0; byte < byteStride; ++byte) {
+        for (size_t byte = 0; byte < byteStride; ++byte) {
             ssize_t headerBitsOffset = srcOffset;
 
             srcOffset += headerByteCount;
-            for (int group = 0; group < groupCount; ++group) {
+            for (size_t group = 0; group < groupCount; ++group) {
                 int deltaMode = ((source[headerBitsOffset] >> ((group & 0x03) << 1)) & 0x03);
                 // If this is the last group, move to the next byte of header bits.
                 if ((group & 0x03) == 0x03) {
                     ++headerBitsOffset;
                 }
 
-                const int dstElemGroup = dstElemBase + (group << 4);
+                const size_t dstElemGroup = dstElemBase + (group << 4);
 
                 switch (deltaMode) {
                     case 0: // All 16 byte deltas are 0; the size of the encoded block is 0 bytes
@@ -109,7 +109,7 @@ BOOL GLTFMeshoptDecodeVertexBuffer(const uint8_t *source, size_t sourceLength,
                 }
 
                 for (int m = 0; m < 16; ++m) {
-                    const int dstElem = dstElemGroup + m;
+                    const size_t dstElem = dstElemGroup + m;
                     if (dstElem >= elementCount) {
                         break;
                     }
@@ -137,7 +137,7 @@ void GLTFMeshoptApplyFilter(uint8_t *destination, size_t elementCount, size_t st
                     int8_t *dst = reinterpret_cast<int8_t *>(destination);
                     int maxInt = 127;
 
-                    for (int i = 0; i < 4 * elementCount; i += 4) {
+                    for (size_t i = 0; i < 4 * elementCount; i += 4) {
                         float x = dst[i + 0], y = dst[i + 1], one = dst[i + 2];
                         x /= one;
                         y /= one;
@@ -157,7 +157,7 @@ void GLTFMeshoptApplyFilter(uint8_t *destination, size_t elementCount, size_t st
                     int16_t *dst = reinterpret_cast<int16_t *>(destination);
                     int maxInt = 32767;
 
-                    for (int i = 0; i < 4 * elementCount; i += 4) {
+                    for (size_t i = 0; i < 4 * elementCount; i += 4) {
                         float x = dst[i + 0], y = dst[i + 1], one = dst[i + 2];
                         x /= one;
                         y /= one;
@@ -183,7 +183,7 @@ void GLTFMeshoptApplyFilter(uint8_t *destination, size_t elementCount, size_t st
 
             int16_t *dst = reinterpret_cast<int16_t *>(destination);
 
-            for (int i = 0; i < 4 * elementCount; i += 4) {
+            for (size_t i = 0; i < 4 * elementCount; i += 4) {
                 const int16_t inputW = dst[i + 3];
                 const int maxComponent = inputW & 0x03;
                 const float s = M_SQRT1_2 / (inputW | 0x03);
@@ -204,7 +204,7 @@ void GLTFMeshoptApplyFilter(uint8_t *destination, size_t elementCount, size_t st
             const int32_t *src = reinterpret_cast<const int32_t *>(destination);
             float *dst = reinterpret_cast<float *>(destination); // Strict aliasing violation
 
-            for (int i = 0; i < (stride * elementCount) / 4; ++i) {
+            for (size_t i = 0; i < (stride * elementCount) / 4; ++i) {
                 const int32_t v = src[i];
                 int32_t exp = v >> 24;
                 exp = MAX(-100, MIN(exp, 100));
@@ -244,7 +244,7 @@ BOOL GLTFMeshoptDecodeIndexBuffer(const uint8_t *source, size_t sourceLength, si
     std::deque<uint32_t> vertexfifo {}; // cap = 16
 
     ssize_t dstOffset = 0;
-    for (int i = 0; i < triCount; i++) {
+    for (size_t i = 0; i < triCount; i++) {
         const uint8_t code = source[codeOffset++];
         const uint8_t b0 = code >> 4, b1 = code & 0x0F;
 
@@ -363,7 +363,7 @@ BOOL GLTFMeshoptDecodeIndexSequence(const uint8_t *source, size_t count, size_t
 
     std::array<uint32_t, 2> last {};
     size_t dataOffset = 1;
-    for (int i = 0; i < count; i++) {
+    for (size_t i = 0; i < count; i++) {
         uint32_t v = consumeLEB128(source, dataOffset);
         int b = (v & 1);
         int32_t delta = dezig(v >> 1);
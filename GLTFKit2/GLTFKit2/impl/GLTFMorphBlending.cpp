@@ -0,0 +1,186 @@
+
+#include "GLTFMorphBlending.h"
+
+namespace GLTF {
+
+namespace {
+
+// Deltas stored after the last, so that it can be loaded as a vector of four
+const size_t DeltaPaddingCount = 3;
+
+typedef float Float4 __attribute__((vector_size(16)));
+
+inline Float4 splat(float f) {
+    Float4 v = { f, f, f, f };
+    return v;
+}
+
+inline Float4 make4(float x, float y, float z, float w) {
+    Float4 v = { x, y, z, w };
+    return v;
+}
+
+inline Float4 load4(const float *p) {
+    Float4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void store4(float *p, Float4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+// Reads `componentCount` components of element `index` of `view`, with missing and non-finite components read as
+// zero, and returns whether any is further than `threshold` from zero.
+bool readDelta(const AccessorView &view, size_t index, int componentCount, float threshold, float *delta) {
+    std::fill(delta, delta + componentCount, 0.0f);
+    ReadFloats(view, index, delta, componentCount);
+    bool moves = false;
+    for (int c = 0; c < componentCount; ++c) {
+        if (!std::isfinite(delta[c])) {
+            delta[c] = 0.0f;
+        }
+        moves = moves || std::fabs(delta[c]) > threshold;
+    }
+    return moves;
+}
+
+// output[i] += weight * delta[i] for `count` floats
+void addScaled(float *output, const float *delta, float weight, size_t count) {
+    const Float4 w = splat(weight);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        store4(output + i, load4(output + i) + load4(delta + i) * w);
+    }
+    for (; i < count; ++i) {
+        output[i] += delta[i] * weight;
+    }
+}
+
+} // namespace
+
+bool MorphTargetSet::reset(size_t vertexCount, int componentCount) {
+    *this = MorphTargetSet();
+    if (componentCount < 1 || componentCount > 4) {
+        return false;
+    }
+    elementCount = vertexCount;
+    components = componentCount;
+    deltas.assign(DeltaPaddingCount, 0.0f);
+    return true;
+}
+
+bool MorphTargetSet::addTarget(const AccessorView &view, float threshold) {
+    if (components == 0 || !view.isValid() || view.count != elementCount) {
+        return false;
+    }
+    std::vector<uint32_t> targetIndices;
+    std::vector<float> targetDeltas;
+    float delta[4];
+    for (size_t i = 0; i < elementCount; ++i) {
+        if (readDelta(view, i, components, threshold, delta)) {
+            targetIndices.push_back(static_cast<uint32_t>(i));
+            targetDeltas.insert(targetDeltas.end(), delta, delta + components);
+        }
+    }
+    appendTarget(targetIndices, targetDeltas);
+    return true;
+}
+
+bool MorphTargetSet::addSparseTarget(const uint32_t *sparseIndices, const AccessorView &view) {
+    if (components == 0 || (view.count > 0 && !view.isValid())) {
+        return false;
+    }
+    for (size_t i = 0; i < view.count; ++i) {
+        if (sparseIndices[i] >= elementCount || (i > 0 && sparseIndices[i] <= sparseIndices[i - 1])) {
+            return false;
+        }
+    }
+    std::vector<uint32_t> targetIndices;
+    std::vector<float> targetDeltas;
+    float delta[4];
+    for (size_t i = 0; i < view.count; ++i) {
+        if (readDelta(view, i, components, 0.0f, delta)) {
+            targetIndices.push_back(sparseIndices[i]);
+            targetDeltas.insert(targetDeltas.end(), delta, delta + components);
+        }
+    }
+    appendTarget(targetIndices, targetDeltas);
+    return true;
+}
+
+void MorphTargetSet::appendTarget(const std::vector<uint32_t> &targetIndices, const std::vector<float> &targetDeltas) {
+    Target target;
+    target.firstIndex = indices.size();
+    target.firstDelta = deltas.size() - DeltaPaddingCount;
+    target.dense = targetIndices.size() * 2 > elementCount;
+    deltas.resize(target.firstDelta);
+    if (target.dense) {
+        // Blending every vertex in order is faster than visiting most of them by index
+        target.count = elementCount;
+        deltas.resize(target.firstDelta + elementCount * components, 0.0f);
+        for (size_t i = 0; i < targetIndices.size(); ++i) {
+            memcpy(&deltas[target.firstDelta + size_t(targetIndices[i]) * components], &targetDeltas[i * components],
+                   components * sizeof(float));
+        }
+    } else {
+        target.count = targetIndices.size();
+        indices.insert(indices.end(), targetIndices.begin(), targetIndices.end());
+        deltas.insert(deltas.end(), targetDeltas.begin(), targetDeltas.end());
+    }
+    deltas.resize(deltas.size() + DeltaPaddingCount, 0.0f);
+    targets.push_back(target);
+}
+
+size_t MorphTargetSet::byteCount() const {
+    return targets.size() * sizeof(Target) + indices.size() * sizeof(uint32_t) + deltas.size() * sizeof(float);
+}
+
+void MorphTargetSet::blend(const float *base, const float *weights, size_t weightCount, float *output) const {
+    const size_t floatCount = elementCount * components;
+    if (output != base) {
+        memcpy(output, base, floatCount * sizeof(float));
+    }
+    const size_t count = std::min(weightCount, targets.size());
+    for (size_t t = 0; t < count; ++t) {
+        const float weight = weights[t];
+        if (weight == 0.0f) {
+            continue;
+        }
+        const Target &target = targets[t];
+        const float *delta = &deltas[target.firstDelta];
+        if (target.dense) {
+            addScaled(output, delta, weight, floatCount);
+            continue;
+        }
+        const uint32_t *targetIndices = indices.data() + target.firstIndex;
+        size_t i = 0;
+        if (components == 4) {
+            const Float4 w = splat(weight);
+            for (; i < target.count; ++i) {
+                float *element = output + 4 * size_t(targetIndices[i]);
+                store4(element, load4(element) + load4(delta + 4 * i) * w);
+            }
+        } else if (components == 3) {
+            // Each element is loaded and stored as four floats, the last of which belongs to the next element and
+            // is left unchanged by a zero weight; a store at the last vertex would pass the end of the output.
+            size_t vectorCount = target.count;
+            if (vectorCount > 0 && targetIndices[vectorCount - 1] + 1 == elementCount) {
+                vectorCount -= 1;
+            }
+            const Float4 w = make4(weight, weight, weight, 0.0f);
+            for (; i < vectorCount; ++i) {
+                float *element = output + 3 * size_t(targetIndices[i]);
+                store4(element, load4(element) + load4(delta + 3 * i) * w);
+            }
+        }
+        for (; i < target.count; ++i) {
+            float *element = output + components * size_t(targetIndices[i]);
+            for (int c = 0; c < components; ++c) {
+                element[c] += delta[components * i + c] * weight;
+            }
+        }
+    }
+}
+
+} // namespace GLTF
@@ -0,0 +1,60 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GLTF {
+
+/// The morph targets of one vertex attribute, stored compactly for blending on the CPU. A target that moves fewer
+/// than half of the vertices keeps only the indices of the vertices it moves and their deltas; one that moves more
+/// is stored densely, without indices. Deltas are kept as floats, whatever the type of the source data.
+class MorphTargetSet {
+public:
+    /// Empties the set and prepares it for targets of `vertexCount` elements of `componentCount` (1 to 4) floats.
+    /// Returns false if the component count is unsupported.
+    bool reset(size_t vertexCount, int componentCount);
+
+    /// Adds a target from the deltas of every vertex, dropping those whose components are all within `threshold`
+    /// of zero. Components beyond those of `deltas` are zero, as for the handedness of a tangent; non-finite deltas
+    /// are read as zero. Returns false, adding nothing, if `deltas` is invalid or does not match the set's vertices.
+    bool addTarget(const AccessorView &deltas, float threshold);
+
+    /// Adds a target that moves only the vertices in `indices`, which must be strictly increasing, by the matching
+    /// elements of `deltas`; every other delta is zero. Returns false, adding nothing, if an index is out of range
+    /// or out of order, or `deltas` is invalid.
+    bool addSparseTarget(const uint32_t *indices, const AccessorView &deltas);
+
+    size_t vertexCount() const { return elementCount; }
+    int componentCount() const { return components; }
+    size_t targetCount() const { return targets.size(); }
+    /// The number of vertex deltas stored for `target`
+    size_t storedElementCount(size_t target) const { return targets[target].count; }
+    bool isDense(size_t target) const { return targets[target].dense; }
+    size_t byteCount() const;
+
+    /// Writes `base` plus the weighted deltas of every target to `output`, both holding `vertexCount()` elements of
+    /// `componentCount()` floats; they may be the same buffer. Targets beyond `weightCount` and those of zero weight
+    /// are skipped, and weights beyond `targetCount()` are ignored.
+    void blend(const float *base, const float *weights, size_t weightCount, float *output) const;
+
+private:
+    struct Target {
+        size_t firstIndex = 0; // The target's first entry in indices, if it is sparse
+        size_t firstDelta = 0; // The target's first float in deltas
+        size_t count = 0;
+        bool dense = false;
+    };
+
+    void appendTarget(const std::vector<uint32_t> &targetIndices, const std::vector<float> &targetDeltas);
+
+    size_t elementCount = 0;
+    int components = 0;
+    std::vector<Target> targets;
+    std::vector<uint32_t> indices;
+    std::vector<float> deltas; // Followed by padding, so that the last delta can be loaded four floats at a time
+};
+
+} // namespace GLTF
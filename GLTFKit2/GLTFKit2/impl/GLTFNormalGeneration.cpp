@@ -0,0 +1,212 @@
+
+#include "GLTFNormalGeneration.h"
+#include "GLTFParallel.h"
+#include "GLTFVectorMath.h"
+
+#include <unordered_map>
+
+namespace GLTF {
+
+namespace {
+
+// Triangles per unit of parallel work
+const size_t TriangleGrainSize = 1 << 14;
+
+// Corner normals closer than this (by cosine) are considered equal when deciding whether to split a vertex.
+const float SplitNormalTolerance = 0.9999f;
+
+const Vec3 DefaultNormal = { 0.0f, 0.0f, 1.0f };
+
+struct PositionKey {
+    uint32_t bits[3];
+
+    bool operator==(const PositionKey &other) const {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey &key) const {
+        return (key.bits[0] * 73856093u) ^ (key.bits[1] * 19349663u) ^ (key.bits[2] * 83492791u);
+    }
+};
+
+// Maps each vertex to the first vertex with the same position.
+std::vector<uint32_t> weldPositions(const std::vector<Vec3> &positions) {
+    std::vector<uint32_t> canonical(positions.size());
+    std::unordered_map<PositionKey, uint32_t, PositionKeyHash> firstVertexForPosition;
+    firstVertexForPosition.reserve(positions.size());
+    for (size_t v = 0; v < positions.size(); ++v) {
+        PositionKey key;
+        const float components[3] = { positions[v].x + 0.0f, positions[v].y + 0.0f, positions[v].z + 0.0f }; // -0 to 0
+        memcpy(key.bits, components, sizeof(key.bits));
+        canonical[v] = firstVertexForPosition.insert(std::make_pair(key, static_cast<uint32_t>(v))).first->second;
+    }
+    return canonical;
+}
+
+float cornerAngle(Vec3 corner, Vec3 a, Vec3 b) {
+    const Vec3 ea = Normalize(a - corner, MakeVec3(0.0f, 0.0f, 0.0f));
+    const Vec3 eb = Normalize(b - corner, MakeVec3(0.0f, 0.0f, 0.0f));
+    return std::acos(std::min(std::max(Dot(ea, eb), -1.0f), 1.0f));
+}
+
+void smoothNormals(const std::vector<uint32_t> &canonical, const uint32_t *indices, size_t triangleCount,
+                   const std::vector<Vec3> &faceNormals, const std::vector<float> &cornerWeights,
+                   GeneratedNormals &result)
+{
+    const size_t vertexCount = canonical.size();
+    // Each slice of triangles accumulates into its own buffer, so no synchronization is needed
+    const size_t sliceCount = std::max<size_t>(1, std::min(ParallelWorkerCount(),
+                                                           triangleCount / TriangleGrainSize));
+    const size_t sliceSize = (triangleCount + sliceCount - 1) / sliceCount;
+    std::vector<std::vector<Vec3>> sums(sliceCount);
+    ParallelFor(triangleCount, sliceSize, [&](size_t begin, size_t end) {
+        std::vector<Vec3> &sum = sums[begin / sliceSize];
+        sum.assign(vertexCount, MakeVec3(0.0f, 0.0f, 0.0f));
+        for (size_t t = begin; t < end; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                sum[canonical[indices[3 * t + k]]] += faceNormals[t] * cornerWeights[3 * t + k];
+            }
+        }
+    });
+    result.normals.resize(3 * vertexCount);
+    ParallelFor(vertexCount, TriangleGrainSize, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            Vec3 sum = MakeVec3(0.0f, 0.0f, 0.0f);
+            for (const std::vector<Vec3> &sliceSum : sums) {
+                if (!sliceSum.empty()) {
+                    sum += sliceSum[canonical[v]];
+                }
+            }
+            const Vec3 n = Normalize(sum, DefaultNormal);
+            result.normals[3 * v + 0] = n.x;
+            result.normals[3 * v + 1] = n.y;
+            result.normals[3 * v + 2] = n.z;
+        }
+    });
+}
+
+void creasedNormals(const std::vector<uint32_t> &canonical, const uint32_t *indices, size_t triangleCount,
+                    const std::vector<Vec3> &faceNormals, const std::vector<float> &cornerWeights,
+                    float creaseAngle, GeneratedNormals &result)
+{
+    const size_t vertexCount = canonical.size();
+    const size_t cornerCount = 3 * triangleCount;
+
+    // Corners incident to each welded vertex, in compressed sparse row form
+    std::vector<uint32_t> firstCorner(vertexCount + 1, 0);
+    for (size_t c = 0; c < cornerCount; ++c) {
+        ++firstCorner[canonical[indices[c]] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        firstCorner[v + 1] += firstCorner[v];
+    }
+    std::vector<uint32_t> incidentCorners(cornerCount);
+    std::vector<uint32_t> fill(firstCorner.begin(), firstCorner.end() - 1);
+    for (size_t c = 0; c < cornerCount; ++c) {
+        incidentCorners[fill[canonical[indices[c]]]++] = static_cast<uint32_t>(c);
+    }
+
+    // Each corner averages the faces around its vertex that lie within the crease angle of its own face
+    const float creaseCosine = std::cos(creaseAngle);
+    std::vector<Vec3> cornerNormals(cornerCount);
+    ParallelFor(triangleCount, TriangleGrainSize, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const Vec3 faceNormal = faceNormals[t];
+            const bool degenerate = (Dot(faceNormal, faceNormal) == 0.0f);
+            for (size_t c = 3 * t; c < 3 * t + 3; ++c) {
+                const uint32_t v = canonical[indices[c]];
+                Vec3 sum = MakeVec3(0.0f, 0.0f, 0.0f);
+                for (uint32_t i = firstCorner[v]; i < firstCorner[v + 1]; ++i) {
+                    const uint32_t other = incidentCorners[i];
+                    const Vec3 otherNormal = faceNormals[other / 3];
+                    if (degenerate || other / 3 == t || Dot(otherNormal, faceNormal) >= creaseCosine) {
+                        sum += otherNormal * cornerWeights[other];
+                    }
+                }
+                cornerNormals[c] = Normalize(sum, degenerate ? DefaultNormal : faceNormal);
+            }
+        }
+    });
+
+    // Give each vertex the normal of its first corner, and split off a copy for every distinct normal after that
+    const uint32_t Unassigned = UINT32_MAX;
+    std::vector<Vec3> normals(vertexCount, DefaultNormal);
+    std::vector<uint32_t> nextVariant(vertexCount, Unassigned);
+    std::vector<bool> assigned(vertexCount, false);
+    std::vector<uint32_t> remappedIndices(cornerCount);
+    for (size_t c = 0; c < cornerCount; ++c) {
+        const uint32_t v = indices[c];
+        const Vec3 n = cornerNormals[c];
+        if (!assigned[v]) {
+            assigned[v] = true;
+            normals[v] = n;
+            remappedIndices[c] = v;
+            continue;
+        }
+        uint32_t variant = v, last = v;
+        while (variant != Unassigned && Dot(normals[variant], n) < SplitNormalTolerance) {
+            last = variant;
+            variant = nextVariant[variant];
+        }
+        if (variant == Unassigned) {
+            variant = static_cast<uint32_t>(normals.size());
+            normals.push_back(n);
+            nextVariant.push_back(Unassigned);
+            nextVariant[last] = variant;
+            result.splitSourceVertices.push_back(v);
+        }
+        remappedIndices[c] = variant;
+    }
+
+    result.normals.resize(3 * normals.size());
+    memcpy(result.normals.data(), normals.data(), normals.size() * sizeof(Vec3));
+    if (!result.splitSourceVertices.empty()) {
+        result.indices.swap(remappedIndices);
+    }
+}
+
+} // namespace
+
+bool GenerateNormals(const AccessorView &positions, const uint32_t *indices, size_t indexCount, float creaseAngle,
+                     GeneratedNormals &result)
+{
+    result = GeneratedNormals();
+    if (!positions.isValid() || positions.componentCount < 3) {
+        return false;
+    }
+    const size_t vertexCount = positions.count;
+    for (size_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            return false;
+        }
+    }
+
+    const std::vector<Vec3> points = ReadVec3s(positions);
+    const std::vector<uint32_t> canonical = weldPositions(points);
+
+    const size_t triangleCount = indexCount / 3;
+    std::vector<Vec3> faceNormals(triangleCount);
+    std::vector<float> cornerWeights(3 * triangleCount);
+    ParallelFor(triangleCount, TriangleGrainSize, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const Vec3 a = points[indices[3 * t + 0]];
+            const Vec3 b = points[indices[3 * t + 1]];
+            const Vec3 c = points[indices[3 * t + 2]];
+            faceNormals[t] = Normalize(Cross(b - a, c - a), MakeVec3(0.0f, 0.0f, 0.0f));
+            cornerWeights[3 * t + 0] = cornerAngle(a, b, c);
+            cornerWeights[3 * t + 1] = cornerAngle(b, c, a);
+            cornerWeights[3 * t + 2] = cornerAngle(c, a, b);
+        }
+    });
+
+    if (creaseAngle >= static_cast<float>(M_PI)) {
+        smoothNormals(canonical, indices, triangleCount, faceNormals, cornerWeights, result);
+    } else {
+        creasedNormals(canonical, indices, triangleCount, faceNormals, cornerWeights, std::max(creaseAngle, 0.0f), result);
+    }
+    return true;
+}
+
+} // namespace GLTF
@@ -0,0 +1,24 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+struct GeneratedNormals {
+    std::vector<float> normals;                // Three components per output vertex
+    std::vector<uint32_t> splitSourceVertices; // The input vertex copied by each output vertex past the input vertex count
+    std::vector<uint32_t> indices;             // The rewritten triangle list; empty unless vertices were split
+};
+
+/// Generates angle-weighted vertex normals for the triangle list `indices` over `positions`. Vertices that share a
+/// position are smoothed together, so seams in other attributes do not show up in the shading. Where faces around a
+/// vertex meet at more than `creaseAngle` radians, the vertex is split so that each side of the crease has its own
+/// normal; a crease angle of pi or more yields smooth normals without splitting, and a crease angle of 0 yields flat
+/// normals. Returns false if an index is out of range.
+bool GenerateNormals(const AccessorView &positions, const uint32_t *indices, size_t indexCount, float creaseAngle,
+                     GeneratedNormals &result);
+
+} // namespace GLTF
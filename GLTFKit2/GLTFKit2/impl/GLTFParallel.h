@@ -0,0 +1,78 @@
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#else
+#include <atomic>
+#include <vector>
+#endif
+
+namespace GLTF {
+
+namespace detail {
+
+template <typename Body>
+struct ParallelForContext {
+    const Body *body;
+    size_t count;
+    size_t grainSize;
+};
+
+template <typename Body>
+void runParallelForChunk(void *context, size_t chunk) {
+    const ParallelForContext<Body> *ctx = static_cast<const ParallelForContext<Body> *>(context);
+    const size_t begin = chunk * ctx->grainSize;
+    const size_t end = std::min(begin + ctx->grainSize, ctx->count);
+    (*ctx->body)(begin, end);
+}
+
+} // namespace detail
+
+/// The number of threads that ParallelFor can keep busy, for sizing per-thread scratch storage.
+inline size_t ParallelWorkerCount() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/// Invokes `body(begin, end)` over consecutive, disjoint ranges of at most `grainSize` items that together
+/// cover [0, count). Ranges may run concurrently, so `body` must only write state owned by its range.
+/// When `count` fits in a single range, `body` is called once on the calling thread.
+template <typename Body>
+void ParallelFor(size_t count, size_t grainSize, const Body &body) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = std::max<size_t>(grainSize, 1);
+    const size_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (chunkCount == 1) {
+        body(static_cast<size_t>(0), count);
+        return;
+    }
+    detail::ParallelForContext<Body> context = { &body, count, grainSize };
+#if defined(__APPLE__)
+    dispatch_apply_f(chunkCount, DISPATCH_APPLY_AUTO, &context, &detail::runParallelForChunk<Body>);
+#else
+    const size_t threadCount = std::min(ParallelWorkerCount(), chunkCount);
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+            detail::runParallelForChunk<Body>(&context, chunk);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+#endif
+}
+
+} // namespace GLTF
@@ -0,0 +1,96 @@
+
+#include "GLTFQuantization.h"
+#include "GLTFParallel.h"
+
+#include <vector>
+
+namespace GLTF {
+
+namespace {
+
+// Elements per unit of parallel work
+const size_t ElementGrainSize = 4096;
+
+bool isSigned(int format) {
+    return format == VertexComponentFormatSNorm8 || format == VertexComponentFormatSNorm16;
+}
+
+// The largest integer of the format, which represents 1.0
+int32_t normalizedMaximum(int format) {
+    switch (format) {
+        case VertexComponentFormatSNorm8:  return 127;
+        case VertexComponentFormatUNorm8:  return 255;
+        case VertexComponentFormatSNorm16: return 32767;
+        default:                           return 65535;
+    }
+}
+
+void storeInteger(int32_t value, int format, uint8_t *dst, int c) {
+    if (BytesPerVertexComponent(format) == 1) {
+        dst[c] = static_cast<uint8_t>(value);
+    } else {
+        StoreUnaligned<uint16_t>(dst + c * sizeof(uint16_t), static_cast<uint16_t>(value));
+    }
+}
+
+} // namespace
+
+size_t QuantizedStride(int format, int componentCount) {
+    return (BytesPerVertexComponent(format) * componentCount + 3) & ~size_t(3);
+}
+
+float QuantizeVertexStream(const AccessorView &source, const QuantizationParameters &parameters, uint8_t *destination) {
+    const int componentCount = std::min(source.componentCount, 4);
+    const int format = parameters.format;
+    const size_t stride = QuantizedStride(format, componentCount);
+    const int32_t maximum = normalizedMaximum(format);
+    const int32_t minimum = isSigned(format) ? -maximum : 0;
+    const float maximumValue = static_cast<float>(maximum);
+
+    std::vector<float> rangeErrors((source.count + ElementGrainSize - 1) / ElementGrainSize, 0.0f);
+    ParallelFor(source.count, ElementGrainSize, [&](size_t begin, size_t end) {
+        float largestError = 0.0f;
+        for (size_t i = begin; i < end; ++i) {
+            float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            ReadFloats(source, i, values, componentCount);
+            int32_t quantized[4] = { 0, 0, 0, 0 };
+            int64_t sum = 0;
+            float valueSum = 0.0f;
+            for (int c = 0; c < componentCount; ++c) {
+                const float scaled = (values[c] - parameters.offset[c]) * parameters.scale[c] * maximumValue;
+                const float clamped = std::min(std::max(scaled, static_cast<float>(minimum)), maximumValue);
+                quantized[c] = static_cast<int32_t>(std::lround(clamped));
+                sum += quantized[c];
+                valueSum += clamped;
+            }
+            if (parameters.preservesSum && componentCount > 1) {
+                // Rounding each weight separately can leave the sum off by a few steps, so give the difference to
+                // the largest weight, which it changes the least in relative terms
+                const int64_t targetSum = std::llround(valueSum);
+                int largest = 0;
+                for (int c = 1; c < componentCount; ++c) {
+                    largest = (quantized[c] > quantized[largest]) ? c : largest;
+                }
+                const int64_t adjusted = quantized[largest] + (targetSum - sum);
+                quantized[largest] = static_cast<int32_t>(std::min<int64_t>(std::max<int64_t>(adjusted, minimum), maximum));
+            }
+            uint8_t *dst = destination + i * stride;
+            memset(dst, 0, stride);
+            for (int c = 0; c < componentCount; ++c) {
+                storeInteger(quantized[c], format, dst, c);
+                // Dequantize as a GPU does, with the most negative signed value standing for -1
+                const float normalized = std::max(static_cast<float>(quantized[c]) / maximumValue, -1.0f);
+                const float dequantized = normalized / parameters.scale[c] + parameters.offset[c];
+                largestError = std::max(largestError, std::fabs(dequantized - values[c]));
+            }
+        }
+        rangeErrors[begin / ElementGrainSize] = largestError;
+    });
+    float largestError = 0.0f;
+    for (float error : rangeErrors) {
+        largestError = std::max(largestError, error);
+    }
+    return largestError;
+}
+
+} // namespace GLTF
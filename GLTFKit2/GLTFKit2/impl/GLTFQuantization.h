@@ -0,0 +1,26 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+#include "GLTFVertexInterleaving.h"
+
+namespace GLTF {
+
+struct QuantizationParameters {
+    int format = VertexComponentFormatSNorm16; // One of the normalized 8- or 16-bit formats
+    float offset[4] = { 0.0f, 0.0f, 0.0f, 0.0f }; // Subtracted from each component before scaling
+    float scale[4] = { 1.0f, 1.0f, 1.0f, 1.0f };  // Maps each offset component into the range of the format
+    bool preservesSum = false; // Adjust rounding so that the components sum as before, as skinning weights must
+};
+
+/// Returns the distance between quantized elements of `componentCount` components, which KHR_mesh_quantization
+/// requires to be a multiple of four bytes.
+size_t QuantizedStride(int format, int componentCount);
+
+/// Quantizes the elements of `source` into `destination`, which has room for `source.count` elements at
+/// `QuantizedStride`, in parallel. Each component c becomes the normalized integer nearest to
+/// (value - offset[c]) * scale[c], clamped to the range of the format. Returns the largest absolute difference
+/// between any source component and its dequantized value, in the units of the source.
+float QuantizeVertexStream(const AccessorView &source, const QuantizationParameters &parameters, uint8_t *destination);
+
+} // namespace GLTF
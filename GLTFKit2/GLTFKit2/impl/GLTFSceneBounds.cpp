@@ -0,0 +1,341 @@
+
+#include "GLTFSceneBounds.h"
+#include "GLTFParallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace GLTF {
+
+namespace {
+
+// Nodes per unit of parallel work when transforming boxes
+const size_t NodeGrainSize = 1024;
+
+typedef float Float4 __attribute__((vector_size(16)));
+
+inline Float4 splat(float f) {
+    Float4 v = { f, f, f, f };
+    return v;
+}
+
+inline Float4 load4(const float *p) {
+    Float4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void store4(float *p, Float4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+inline Float4 abs4(Float4 v) {
+    Float4 result = { std::fabs(v[0]), std::fabs(v[1]), std::fabs(v[2]), std::fabs(v[3]) };
+    return result;
+}
+
+inline void multiply(const Matrix4x4 &a, const Matrix4x4 &b, Matrix4x4 &result) {
+    const Float4 a0 = load4(a.columns[0]), a1 = load4(a.columns[1]);
+    const Float4 a2 = load4(a.columns[2]), a3 = load4(a.columns[3]);
+    for (int j = 0; j < 4; ++j) {
+        const float *column = b.columns[j];
+        store4(result.columns[j], a0 * column[0] + a1 * column[1] + a2 * column[2] + a3 * column[3]);
+    }
+}
+
+AxisAlignedBox emptyBox() {
+    const float infinity = std::numeric_limits<float>::infinity();
+    AxisAlignedBox box = { { infinity, infinity, infinity, 0.0f }, { -infinity, -infinity, -infinity, 0.0f } };
+    return box;
+}
+
+inline bool isEmpty(const AxisAlignedBox &box) {
+    return !(box.min[0] <= box.max[0] && box.min[1] <= box.max[1] && box.min[2] <= box.max[2]);
+}
+
+inline void formUnion(AxisAlignedBox &box, const AxisAlignedBox &other) {
+    for (int c = 0; c < 3; ++c) {
+        box.min[c] = std::min(box.min[c], other.min[c]);
+        box.max[c] = std::max(box.max[c], other.max[c]);
+    }
+}
+
+// Returns the box around `box` transformed by `m`: its center is transformed, and its half extents along each axis
+// are those of the box weighted by the absolute values of the matrix's columns.
+AxisAlignedBox transformBox(const Matrix4x4 &m, const AxisAlignedBox &box) {
+    if (isEmpty(box)) {
+        return box;
+    }
+    const Float4 center = (load4(box.min) + load4(box.max)) * splat(0.5f);
+    const Float4 extent = (load4(box.max) - load4(box.min)) * splat(0.5f);
+    const Float4 c0 = load4(m.columns[0]), c1 = load4(m.columns[1]), c2 = load4(m.columns[2]);
+    const Float4 worldCenter = c0 * center[0] + c1 * center[1] + c2 * center[2] + load4(m.columns[3]);
+    const Float4 worldExtent = abs4(c0) * extent[0] + abs4(c1) * extent[1] + abs4(c2) * extent[2];
+    AxisAlignedBox result;
+    store4(result.min, worldCenter - worldExtent);
+    store4(result.max, worldCenter + worldExtent);
+    return result;
+}
+
+enum Containment {
+    Outside,
+    Intersecting,
+    Inside,
+};
+
+// Up to four planes in structure-of-arrays form; unused lanes hold a plane that contains everything.
+struct PlaneGroup {
+    Float4 x, y, z, d;
+    Float4 absX, absY, absZ;
+};
+
+std::vector<PlaneGroup> groupPlanes(const float *planes, size_t planeCount) {
+    std::vector<PlaneGroup> groups((planeCount + 3) / 4);
+    for (size_t g = 0; g < groups.size(); ++g) {
+        PlaneGroup &group = groups[g];
+        group.x = group.y = group.z = splat(0.0f);
+        group.d = splat(1.0f);
+        for (size_t lane = 0; lane < 4 && 4 * g + lane < planeCount; ++lane) {
+            const float *plane = planes + 4 * (4 * g + lane);
+            group.x[lane] = plane[0];
+            group.y[lane] = plane[1];
+            group.z[lane] = plane[2];
+            group.d[lane] = plane[3];
+        }
+        group.absX = abs4(group.x);
+        group.absY = abs4(group.y);
+        group.absZ = abs4(group.z);
+    }
+    return groups;
+}
+
+// Classifies `box` against four planes at a time by the signed distance of its center from each plane and the
+// projection of its half extents onto the plane's normal.
+Containment classify(const std::vector<PlaneGroup> &groups, const AxisAlignedBox &box) {
+    if (isEmpty(box)) {
+        return Outside;
+    }
+    const Float4 center = (load4(box.min) + load4(box.max)) * splat(0.5f);
+    const Float4 extent = (load4(box.max) - load4(box.min)) * splat(0.5f);
+    Containment containment = Inside;
+    for (const PlaneGroup &group : groups) {
+        const Float4 distance = group.x * center[0] + group.y * center[1] + group.z * center[2] + group.d;
+        const Float4 radius = group.absX * extent[0] + group.absY * extent[1] + group.absZ * extent[2];
+        const Float4 nearest = distance + radius, farthest = distance - radius;
+        for (int lane = 0; lane < 4; ++lane) {
+            if (nearest[lane] < 0.0f) {
+                return Outside;
+            }
+            if (farthest[lane] < 0.0f) {
+                containment = Intersecting;
+            }
+        }
+    }
+    return containment;
+}
+
+} // namespace
+
+bool SceneBounds::build(const SceneGraph &graph, SceneGeometry sceneGeometry) {
+    *this = SceneBounds();
+    const size_t nodeCount = graph.nodeCount();
+    if (sceneGeometry.primitiveStarts.size() != nodeCount + 1 ||
+        sceneGeometry.primitiveStarts.back() != sceneGeometry.primitiveBoxes.size() ||
+        sceneGeometry.jointNodes.size() != sceneGeometry.inverseBindMatrices.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < nodeCount; ++i) {
+        if (sceneGeometry.primitiveStarts[i] > sceneGeometry.primitiveStarts[i + 1]) {
+            return false;
+        }
+    }
+    std::vector<int32_t> bindings(nodeCount, -1);
+    for (size_t b = 0; b < sceneGeometry.skinnedNodes.size(); ++b) {
+        const SkinnedNodeBinding &binding = sceneGeometry.skinnedNodes[b];
+        if (binding.node >= nodeCount || bindings[binding.node] != -1 ||
+            size_t(binding.firstJoint) + binding.jointCount > sceneGeometry.jointNodes.size())
+        {
+            return false;
+        }
+        for (uint32_t j = binding.firstJoint; j < binding.firstJoint + binding.jointCount; ++j) {
+            if (sceneGeometry.jointNodes[j] >= nodeCount) {
+                return false;
+            }
+        }
+        bindings[binding.node] = static_cast<int32_t>(b);
+    }
+
+    geometry = std::move(sceneGeometry);
+    skinnedNodeBindings.swap(bindings);
+    primitiveWorldBoxes.resize(geometry.primitiveBoxes.size());
+    nodeBoxes.resize(nodeCount);
+    subtreeBoxes.resize(nodeCount);
+    ancestorMarks.assign(nodeCount, 0);
+    updateAll(graph);
+    return true;
+}
+
+void SceneBounds::updateNodeBoxes(const SceneGraph &graph, size_t begin, size_t end) {
+    const Matrix4x4 *worlds = graph.worldTransforms();
+    ParallelFor(end - begin, NodeGrainSize, [&](size_t rangeBegin, size_t rangeEnd) {
+        for (size_t node = begin + rangeBegin; node < begin + rangeEnd; ++node) {
+            if (skinnedNodeBindings[node] >= 0) {
+                updateSkinnedNode(graph, geometry.skinnedNodes[size_t(skinnedNodeBindings[node])]);
+                continue;
+            }
+            AxisAlignedBox nodeBox = emptyBox();
+            for (uint32_t p = geometry.primitiveStarts[node]; p < geometry.primitiveStarts[node + 1]; ++p) {
+                primitiveWorldBoxes[p] = transformBox(worlds[node], geometry.primitiveBoxes[p]);
+                formUnion(nodeBox, primitiveWorldBoxes[p]);
+            }
+            nodeBoxes[node] = nodeBox;
+        }
+    });
+}
+
+void SceneBounds::updateSkinnedNode(const SceneGraph &graph, const SkinnedNodeBinding &binding) {
+    const Matrix4x4 *worlds = graph.worldTransforms();
+    const uint32_t node = binding.node;
+    AxisAlignedBox nodeBox = emptyBox();
+    for (uint32_t p = geometry.primitiveStarts[node]; p < geometry.primitiveStarts[node + 1]; ++p) {
+        primitiveWorldBoxes[p] = (binding.jointCount == 0) ? transformBox(worlds[node], geometry.primitiveBoxes[p])
+                                                           : emptyBox();
+    }
+    // Each skinned vertex is a weighted average of the vertex transformed by its joints' skinning matrices, so it
+    // lies within the union of the primitive's box transformed by each of them
+    for (uint32_t j = binding.firstJoint; j < binding.firstJoint + binding.jointCount; ++j) {
+        Matrix4x4 skinningMatrix;
+        multiply(worlds[geometry.jointNodes[j]], geometry.inverseBindMatrices[j], skinningMatrix);
+        for (uint32_t p = geometry.primitiveStarts[node]; p < geometry.primitiveStarts[node + 1]; ++p) {
+            formUnion(primitiveWorldBoxes[p], transformBox(skinningMatrix, geometry.primitiveBoxes[p]));
+        }
+    }
+    for (uint32_t p = geometry.primitiveStarts[node]; p < geometry.primitiveStarts[node + 1]; ++p) {
+        formUnion(nodeBox, primitiveWorldBoxes[p]);
+    }
+    nodeBoxes[node] = nodeBox;
+}
+
+void SceneBounds::updateSubtreeBoxes(const SceneGraph &graph, size_t begin, size_t end) {
+    std::copy(nodeBoxes.begin() + begin, nodeBoxes.begin() + end, subtreeBoxes.begin() + begin);
+    // Children follow their parents, so visiting the range backward completes each subtree before its parent's
+    const int32_t *parents = graph.parentIndices();
+    for (size_t node = end; node-- > begin + 1;) {
+        if (parents[node] >= static_cast<int64_t>(begin)) {
+            formUnion(subtreeBoxes[size_t(parents[node])], subtreeBoxes[node]);
+        }
+    }
+}
+
+void SceneBounds::updateAncestors(const SceneGraph &graph, const std::vector<uint32_t> &nodes) {
+    const int32_t *parents = graph.parentIndices();
+    ancestors.clear();
+    for (uint32_t node : nodes) {
+        for (int32_t parent = parents[node]; parent >= 0 && !ancestorMarks[size_t(parent)];
+             parent = parents[parent])
+        {
+            ancestorMarks[size_t(parent)] = 1;
+            ancestors.push_back(static_cast<uint32_t>(parent));
+        }
+    }
+    // Recompute descendants before their ancestors, which come first in the graph
+    std::sort(ancestors.begin(), ancestors.end());
+    for (size_t a = ancestors.size(); a-- > 0;) {
+        const uint32_t ancestor = ancestors[a];
+        AxisAlignedBox box = nodeBoxes[ancestor];
+        for (uint32_t child = ancestor + 1; child < graph.subtreeEnd(ancestor); child = graph.subtreeEnd(child)) {
+            formUnion(box, subtreeBoxes[child]);
+        }
+        subtreeBoxes[ancestor] = box;
+        ancestorMarks[ancestor] = 0;
+    }
+}
+
+void SceneBounds::updateAll(const SceneGraph &graph) {
+    updateNodeBoxes(graph, 0, nodeCount());
+    updateSubtreeBoxes(graph, 0, nodeCount());
+}
+
+void SceneBounds::update(const SceneGraph &graph, const std::vector<uint32_t> &roots) {
+    // Skinned nodes depend on joints elsewhere in the graph, so they are updated whether or not they moved
+    updateRoots.clear();
+    uint32_t coveredEnd = 0;
+    auto addRoot = [&](uint32_t root) {
+        if (root >= coveredEnd) {
+            updateRoots.push_back(root);
+            coveredEnd = graph.subtreeEnd(root);
+        }
+    };
+    size_t r = 0;
+    for (const SkinnedNodeBinding &binding : geometry.skinnedNodes) {
+        for (; r < roots.size() && roots[r] <= binding.node; ++r) {
+            addRoot(roots[r]);
+        }
+        addRoot(binding.node);
+    }
+    for (; r < roots.size(); ++r) {
+        addRoot(roots[r]);
+    }
+    for (uint32_t root : updateRoots) {
+        updateNodeBoxes(graph, root, graph.subtreeEnd(root));
+        updateSubtreeBoxes(graph, root, graph.subtreeEnd(root));
+    }
+    updateAncestors(graph, updateRoots);
+}
+
+void SceneBounds::appendVisible(size_t node, std::vector<uint32_t> &visibleNodes,
+                                std::vector<uint32_t> &visiblePrimitives) const
+{
+    bool visible = false;
+    for (uint32_t p = geometry.primitiveStarts[node]; p < geometry.primitiveStarts[node + 1]; ++p) {
+        if (!isEmpty(primitiveWorldBoxes[p])) {
+            visiblePrimitives.push_back(p);
+            visible = true;
+        }
+    }
+    if (visible) {
+        visibleNodes.push_back(static_cast<uint32_t>(node));
+    }
+}
+
+void SceneBounds::cull(const SceneGraph &graph, const float *planes, size_t planeCount,
+                       std::vector<uint32_t> &visibleNodes, std::vector<uint32_t> &visiblePrimitives) const
+{
+    const std::vector<PlaneGroup> groups = groupPlanes(planes, planeCount);
+    const size_t count = nodeCount();
+    for (size_t node = 0; node < count;) {
+        const size_t subtreeEnd = graph.subtreeEnd(node);
+        const Containment subtree = classify(groups, subtreeBoxes[node]);
+        if (subtree == Outside) {
+            node = subtreeEnd;
+            continue;
+        }
+        if (subtree == Inside) {
+            for (; node < subtreeEnd; ++node) {
+                appendVisible(node, visibleNodes, visiblePrimitives);
+            }
+            continue;
+        }
+        const Containment own = classify(groups, nodeBoxes[node]);
+        if (own == Inside) {
+            appendVisible(node, visibleNodes, visiblePrimitives);
+        } else if (own == Intersecting) {
+            bool visible = false;
+            for (uint32_t p = geometry.primitiveStarts[node]; p < geometry.primitiveStarts[node + 1]; ++p) {
+                if (classify(groups, primitiveWorldBoxes[p]) != Outside) {
+                    visiblePrimitives.push_back(p);
+                    visible = true;
+                }
+            }
+            if (visible) {
+                visibleNodes.push_back(static_cast<uint32_t>(node));
+            }
+        }
+        ++node;
+    }
+}
+
+} // namespace GLTF
@@ -0,0 +1,85 @@
+
+#pragma once
+
+#include "GLTFSceneGraph.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GLTF {
+
+/// An axis-aligned box, padded so that each corner loads as a SIMD vector. A box whose minimum exceeds its maximum
+/// on some axis is empty.
+struct alignas(16) AxisAlignedBox {
+    float min[4];
+    float max[4];
+};
+
+/// The joints that deform the primitives of a skinned node: their indices in the scene graph, and their inverse bind
+/// matrices, as a run of the set's skin joints.
+struct SkinnedNodeBinding {
+    uint32_t node = 0;
+    uint32_t firstJoint = 0;
+    uint32_t jointCount = 0;
+};
+
+/// The geometry of every node of a SceneGraph, for building SceneBounds. Node i draws the primitives
+/// [primitiveStarts[i], primitiveStarts[i + 1]), whose boxes in the node's space are in `primitiveBoxes`.
+struct SceneGeometry {
+    std::vector<uint32_t> primitiveStarts;
+    std::vector<AxisAlignedBox> primitiveBoxes;
+    std::vector<SkinnedNodeBinding> skinnedNodes; // In increasing order of node
+    std::vector<uint32_t> jointNodes;
+    std::vector<Matrix4x4> inverseBindMatrices;
+};
+
+/// World-space boxes for each primitive, each node's primitives together, and each node's subtree, kept up to date
+/// with a SceneGraph, for answering visibility queries with hierarchical early-out. A skinned node's primitives are
+/// bounded by the union of their boxes under each joint's skinning matrix, which contains every blend of them.
+class SceneBounds {
+public:
+    /// Prepares the bounds of the nodes of `graph` from `geometry`, and computes them from its world transforms.
+    /// Returns false, leaving the bounds empty, if the geometry does not match the graph.
+    bool build(const SceneGraph &graph, SceneGeometry geometry);
+
+    /// Recomputes the bounds of every node, in parallel.
+    void updateAll(const SceneGraph &graph);
+    /// Recomputes the bounds within the subtrees at `roots`, which must be in increasing order and disjoint, as
+    /// SceneGraph::lastUpdatedRoots() are, and of skinned nodes, then the subtree bounds of their ancestors.
+    void update(const SceneGraph &graph, const std::vector<uint32_t> &roots);
+
+    size_t nodeCount() const { return nodeBoxes.size(); }
+    size_t primitiveCount() const { return primitiveWorldBoxes.size(); }
+    uint32_t firstPrimitive(size_t node) const { return geometry.primitiveStarts[node]; }
+    const AxisAlignedBox &primitiveBox(size_t primitive) const { return primitiveWorldBoxes[primitive]; }
+    /// The union of the boxes of the node's primitives
+    const AxisAlignedBox &nodeBox(size_t node) const { return nodeBoxes[node]; }
+    /// The union of the boxes of the node's subtree
+    const AxisAlignedBox &subtreeBox(size_t node) const { return subtreeBoxes[node]; }
+
+    /// Appends the nodes and primitives whose boxes intersect the convex volume bounded by `planes`, each of four
+    /// floats (a, b, c, d) that contain the points p with a p.x + b p.y + c p.z + d >= 0. A subtree outside a plane
+    /// is skipped, and one inside every plane is accepted without testing its nodes. Nodes are appended only if
+    /// some primitive of theirs is.
+    void cull(const SceneGraph &graph, const float *planes, size_t planeCount, std::vector<uint32_t> &visibleNodes,
+              std::vector<uint32_t> &visiblePrimitives) const;
+
+private:
+    void updateNodeBoxes(const SceneGraph &graph, size_t begin, size_t end);
+    void updateSkinnedNode(const SceneGraph &graph, const SkinnedNodeBinding &binding);
+    void updateSubtreeBoxes(const SceneGraph &graph, size_t begin, size_t end);
+    void updateAncestors(const SceneGraph &graph, const std::vector<uint32_t> &nodes);
+    void appendVisible(size_t node, std::vector<uint32_t> &visibleNodes,
+                       std::vector<uint32_t> &visiblePrimitives) const;
+
+    SceneGeometry geometry;
+    std::vector<int32_t> skinnedNodeBindings; // The index in geometry.skinnedNodes of each node's binding, or -1
+    std::vector<AxisAlignedBox> primitiveWorldBoxes;
+    std::vector<AxisAlignedBox> nodeBoxes;
+    std::vector<AxisAlignedBox> subtreeBoxes;
+    std::vector<uint32_t> updateRoots;    // Scratch for updates
+    std::vector<uint32_t> ancestors;
+    std::vector<uint8_t> ancestorMarks;
+};
+
+} // namespace GLTF
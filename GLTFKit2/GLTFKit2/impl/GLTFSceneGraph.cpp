@@ -0,0 +1,203 @@
+
+#include "GLTFSceneGraph.h"
+#include "GLTFParallel.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace GLTF {
+
+namespace {
+
+// Updates of fewer nodes than this are made on the calling thread
+const size_t ParallelNodeCount = 4096;
+
+// The fewest nodes in a subtree that is updated as one unit of parallel work
+const size_t MinimumSubtreeSize = 256;
+
+typedef float Float4 __attribute__((vector_size(16)));
+
+inline Float4 load4(const float *p) {
+    Float4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void store4(float *p, Float4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+inline void multiply(const Matrix4x4 &a, const Matrix4x4 &b, Matrix4x4 &result) {
+    const Float4 a0 = load4(a.columns[0]), a1 = load4(a.columns[1]);
+    const Float4 a2 = load4(a.columns[2]), a3 = load4(a.columns[3]);
+    for (int j = 0; j < 4; ++j) {
+        const float *column = b.columns[j];
+        store4(result.columns[j], a0 * column[0] + a1 * column[1] + a2 * column[2] + a3 * column[3]);
+    }
+}
+
+// Composes translation * rotation * scale.
+void composeTransform(const float *t, const float *q, const float *s, Matrix4x4 &result) {
+    const float x = q[0], y = q[1], z = q[2], w = q[3];
+    const float columns[4][4] = {
+        { (1.0f - 2.0f * (y * y + z * z)) * s[0], 2.0f * (x * y + z * w) * s[0], 2.0f * (x * z - y * w) * s[0], 0.0f },
+        { 2.0f * (x * y - z * w) * s[1], (1.0f - 2.0f * (x * x + z * z)) * s[1], 2.0f * (y * z + x * w) * s[1], 0.0f },
+        { 2.0f * (x * z + y * w) * s[2], 2.0f * (y * z - x * w) * s[2], (1.0f - 2.0f * (x * x + y * y)) * s[2], 0.0f },
+        { t[0], t[1], t[2], 1.0f },
+    };
+    memcpy(result.columns, columns, sizeof(columns));
+}
+
+// Copies `count` floats from `source` to `destination`, returning whether any changed.
+inline bool assignFloats(float *destination, const float *source, size_t count) {
+    if (memcmp(destination, source, count * sizeof(float)) == 0) {
+        return false;
+    }
+    memcpy(destination, source, count * sizeof(float));
+    return true;
+}
+
+} // namespace
+
+bool SceneGraph::build(const int32_t *parentIndices, size_t count) {
+    *this = SceneGraph();
+    // Walk the nodes keeping the chain of ancestors of the current node; a node's parent must be on that chain
+    std::vector<int32_t> chain;
+    std::vector<uint32_t> ends(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        while (!chain.empty() && chain.back() != parentIndices[i]) {
+            ends[size_t(chain.back())] = static_cast<uint32_t>(i);
+            chain.pop_back();
+        }
+        if (chain.empty() && parentIndices[i] != -1) {
+            return false;
+        }
+        chain.push_back(static_cast<int32_t>(i));
+    }
+    for (int32_t node : chain) {
+        ends[size_t(node)] = static_cast<uint32_t>(count);
+    }
+
+    parents.assign(parentIndices, parentIndices + count);
+    subtreeEnds.swap(ends);
+    nodeTranslations.assign(3 * count, 0.0f);
+    nodeRotations.resize(4 * count);
+    nodeScales.assign(3 * count, 1.0f);
+    for (size_t i = 0; i < count; ++i) {
+        const float identity[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        memcpy(&nodeRotations[4 * i], identity, sizeof(identity));
+    }
+    const Matrix4x4 identity = { { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } };
+    locals.assign(count, identity);
+    worlds.assign(count, identity);
+    flags.assign(count, 0);
+    return true;
+}
+
+void SceneGraph::setTransform(size_t node, const float *translation, const float *rotation, const float *scale) {
+    bool changed = assignFloats(&nodeTranslations[3 * node], translation, 3);
+    changed = assignFloats(&nodeRotations[4 * node], rotation, 4) || changed;
+    changed = assignFloats(&nodeScales[3 * node], scale, 3) || changed;
+    if (changed) {
+        markDirty(node, flags[node] | LocalTransformChanged | WorldTransformChanged);
+    }
+}
+
+void SceneGraph::setLocalTransform(size_t node, const Matrix4x4 &transform) {
+    locals[node] = transform;
+    markDirty(node, WorldTransformChanged);
+}
+
+void SceneGraph::markDirty(size_t node, uint8_t changes) {
+    if (flags[node] == 0) {
+        dirtyNodes.push_back(static_cast<uint32_t>(node));
+    }
+    flags[node] = changes;
+}
+
+bool SceneGraph::applyPose(const AnimationPose &pose, const uint32_t *poseNodes) {
+    const size_t count = nodeCount();
+    for (size_t i = 0; i < count; ++i) {
+        const size_t p = poseNodes[i];
+        if (3 * p + 3 > pose.translations.size() || 4 * p + 4 > pose.rotations.size() ||
+            3 * p + 3 > pose.scales.size())
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const size_t p = poseNodes[i];
+        setTransform(i, &pose.translations[3 * p], &pose.rotations[4 * p], &pose.scales[3 * p]);
+    }
+    return true;
+}
+
+void SceneGraph::updateNode(size_t node) {
+    if (flags[node] & LocalTransformChanged) {
+        composeTransform(&nodeTranslations[3 * node], &nodeRotations[4 * node], &nodeScales[3 * node], locals[node]);
+    }
+    if (parents[node] < 0) {
+        worlds[node] = locals[node];
+    } else {
+        multiply(worlds[size_t(parents[node])], locals[node], worlds[node]);
+    }
+    flags[node] = 0;
+}
+
+void SceneGraph::updateSubtree(size_t node) {
+    for (size_t i = node; i < subtreeEnds[node]; ++i) {
+        updateNode(i);
+    }
+}
+
+size_t SceneGraph::updateWorldTransforms() {
+    // A dirty node invalidates its whole subtree, so only the topmost dirty nodes need to be found. In depth-first
+    // order, those are the dirty nodes not within the subtree of an earlier one.
+    std::sort(dirtyNodes.begin(), dirtyNodes.end());
+    dirtyRoots.clear();
+    size_t updatedCount = 0;
+    uint32_t coveredEnd = 0;
+    for (uint32_t node : dirtyNodes) {
+        if (node >= coveredEnd) {
+            dirtyRoots.push_back(node);
+            coveredEnd = subtreeEnds[node];
+            updatedCount += coveredEnd - node;
+        }
+    }
+    dirtyNodes.clear();
+    updatedRoots = dirtyRoots;
+    if (updatedCount < ParallelNodeCount) {
+        for (uint32_t root : dirtyRoots) {
+            updateSubtree(root);
+        }
+        return updatedCount;
+    }
+
+    // Split subtrees too large to balance across threads: update their roots here, and update their children's
+    // subtrees, which are independent of one another, in parallel
+    const size_t workerCount = ParallelWorkerCount();
+    const size_t largestSubtree = std::max(updatedCount / (4 * workerCount), MinimumSubtreeSize);
+    pendingRoots.swap(dirtyRoots);
+    dirtyRoots.clear();
+    while (!pendingRoots.empty()) {
+        const uint32_t root = pendingRoots.back();
+        pendingRoots.pop_back();
+        if (subtreeEnds[root] - root <= largestSubtree) {
+            dirtyRoots.push_back(root);
+            continue;
+        }
+        updateNode(root);
+        for (uint32_t child = root + 1; child < subtreeEnds[root]; child = subtreeEnds[child]) {
+            pendingRoots.push_back(child);
+        }
+    }
+    const size_t grainSize = std::max<size_t>(dirtyRoots.size() / (4 * workerCount), 1);
+    ParallelFor(dirtyRoots.size(), grainSize, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            updateSubtree(dirtyRoots[r]);
+        }
+    });
+    return updatedCount;
+}
+
+} // namespace GLTF
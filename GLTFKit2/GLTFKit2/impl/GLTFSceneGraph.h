@@ -0,0 +1,76 @@
+
+#pragma once
+
+#include "GLTFAnimationSampling.h"
+#include "GLTFSkinPalettes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GLTF {
+
+/// The nodes of a scene flattened into arrays in depth-first order, so that every node follows its parent and the
+/// nodes of each subtree are contiguous. Local transforms are kept both as translation, rotation and scale and as
+/// matrices. Changing a node's local transform marks it dirty, and updating recomposes the world transforms of
+/// dirty subtrees only, in parallel across independent subtrees.
+class SceneGraph {
+public:
+    /// Prepares `nodeCount` nodes whose parents are given by `parents` (-1 for a root), with identity transforms.
+    /// Returns false, leaving the graph empty, unless the nodes are in depth-first order: each node's parent must be
+    /// the node before it or one of that node's ancestors.
+    bool build(const int32_t *parents, size_t nodeCount);
+
+    size_t nodeCount() const { return parents.size(); }
+    const int32_t *parentIndices() const { return parents.data(); }
+    /// The index after the last node of the subtree at `node`
+    uint32_t subtreeEnd(size_t node) const { return subtreeEnds[node]; }
+
+    const float *translations() const { return nodeTranslations.data(); } // 3 floats per node
+    const float *rotations() const { return nodeRotations.data(); }       // 4 floats per node, xyzw
+    const float *scales() const { return nodeScales.data(); }             // 3 floats per node
+    const Matrix4x4 *localTransforms() const { return locals.data(); }
+    /// Up to date for every node that has not been marked dirty since the last update
+    const Matrix4x4 *worldTransforms() const { return worlds.data(); }
+    bool isDirty(size_t node) const { return flags[node] != 0; }
+
+    /// Sets the node's translation, rotation and scale, from which its local matrix is composed when the graph is
+    /// updated. The node is only marked dirty if they change.
+    void setTransform(size_t node, const float *translation, const float *rotation, const float *scale);
+    /// Sets the node's local matrix directly, leaving its translation, rotation and scale as they were.
+    void setLocalTransform(size_t node, const Matrix4x4 &transform);
+    /// Copies the translation, rotation and scale of `poseNodes[i]` in `pose` to each node i, marking those that
+    /// change. Returns false, changing nothing, if `pose` has too few nodes for an index in `poseNodes`.
+    bool applyPose(const AnimationPose &pose, const uint32_t *poseNodes);
+
+    /// Recomposes the local matrices of nodes whose translation, rotation or scale changed, then the world
+    /// transforms of every dirty node and its descendants, and returns the number of world transforms updated.
+    size_t updateWorldTransforms();
+    /// The topmost nodes that were dirty at the last update, in increasing order; the subtrees at them hold every
+    /// world transform that the update changed.
+    const std::vector<uint32_t> &lastUpdatedRoots() const { return updatedRoots; }
+
+private:
+    enum : uint8_t {
+        LocalTransformChanged = 1, // Compose the local matrix from translation, rotation and scale
+        WorldTransformChanged = 2,
+    };
+
+    void markDirty(size_t node, uint8_t changes);
+    void updateNode(size_t node);
+    void updateSubtree(size_t node);
+
+    std::vector<int32_t> parents;
+    std::vector<uint32_t> subtreeEnds;
+    std::vector<float> nodeTranslations;
+    std::vector<float> nodeRotations;
+    std::vector<float> nodeScales;
+    std::vector<Matrix4x4> locals;
+    std::vector<Matrix4x4> worlds;
+    std::vector<uint8_t> flags;
+    std::vector<uint32_t> dirtyNodes;   // Each node marked dirty since the last update, once
+    std::vector<uint32_t> updatedRoots;
+    std::vector<uint32_t> dirtyRoots;   // Scratch for updates
+    std::vector<uint32_t> pendingRoots;
+};
+
+} // namespace GLTF
@@ -0,0 +1,481 @@
+
+#include "GLTFSimplification.h"
+#include "GLTFVectorMath.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace GLTF {
+
+namespace {
+
+// The weight of the normal deviation penalty relative to the geometric error of a collapse
+const float NormalDeviationWeight = 1.0f;
+
+// The weight of the texture coordinate error of a collapse relative to its geometric error
+const float TexCoordDeviationWeight = 1.0f;
+
+// A level is only recorded if it has at most this fraction of the indices of the previous level
+const float MinimumLevelReduction = 0.9f;
+
+// The area-weighted sum of the squared-distance quadrics of the planes around a vertex
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+    double weight = 0;
+
+    static Quadric fromPlane(Vec3 n, double d, double weight) {
+        Quadric q;
+        q.a2 = weight * n.x * n.x; q.ab = weight * n.x * n.y; q.ac = weight * n.x * n.z; q.ad = weight * n.x * d;
+        q.b2 = weight * n.y * n.y; q.bc = weight * n.y * n.z; q.bd = weight * n.y * d;
+        q.c2 = weight * n.z * n.z; q.cd = weight * n.z * d;
+        q.d2 = weight * d * d;
+        q.weight = weight;
+        return q;
+    }
+
+    Quadric &operator+=(const Quadric &o) {
+        a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad; b2 += o.b2;
+        bc += o.bc; bd += o.bd; c2 += o.c2; cd += o.cd; d2 += o.d2;
+        weight += o.weight;
+        return *this;
+    }
+
+    // The weighted sum of squared distances from `p` to the planes
+    double evaluate(Vec3 p) const {
+        const double x = p.x, y = p.y, z = p.z;
+        return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+               b2 * y * y + 2 * bc * y * z + 2 * bd * y +
+               c2 * z * z + 2 * cd * z + d2;
+    }
+};
+
+// The area-weighted sum of the squared errors of the linear texture coordinate functions of the triangles around
+// a vertex, as a quadratic form over (x, y, z, u, v). Each triangle contributes the squared difference between the
+// texture coordinates a point would have in the triangle's plane and the texture coordinates it is given.
+struct TexCoordQuadric {
+    static const int Dimension = 5;
+    double a[Dimension][Dimension] = {};
+    double b[Dimension] = {};
+    double c = 0;
+    double weight = 0;
+
+    // Adds the squared linear form `l . x + d`
+    void addSquare(const double *l, double d, double w) {
+        for (int i = 0; i < Dimension; ++i) {
+            for (int j = 0; j < Dimension; ++j) {
+                a[i][j] += w * l[i] * l[j];
+            }
+            b[i] += w * d * l[i];
+        }
+        c += w * d * d;
+    }
+
+    TexCoordQuadric &operator+=(const TexCoordQuadric &o) {
+        for (int i = 0; i < Dimension; ++i) {
+            for (int j = 0; j < Dimension; ++j) {
+                a[i][j] += o.a[i][j];
+            }
+            b[i] += o.b[i];
+        }
+        c += o.c;
+        weight += o.weight;
+        return *this;
+    }
+
+    double evaluate(Vec3 p, const float *uv) const {
+        const double x[Dimension] = { p.x, p.y, p.z, uv[0], uv[1] };
+        double sum = c;
+        for (int i = 0; i < Dimension; ++i) {
+            double row = 2 * b[i];
+            for (int j = 0; j < Dimension; ++j) {
+                row += a[i][j] * x[j];
+            }
+            sum += row * x[i];
+        }
+        return sum;
+    }
+};
+
+struct PositionKey {
+    uint32_t bits[3];
+
+    bool operator==(const PositionKey &other) const {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey &key) const {
+        return (key.bits[0] * 73856093u) ^ (key.bits[1] * 19349663u) ^ (key.bits[2] * 83492791u);
+    }
+};
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    float cost;
+};
+
+class Simplifier {
+public:
+    Simplifier(const AccessorView &positionView, const AccessorView &normalView, const AccessorView &texCoordView,
+               const uint32_t *sourceIndices, size_t sourceIndexCount)
+        : indices(sourceIndices, sourceIndices + sourceIndexCount)
+    {
+        points = ReadVec3s(positionView);
+        normalizePositions();
+        vertexCount = points.size();
+        if (normalView.isValid() && normalView.count == vertexCount && normalView.componentCount >= 3) {
+            normals = ReadVec3s(normalView);
+        }
+        if (texCoordView.isValid() && texCoordView.count == vertexCount && texCoordView.componentCount >= 2) {
+            texCoords.resize(2 * vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v) {
+                ReadFloats(texCoordView, v, &texCoords[2 * v], 2);
+            }
+        }
+        weldPositions();
+        lockBordersAndSeams();
+        computeQuadrics();
+    }
+
+    // Collapses edges until at most `targetIndexCount` indices remain or no collapse within `maxCost` is possible.
+    // Returns the greatest cost of the collapses performed.
+    float simplify(size_t targetIndexCount, float maxCost) {
+        float greatestCost = 0.0f;
+        while (indices.size() > targetIndexCount) {
+            float passCost = 0.0f;
+            if (!collapsePass(targetIndexCount, maxCost, passCost)) {
+                break;
+            }
+            greatestCost = std::max(greatestCost, passCost);
+        }
+        return greatestCost;
+    }
+
+    const std::vector<uint32_t> &currentIndices() const {
+        return indices;
+    }
+
+private:
+    std::vector<uint32_t> indices;
+    std::vector<Vec3> points;
+    std::vector<Vec3> normals;
+    std::vector<float> texCoords;
+    size_t vertexCount = 0;
+    std::vector<uint32_t> canonical; // The first vertex sharing the position of each vertex
+    std::vector<bool> locked;
+    std::vector<Quadric> quadrics;   // Indexed by canonical vertex
+    std::vector<TexCoordQuadric> texCoordQuadrics; // Indexed by vertex, since vertices on seams differ in UV
+
+    // Scale positions into the unit cube, so that costs are relative to the extent of the mesh
+    void normalizePositions() {
+        if (points.empty()) {
+            return;
+        }
+        Vec3 lo = points[0], hi = points[0];
+        for (const Vec3 &p : points) {
+            lo = Min(lo, p);
+            hi = Max(hi, p);
+        }
+        const float extent = std::max(std::max(hi.x - lo.x, hi.y - lo.y), hi.z - lo.z);
+        const float scale = (extent > 0.0f) ? 1.0f / extent : 1.0f;
+        for (Vec3 &p : points) {
+            p = (p - lo) * scale;
+        }
+    }
+
+    void weldPositions() {
+        canonical.resize(vertexCount);
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> firstVertexForPosition;
+        firstVertexForPosition.reserve(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            PositionKey key;
+            const float components[3] = { points[v].x + 0.0f, points[v].y + 0.0f, points[v].z + 0.0f }; // -0 to 0
+            memcpy(key.bits, components, sizeof(key.bits));
+            canonical[v] = firstVertexForPosition.insert(std::make_pair(key, static_cast<uint32_t>(v))).first->second;
+        }
+    }
+
+    void lockBordersAndSeams() {
+        locked.assign(vertexCount, false);
+
+        // Vertices whose position is shared by another vertex lie on an attribute seam
+        std::vector<uint32_t> positionUseCount(vertexCount, 0);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            ++positionUseCount[canonical[v]];
+        }
+
+        // Edges between positions that are not shared by exactly two triangles are on a border (or non-manifold)
+        std::vector<uint64_t> edges;
+        edges.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                const uint64_t a = canonical[indices[i + k]], b = canonical[indices[i + (k + 1) % 3]];
+                edges.push_back((std::min(a, b) << 32) | std::max(a, b));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        std::vector<bool> lockedPositions(vertexCount, false);
+        for (size_t i = 0; i < edges.size();) {
+            size_t j = i + 1;
+            while (j < edges.size() && edges[j] == edges[i]) {
+                ++j;
+            }
+            if (j - i != 2) {
+                lockedPositions[edges[i] >> 32] = true;
+                lockedPositions[edges[i] & 0xFFFFFFFFu] = true;
+            }
+            i = j;
+        }
+        for (size_t v = 0; v < vertexCount; ++v) {
+            locked[v] = lockedPositions[canonical[v]] || positionUseCount[canonical[v]] > 1;
+        }
+    }
+
+    void computeQuadrics() {
+        quadrics.assign(vertexCount, Quadric());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const Vec3 a = points[indices[i]], b = points[indices[i + 1]], c = points[indices[i + 2]];
+            const Vec3 cross = Cross(b - a, c - a);
+            const float length = Length(cross);
+            if (length == 0.0f) {
+                continue;
+            }
+            const Vec3 n = cross * (1.0f / length);
+            const Quadric q = Quadric::fromPlane(n, -Dot(n, a), 0.5 * length);
+            for (int k = 0; k < 3; ++k) {
+                quadrics[canonical[indices[i + k]]] += q;
+            }
+        }
+        if (!texCoords.empty()) {
+            computeTexCoordQuadrics();
+        }
+    }
+
+    void computeTexCoordQuadrics() {
+        texCoordQuadrics.assign(vertexCount, TexCoordQuadric());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const uint32_t v0 = indices[i], v1 = indices[i + 1], v2 = indices[i + 2];
+            const Vec3 p0 = points[v0], e1 = points[v1] - p0, e2 = points[v2] - p0;
+            const double e11 = Dot(e1, e1), e12 = Dot(e1, e2), e22 = Dot(e2, e2);
+            const double det = e11 * e22 - e12 * e12; // The squared length of the cross product
+            if (!(det > 0.0)) {
+                continue;
+            }
+            const double area = 0.5 * std::sqrt(det);
+            TexCoordQuadric q;
+            for (int component = 0; component < 2; ++component) {
+                // The gradient g in the plane of the triangle with g . e1 = ds1 and g . e2 = ds2
+                const double s0 = texCoords[2 * v0 + component];
+                const double ds1 = texCoords[2 * v1 + component] - s0, ds2 = texCoords[2 * v2 + component] - s0;
+                const double alpha = (ds1 * e22 - ds2 * e12) / det, beta = (ds2 * e11 - ds1 * e12) / det;
+                double l[TexCoordQuadric::Dimension] = {
+                    alpha * e1.x + beta * e2.x, alpha * e1.y + beta * e2.y, alpha * e1.z + beta * e2.z, 0, 0
+                };
+                l[3 + component] = -1;
+                const double d = s0 - (l[0] * p0.x + l[1] * p0.y + l[2] * p0.z);
+                q.addSquare(l, d, area);
+            }
+            q.weight = area;
+            texCoordQuadrics[v0] += q;
+            texCoordQuadrics[v1] += q;
+            texCoordQuadrics[v2] += q;
+        }
+    }
+
+    float collapseCost(uint32_t from, uint32_t to) const {
+        Quadric q = quadrics[canonical[from]];
+        q += quadrics[canonical[to]];
+        const Vec3 p = points[to];
+        double cost = (q.weight > 0.0) ? std::max(q.evaluate(p), 0.0) / q.weight : 0.0;
+        if (!normals.empty()) {
+            const Vec3 delta = points[from] - p;
+            const float deviation = 1.0f - Dot(Normalize(normals[from], normals[from]), Normalize(normals[to], normals[to]));
+            cost += NormalDeviationWeight * std::max(deviation, 0.0f) * Dot(delta, delta);
+        }
+        if (!texCoordQuadrics.empty()) {
+            TexCoordQuadric t = texCoordQuadrics[from];
+            t += texCoordQuadrics[to];
+            if (t.weight > 0.0) {
+                cost += TexCoordDeviationWeight * std::max(t.evaluate(p, &texCoords[2 * to]), 0.0) / t.weight;
+            }
+        }
+        return static_cast<float>(cost);
+    }
+
+    static float signedTexCoordArea(const float *a, const float *b, const float *c) {
+        return (b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]);
+    }
+
+    // Returns true if moving `from` onto `to` would flip a triangle around `from`, in space or in texture space
+    bool collapseFlips(uint32_t from, uint32_t to, const std::vector<uint32_t> &firstTriangle,
+                       const std::vector<uint32_t> &triangles) const
+    {
+        for (uint32_t i = firstTriangle[from]; i < firstTriangle[from + 1]; ++i) {
+            const uint32_t *t = &indices[3 * triangles[i]];
+            if (t[0] == to || t[1] == to || t[2] == to) {
+                continue; // This triangle collapses
+            }
+            uint32_t moved[3] = { t[0], t[1], t[2] };
+            for (int k = 0; k < 3; ++k) {
+                if (moved[k] == from) {
+                    moved[k] = to;
+                }
+            }
+            const Vec3 before = Cross(points[t[1]] - points[t[0]], points[t[2]] - points[t[0]]);
+            const Vec3 after = Cross(points[moved[1]] - points[moved[0]], points[moved[2]] - points[moved[0]]);
+            if (Dot(before, after) <= 0.0f) {
+                return true;
+            }
+            if (!texCoords.empty()) {
+                const float areaBefore = signedTexCoordArea(&texCoords[2 * t[0]], &texCoords[2 * t[1]], &texCoords[2 * t[2]]);
+                const float areaAfter = signedTexCoordArea(&texCoords[2 * moved[0]], &texCoords[2 * moved[1]],
+                                                           &texCoords[2 * moved[2]]);
+                if (areaBefore * areaAfter < 0.0f) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Performs a set of independent collapses, cheapest first. Returns false if no collapse was possible.
+    bool collapsePass(size_t targetIndexCount, float maxCost, float &outGreatestCost) {
+        const size_t triangleCount = indices.size() / 3;
+
+        // Triangles incident to each vertex, in compressed sparse row form
+        std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+        for (uint32_t v : indices) {
+            ++firstTriangle[v + 1];
+        }
+        for (size_t v = 0; v < vertexCount; ++v) {
+            firstTriangle[v + 1] += firstTriangle[v];
+        }
+        std::vector<uint32_t> triangles(indices.size());
+        std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // The cheapest collapse of each unlocked vertex onto one of its neighbors
+        const uint32_t None = UINT32_MAX;
+        std::vector<Collapse> best(vertexCount, Collapse { None, None, std::numeric_limits<float>::infinity() });
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t from = indices[i + k];
+                if (locked[from]) {
+                    continue;
+                }
+                for (int j = 1; j < 3; ++j) {
+                    const uint32_t to = indices[i + (k + j) % 3];
+                    const float cost = collapseCost(from, to);
+                    Collapse &candidate = best[from];
+                    if (cost < candidate.cost || (cost == candidate.cost && to < candidate.to)) {
+                        candidate.from = from;
+                        candidate.to = to;
+                        candidate.cost = cost;
+                    }
+                }
+            }
+        }
+        std::vector<Collapse> collapses;
+        for (const Collapse &collapse : best) {
+            if (collapse.from != None && collapse.cost <= maxCost) {
+                collapses.push_back(collapse);
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse &lhs, const Collapse &rhs) {
+            return (lhs.cost < rhs.cost) || (lhs.cost == rhs.cost && lhs.from < rhs.from);
+        });
+
+        // Collapse vertices whose neighborhoods are untouched so far in this pass, so that each flip test sees
+        // the geometry that will result
+        std::vector<uint32_t> remap(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            remap[v] = static_cast<uint32_t>(v);
+        }
+        std::vector<bool> touched(vertexCount, false);
+        const size_t targetTriangleCount = targetIndexCount / 3;
+        size_t remainingTriangles = triangleCount;
+        size_t collapseCount = 0;
+        for (const Collapse &collapse : collapses) {
+            if (remainingTriangles <= targetTriangleCount) {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to] ||
+                collapseFlips(collapse.from, collapse.to, firstTriangle, triangles))
+            {
+                continue;
+            }
+            remap[collapse.from] = collapse.to;
+            quadrics[canonical[collapse.to]] += quadrics[canonical[collapse.from]];
+            if (!texCoordQuadrics.empty()) {
+                texCoordQuadrics[collapse.to] += texCoordQuadrics[collapse.from];
+            }
+            for (uint32_t i = firstTriangle[collapse.from]; i < firstTriangle[collapse.from + 1]; ++i) {
+                const uint32_t *t = &indices[3 * triangles[i]];
+                touched[t[0]] = touched[t[1]] = touched[t[2]] = true;
+                if (t[0] == collapse.to || t[1] == collapse.to || t[2] == collapse.to) {
+                    --remainingTriangles;
+                }
+            }
+            outGreatestCost = std::max(outGreatestCost, collapse.cost);
+            ++collapseCount;
+        }
+        if (collapseCount == 0) {
+            return false;
+        }
+
+        size_t out = 0;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const uint32_t a = remap[indices[i]], b = remap[indices[i + 1]], c = remap[indices[i + 2]];
+            if (a != b && b != c && c != a) {
+                indices[out++] = a;
+                indices[out++] = b;
+                indices[out++] = c;
+            }
+        }
+        indices.resize(out);
+        return true;
+    }
+};
+
+} // namespace
+
+std::vector<SimplifiedLevel> SimplifyToLevels(const AccessorView &positions, const AccessorView &normals,
+                                              const AccessorView &texCoords, const uint32_t *indices,
+                                              size_t indexCount, const std::vector<size_t> &targetIndexCounts,
+                                              float targetError)
+{
+    std::vector<SimplifiedLevel> levels;
+    if (!positions.isValid() || positions.componentCount < 3) {
+        return levels;
+    }
+    indexCount -= indexCount % 3;
+    for (size_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= positions.count) {
+            return levels;
+        }
+    }
+    Simplifier simplifier(positions, normals, texCoords, indices, indexCount);
+    const float maxCost = targetError * targetError;
+    size_t previousIndexCount = indexCount;
+    float error = 0.0f;
+    for (size_t target : targetIndexCounts) {
+        error = std::max(error, simplifier.simplify(target, maxCost));
+        const std::vector<uint32_t> &simplified = simplifier.currentIndices();
+        if (static_cast<float>(simplified.size()) > MinimumLevelReduction * static_cast<float>(previousIndexCount)) {
+            break;
+        }
+        SimplifiedLevel level;
+        level.indices = simplified;
+        level.error = std::sqrt(error);
+        levels.push_back(level);
+        previousIndexCount = simplified.size();
+    }
+    return levels;
+}
+
+} // namespace GLTF
@@ -0,0 +1,29 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+struct SimplifiedLevel {
+    std::vector<uint32_t> indices; // A triangle list over the input vertices
+    float error = 0.0f;            // The greatest deviation introduced, relative to the extent of the mesh
+};
+
+/// Simplifies the triangle list `indices` over `positions` by quadric-error edge collapse (Garland and Heckbert),
+/// recording a level each time the index count reaches the next of `targetIndexCounts`, which must be decreasing.
+/// Collapses move a vertex onto one of its neighbors, so every level indexes the input vertices. Vertices on open
+/// borders and on attribute seams (where vertices share a position) are locked. If `normals` is valid, collapses
+/// are penalized by the angle between the normals they merge. If `texCoords` is valid, collapses are also charged
+/// the texture coordinate error they introduce, by attribute quadrics over position and UV, and collapses that flip
+/// a triangle in texture space are rejected. No collapse introduces more than `targetError` of combined error,
+/// relative to the extent of the mesh, so fewer levels than requested may be produced. Collapses are ordered by cost with ties
+/// broken by vertex index, so the result is deterministic.
+std::vector<SimplifiedLevel> SimplifyToLevels(const AccessorView &positions, const AccessorView &normals,
+                                              const AccessorView &texCoords, const uint32_t *indices,
+                                              size_t indexCount, const std::vector<size_t> &targetIndexCounts,
+                                              float targetError);
+
+} // namespace GLTF
@@ -0,0 +1,211 @@
+
+#include "GLTFSkinPalettes.h"
+#include "GLTFParallel.h"
+
+#include <cstring>
+
+namespace GLTF {
+
+namespace {
+
+// Nodes per unit of parallel work when composing a level of the hierarchy
+const size_t NodeGrainSize = 256;
+
+typedef float Float4 __attribute__((vector_size(16)));
+
+inline Float4 load4(const float *p) {
+    Float4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void store4(float *p, Float4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+// Returns a * b, column by column: each column of the product is a's columns weighted by a column of b.
+inline void multiply(const Matrix4x4 &a, const Matrix4x4 &b, Matrix4x4 &result) {
+    const Float4 a0 = load4(a.columns[0]), a1 = load4(a.columns[1]);
+    const Float4 a2 = load4(a.columns[2]), a3 = load4(a.columns[3]);
+    for (int j = 0; j < 4; ++j) {
+        const float *column = b.columns[j];
+        store4(result.columns[j], a0 * column[0] + a1 * column[1] + a2 * column[2] + a3 * column[3]);
+    }
+}
+
+// Composes translation * rotation * scale for node `node` of `pose`.
+void localTransform(const AnimationPose &pose, uint32_t node, Matrix4x4 &result) {
+    const float *t = &pose.translations[3 * node];
+    const float *q = &pose.rotations[4 * node];
+    const float *s = &pose.scales[3 * node];
+    const float x = q[0], y = q[1], z = q[2], w = q[3];
+    const float columns[4][4] = {
+        { (1.0f - 2.0f * (y * y + z * z)) * s[0], 2.0f * (x * y + z * w) * s[0], 2.0f * (x * z - y * w) * s[0], 0.0f },
+        { 2.0f * (x * y - z * w) * s[1], (1.0f - 2.0f * (x * x + z * z)) * s[1], 2.0f * (y * z + x * w) * s[1], 0.0f },
+        { 2.0f * (x * z + y * w) * s[2], 2.0f * (y * z - x * w) * s[2], (1.0f - 2.0f * (x * x + y * y)) * s[2], 0.0f },
+        { t[0], t[1], t[2], 1.0f },
+    };
+    memcpy(result.columns, columns, sizeof(columns));
+}
+
+void writeJointMatrix(const Matrix4x4 &m, int format, float *destination) {
+    if (format == SkinPaletteFormat3x4) {
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                destination[4 * row + column] = m.columns[column][row];
+            }
+        }
+    } else {
+        memcpy(destination, m.columns, sizeof(m.columns));
+    }
+}
+
+} // namespace
+
+bool SkinPaletteSet::build(const int32_t *parents, size_t nodeCount, const std::vector<SkinDescription> &skins) {
+    *this = SkinPaletteSet();
+    for (size_t i = 0; i < nodeCount; ++i) {
+        if (parents[i] < -1 || parents[i] >= static_cast<int64_t>(nodeCount) || parents[i] == static_cast<int64_t>(i)) {
+            return false;
+        }
+    }
+    for (const SkinDescription &skin : skins) {
+        if (!skin.inverseBindMatrices.empty() && skin.inverseBindMatrices.size() != 16 * skin.joints.size()) {
+            return false;
+        }
+        for (uint32_t joint : skin.joints) {
+            if (joint >= nodeCount) {
+                return false;
+            }
+        }
+    }
+
+    // Find the depth of every joint and ancestor of a joint, walking up until a node of known depth
+    const int32_t Unknown = -1;
+    std::vector<int32_t> depths(nodeCount, Unknown);
+    std::vector<uint32_t> path;
+    for (const SkinDescription &skin : skins) {
+        for (uint32_t joint : skin.joints) {
+            path.clear();
+            int32_t node = static_cast<int32_t>(joint);
+            while (node >= 0 && depths[node] == Unknown) {
+                if (path.size() > nodeCount) {
+                    return false; // A cycle
+                }
+                path.push_back(static_cast<uint32_t>(node));
+                node = parents[node];
+            }
+            int32_t depth = (node >= 0) ? depths[node] : -1;
+            for (size_t p = path.size(); p-- > 0;) {
+                depths[path[p]] = ++depth;
+            }
+        }
+    }
+
+    // Order the evaluated nodes by depth, so that each level depends only on those before it
+    int32_t maxDepth = -1;
+    for (int32_t depth : depths) {
+        maxDepth = std::max(maxDepth, depth);
+    }
+    std::vector<uint32_t> levelCounts(size_t(maxDepth + 1), 0);
+    for (int32_t depth : depths) {
+        if (depth != Unknown) {
+            levelCounts[size_t(depth)] += 1;
+        }
+    }
+    levelStarts.assign(1, 0);
+    for (uint32_t count : levelCounts) {
+        levelStarts.push_back(levelStarts.back() + count);
+    }
+    std::vector<uint32_t> nextSlot(levelStarts.begin(), levelStarts.end() - 1);
+    std::vector<int32_t> slotForNode(nodeCount, -1);
+    slotNodes.resize(levelStarts.back());
+    for (size_t i = 0; i < nodeCount; ++i) {
+        if (depths[i] != Unknown) {
+            const uint32_t slot = nextSlot[size_t(depths[i])]++;
+            slotNodes[slot] = static_cast<uint32_t>(i);
+            slotForNode[i] = static_cast<int32_t>(slot);
+        }
+    }
+    slotParents.resize(slotNodes.size());
+    for (size_t slot = 0; slot < slotNodes.size(); ++slot) {
+        const int32_t parent = parents[slotNodes[slot]];
+        slotParents[slot] = (parent >= 0) ? slotForNode[size_t(parent)] : -1;
+    }
+
+    for (const SkinDescription &skin : skins) {
+        for (size_t j = 0; j < skin.joints.size(); ++j) {
+            jointSlots.push_back(static_cast<uint32_t>(slotForNode[skin.joints[j]]));
+            Matrix4x4 inverseBindMatrix = { { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } };
+            if (!skin.inverseBindMatrices.empty()) {
+                memcpy(inverseBindMatrix.columns, &skin.inverseBindMatrices[16 * j], sizeof(inverseBindMatrix.columns));
+            }
+            inverseBindMatrices.push_back(inverseBindMatrix);
+        }
+        skinFirstJoints.push_back(static_cast<uint32_t>(jointSlots.size()));
+    }
+    hierarchyNodeCount = nodeCount;
+    return true;
+}
+
+bool SkinPaletteSet::computePalettes(const AnimationPose &pose, int format, float *palettes,
+                                     std::vector<Matrix4x4> &worldTransforms) const
+{
+    if (pose.translations.size() < 3 * hierarchyNodeCount || pose.rotations.size() < 4 * hierarchyNodeCount ||
+        pose.scales.size() < 3 * hierarchyNodeCount)
+    {
+        return false;
+    }
+    worldTransforms.resize(slotNodes.size());
+    Matrix4x4 *world = worldTransforms.data();
+    for (size_t level = 0; level + 1 < levelStarts.size(); ++level) {
+        const uint32_t levelStart = levelStarts[level];
+        ParallelFor(levelStarts[level + 1] - levelStart, NodeGrainSize, [&](size_t begin, size_t end) {
+            for (size_t slot = levelStart + begin; slot < levelStart + end; ++slot) {
+                if (slotParents[slot] < 0) {
+                    localTransform(pose, slotNodes[slot], world[slot]);
+                } else {
+                    Matrix4x4 local;
+                    localTransform(pose, slotNodes[slot], local);
+                    multiply(world[slotParents[slot]], local, world[slot]);
+                }
+            }
+        });
+    }
+
+    const size_t floatsPerJoint = FloatsPerJoint(format);
+    ParallelFor(skinCount(), 1, [&](size_t begin, size_t end) {
+        for (size_t skin = begin; skin < end; ++skin) {
+            for (uint32_t joint = skinFirstJoints[skin]; joint < skinFirstJoints[skin + 1]; ++joint) {
+                Matrix4x4 jointMatrix;
+                multiply(world[jointSlots[joint]], inverseBindMatrices[joint], jointMatrix);
+                writeJointMatrix(jointMatrix, format, palettes + joint * floatsPerJoint);
+            }
+        }
+    });
+    return true;
+}
+
+bool SkinPaletteSet::computePalettes(const Matrix4x4 *worldTransforms, const int32_t *worldIndices, int format,
+                                     float *palettes) const
+{
+    for (uint32_t slot : jointSlots) {
+        if (worldIndices[slotNodes[slot]] < 0) {
+            return false;
+        }
+    }
+    const size_t floatsPerJoint = FloatsPerJoint(format);
+    ParallelFor(skinCount(), 1, [&](size_t begin, size_t end) {
+        for (size_t skin = begin; skin < end; ++skin) {
+            for (uint32_t joint = skinFirstJoints[skin]; joint < skinFirstJoints[skin + 1]; ++joint) {
+                const Matrix4x4 &world = worldTransforms[worldIndices[slotNodes[jointSlots[joint]]]];
+                Matrix4x4 jointMatrix;
+                multiply(world, inverseBindMatrices[joint], jointMatrix);
+                writeJointMatrix(jointMatrix, format, palettes + joint * floatsPerJoint);
+            }
+        }
+    });
+    return true;
+}
+
+} // namespace GLTF
@@ -0,0 +1,68 @@
+
+#pragma once
+
+#include "GLTFAnimationSampling.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GLTF {
+
+enum SkinPaletteFormat : int {
+    SkinPaletteFormat4x4, // 16 floats per joint, column-major
+    SkinPaletteFormat3x4, // 12 floats per joint: the first three rows of the affine transform, each of four floats
+};
+
+/// A column-major 4x4 matrix, aligned for loading its columns as SIMD vectors.
+struct alignas(16) Matrix4x4 {
+    float columns[4][4];
+};
+
+struct SkinDescription {
+    std::vector<uint32_t> joints;            // Node indices
+    std::vector<float> inverseBindMatrices;  // 16 floats per joint, column-major, or empty for identities
+};
+
+/// The joints and inverse bind matrices of every skin of an asset, prepared for computing the skinning matrices of
+/// all of them at once. Only the nodes that are joints, or ancestors of joints, are evaluated; they are ordered by
+/// depth so that each level of the hierarchy is composed in parallel.
+class SkinPaletteSet {
+public:
+    static size_t FloatsPerJoint(int format) { return (format == SkinPaletteFormat3x4) ? 12 : 16; }
+
+    /// Prepares `skins`, whose joints are indices into the `nodeCount` nodes whose parents are given by `parents`
+    /// (-1 for a root). Returns false, leaving the set empty, if a joint is out of range, a skin's inverse bind
+    /// matrices do not match its joints, or the parents do not form a forest.
+    bool build(const int32_t *parents, size_t nodeCount, const std::vector<SkinDescription> &skins);
+
+    size_t nodeCount() const { return hierarchyNodeCount; }
+    size_t skinCount() const { return skinFirstJoints.size() - 1; }
+    /// The joints of all skins
+    size_t jointCount() const { return jointSlots.size(); }
+    uint32_t firstJoint(size_t skin) const { return skinFirstJoints[skin]; }
+    uint32_t jointCount(size_t skin) const { return skinFirstJoints[skin + 1] - skinFirstJoints[skin]; }
+
+    /// Composes the world transforms of the joints from the local transforms in `pose`, then writes each skin's
+    /// skinning matrices (a joint's world transform times its inverse bind matrix) to `palettes`, starting at
+    /// `firstJoint(skin) * FloatsPerJoint(format)`, with skins processed in parallel. `worldTransforms` is scratch
+    /// storage, reused between calls to avoid allocation. Returns false, writing nothing, if `pose` has too few nodes.
+    bool computePalettes(const AnimationPose &pose, int format, float *palettes,
+                         std::vector<Matrix4x4> &worldTransforms) const;
+
+    /// Writes each skin's skinning matrices to `palettes` as above, taking the world transform of node i from
+    /// `worldTransforms[worldIndices[i]]`, as a SceneGraph keeps them, instead of composing them from a pose.
+    /// Returns false, writing nothing, if a joint has no world transform (a world index of -1).
+    bool computePalettes(const Matrix4x4 *worldTransforms, const int32_t *worldIndices, int format,
+                         float *palettes) const;
+
+private:
+    size_t hierarchyNodeCount = 0;
+    std::vector<uint32_t> slotNodes;      // The node evaluated in each slot, parents before children
+    std::vector<int32_t> slotParents;     // The slot of each slot's parent, or -1
+    std::vector<uint32_t> levelStarts;    // The first slot of each depth, then the slot count
+    std::vector<uint32_t> jointSlots;     // The slot of each joint of every skin
+    std::vector<Matrix4x4> inverseBindMatrices;
+    std::vector<uint32_t> skinFirstJoints = std::vector<uint32_t>(1, 0);
+};
+
+} // namespace GLTF
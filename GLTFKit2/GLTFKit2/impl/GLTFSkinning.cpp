@@ -0,0 +1,324 @@
+
+#include "GLTFSkinning.h"
+#include "GLTFParallel.h"
+#include "GLTFSkinPalettes.h"
+
+#include <atomic>
+
+namespace GLTF {
+
+namespace {
+
+// Vertices per unit of parallel work
+const size_t VertexGrainSize = 1024;
+
+typedef float Float4 __attribute__((vector_size(16)));
+
+inline Float4 splat(float f) {
+    Float4 v = { f, f, f, f };
+    return v;
+}
+
+inline Float4 make4(float x, float y, float z, float w) {
+    Float4 v = { x, y, z, w };
+    return v;
+}
+
+inline float dot3(Float4 a, Float4 b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline Float4 cross3(Float4 a, Float4 b) {
+    return make4(a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0], 0.0f);
+}
+
+inline Float4 normalize3(Float4 v) {
+    const float lengthSquared = dot3(v, v);
+    return (lengthSquared > 0.0f) ? v * (1.0f / std::sqrt(lengthSquared)) : v;
+}
+
+// The upper 3x3 of a matrix, applied to the direction d
+inline Float4 transformDirection(const Float4 *columns, Float4 d) {
+    return columns[0] * d[0] + columns[1] * d[1] + columns[2] * d[2];
+}
+
+// Applies the inverse transpose of the 3x3 matrix with the given columns to the normal n, up to scale, by way of
+// its cofactor matrix, whose columns are the cross products of the matrix's columns; the sign of the determinant
+// keeps the normal facing the same way under reflection.
+inline Float4 transformNormal(const Float4 *columns, Float4 n) {
+    const Float4 c12 = cross3(columns[1], columns[2]);
+    const Float4 c20 = cross3(columns[2], columns[0]);
+    const Float4 c01 = cross3(columns[0], columns[1]);
+    const float sign = (dot3(columns[0], c12) < 0.0f) ? -1.0f : 1.0f;
+    return normalize3((c12 * n[0] + c20 * n[1] + c01 * n[2]) * sign);
+}
+
+inline float determinantSign(const Float4 *columns) {
+    return (dot3(columns[0], cross3(columns[1], columns[2])) < 0.0f) ? -1.0f : 1.0f;
+}
+
+// A skinning matrix split into the rigid transform that dual-quaternion skinning blends, and the scale and shear
+// that are blended linearly and applied first
+struct JointDualQuaternion {
+    Float4 real;          // The rotation, x y z w
+    Float4 dual;          // Half the translation, times the rotation
+    Float4 scaleShear[3]; // The columns of the rotation's inverse times the matrix's upper 3x3
+};
+
+// Quaternion product a * b, with components x y z w
+inline Float4 multiplyQuaternions(Float4 a, Float4 b) {
+    const Float4 v = b * a[3] + a * b[3] + cross3(a, b);
+    return make4(v[0], v[1], v[2], a[3] * b[3] - dot3(a, b));
+}
+
+Float4 quaternionFromRotation(const Float4 *c) {
+    float q[4];
+    const float trace = c[0][0] + c[1][1] + c[2][2];
+    if (trace > 0.0f) {
+        const float s = std::sqrt(trace + 1.0f) * 2.0f;
+        q[0] = (c[1][2] - c[2][1]) / s;
+        q[1] = (c[2][0] - c[0][2]) / s;
+        q[2] = (c[0][1] - c[1][0]) / s;
+        q[3] = 0.25f * s;
+    } else if (c[0][0] > c[1][1] && c[0][0] > c[2][2]) {
+        const float s = std::sqrt(1.0f + c[0][0] - c[1][1] - c[2][2]) * 2.0f;
+        q[0] = 0.25f * s;
+        q[1] = (c[1][0] + c[0][1]) / s;
+        q[2] = (c[2][0] + c[0][2]) / s;
+        q[3] = (c[1][2] - c[2][1]) / s;
+    } else if (c[1][1] > c[2][2]) {
+        const float s = std::sqrt(1.0f + c[1][1] - c[0][0] - c[2][2]) * 2.0f;
+        q[0] = (c[1][0] + c[0][1]) / s;
+        q[1] = 0.25f * s;
+        q[2] = (c[2][1] + c[1][2]) / s;
+        q[3] = (c[2][0] - c[0][2]) / s;
+    } else {
+        const float s = std::sqrt(1.0f + c[2][2] - c[0][0] - c[1][1]) * 2.0f;
+        q[0] = (c[2][0] + c[0][2]) / s;
+        q[1] = (c[2][1] + c[1][2]) / s;
+        q[2] = 0.25f * s;
+        q[3] = (c[0][1] - c[1][0]) / s;
+    }
+    const Float4 quaternion = make4(q[0], q[1], q[2], q[3]);
+    const float length = std::sqrt(dot3(quaternion, quaternion) + q[3] * q[3]);
+    return quaternion * (1.0f / length);
+}
+
+JointDualQuaternion dualQuaternionFromMatrix(const Float4 *columns) {
+    // Orthonormalize the columns into the nearest proper rotation; whatever it leaves out, including reflection,
+    // goes into the scale and shear
+    Float4 rotation[3];
+    rotation[0] = normalize3(columns[0]);
+    rotation[1] = normalize3(columns[1] - rotation[0] * dot3(rotation[0], columns[1]));
+    rotation[2] = cross3(rotation[0], rotation[1]);
+    JointDualQuaternion joint;
+    if (dot3(rotation[0], rotation[0]) == 0.0f || dot3(rotation[1], rotation[1]) == 0.0f) {
+        // A degenerate matrix: use no rotation, and blend it all as scale and shear
+        joint.real = make4(0.0f, 0.0f, 0.0f, 1.0f);
+        for (int c = 0; c < 3; ++c) {
+            joint.scaleShear[c] = columns[c];
+        }
+    } else {
+        joint.real = quaternionFromRotation(rotation);
+        for (int c = 0; c < 3; ++c) {
+            joint.scaleShear[c] = make4(dot3(rotation[0], columns[c]), dot3(rotation[1], columns[c]),
+                                        dot3(rotation[2], columns[c]), 0.0f);
+        }
+    }
+    const Float4 translation = make4(columns[3][0], columns[3][1], columns[3][2], 0.0f);
+    joint.dual = multiplyQuaternions(translation, joint.real) * 0.5f;
+    return joint;
+}
+
+void readJointMatrix(const float *palette, int format, size_t joint, Float4 *columns) {
+    if (format == SkinPaletteFormat3x4) {
+        const float *rows = palette + 12 * joint;
+        for (int c = 0; c < 4; ++c) {
+            columns[c] = make4(rows[c], rows[4 + c], rows[8 + c], (c == 3) ? 1.0f : 0.0f);
+        }
+    } else {
+        const float *m = palette + 16 * joint;
+        for (int c = 0; c < 4; ++c) {
+            columns[c] = make4(m[4 * c], m[4 * c + 1], m[4 * c + 2], m[4 * c + 3]);
+        }
+    }
+}
+
+inline void readJointIndices(const AccessorView &view, size_t index, uint32_t *joints) {
+    const uint8_t *element = view.element(index);
+    switch (view.componentType) {
+        case ComponentTypeUnsignedByte:
+            for (int c = 0; c < 4; ++c) {
+                joints[c] = element[c];
+            }
+            break;
+        case ComponentTypeUnsignedShort:
+            for (int c = 0; c < 4; ++c) {
+                joints[c] = LoadUnaligned<uint16_t>(element + 2 * c);
+            }
+            break;
+        default: {
+            float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            ReadFloats(view, index, values, 4);
+            for (int c = 0; c < 4; ++c) {
+                joints[c] = (values[c] >= 0.0f) ? static_cast<uint32_t>(values[c]) : UINT32_MAX;
+            }
+            break;
+        }
+    }
+}
+
+inline Float4 readVector(const AccessorView &view, size_t index, float w) {
+    float values[4] = { 0.0f, 0.0f, 0.0f, w };
+    ReadFloats(view, index, values, 4);
+    return make4(values[0], values[1], values[2], values[3]);
+}
+
+// The influences of one vertex, gathered from all of its joint and weight sets
+struct Influences {
+    std::vector<uint32_t> joints;
+    std::vector<float> weights;
+    float weightSum = 0.0f;
+};
+
+bool gatherInfluences(const SkinningInput &input, size_t vertex, size_t jointCount, Influences &influences) {
+    influences.joints.clear();
+    influences.weights.clear();
+    influences.weightSum = 0.0f;
+    for (size_t set = 0; set < input.jointSets.size(); ++set) {
+        uint32_t joints[4];
+        float weights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        readJointIndices(input.jointSets[set], vertex, joints);
+        ReadFloats(input.weightSets[set], vertex, weights, 4);
+        for (int c = 0; c < 4; ++c) {
+            if (weights[c] <= 0.0f) {
+                continue;
+            }
+            if (joints[c] >= jointCount) {
+                return false;
+            }
+            influences.joints.push_back(joints[c]);
+            influences.weights.push_back(weights[c]);
+            influences.weightSum += weights[c];
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool SkinVertices(const SkinningInput &input, const float *palette, size_t jointCount, int paletteFormat,
+                  int method, SkinnedVertices &output)
+{
+    const size_t vertexCount = input.positions.count;
+    const bool hasNormals = input.normals.isValid(), hasTangents = input.tangents.isValid();
+    if (!input.positions.isValid() || input.positions.componentCount < 3 ||
+        input.jointSets.empty() || input.jointSets.size() != input.weightSets.size() ||
+        (hasNormals && (input.normals.count < vertexCount || input.normals.componentCount < 3)) ||
+        (hasTangents && (input.tangents.count < vertexCount || input.tangents.componentCount < 3)))
+    {
+        return false;
+    }
+    for (size_t set = 0; set < input.jointSets.size(); ++set) {
+        const AccessorView &joints = input.jointSets[set], &weights = input.weightSets[set];
+        if (!joints.isValid() || !weights.isValid() || joints.componentCount != 4 || weights.componentCount != 4 ||
+            joints.count < vertexCount || weights.count < vertexCount)
+        {
+            return false;
+        }
+    }
+
+    // Convert the palette once into the form that the method blends
+    std::vector<Float4> jointColumns(4 * jointCount);
+    std::vector<JointDualQuaternion> jointDualQuaternions;
+    for (size_t j = 0; j < jointCount; ++j) {
+        readJointMatrix(palette, paletteFormat, j, &jointColumns[4 * j]);
+    }
+    if (method == SkinningMethodDualQuaternion) {
+        jointDualQuaternions.resize(jointCount);
+        for (size_t j = 0; j < jointCount; ++j) {
+            jointDualQuaternions[j] = dualQuaternionFromMatrix(&jointColumns[4 * j]);
+        }
+    }
+
+    output.positions.resize(3 * vertexCount);
+    output.normals.resize(hasNormals ? 3 * vertexCount : 0);
+    output.tangents.resize(hasTangents ? 4 * vertexCount : 0);
+    std::atomic<bool> failed(false);
+    ParallelFor(vertexCount, VertexGrainSize, [&](size_t begin, size_t end) {
+        Influences influences;
+        for (size_t i = begin; i < end; ++i) {
+            if (!gatherInfluences(input, i, jointCount, influences)) {
+                failed = true;
+                return;
+            }
+            Float4 position = readVector(input.positions, i, 1.0f);
+            Float4 normal = hasNormals ? readVector(input.normals, i, 0.0f) : splat(0.0f);
+            Float4 tangent = hasTangents ? readVector(input.tangents, i, 1.0f) : splat(0.0f);
+            const float handedness = tangent[3];
+            if (influences.weightSum > 0.0f) {
+                const float weightScale = 1.0f / influences.weightSum;
+                if (method == SkinningMethodDualQuaternion) {
+                    const JointDualQuaternion &first = jointDualQuaternions[influences.joints[0]];
+                    Float4 real = splat(0.0f), dual = splat(0.0f);
+                    Float4 scaleShear[3] = { splat(0.0f), splat(0.0f), splat(0.0f) };
+                    for (size_t k = 0; k < influences.joints.size(); ++k) {
+                        const JointDualQuaternion &joint = jointDualQuaternions[influences.joints[k]];
+                        const float weight = influences.weights[k] * weightScale;
+                        // Blend along the shorter way around from the first influence
+                        const float sign = (dot3(joint.real, first.real) + joint.real[3] * first.real[3] < 0.0f) ?
+                            -weight : weight;
+                        real += joint.real * sign;
+                        dual += joint.dual * sign;
+                        for (int c = 0; c < 3; ++c) {
+                            scaleShear[c] += joint.scaleShear[c] * weight;
+                        }
+                    }
+                    const float length = std::sqrt(dot3(real, real) + real[3] * real[3]);
+                    real *= 1.0f / length;
+                    dual *= 1.0f / length;
+                    const Float4 translation = (dual * real[3] - real * dual[3] + cross3(real, dual)) * 2.0f;
+                    const float r = real[3];
+                    auto rotate = [&](Float4 v) {
+                        return v + cross3(real, cross3(real, v) + v * r) * 2.0f;
+                    };
+                    position = rotate(transformDirection(scaleShear, position)) + translation;
+                    if (hasNormals) {
+                        normal = rotate(transformNormal(scaleShear, normal));
+                    }
+                    if (hasTangents) {
+                        tangent = rotate(normalize3(transformDirection(scaleShear, tangent)));
+                        tangent[3] = handedness * determinantSign(scaleShear);
+                    }
+                } else {
+                    Float4 blended[4] = { splat(0.0f), splat(0.0f), splat(0.0f), splat(0.0f) };
+                    for (size_t k = 0; k < influences.joints.size(); ++k) {
+                        const Float4 *columns = &jointColumns[4 * influences.joints[k]];
+                        const float weight = influences.weights[k] * weightScale;
+                        for (int c = 0; c < 4; ++c) {
+                            blended[c] += columns[c] * weight;
+                        }
+                    }
+                    position = transformDirection(blended, position) + blended[3];
+                    if (hasNormals) {
+                        normal = transformNormal(blended, normal);
+                    }
+                    if (hasTangents) {
+                        tangent = normalize3(transformDirection(blended, tangent));
+                        tangent[3] = handedness * determinantSign(blended);
+                    }
+                }
+            }
+            memcpy(&output.positions[3 * i], &position, 3 * sizeof(float));
+            if (hasNormals) {
+                memcpy(&output.normals[3 * i], &normal, 3 * sizeof(float));
+            }
+            if (hasTangents) {
+                memcpy(&output.tangents[4 * i], &tangent, 4 * sizeof(float));
+            }
+        }
+    });
+    return !failed;
+}
+
+} // namespace GLTF
@@ -0,0 +1,41 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+enum SkinningMethod : int {
+    SkinningMethodLinearBlend,
+    SkinningMethodDualQuaternion,
+};
+
+/// The vertex streams of a skinned primitive. Normals and tangents may be left empty (invalid); joint and weight
+/// sets pair up by index, each holding four influences per vertex.
+struct SkinningInput {
+    AccessorView positions;
+    AccessorView normals;
+    AccessorView tangents;
+    std::vector<AccessorView> jointSets;  // JOINTS_n, of unsigned 8- or 16-bit indices
+    std::vector<AccessorView> weightSets; // WEIGHTS_n, float or normalized unsigned 8- or 16-bit
+};
+
+struct SkinnedVertices {
+    std::vector<float> positions; // 3 floats per vertex
+    std::vector<float> normals;   // 3 floats per vertex, or empty if the input had none
+    std::vector<float> tangents;  // 4 floats per vertex (w is the handedness), or empty if the input had none
+};
+
+/// Deforms the vertices of `input` by the skinning matrices in `palette` (`jointCount` joints of `paletteFormat`,
+/// as produced by SkinPaletteSet), with any number of influences per vertex. Weights are renormalized to sum to one;
+/// vertices without weight keep their positions. Linear blend skinning blends the matrices, and transforms normals
+/// by the blend's cofactor matrix, so that non-uniform scale is handled. Dual-quaternion skinning blends the rigid
+/// part of each matrix as a dual quaternion, which does not collapse at twisting joints, after applying a linear
+/// blend of the remaining scale and shear. Vertices are processed in chunks, in parallel. Returns false if a stream
+/// is invalid or the wrong size, or a vertex refers to a joint beyond `jointCount`.
+bool SkinVertices(const SkinningInput &input, const float *palette, size_t jointCount, int paletteFormat,
+                  int method, SkinnedVertices &output);
+
+} // namespace GLTF
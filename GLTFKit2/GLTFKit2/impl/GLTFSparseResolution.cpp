@@ -0,0 +1,172 @@
+
+#include "GLTFSparseResolution.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace GLTF {
+
+namespace {
+
+template <typename Index_t>
+size_t resolveIndices(const Index_t *indices, size_t count, size_t elementCount,
+                      uint32_t *outIndices, uint32_t *outSlots, size_t &outDiscardedCount)
+{
+    // Conforming assets store sparse indices in strictly increasing order, so we first copy
+    // them through while checking bounds and order, and only sort if we find them out of order.
+    size_t resolvedCount = 0;
+    bool isSorted = true;
+    outDiscardedCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t index = indices[i];
+        if (index >= elementCount) {
+            ++outDiscardedCount;
+            continue;
+        }
+        if (resolvedCount > 0 && index <= outIndices[resolvedCount - 1]) {
+            isSorted = false;
+        }
+        outIndices[resolvedCount] = static_cast<uint32_t>(index);
+        outSlots[resolvedCount] = static_cast<uint32_t>(i);
+        ++resolvedCount;
+    }
+    if (isSorted) {
+        return resolvedCount;
+    }
+
+    // Sort by index, then by slot, so that repeated indices are adjacent and their last occurrence comes last.
+    std::vector<uint64_t> keys(resolvedCount);
+    for (size_t i = 0; i < resolvedCount; ++i) {
+        keys[i] = (static_cast<uint64_t>(outIndices[i]) << 32) | outSlots[i];
+    }
+    std::sort(keys.begin(), keys.end());
+
+    size_t uniqueCount = 0;
+    for (size_t i = 0; i < resolvedCount; ++i) {
+        const uint32_t index = static_cast<uint32_t>(keys[i] >> 32);
+        if ((i + 1 < resolvedCount) && static_cast<uint32_t>(keys[i + 1] >> 32) == index) {
+            continue; // Superseded by a later value for the same index
+        }
+        outIndices[uniqueCount] = index;
+        outSlots[uniqueCount] = static_cast<uint32_t>(keys[i]);
+        ++uniqueCount;
+    }
+    return uniqueCount;
+}
+
+// The element-sized copies below are written as memcpy calls with a compile-time size,
+// which the compiler lowers to a handful of unaligned loads and stores.
+
+template <size_t ElementSize>
+void gatherValues(const uint8_t *values, size_t valueStride, const uint32_t *slots, size_t count, uint8_t *dst) {
+    if (slots == nullptr && valueStride == ElementSize) {
+        memcpy(dst, values, count * ElementSize);
+    } else if (slots == nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+            memcpy(dst + i * ElementSize, values + i * valueStride, ElementSize);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            memcpy(dst + i * ElementSize, values + slots[i] * valueStride, ElementSize);
+        }
+    }
+}
+
+void gatherValues(const uint8_t *values, size_t valueStride, const uint32_t *slots, size_t count,
+                  size_t elementSize, uint8_t *dst)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const size_t slot = (slots != nullptr) ? slots[i] : i;
+        memcpy(dst + i * elementSize, values + slot * valueStride, elementSize);
+    }
+}
+
+template <size_t ElementSize>
+void scatterValues(const uint8_t *values, const uint32_t *indices, size_t count, uint8_t *dst) {
+    size_t i = 0;
+    while (i < count) {
+        size_t runEnd = i + 1;
+        while (runEnd < count && indices[runEnd] == indices[runEnd - 1] + 1) {
+            ++runEnd;
+        }
+        uint8_t *runDst = dst + static_cast<size_t>(indices[i]) * ElementSize;
+        const uint8_t *runSrc = values + i * ElementSize;
+        if (runEnd - i == 1) {
+            memcpy(runDst, runSrc, ElementSize);
+        } else {
+            memcpy(runDst, runSrc, (runEnd - i) * ElementSize);
+        }
+        i = runEnd;
+    }
+}
+
+void scatterValues(const uint8_t *values, const uint32_t *indices, size_t count, size_t elementSize, uint8_t *dst) {
+    size_t i = 0;
+    while (i < count) {
+        size_t runEnd = i + 1;
+        while (runEnd < count && indices[runEnd] == indices[runEnd - 1] + 1) {
+            ++runEnd;
+        }
+        memcpy(dst + static_cast<size_t>(indices[i]) * elementSize, values + i * elementSize, (runEnd - i) * elementSize);
+        i = runEnd;
+    }
+}
+
+} // namespace
+
+size_t ResolveSparseIndices(const uint8_t *indices, size_t count, size_t elementCount,
+                            uint32_t *outIndices, uint32_t *outSlots, size_t &outDiscardedCount)
+{
+    return resolveIndices(indices, count, elementCount, outIndices, outSlots, outDiscardedCount);
+}
+
+size_t ResolveSparseIndices(const uint16_t *indices, size_t count, size_t elementCount,
+                            uint32_t *outIndices, uint32_t *outSlots, size_t &outDiscardedCount)
+{
+    return resolveIndices(indices, count, elementCount, outIndices, outSlots, outDiscardedCount);
+}
+
+size_t ResolveSparseIndices(const uint32_t *indices, size_t count, size_t elementCount,
+                            uint32_t *outIndices, uint32_t *outSlots, size_t &outDiscardedCount)
+{
+    return resolveIndices(indices, count, elementCount, outIndices, outSlots, outDiscardedCount);
+}
+
+void GatherSparseValues(const void *values, size_t valueStride, const uint32_t *slots, size_t count,
+                        size_t elementSize, void *destination)
+{
+    const uint8_t *src = static_cast<const uint8_t *>(values);
+    uint8_t *dst = static_cast<uint8_t *>(destination);
+    switch (elementSize) {
+        case 1:  gatherValues<1>(src, valueStride, slots, count, dst); break;
+        case 2:  gatherValues<2>(src, valueStride, slots, count, dst); break;
+        case 3:  gatherValues<3>(src, valueStride, slots, count, dst); break;
+        case 4:  gatherValues<4>(src, valueStride, slots, count, dst); break;
+        case 6:  gatherValues<6>(src, valueStride, slots, count, dst); break;
+        case 8:  gatherValues<8>(src, valueStride, slots, count, dst); break;
+        case 12: gatherValues<12>(src, valueStride, slots, count, dst); break;
+        case 16: gatherValues<16>(src, valueStride, slots, count, dst); break;
+        default: gatherValues(src, valueStride, slots, count, elementSize, dst); break;
+    }
+}
+
+void ScatterSparseValues(const void *values, const uint32_t *indices, size_t count, size_t elementSize,
+                         void *destination)
+{
+    const uint8_t *src = static_cast<const uint8_t *>(values);
+    uint8_t *dst = static_cast<uint8_t *>(destination);
+    switch (elementSize) {
+        case 1:  scatterValues<1>(src, indices, count, dst); break;
+        case 2:  scatterValues<2>(src, indices, count, dst); break;
+        case 3:  scatterValues<3>(src, indices, count, dst); break;
+        case 4:  scatterValues<4>(src, indices, count, dst); break;
+        case 6:  scatterValues<6>(src, indices, count, dst); break;
+        case 8:  scatterValues<8>(src, indices, count, dst); break;
+        case 12: scatterValues<12>(src, indices, count, dst); break;
+        case 16: scatterValues<16>(src, indices, count, dst); break;
+        default: scatterValues(src, indices, count, elementSize, dst); break;
+    }
+}
+
+} // namespace GLTF
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GLTF {
+
+/// Resolves `count` sparse indices into a strictly increasing list of destination element indices. Indices not less
+/// than `elementCount` are discarded. When an index occurs more than once, the last occurrence wins, matching the
+/// order in which the substitutions would otherwise be applied. For each resolved index, `outSlots` receives the
+/// position of the sparse value to be stored there. Both output arrays must have room for `count` entries. Returns
+/// the number of resolved indices, and stores the number of out-of-range indices that were dropped in
+/// `outDiscardedCount`.
+size_t ResolveSparseIndices(const uint8_t *indices, size_t count, size_t elementCount,
+                            uint32_t *outIndices, uint32_t *outSlots, size_t &outDiscardedCount);
+size_t ResolveSparseIndices(const uint16_t *indices, size_t count, size_t elementCount,
+                            uint32_t *outIndices, uint32_t *outSlots, size_t &outDiscardedCount);
+size_t ResolveSparseIndices(const uint32_t *indices, size_t count, size_t elementCount,
+                            uint32_t *outIndices, uint32_t *outSlots, size_t &outDiscardedCount);
+
+/// Copies the sparse values named by `slots` (or the first `count` values, if `slots` is null) into `destination`,
+/// which receives `count` tightly packed elements of `elementSize` bytes.
+void GatherSparseValues(const void *values, size_t valueStride, const uint32_t *slots, size_t count,
+                        size_t elementSize, void *destination);
+
+/// Stores `count` tightly packed elements of `elementSize` bytes at the strictly increasing element indices given
+/// by `indices` in `destination`. Runs of consecutive indices are copied with a single store.
+void ScatterSparseValues(const void *values, const uint32_t *indices, size_t count, size_t elementSize,
+                         void *destination);
+
+} // namespace GLTF
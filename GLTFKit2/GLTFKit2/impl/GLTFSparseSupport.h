@@ -0,0 +1,29 @@
+
+#import <Foundation/Foundation.h>
+#import "GLTFTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Reads `count` sparse indices of the given component type and resolves them into a strictly increasing list of
+/// destination element indices. Indices not less than `elementCount` are discarded. When an index occurs more than
+/// once, the last occurrence wins, matching the order in which the substitutions would otherwise be applied.
+/// For each resolved index, `outSlots` receives the position of the sparse value to be stored there.
+/// Both output arrays must have room for `count` entries. Returns the number of resolved indices, and, if
+/// `outDiscardedCount` is non-NULL, the number of out-of-range indices that were dropped.
+GLTFKIT2_EXPORT
+size_t GLTFSparseResolveIndices(const void *indices, GLTFComponentType indexType, size_t count, size_t elementCount,
+                                uint32_t *outIndices, uint32_t *outSlots, size_t *_Nullable outDiscardedCount);
+
+/// Copies the sparse values named by `slots` (or the first `count` values, if `slots` is NULL) into `destination`,
+/// which receives `count` tightly packed elements of `elementSize` bytes.
+GLTFKIT2_EXPORT
+void GLTFSparseGatherValues(const void *values, size_t valueStride, const uint32_t *_Nullable slots, size_t count,
+                            size_t elementSize, void *destination);
+
+/// Stores `count` tightly packed elements of `elementSize` bytes at the strictly increasing element indices given
+/// by `indices` in `destination`. Runs of consecutive indices are copied with a single store.
+GLTFKIT2_EXPORT
+void GLTFSparseScatterValues(const void *values, const uint32_t *indices, size_t count, size_t elementSize,
+                             void *destination);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,45 @@
+
+#import "GLTFSparseSupport.h"
+
+#include "GLTFSparseResolution.h"
+
+size_t GLTFSparseResolveIndices(const void *indices, GLTFComponentType indexType, size_t count, size_t elementCount,
+                                uint32_t *outIndices, uint32_t *outSlots, size_t *outDiscardedCount)
+{
+    size_t discardedCount = 0;
+    size_t resolvedCount = 0;
+    switch (indexType) {
+        case GLTFComponentTypeUnsignedByte:
+            resolvedCount = GLTF::ResolveSparseIndices(static_cast<const uint8_t *>(indices), count, elementCount,
+                                                       outIndices, outSlots, discardedCount);
+            break;
+        case GLTFComponentTypeUnsignedShort:
+            resolvedCount = GLTF::ResolveSparseIndices(static_cast<const uint16_t *>(indices), count, elementCount,
+                                                       outIndices, outSlots, discardedCount);
+            break;
+        case GLTFComponentTypeUnsignedInt:
+            resolvedCount = GLTF::ResolveSparseIndices(static_cast<const uint32_t *>(indices), count, elementCount,
+                                                       outIndices, outSlots, discardedCount);
+            break;
+        default:
+            // Sparse accessor index type must be one of: unsigned byte, unsigned short, or unsigned int.
+            discardedCount = count;
+            break;
+    }
+    if (outDiscardedCount) {
+        *outDiscardedCount = discardedCount;
+    }
+    return resolvedCount;
+}
+
+void GLTFSparseGatherValues(const void *values, size_t valueStride, const uint32_t *slots, size_t count,
+                            size_t elementSize, void *destination)
+{
+    GLTF::GatherSparseValues(values, valueStride, slots, count, elementSize, destination);
+}
+
+void GLTFSparseScatterValues(const void *values, const uint32_t *indices, size_t count, size_t elementSize,
+                             void *destination)
+{
+    GLTF::ScatterSparseValues(values, indices, count, elementSize, destination);
+}
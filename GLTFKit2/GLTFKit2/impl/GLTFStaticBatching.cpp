@@ -0,0 +1,173 @@
+
+#include "GLTFStaticBatching.h"
+#include "GLTFParallel.h"
+#include "GLTFVectorMath.h"
+
+namespace GLTF {
+
+namespace {
+
+// Sources per unit of parallel work; batched sources are typically small
+const size_t SourceGrainSize = 16;
+
+struct BakeMatrices {
+    float linear[9];  // Column-major upper 3x3 of the transform
+    float normal[9];  // Column-major cofactor matrix, with the sign of the determinant folded in
+    Vec3 translation;
+    bool mirrors;
+};
+
+BakeMatrices makeBakeMatrices(const float m[16]) {
+    BakeMatrices matrices;
+    const Vec3 c0 = MakeVec3(m[0], m[1], m[2]);
+    const Vec3 c1 = MakeVec3(m[4], m[5], m[6]);
+    const Vec3 c2 = MakeVec3(m[8], m[9], m[10]);
+    const float determinant = Dot(c0, Cross(c1, c2));
+    const float sign = (determinant < 0.0f) ? -1.0f : 1.0f;
+    // The cofactor matrix is the inverse transpose scaled by the determinant; its columns are cross products of
+    // pairs of columns of the linear part
+    const Vec3 n0 = Cross(c1, c2) * sign, n1 = Cross(c2, c0) * sign, n2 = Cross(c0, c1) * sign;
+    const Vec3 linearColumns[3] = { c0, c1, c2 }, normalColumns[3] = { n0, n1, n2 };
+    for (int c = 0; c < 3; ++c) {
+        matrices.linear[3 * c + 0] = linearColumns[c].x;
+        matrices.linear[3 * c + 1] = linearColumns[c].y;
+        matrices.linear[3 * c + 2] = linearColumns[c].z;
+        matrices.normal[3 * c + 0] = normalColumns[c].x;
+        matrices.normal[3 * c + 1] = normalColumns[c].y;
+        matrices.normal[3 * c + 2] = normalColumns[c].z;
+    }
+    matrices.translation = MakeVec3(m[12], m[13], m[14]);
+    matrices.mirrors = determinant < 0.0f;
+    return matrices;
+}
+
+inline Vec3 multiply(const float m[9], Vec3 v) {
+    return MakeVec3(m[0] * v.x + m[3] * v.y + m[6] * v.z,
+                    m[1] * v.x + m[4] * v.y + m[7] * v.z,
+                    m[2] * v.x + m[5] * v.y + m[8] * v.z);
+}
+
+void bakeAttribute(const AccessorView &source, BatchAttributeTransform transform, const BakeMatrices &matrices,
+                   uint8_t *destination)
+{
+    const size_t elementSize = source.elementSize();
+    for (size_t i = 0; i < source.count; ++i) {
+        const uint8_t *element = source.element(i);
+        uint8_t *out = destination + i * elementSize;
+        if (transform == BatchAttributeTransformNone) {
+            memcpy(out, element, elementSize);
+            continue;
+        }
+        Vec3 v = MakeVec3(LoadUnaligned<float>(element), LoadUnaligned<float>(element + 4),
+                          LoadUnaligned<float>(element + 8));
+        switch (transform) {
+            case BatchAttributeTransformPoint:
+                v = multiply(matrices.linear, v) + matrices.translation;
+                break;
+            case BatchAttributeTransformNormal:
+                v = Normalize(multiply(matrices.normal, v), v);
+                break;
+            case BatchAttributeTransformTangent: {
+                v = Normalize(multiply(matrices.linear, v), v);
+                const float w = LoadUnaligned<float>(element + 12);
+                StoreUnaligned<float>(out + 12, matrices.mirrors ? -w : w);
+                break;
+            }
+            default:
+                break;
+        }
+        StoreUnaligned<float>(out, v.x);
+        StoreUnaligned<float>(out + 4, v.y);
+        StoreUnaligned<float>(out + 8, v.z);
+    }
+}
+
+bool isBakeable(const AccessorView &view, BatchAttributeTransform transform) {
+    switch (transform) {
+        case BatchAttributeTransformPoint:
+        case BatchAttributeTransformNormal:
+            return view.componentType == ComponentTypeFloat && view.componentCount == 3;
+        case BatchAttributeTransformTangent:
+            return view.componentType == ComponentTypeFloat && view.componentCount == 4;
+        default:
+            return true;
+    }
+}
+
+} // namespace
+
+bool BuildStaticBatch(const std::vector<BatchSource> &sources, const std::vector<BatchAttributeTransform> &transforms,
+                      size_t verticesPerPrimitive, StaticBatch &result)
+{
+    result = StaticBatch();
+    const size_t attributeCount = transforms.size();
+    if (sources.empty() || attributeCount == 0) {
+        return false;
+    }
+
+    // Validate every source against the first, and lay the sources out one after another
+    const BatchSource &first = sources.front();
+    result.ranges.resize(sources.size());
+    uint64_t vertexTotal = 0, indexTotal = 0;
+    for (size_t s = 0; s < sources.size(); ++s) {
+        const BatchSource &source = sources[s];
+        if (source.attributes.size() != attributeCount || first.attributes.size() != attributeCount) {
+            return false;
+        }
+        const size_t vertexCount = source.attributes[0].count;
+        for (size_t a = 0; a < attributeCount; ++a) {
+            const AccessorView &view = source.attributes[a];
+            if (!view.isValid() || view.count != vertexCount || view.componentType != first.attributes[a].componentType ||
+                view.componentCount != first.attributes[a].componentCount || !isBakeable(view, transforms[a]))
+            {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < source.indexCount; ++i) {
+            if (source.indices[i] >= vertexCount) {
+                return false;
+            }
+        }
+        BatchRange &range = result.ranges[s];
+        range.vertexOffset = static_cast<uint32_t>(vertexTotal);
+        range.vertexCount = static_cast<uint32_t>(vertexCount);
+        range.indexOffset = static_cast<uint32_t>(indexTotal);
+        range.indexCount = static_cast<uint32_t>(source.indexCount);
+        vertexTotal += vertexCount;
+        indexTotal += source.indexCount;
+        if (vertexTotal >= UINT32_MAX || indexTotal >= UINT32_MAX) {
+            return false;
+        }
+    }
+
+    result.attributes.resize(attributeCount);
+    for (size_t a = 0; a < attributeCount; ++a) {
+        result.attributes[a].resize(static_cast<size_t>(vertexTotal) * first.attributes[a].elementSize());
+    }
+    result.indices.resize(static_cast<size_t>(indexTotal));
+
+    ParallelFor(sources.size(), SourceGrainSize, [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            const BatchSource &source = sources[s];
+            const BatchRange &range = result.ranges[s];
+            const BakeMatrices matrices = makeBakeMatrices(source.transform);
+            for (size_t a = 0; a < attributeCount; ++a) {
+                const AccessorView &view = source.attributes[a];
+                bakeAttribute(view, transforms[a], matrices,
+                              result.attributes[a].data() + range.vertexOffset * view.elementSize());
+            }
+            uint32_t *indices = result.indices.data() + range.indexOffset;
+            for (size_t i = 0; i < source.indexCount; ++i) {
+                indices[i] = source.indices[i] + range.vertexOffset;
+            }
+            if (verticesPerPrimitive == 3 && matrices.mirrors) {
+                for (size_t i = 0; i + 2 < source.indexCount; i += 3) {
+                    std::swap(indices[i + 1], indices[i + 2]);
+                }
+            }
+        }
+    });
+    return true;
+}
+
+} // namespace GLTF
@@ -0,0 +1,47 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+/// How the elements of an attribute change when a primitive is baked into a batch.
+enum BatchAttributeTransform : int {
+    BatchAttributeTransformNone,    // Copied unchanged
+    BatchAttributeTransformPoint,   // Float VEC3 transformed as a point
+    BatchAttributeTransformNormal,  // Float VEC3 transformed by the inverse transpose and renormalized
+    BatchAttributeTransformTangent, // Float VEC4 whose xyz is transformed as a direction and renormalized, and
+                                    // whose handedness in w is flipped by mirroring transforms
+};
+
+struct BatchSource {
+    std::vector<AccessorView> attributes; // One per batch attribute, in the batch's order, all of the same count
+    const uint32_t *indices = nullptr;    // A list of points, lines or triangles
+    size_t indexCount = 0;
+    float transform[16];                  // Column-major transform from the source to the batch
+};
+
+struct BatchRange {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    uint32_t vertexOffset;
+    uint32_t vertexCount;
+};
+
+struct StaticBatch {
+    std::vector<std::vector<uint8_t>> attributes; // Tightly packed, in the element format of the source attributes
+    std::vector<uint32_t> indices;
+    std::vector<BatchRange> ranges;               // The vertices and indices that came from each source, in order
+};
+
+/// Concatenates `sources` into a single batch, transforming each attribute as `transforms` directs and offsetting
+/// each source's indices by the vertices that precede it. Where `verticesPerPrimitive` is 3 and a transform mirrors,
+/// triangle winding is reversed so that front faces stay front faces. Sources are baked in parallel. Returns false
+/// if the sources' attributes disagree in format, a transformed attribute is not of the required float type, an
+/// index is out of range, or the batch would need more than 2^32 - 1 vertices or indices.
+bool BuildStaticBatch(const std::vector<BatchSource> &sources, const std::vector<BatchAttributeTransform> &transforms,
+                      size_t verticesPerPrimitive, StaticBatch &result);
+
+} // namespace GLTF
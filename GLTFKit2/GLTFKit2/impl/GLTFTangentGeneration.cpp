@@ -0,0 +1,479 @@
+
+#include "GLTFTangentGeneration.h"
+#include "GLTFParallel.h"
+#include "GLTFVectorMath.h"
+
+#include <cfloat>
+#include <unordered_map>
+
+// A port of the triangle-only path of the reference MikkTSpace implementation (mikktspace.c by Morten S. Mikkelsen)
+// with its default angular threshold of 180 degrees. The grouping, ordering, and floating-point operations follow the
+// reference so that the results match it; only the storage and the independent per-triangle and per-group loops differ.
+
+namespace GLTF {
+
+namespace {
+
+// Triangles per unit of parallel work
+const size_t TriangleGrainSize = 1 << 14;
+
+// Vertex groups per unit of parallel work
+const size_t GroupGrainSize = 1 << 12;
+
+// The cosine of the reference's default angular threshold of 180 degrees
+const float AngularThresholdCosine = -1.0f;
+
+const uint32_t Unassigned = UINT32_MAX;
+
+// Triangle flags, as in the reference
+const int GroupWithAny = 4;
+const int OrientPreserving = 8;
+
+struct TriangleInfo {
+    uint32_t neighbors[3]; // The triangle across the edge from each corner to the next, or Unassigned
+    uint32_t groups[3];    // The group of the vertex at each corner, or Unassigned
+    Vec3 os, ot;           // Normalized first order texture derivatives
+    int flags;
+};
+
+// Triangles around one welded vertex that are connected across edges and have the same texture-space winding
+struct VertexGroup {
+    size_t firstFace; // Offset of the group's triangles in the shared face list
+    size_t faceCount;
+    uint32_t vertex;
+    bool orientPreserving;
+};
+
+struct TangentSpace {
+    Vec3 tangent;
+    bool orientPreserving;
+};
+
+struct Edge {
+    uint32_t lo, hi, triangle;
+
+    bool operator<(const Edge &other) const {
+        if (lo != other.lo) {
+            return lo < other.lo;
+        }
+        return (hi != other.hi) ? hi < other.hi : triangle < other.triangle;
+    }
+};
+
+struct VertexKey {
+    uint32_t bits[8]; // Position, normal, and texture coordinates
+
+    bool operator==(const VertexKey &other) const {
+        return memcmp(bits, other.bits, sizeof(bits)) == 0;
+    }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey &key) const {
+        size_t hash = 0;
+        for (int i = 0; i < 8; ++i) {
+            hash = (hash ^ key.bits[i]) * 16777619u;
+        }
+        return hash;
+    }
+};
+
+// Maps each vertex to the first vertex whose position, normal, and texture coordinates compare equal.
+std::vector<uint32_t> weldVertices(const std::vector<Vec3> &positions, const std::vector<Vec3> &normals,
+                                   const std::vector<float> &texCoords)
+{
+    std::vector<uint32_t> canonical(positions.size());
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> firstVertexForKey;
+    firstVertexForKey.reserve(positions.size());
+    for (size_t v = 0; v < positions.size(); ++v) {
+        const float components[8] = {
+            positions[v].x + 0.0f, positions[v].y + 0.0f, positions[v].z + 0.0f, // -0 to 0
+            normals[v].x + 0.0f, normals[v].y + 0.0f, normals[v].z + 0.0f,
+            texCoords[2 * v] + 0.0f, texCoords[2 * v + 1] + 0.0f
+        };
+        bool comparable = true;
+        for (int c = 0; c < 8; ++c) {
+            comparable = comparable && !std::isnan(components[c]);
+        }
+        if (!comparable) {
+            canonical[v] = static_cast<uint32_t>(v);
+            continue;
+        }
+        VertexKey key;
+        memcpy(key.bits, components, sizeof(key.bits));
+        canonical[v] = firstVertexForKey.insert(std::make_pair(key, static_cast<uint32_t>(v))).first->second;
+    }
+    return canonical;
+}
+
+bool notZero(float x) {
+    return std::fabs(x) > FLT_MIN;
+}
+
+bool notZero(Vec3 v) {
+    return notZero(v.x) || notZero(v.y) || notZero(v.z);
+}
+
+// Projects `v` into the plane of `normal`, normalizing the result unless it is zero.
+Vec3 projectIntoPlane(Vec3 v, Vec3 normal) {
+    const Vec3 projected = v - normal * Dot(normal, v);
+    return notZero(projected) ? projected * (1.0f / Length(projected)) : projected;
+}
+
+int cornerOfVertex(const uint32_t *triangle, uint32_t vertex) {
+    return (triangle[0] == vertex) ? 0 : ((triangle[1] == vertex) ? 1 : 2);
+}
+
+// Finds the edge of `triangle` joining `a` and `b`, and its endpoints in winding order.
+int edgeOfTriangle(const uint32_t *triangle, uint32_t a, uint32_t b, uint32_t &from, uint32_t &to) {
+    if (triangle[0] == a || triangle[0] == b) {
+        if (triangle[1] == a || triangle[1] == b) {
+            from = triangle[0];
+            to = triangle[1];
+            return 0;
+        }
+        from = triangle[2];
+        to = triangle[0];
+        return 2;
+    }
+    from = triangle[1];
+    to = triangle[2];
+    return 1;
+}
+
+// Evaluates the texture derivatives of each triangle and decides whether it is usable on its own.
+void initializeTriangles(const std::vector<uint32_t> &triangleVertices, const std::vector<Vec3> &points,
+                         const std::vector<float> &uvs, std::vector<TriangleInfo> &triangles)
+{
+    ParallelFor(triangles.size(), TriangleGrainSize, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            TriangleInfo &info = triangles[f];
+            const uint32_t *v = &triangleVertices[3 * f];
+            for (int i = 0; i < 3; ++i) {
+                info.neighbors[i] = Unassigned;
+                info.groups[i] = Unassigned;
+            }
+            info.os = MakeVec3(0.0f, 0.0f, 0.0f);
+            info.ot = MakeVec3(0.0f, 0.0f, 0.0f);
+            info.flags = GroupWithAny;
+
+            const float t21x = uvs[2 * v[1]] - uvs[2 * v[0]];
+            const float t21y = uvs[2 * v[1] + 1] - uvs[2 * v[0] + 1];
+            const float t31x = uvs[2 * v[2]] - uvs[2 * v[0]];
+            const float t31y = uvs[2 * v[2] + 1] - uvs[2 * v[0] + 1];
+            const Vec3 d1 = points[v[1]] - points[v[0]];
+            const Vec3 d2 = points[v[2]] - points[v[0]];
+            const float signedAreaTimesTwo = t21x * t31y - t21y * t31x;
+            const Vec3 os = d1 * t31y - d2 * t21y;
+            const Vec3 ot = d1 * -t31x + d2 * t21x;
+            if (signedAreaTimesTwo > 0.0f) {
+                info.flags |= OrientPreserving;
+            }
+            if (notZero(signedAreaTimesTwo)) {
+                const float absArea = std::fabs(signedAreaTimesTwo);
+                const float lengthOs = Length(os);
+                const float lengthOt = Length(ot);
+                const float sign = (info.flags & OrientPreserving) ? 1.0f : -1.0f;
+                if (notZero(lengthOs)) {
+                    info.os = os * (sign / lengthOs);
+                }
+                if (notZero(lengthOt)) {
+                    info.ot = ot * (sign / lengthOt);
+                }
+                if (notZero(lengthOs / absArea) && notZero(lengthOt / absArea)) {
+                    info.flags &= ~GroupWithAny;
+                }
+            }
+        }
+    });
+}
+
+// Pairs up triangles across shared edges. Edges used by more than two triangles pair in triangle order.
+void buildNeighbors(const std::vector<uint32_t> &triangleVertices, std::vector<TriangleInfo> &triangles) {
+    std::vector<Edge> edges(triangleVertices.size());
+    for (size_t f = 0; f < triangles.size(); ++f) {
+        for (size_t i = 0; i < 3; ++i) {
+            const uint32_t a = triangleVertices[3 * f + i];
+            const uint32_t b = triangleVertices[3 * f + (i + 1) % 3];
+            Edge &edge = edges[3 * f + i];
+            edge.lo = std::min(a, b);
+            edge.hi = std::max(a, b);
+            edge.triangle = static_cast<uint32_t>(f);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const uint32_t f = edges[i].triangle;
+        uint32_t fromA, toA;
+        const int edgeA = edgeOfTriangle(&triangleVertices[3 * f], edges[i].lo, edges[i].hi, fromA, toA);
+        if (triangles[f].neighbors[edgeA] != Unassigned) {
+            continue;
+        }
+        for (size_t j = i + 1; j < edges.size() && edges[j].lo == edges[i].lo && edges[j].hi == edges[i].hi; ++j) {
+            const uint32_t t = edges[j].triangle;
+            uint32_t fromB, toB;
+            const int edgeB = edgeOfTriangle(&triangleVertices[3 * t], edges[j].lo, edges[j].hi, fromB, toB);
+            if (fromA == toB && toA == fromB && triangles[t].neighbors[edgeB] == Unassigned) {
+                triangles[f].neighbors[edgeA] = t;
+                triangles[t].neighbors[edgeB] = f;
+                break;
+            }
+        }
+    }
+}
+
+// Collects the triangles around each vertex into groups that are edge-connected and have the same winding. A
+// triangle without usable texture derivatives takes the winding of the first group that reaches it. Neighbors are
+// visited depth-first, left before right, in the order of the reference's recursion.
+std::vector<VertexGroup> buildGroups(const std::vector<uint32_t> &triangleVertices,
+                                     std::vector<TriangleInfo> &triangles, std::vector<uint32_t> &groupFaces)
+{
+    std::vector<VertexGroup> groups;
+    std::vector<uint32_t> pending;
+    for (size_t f = 0; f < triangles.size(); ++f) {
+        for (int i = 0; i < 3; ++i) {
+            if ((triangles[f].flags & GroupWithAny) != 0 || triangles[f].groups[i] != Unassigned) {
+                continue;
+            }
+            const uint32_t groupIndex = static_cast<uint32_t>(groups.size());
+            VertexGroup group;
+            group.firstFace = groupFaces.size();
+            group.vertex = triangleVertices[3 * f + i];
+            group.orientPreserving = (triangles[f].flags & OrientPreserving) != 0;
+            triangles[f].groups[i] = groupIndex;
+            groupFaces.push_back(static_cast<uint32_t>(f));
+            pending.clear();
+            pending.push_back(triangles[f].neighbors[(i + 2) % 3]);
+            pending.push_back(triangles[f].neighbors[i]);
+            while (!pending.empty()) {
+                const uint32_t t = pending.back();
+                pending.pop_back();
+                if (t == Unassigned) {
+                    continue;
+                }
+                TriangleInfo &info = triangles[t];
+                const int corner = cornerOfVertex(&triangleVertices[3 * t], group.vertex);
+                if (info.groups[corner] != Unassigned) {
+                    continue;
+                }
+                if ((info.flags & GroupWithAny) != 0 && info.groups[0] == Unassigned &&
+                    info.groups[1] == Unassigned && info.groups[2] == Unassigned)
+                {
+                    info.flags = (info.flags & ~OrientPreserving) | (group.orientPreserving ? OrientPreserving : 0);
+                }
+                if (((info.flags & OrientPreserving) != 0) != group.orientPreserving) {
+                    continue;
+                }
+                info.groups[corner] = groupIndex;
+                groupFaces.push_back(t);
+                pending.push_back(info.neighbors[(corner + 2) % 3]);
+                pending.push_back(info.neighbors[corner]);
+            }
+            group.faceCount = groupFaces.size() - group.firstFace;
+            groups.push_back(group);
+        }
+    }
+    return groups;
+}
+
+// Averages the projected s directions of the usable triangles in `faces` at `vertex`, weighted by corner angle.
+Vec3 evaluateTangent(const std::vector<uint32_t> &faces, uint32_t vertex, const std::vector<uint32_t> &triangleVertices,
+                     const std::vector<TriangleInfo> &triangles, const std::vector<Vec3> &points,
+                     const std::vector<Vec3> &normals)
+{
+    Vec3 sum = MakeVec3(0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < faces.size(); ++i) {
+        const uint32_t f = faces[i];
+        if ((triangles[f].flags & GroupWithAny) != 0) {
+            continue;
+        }
+        const uint32_t *v = &triangleVertices[3 * f];
+        const int corner = cornerOfVertex(v, vertex);
+        const Vec3 n = normals[vertex];
+        const Vec3 os = projectIntoPlane(triangles[f].os, n);
+        const Vec3 p0 = points[v[(corner + 2) % 3]];
+        const Vec3 p1 = points[v[corner]];
+        const Vec3 p2 = points[v[(corner + 1) % 3]];
+        const Vec3 e1 = projectIntoPlane(p0 - p1, n);
+        const Vec3 e2 = projectIntoPlane(p2 - p1, n);
+        const float cosine = std::min(std::max(Dot(e1, e2), -1.0f), 1.0f);
+        const float angle = static_cast<float>(std::acos(static_cast<double>(cosine)));
+        sum = sum + os * angle;
+    }
+    return notZero(sum) ? sum * (1.0f / Length(sum)) : sum;
+}
+
+// Splits each group into subgroups of triangles whose projected derivatives are within the angular threshold of
+// one another, and writes the tangent space of its subgroup to each corner of the group.
+void generateTangentSpaces(const std::vector<VertexGroup> &groups, const std::vector<uint32_t> &groupFaces,
+                           const std::vector<uint32_t> &triangleVertices, const std::vector<TriangleInfo> &triangles,
+                           const std::vector<uint32_t> &sourceTriangles, const std::vector<Vec3> &points,
+                           const std::vector<Vec3> &normals, std::vector<TangentSpace> &cornerSpaces)
+{
+    ParallelFor(groups.size(), GroupGrainSize, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> members;
+        std::vector<std::vector<uint32_t>> subgroups;
+        std::vector<Vec3> subgroupTangents;
+        for (size_t g = begin; g < end; ++g) {
+            const VertexGroup &group = groups[g];
+            const uint32_t *faces = &groupFaces[group.firstFace];
+            const Vec3 n = normals[group.vertex];
+            subgroups.clear();
+            subgroupTangents.clear();
+            for (size_t i = 0; i < group.faceCount; ++i) {
+                const uint32_t f = faces[i];
+                const TriangleInfo &info = triangles[f];
+                const int corner = (info.groups[0] == g) ? 0 : ((info.groups[1] == g) ? 1 : 2);
+                const Vec3 os = projectIntoPlane(info.os, n);
+                const Vec3 ot = projectIntoPlane(info.ot, n);
+                members.clear();
+                for (size_t j = 0; j < group.faceCount; ++j) {
+                    const uint32_t t = faces[j];
+                    const Vec3 os2 = projectIntoPlane(triangles[t].os, n);
+                    const Vec3 ot2 = projectIntoPlane(triangles[t].ot, n);
+                    const bool any = ((info.flags | triangles[t].flags) & GroupWithAny) != 0;
+                    if (any || f == t || (Dot(os, os2) > AngularThresholdCosine &&
+                                          Dot(ot, ot2) > AngularThresholdCosine))
+                    {
+                        members.push_back(t);
+                    }
+                }
+                std::sort(members.begin(), members.end());
+                size_t s = 0;
+                while (s < subgroups.size() && subgroups[s] != members) {
+                    ++s;
+                }
+                if (s == subgroups.size()) {
+                    subgroups.push_back(members);
+                    subgroupTangents.push_back(evaluateTangent(members, group.vertex, triangleVertices, triangles,
+                                                               points, normals));
+                }
+                TangentSpace &space = cornerSpaces[3 * sourceTriangles[f] + corner];
+                space.tangent = subgroupTangents[s];
+                space.orientPreserving = group.orientPreserving;
+            }
+        }
+    });
+}
+
+bool sameTangentSpace(const TangentSpace &a, const TangentSpace &b) {
+    return memcmp(&a.tangent, &b.tangent, sizeof(Vec3)) == 0 && a.orientPreserving == b.orientPreserving;
+}
+
+} // namespace
+
+bool GenerateTangents(const AccessorView &positions, const AccessorView &normals, const AccessorView &texCoords,
+                      const uint32_t *indices, size_t indexCount, GeneratedTangents &result)
+{
+    result = GeneratedTangents();
+    if (!positions.isValid() || positions.componentCount < 3 ||
+        !normals.isValid() || normals.componentCount < 3 || normals.count != positions.count ||
+        !texCoords.isValid() || texCoords.componentCount < 2 || texCoords.count != positions.count)
+    {
+        return false;
+    }
+    const size_t vertexCount = positions.count;
+    for (size_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            return false;
+        }
+    }
+
+    const std::vector<Vec3> points = ReadVec3s(positions);
+    const std::vector<Vec3> vertexNormals = ReadVec3s(normals);
+    // MikkTSpace puts the texture origin at the bottom left, and glTF at the top left
+    std::vector<float> uvs(2 * vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        ReadFloats(texCoords, v, &uvs[2 * v], 2);
+        uvs[2 * v + 1] = 1.0f - uvs[2 * v + 1];
+    }
+    const std::vector<uint32_t> canonical = weldVertices(points, vertexNormals, uvs);
+
+    // Set aside triangles with coincident corners. The rest keep their order and refer to welded vertices.
+    const size_t triangleCount = indexCount / 3;
+    std::vector<uint32_t> sourceTriangles, degenerateTriangles, triangleVertices;
+    sourceTriangles.reserve(triangleCount);
+    triangleVertices.reserve(3 * triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const Vec3 p0 = points[indices[3 * t]], p1 = points[indices[3 * t + 1]], p2 = points[indices[3 * t + 2]];
+        const bool degenerate = (p0.x == p1.x && p0.y == p1.y && p0.z == p1.z) ||
+                                (p0.x == p2.x && p0.y == p2.y && p0.z == p2.z) ||
+                                (p1.x == p2.x && p1.y == p2.y && p1.z == p2.z);
+        if (degenerate) {
+            degenerateTriangles.push_back(static_cast<uint32_t>(t));
+            continue;
+        }
+        sourceTriangles.push_back(static_cast<uint32_t>(t));
+        for (size_t c = 3 * t; c < 3 * t + 3; ++c) {
+            triangleVertices.push_back(canonical[indices[c]]);
+        }
+    }
+
+    std::vector<TriangleInfo> triangles(sourceTriangles.size());
+    initializeTriangles(triangleVertices, points, uvs, triangles);
+    buildNeighbors(triangleVertices, triangles);
+    std::vector<uint32_t> groupFaces;
+    const std::vector<VertexGroup> groups = buildGroups(triangleVertices, triangles, groupFaces);
+
+    // Corners that no group reaches keep the reference's default tangent space
+    TangentSpace defaultSpace;
+    defaultSpace.tangent = MakeVec3(1.0f, 0.0f, 0.0f);
+    defaultSpace.orientPreserving = false;
+    std::vector<TangentSpace> cornerSpaces(3 * triangleCount, defaultSpace);
+    generateTangentSpaces(groups, groupFaces, triangleVertices, triangles, sourceTriangles, points, vertexNormals,
+                          cornerSpaces);
+
+    // Corners of degenerate triangles copy the first corner of a usable triangle at the same welded vertex
+    std::vector<uint32_t> firstCorner(vertexCount, Unassigned);
+    for (size_t c = 0; c < triangleVertices.size(); ++c) {
+        if (firstCorner[triangleVertices[c]] == Unassigned) {
+            firstCorner[triangleVertices[c]] = static_cast<uint32_t>(3 * sourceTriangles[c / 3] + c % 3);
+        }
+    }
+    for (size_t d = 0; d < degenerateTriangles.size(); ++d) {
+        for (size_t c = 3 * degenerateTriangles[d]; c < 3 * degenerateTriangles[d] + 3; ++c) {
+            const uint32_t source = firstCorner[canonical[indices[c]]];
+            if (source != Unassigned) {
+                cornerSpaces[c] = cornerSpaces[source];
+            }
+        }
+    }
+
+    // Give each vertex the tangent space of its first corner, and split off a copy for each other distinct space
+    std::vector<uint32_t> outputCorners(vertexCount, Unassigned);
+    std::vector<uint32_t> nextVariants(vertexCount, Unassigned);
+    std::vector<uint32_t> remappedIndices(indices, indices + indexCount);
+    for (size_t c = 0; c < 3 * triangleCount; ++c) {
+        uint32_t v = indices[c];
+        if (outputCorners[v] == Unassigned) {
+            outputCorners[v] = static_cast<uint32_t>(c);
+            continue;
+        }
+        while (!sameTangentSpace(cornerSpaces[outputCorners[v]], cornerSpaces[c])) {
+            if (nextVariants[v] == Unassigned) {
+                nextVariants[v] = static_cast<uint32_t>(outputCorners.size());
+                outputCorners.push_back(static_cast<uint32_t>(c));
+                nextVariants.push_back(Unassigned);
+                result.splitSourceVertices.push_back(indices[c]);
+            }
+            v = nextVariants[v];
+        }
+        remappedIndices[c] = v;
+    }
+
+    result.tangents.resize(4 * outputCorners.size());
+    for (size_t v = 0; v < outputCorners.size(); ++v) {
+        // Vertices that no triangle uses get an arbitrary tangent
+        const TangentSpace &space = (outputCorners[v] != Unassigned) ? cornerSpaces[outputCorners[v]] : defaultSpace;
+        result.tangents[4 * v + 0] = space.tangent.x;
+        result.tangents[4 * v + 1] = space.tangent.y;
+        result.tangents[4 * v + 2] = space.tangent.z;
+        result.tangents[4 * v + 3] = space.orientPreserving ? 1.0f : -1.0f;
+    }
+    if (!result.splitSourceVertices.empty()) {
+        result.indices.swap(remappedIndices);
+    }
+    return true;
+}
+
+} // namespace GLTF
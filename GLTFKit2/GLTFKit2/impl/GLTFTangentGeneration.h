@@ -0,0 +1,24 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+struct GeneratedTangents {
+    std::vector<float> tangents;               // Four components (xyz and handedness) per output vertex
+    std::vector<uint32_t> splitSourceVertices; // The input vertex copied by each output vertex past the input vertex count
+    std::vector<uint32_t> indices;             // The rewritten triangle list; empty unless vertices were split
+};
+
+/// Generates the tangents that the reference MikkTSpace implementation produces, with its default settings, for the
+/// triangle list `indices`, with the texture coordinate frame given by `texCoords`. Texture coordinates are taken in
+/// the glTF convention, with the origin at the top left, so the handedness in w is that expected by glTF. MikkTSpace
+/// assigns a tangent to every triangle corner; a vertex whose corners receive different tangents (as along a mirrored
+/// UV seam) is split so that each gets its own. Returns false if the views are invalid or an index is out of range.
+bool GenerateTangents(const AccessorView &positions, const AccessorView &normals, const AccessorView &texCoords,
+                      const uint32_t *indices, size_t indexCount, GeneratedTangents &result);
+
+} // namespace GLTF
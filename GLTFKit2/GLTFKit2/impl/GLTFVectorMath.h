@@ -0,0 +1,62 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <cmath>
+#include <vector>
+
+// Minimal portable vector math for the geometry processing kernels.
+
+namespace GLTF {
+
+struct Vec3 {
+    float x, y, z;
+};
+
+inline Vec3 MakeVec3(float x, float y, float z) {
+    Vec3 v = { x, y, z };
+    return v;
+}
+
+inline Vec3 operator+(Vec3 a, Vec3 b) { return MakeVec3(a.x + b.x, a.y + b.y, a.z + b.z); }
+inline Vec3 operator-(Vec3 a, Vec3 b) { return MakeVec3(a.x - b.x, a.y - b.y, a.z - b.z); }
+inline Vec3 operator*(Vec3 a, float s) { return MakeVec3(a.x * s, a.y * s, a.z * s); }
+inline Vec3 &operator+=(Vec3 &a, Vec3 b) { a = a + b; return a; }
+
+inline float Dot(Vec3 a, Vec3 b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vec3 Cross(Vec3 a, Vec3 b) {
+    return MakeVec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+inline float Length(Vec3 v) {
+    return std::sqrt(Dot(v, v));
+}
+
+/// Returns `v` scaled to unit length, or `fallback` if `v` is too short to normalize.
+inline Vec3 Normalize(Vec3 v, Vec3 fallback) {
+    const float length = Length(v);
+    return (length > 1e-20f) ? v * (1.0f / length) : fallback;
+}
+
+inline Vec3 Min(Vec3 a, Vec3 b) {
+    return MakeVec3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z));
+}
+
+inline Vec3 Max(Vec3 a, Vec3 b) {
+    return MakeVec3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z));
+}
+
+/// Decodes the first three components of every element of `view` (such as a POSITION accessor) to floats.
+inline std::vector<Vec3> ReadVec3s(const AccessorView &view) {
+    std::vector<Vec3> values(view.count, MakeVec3(0.0f, 0.0f, 0.0f));
+    for (size_t i = 0; i < view.count; ++i) {
+        ReadFloats(view, i, &values[i].x, 3);
+    }
+    return values;
+}
+
+} // namespace GLTF
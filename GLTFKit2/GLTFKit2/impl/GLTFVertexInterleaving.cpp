@@ -0,0 +1,196 @@
+
+#include "GLTFVertexInterleaving.h"
+#include "GLTFParallel.h"
+
+namespace GLTF {
+
+namespace {
+
+// Vertices per tile. A tile of destination vertices stays resident in cache while
+// each of its attributes is written, and tiles are the unit of parallel work.
+const size_t VertexTileSize = 2048;
+
+// Returns true if the source components can be copied bit-for-bit into the destination format.
+bool isBitwiseCompatible(const VertexStream &stream) {
+    if (stream.flipTexCoordVertical || stream.source.componentCount != stream.componentCount) {
+        return false;
+    }
+    const AccessorView &source = stream.source;
+    switch (stream.format) {
+        case VertexComponentFormatFloat:
+            return source.componentType == ComponentTypeFloat;
+        case VertexComponentFormatSNorm8:
+            return source.componentType == ComponentTypeByte && source.normalized;
+        case VertexComponentFormatUNorm8:
+            return source.componentType == ComponentTypeUnsignedByte && source.normalized;
+        case VertexComponentFormatSNorm16:
+            return source.componentType == ComponentTypeShort && source.normalized;
+        case VertexComponentFormatUNorm16:
+            return source.componentType == ComponentTypeUnsignedShort && source.normalized;
+        case VertexComponentFormatUInt8:
+            return source.componentType == ComponentTypeUnsignedByte && !source.normalized;
+        case VertexComponentFormatUInt16:
+            return source.componentType == ComponentTypeUnsignedShort && !source.normalized;
+        case VertexComponentFormatUInt32:
+            return source.componentType == ComponentTypeUnsignedInt;
+        default:
+            return false;
+    }
+}
+
+template <size_t ElementSize>
+void copyElements(const AccessorView &source, size_t begin, size_t end, size_t stride, uint8_t *dst) {
+    for (size_t v = begin; v < end; ++v) {
+        memcpy(dst + v * stride, source.element(v), ElementSize);
+    }
+}
+
+void copyElements(const AccessorView &source, size_t begin, size_t end, size_t stride, size_t elementSize, uint8_t *dst) {
+    switch (elementSize) {
+        case 2:  copyElements<2>(source, begin, end, stride, dst); break;
+        case 4:  copyElements<4>(source, begin, end, stride, dst); break;
+        case 8:  copyElements<8>(source, begin, end, stride, dst); break;
+        case 12: copyElements<12>(source, begin, end, stride, dst); break;
+        case 16: copyElements<16>(source, begin, end, stride, dst); break;
+        default:
+            for (size_t v = begin; v < end; ++v) {
+                memcpy(dst + v * stride, source.element(v), elementSize);
+            }
+            break;
+    }
+}
+
+template <int Format>
+void storeComponent(float value, uint8_t *dst, int c);
+
+template <> void storeComponent<VertexComponentFormatFloat>(float value, uint8_t *dst, int c) {
+    StoreUnaligned<float>(dst + c * sizeof(float), value);
+}
+
+template <> void storeComponent<VertexComponentFormatHalf>(float value, uint8_t *dst, int c) {
+    StoreUnaligned<uint16_t>(dst + c * sizeof(uint16_t), FloatToHalf(value));
+}
+
+template <> void storeComponent<VertexComponentFormatSNorm8>(float value, uint8_t *dst, int c) {
+    dst[c] = static_cast<uint8_t>(FloatToSNorm8(value));
+}
+
+template <> void storeComponent<VertexComponentFormatUNorm8>(float value, uint8_t *dst, int c) {
+    dst[c] = FloatToUNorm8(value);
+}
+
+template <> void storeComponent<VertexComponentFormatSNorm16>(float value, uint8_t *dst, int c) {
+    StoreUnaligned<int16_t>(dst + c * sizeof(int16_t), FloatToSNorm16(value));
+}
+
+template <> void storeComponent<VertexComponentFormatUNorm16>(float value, uint8_t *dst, int c) {
+    StoreUnaligned<uint16_t>(dst + c * sizeof(uint16_t), FloatToUNorm16(value));
+}
+
+template <> void storeComponent<VertexComponentFormatUInt8>(float value, uint8_t *dst, int c) {
+    dst[c] = static_cast<uint8_t>(std::min(std::max(value, 0.0f), 255.0f));
+}
+
+template <> void storeComponent<VertexComponentFormatUInt16>(float value, uint8_t *dst, int c) {
+    StoreUnaligned<uint16_t>(dst + c * sizeof(uint16_t), static_cast<uint16_t>(std::min(std::max(value, 0.0f), 65535.0f)));
+}
+
+template <> void storeComponent<VertexComponentFormatUInt32>(float value, uint8_t *dst, int c) {
+    StoreUnaligned<uint32_t>(dst + c * sizeof(uint32_t), static_cast<uint32_t>(std::max(value, 0.0f)));
+}
+
+template <int Format>
+void convertElements(const AccessorView &source, int componentCount, bool flipTexCoordVertical,
+                     size_t begin, size_t end, size_t stride, uint8_t *dst)
+{
+    for (size_t v = begin; v < end; ++v) {
+        float values[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        if (v < source.count) {
+            ReadFloats(source, v, values, componentCount);
+            if (flipTexCoordVertical) {
+                values[1] = 1.0f - values[1];
+            }
+        }
+        uint8_t *vertex = dst + v * stride;
+        for (int c = 0; c < componentCount; ++c) {
+            storeComponent<Format>(values[c], vertex, c);
+        }
+    }
+}
+
+void convertElements(const VertexStream &stream, size_t begin, size_t end, size_t stride, uint8_t *dst) {
+    const int componentCount = std::min(std::max(stream.componentCount, 1), 4);
+    // An invalid source has a count of zero, so every vertex receives the default value.
+    const AccessorView source = stream.source.isValid() ? stream.source : AccessorView();
+    const bool flip = stream.flipTexCoordVertical;
+    switch (stream.format) {
+        case VertexComponentFormatFloat:
+            convertElements<VertexComponentFormatFloat>(source, componentCount, flip, begin, end, stride, dst);
+            break;
+        case VertexComponentFormatHalf:
+            convertElements<VertexComponentFormatHalf>(source, componentCount, flip, begin, end, stride, dst);
+            break;
+        case VertexComponentFormatSNorm8:
+            convertElements<VertexComponentFormatSNorm8>(source, componentCount, flip, begin, end, stride, dst);
+            break;
+        case VertexComponentFormatUNorm8:
+            convertElements<VertexComponentFormatUNorm8>(source, componentCount, flip, begin, end, stride, dst);
+            break;
+        case VertexComponentFormatSNorm16:
+            convertElements<VertexComponentFormatSNorm16>(source, componentCount, flip, begin, end, stride, dst);
+            break;
+        case VertexComponentFormatUNorm16:
+            convertElements<VertexComponentFormatUNorm16>(source, componentCount, flip, begin, end, stride, dst);
+            break;
+        case VertexComponentFormatUInt8:
+            convertElements<VertexComponentFormatUInt8>(source, componentCount, flip, begin, end, stride, dst);
+            break;
+        case VertexComponentFormatUInt16:
+            convertElements<VertexComponentFormatUInt16>(source, componentCount, flip, begin, end, stride, dst);
+            break;
+        case VertexComponentFormatUInt32:
+            convertElements<VertexComponentFormatUInt32>(source, componentCount, flip, begin, end, stride, dst);
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace
+
+size_t BytesPerVertexComponent(int format) {
+    switch (format) {
+        case VertexComponentFormatFloat:
+        case VertexComponentFormatUInt32:
+            return 4;
+        case VertexComponentFormatHalf:
+        case VertexComponentFormatSNorm16:
+        case VertexComponentFormatUNorm16:
+        case VertexComponentFormatUInt16:
+            return 2;
+        case VertexComponentFormatSNorm8:
+        case VertexComponentFormatUNorm8:
+        case VertexComponentFormatUInt8:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+void InterleaveVertexStreams(const VertexStream *streams, size_t streamCount, size_t vertexCount,
+                             size_t stride, uint8_t *destination)
+{
+    ParallelFor(vertexCount, VertexTileSize, [=](size_t begin, size_t end) {
+        for (size_t s = 0; s < streamCount; ++s) {
+            const VertexStream &stream = streams[s];
+            uint8_t *dst = destination + stream.offset;
+            if (stream.source.isValid() && isBitwiseCompatible(stream) && end <= stream.source.count) {
+                copyElements(stream.source, begin, end, stride, stream.source.elementSize(), dst);
+            } else {
+                convertElements(stream, begin, end, stride, dst);
+            }
+        }
+    });
+}
+
+} // namespace GLTF
@@ -0,0 +1,40 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GLTF {
+
+// These mirror the values of GLTFVertexComponentFormat.
+enum VertexComponentFormat : int {
+    VertexComponentFormatFloat,
+    VertexComponentFormatHalf,
+    VertexComponentFormatSNorm8,
+    VertexComponentFormatUNorm8,
+    VertexComponentFormatSNorm16,
+    VertexComponentFormatUNorm16,
+    VertexComponentFormatUInt8,
+    VertexComponentFormatUInt16,
+    VertexComponentFormatUInt32,
+};
+
+size_t BytesPerVertexComponent(int format);
+
+struct VertexStream {
+    AccessorView source;     // If invalid, the attribute is filled with (0, 0, 0, 1)
+    int format = VertexComponentFormatFloat;
+    int componentCount = 0;  // Components written per vertex, from 1 to 4
+    size_t offset = 0;       // Offset of the attribute within each vertex
+    bool flipTexCoordVertical = false; // Replace the second component v with 1 - v
+};
+
+/// Writes `vertexCount` interleaved vertices of `stride` bytes into `destination`, converting each stream from
+/// its source accessor to its destination format. Components missing from a source are filled as by vertex fetch
+/// (0 for x, y, z and 1 for w). Large vertex counts are split into tiles that are converted concurrently.
+void InterleaveVertexStreams(const VertexStream *streams, size_t streamCount, size_t vertexCount,
+                             size_t stride, uint8_t *destination);
+
+} // namespace GLTF
@@ -0,0 +1,163 @@
+
+#include "GLTFVertexWelding.h"
+#include "GLTFParallel.h"
+
+#include <cmath>
+
+namespace GLTF {
+
+namespace {
+
+// Vertices per unit of parallel work when hashing
+const size_t VertexGrainSize = 1 << 16;
+
+// Rounded keys lie strictly between -2^62 and 2^62, so that as unsigned words they never have the top two bits 10
+// that mark the keys of unrounded values
+const double MaxRoundedMultiple = 4611686018427387904.0;
+
+inline uint32_t mixHash(uint32_t hash, uint32_t word) {
+    word *= 0xcc9e2d51u;
+    word = (word << 15) | (word >> 17);
+    word *= 0x1b873593u;
+    hash ^= word;
+    hash = (hash << 13) | (hash >> 19);
+    return hash * 5 + 0xe6546b64u;
+}
+
+inline uint32_t finalizeHash(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    return hash ^ (hash >> 16);
+}
+
+class VertexComparator {
+public:
+    VertexComparator(const std::vector<AccessorView> &vertexStreams, float epsilon)
+        : streams(vertexStreams), inverseEpsilon((epsilon > 0.0f) ? 1.0 / epsilon : 0.0) {}
+
+    uint32_t hash(size_t v) const {
+        uint32_t h = 0;
+        for (const AccessorView &stream : streams) {
+            const uint8_t *element = stream.element(v);
+            if (stream.componentType == ComponentTypeFloat) {
+                for (int c = 0; c < stream.componentCount; ++c) {
+                    const uint64_t key = floatKey(LoadUnaligned<float>(element + c * sizeof(float)));
+                    h = mixHash(mixHash(h, static_cast<uint32_t>(key)), static_cast<uint32_t>(key >> 32));
+                }
+            } else {
+                const size_t size = stream.elementSize();
+                for (size_t i = 0; i < size; ++i) {
+                    h = mixHash(h, element[i]);
+                }
+            }
+        }
+        return finalizeHash(h);
+    }
+
+    bool equal(size_t a, size_t b) const {
+        for (const AccessorView &stream : streams) {
+            const uint8_t *elementA = stream.element(a);
+            const uint8_t *elementB = stream.element(b);
+            if (stream.componentType == ComponentTypeFloat) {
+                for (int c = 0; c < stream.componentCount; ++c) {
+                    if (floatKey(LoadUnaligned<float>(elementA + c * sizeof(float))) !=
+                        floatKey(LoadUnaligned<float>(elementB + c * sizeof(float))))
+                    {
+                        return false;
+                    }
+                }
+            } else if (memcmp(elementA, elementB, stream.elementSize()) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const std::vector<AccessorView> &streams;
+    const double inverseEpsilon;
+
+    // The value a float component is compared by: its bits (with -0 folded into 0), or its nearest multiple of
+    // epsilon. Values too large for the multiple to be represented (beyond 2^62 multiples) and non-finite values
+    // are compared by their bits; the two kinds of key are kept apart by their top bits.
+    uint64_t floatKey(float value) const {
+        if (inverseEpsilon > 0.0 && std::isfinite(value)) {
+            const double multiple = std::floor(value * inverseEpsilon + 0.5);
+            if (std::fabs(multiple) < MaxRoundedMultiple) {
+                return static_cast<uint64_t>(static_cast<int64_t>(multiple));
+            }
+        }
+        value += 0.0f;
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (inverseEpsilon > 0.0) ? (0x8000000000000000ull | bits) : bits;
+    }
+};
+
+} // namespace
+
+bool WeldVertices(const std::vector<AccessorView> &streams, size_t vertexCount, const uint32_t *indices,
+                  size_t indexCount, float epsilon, std::vector<uint32_t> &outSourceVertices,
+                  std::vector<uint32_t> &outIndices)
+{
+    outSourceVertices.clear();
+    outIndices.clear();
+    for (const AccessorView &stream : streams) {
+        if (!stream.isValid() || stream.count != vertexCount) {
+            return false;
+        }
+    }
+    if (indices) {
+        for (size_t i = 0; i < indexCount; ++i) {
+            if (indices[i] >= vertexCount) {
+                return false;
+            }
+        }
+    } else {
+        indexCount = vertexCount;
+    }
+
+    const VertexComparator comparator(streams, epsilon);
+    std::vector<uint32_t> hashes(vertexCount);
+    ParallelFor(vertexCount, VertexGrainSize, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            hashes[v] = comparator.hash(v);
+        }
+    });
+
+    // Linear probing over a power-of-two table at most 80% full
+    size_t capacity = 1;
+    while (capacity < vertexCount + vertexCount / 4 + 1) {
+        capacity *= 2;
+    }
+    const uint32_t Empty = UINT32_MAX;
+    std::vector<uint32_t> table(capacity, Empty);
+    std::vector<uint32_t> newIndexForVertex(vertexCount, Empty);
+    outIndices.resize(indexCount);
+    for (size_t i = 0; i < indexCount; ++i) {
+        const uint32_t v = indices ? indices[i] : static_cast<uint32_t>(i);
+        if (newIndexForVertex[v] == Empty) {
+            size_t slot = hashes[v] & (capacity - 1);
+            while (table[slot] != Empty) {
+                const uint32_t other = table[slot];
+                if (hashes[other] == hashes[v] && comparator.equal(other, v)) {
+                    break;
+                }
+                slot = (slot + 1) & (capacity - 1);
+            }
+            if (table[slot] == Empty) {
+                table[slot] = v;
+                newIndexForVertex[v] = static_cast<uint32_t>(outSourceVertices.size());
+                outSourceVertices.push_back(v);
+            } else {
+                newIndexForVertex[v] = newIndexForVertex[table[slot]];
+            }
+        }
+        outIndices[i] = newIndexForVertex[v];
+    }
+    return true;
+}
+
+} // namespace GLTF
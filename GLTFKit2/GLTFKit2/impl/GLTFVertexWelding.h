@@ -0,0 +1,22 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <vector>
+
+namespace GLTF {
+
+/// Finds vertices whose elements are equal in every one of `streams` (which must all have `vertexCount` elements)
+/// and assigns each distinct vertex a new index, in order of first use by `indices` (or of vertex index, if
+/// `indices` is null). Float components are compared exactly if `epsilon` is zero, and otherwise after rounding to
+/// a multiple of `epsilon` (except for non-finite values, and those more than 2^62 multiples from zero, which are
+/// compared exactly); other components are compared exactly. On return, `outSourceVertices` lists the old
+/// vertex copied by each new vertex, and `outIndices` holds `indices` rewritten to the new vertices. Unreferenced
+/// vertices are dropped. Vertices are found through an open-addressing table of vertex indices, so memory beyond
+/// the output is about 12 to 16 bytes per vertex. Returns false if an index is out of range.
+bool WeldVertices(const std::vector<AccessorView> &streams, size_t vertexCount, const uint32_t *indices,
+                  size_t indexCount, float epsilon, std::vector<uint32_t> &outSourceVertices,
+                  std::vector<uint32_t> &outIndices);
+
+} // namespace GLTF
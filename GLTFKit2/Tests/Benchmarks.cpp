@@ -0,0 +1,788 @@
+#include "GLTFAnimationCompression.h"
+#include "GLTFBoundsComputation.h"
+#include "GLTFIndexProcessing.h"
+#include "GLTFMeshletBuilder.h"
+#include "GLTFMorphBlending.h"
+#include "GLTFSceneBounds.h"
+#include "GLTFSceneGraph.h"
+#include "GLTFTangentGeneration.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Timings of the kernels on generated data, so that changes to them can be measured on any platform. Each benchmark
+// prints the median and fastest of several runs, with whatever figures describe the quality of its output.
+//
+//     GLTFKitBenchmarks [name...]
+
+namespace {
+
+typedef void (*BenchmarkFunction)();
+
+struct Benchmark {
+    const char *name;
+    BenchmarkFunction function;
+};
+
+std::vector<Benchmark> &registeredBenchmarks() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct BenchmarkRegistrar {
+    BenchmarkRegistrar(const char *name, BenchmarkFunction function) {
+        Benchmark benchmark = { name, function };
+        registeredBenchmarks().push_back(benchmark);
+    }
+};
+
+#define GLTF_BENCHMARK(name)                                                                                    \
+    void name();                                                                                                \
+    BenchmarkRegistrar name##Registrar(#name, &name);                                                           \
+    void name()
+
+const int RunCount = 9;
+
+// Prints the median and fastest time of `RunCount` runs of `body` after one warm-up run, per item if `itemCount`
+// is not zero. Returns the median in seconds.
+template <typename Body>
+double measure(const char *label, size_t itemCount, const Body &body) {
+    body();
+    std::vector<double> seconds;
+    for (int run = 0; run < RunCount; ++run) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        body();
+        seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(seconds.begin(), seconds.end());
+    const double median = seconds[RunCount / 2];
+    if (itemCount > 0) {
+        printf("  %-36s %10.3f ms median %10.3f ms best %10.2f ns/item\n", label, median * 1e3, seconds[0] * 1e3,
+               median * 1e9 / itemCount);
+    } else {
+        printf("  %-36s %10.3f ms median %10.3f ms best\n", label, median * 1e3, seconds[0] * 1e3);
+    }
+    return median;
+}
+
+// A square grid of `size` by `size` quads over a gentle wave, as two triangles per quad
+struct GridMesh {
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+};
+
+GridMesh makeGridMesh(uint32_t size) {
+    GridMesh mesh;
+    mesh.positions.reserve(3 * (size + 1) * (size + 1));
+    for (uint32_t y = 0; y <= size; ++y) {
+        for (uint32_t x = 0; x <= size; ++x) {
+            mesh.positions.push_back(float(x));
+            mesh.positions.push_back(float(y));
+            mesh.positions.push_back(std::sin(0.1f * x) * std::cos(0.1f * y));
+        }
+    }
+    mesh.indices.reserve(6 * size * size);
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            const uint32_t a = y * (size + 1) + x, b = a + 1, c = a + size + 1, d = c + 1;
+            const uint32_t quad[6] = { a, b, d, a, d, c };
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+    return mesh;
+}
+
+GLTF::AccessorView floatView(const std::vector<float> &values, int componentCount) {
+    GLTF::AccessorView view;
+    view.data = reinterpret_cast<const uint8_t *>(values.data());
+    view.stride = sizeof(float) * componentCount;
+    view.count = values.size() / componentCount;
+    view.componentType = GLTF::ComponentTypeFloat;
+    view.componentCount = componentCount;
+    return view;
+}
+
+GLTF_BENCHMARK(MeshletBuilding) {
+    const GridMesh mesh = makeGridMesh(512);
+    const GLTF::AccessorView positions = floatView(mesh.positions, 3);
+    const size_t triangleCount = mesh.indices.size() / 3;
+    printf("  %zu triangles, %zu vertices\n", triangleCount, positions.count);
+
+    const size_t limits[][2] = { { 64, 124 }, { 128, 256 } };
+    for (const size_t *limit : limits) {
+        GLTF::MeshletSet meshlets;
+        char label[64];
+        snprintf(label, sizeof(label), "%zu vertices, %zu triangles", limit[0], limit[1]);
+        measure(label, triangleCount, [&]() {
+            GLTF::MeshletSet result;
+            GLTF::BuildMeshlets(positions, mesh.indices.data(), mesh.indices.size(), limit[0], limit[1], result);
+            meshlets.meshlets.swap(result.meshlets);
+            meshlets.vertices.swap(result.vertices);
+        });
+        // A perfectly full meshlet reaches the triangle limit; vertices per triangle measure their compactness
+        printf("  %-36s %10zu meshlets %8.1f%% full %8.3f vertices/triangle\n", "", meshlets.meshlets.size(),
+               100.0 * triangleCount / (meshlets.meshlets.size() * limit[1]),
+               double(meshlets.vertices.size()) / triangleCount);
+    }
+}
+
+GLTF_BENCHMARK(IndexConversion) {
+    // Widening and narrowing against a plain loop, which the compiler may also vectorize, then topology rewriting
+    const size_t indexCount = 1 << 22;
+    std::vector<uint8_t> bytes(indexCount);
+    std::vector<uint16_t> shorts(indexCount);
+    std::vector<uint32_t> ints(indexCount);
+    for (size_t i = 0; i < indexCount; ++i) {
+        bytes[i] = uint8_t(i * 7 % 251);
+        shorts[i] = uint16_t(i * 7 % 65521);
+        ints[i] = uint32_t(i * 7 % 65521);
+    }
+    printf("  %zu indices\n", indexCount);
+
+    std::vector<uint16_t> shortResult(indexCount);
+    std::vector<uint32_t> intResult(indexCount);
+    measure("8 to 16 bits", indexCount, [&]() {
+        GLTF::ConvertIndices(bytes.data(), indexCount, shortResult.data());
+    });
+    measure("8 to 32 bits", indexCount, [&]() {
+        GLTF::ConvertIndices(bytes.data(), indexCount, intResult.data());
+    });
+    measure("16 to 32 bits", indexCount, [&]() {
+        GLTF::ConvertIndices(shorts.data(), indexCount, intResult.data());
+    });
+    measure("16 to 32 bits, scalar loop", indexCount, [&]() {
+        for (size_t i = 0; i < indexCount; ++i) {
+            intResult[i] = (shorts[i] == 0xFFFF) ? 0xFFFFFFFFu : shorts[i];
+        }
+    });
+    measure("32 to 16 bits", indexCount, [&]() {
+        GLTF::ConvertIndices(ints.data(), indexCount, shortResult.data());
+    });
+    uint32_t maxIndex = 0;
+    measure("max index, 32 bits", indexCount, [&]() {
+        maxIndex = GLTF::MaxIndexValue(ints.data(), indexCount);
+    });
+
+    // Strips of 64 indices separated by restarts, and a single long fan
+    std::vector<uint32_t> strips(indexCount);
+    for (size_t i = 0; i < indexCount; ++i) {
+        strips[i] = (i % 65 == 64) ? GLTF::RestartIndex<uint32_t>() : uint32_t(i);
+    }
+    std::vector<uint32_t> lists(GLTF::ListIndexCountUpperBound(GLTF::PrimitiveTopologyTriangleStrip, indexCount));
+    size_t listCount = 0;
+    measure("strip to list (per strip index)", indexCount, [&]() {
+        listCount = GLTF::ConvertIndicesToListTopology(GLTF::PrimitiveTopologyTriangleStrip, strips.data(),
+                                                       indexCount, lists.data());
+    });
+    printf("  %-36s %10zu triangles\n", "", listCount / 3);
+    measure("fan to list (per fan index)", indexCount, [&]() {
+        listCount = GLTF::ConvertIndicesToListTopology(GLTF::PrimitiveTopologyTriangleFan, ints.data() + 1,
+                                                       indexCount - 1, lists.data());
+    });
+    printf("  %-36s %10zu triangles, max index %u\n", "", listCount / 3, maxIndex);
+}
+
+// A read-only view of `tileCount` consecutive copies of a `tileSize`-byte temporary file, so that a region of many
+// gigabytes is dense (every page holds data) while occupying only one tile of memory.
+struct RepeatedMapping {
+    int fd = -1;
+    uint8_t *base = nullptr;
+    size_t length = 0;
+
+    ~RepeatedMapping() {
+        if (base != nullptr) {
+            munmap(base, length);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool create(const std::vector<uint8_t> &tile, size_t tileCount) {
+        char path[] = "/tmp/GLTFKitBenchmarkXXXXXX";
+        fd = mkstemp(path);
+        if (fd < 0) {
+            return false;
+        }
+        unlink(path);
+        if (write(fd, tile.data(), tile.size()) != static_cast<ssize_t>(tile.size())) {
+            return false;
+        }
+        length = tile.size() * tileCount;
+        void *reserved = mmap(nullptr, length, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reserved == MAP_FAILED) {
+            return false;
+        }
+        base = static_cast<uint8_t *>(reserved);
+        for (size_t t = 0; t < tileCount; ++t) {
+            if (mmap(base + t * tile.size(), tile.size(), PROT_READ, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// The strided path of GLTFPackedDataForAccessor, with the same 64-bit counters
+void copyPackedElements(const GLTF::AccessorView &view, uint8_t *dst) {
+    const size_t elementSize = view.elementSize();
+    for (size_t i = 0; i < view.count; ++i) {
+        memcpy(dst + i * elementSize, view.data + i * view.stride, elementSize);
+    }
+}
+
+GLTF_BENCHMARK(LargeOffsets) {
+    // Float positions in 64-byte interleaved vertices. Each tile is larger than the caches, so both the small buffer
+    // and the large region stream from memory, and only the size of the offsets differs.
+    const size_t vertexStride = 64;
+    const size_t tileSize = size_t(64) << 20;
+    const size_t tileCount = 72; // 4.5 GB
+    if (sizeof(size_t) < 8) {
+        printf("  skipped: needs a 64-bit address space\n");
+        return;
+    }
+    std::vector<uint8_t> tile(tileSize, 0);
+    for (size_t v = 0; v < tileSize / vertexStride; ++v) {
+        const float position[3] = { float(v % 1000), float(v % 777) * -0.5f, 2.0f };
+        memcpy(&tile[v * vertexStride], position, sizeof(position));
+    }
+    RepeatedMapping mapping;
+    if (!mapping.create(tile, tileCount)) {
+        printf("  skipped: could not map %zu copies of a %zu MB file\n", tileCount, tileSize >> 20);
+        return;
+    }
+
+    GLTF::AccessorView small;
+    small.data = mapping.base;
+    small.stride = vertexStride;
+    small.count = tileSize / vertexStride;
+    small.componentType = GLTF::ComponentTypeFloat;
+    small.componentCount = 3;
+    GLTF::AccessorView large = small;
+    large.count = mapping.length / vertexStride;
+    printf("  %zu vertices (%zu MB) against %zu vertices (%.2f GB), the last at offset %zu\n", small.count,
+           tileSize >> 20, large.count, mapping.length / double(1 << 30), (large.count - 1) * vertexStride);
+
+    double lo[3], hi[3];
+    const double smallBounds = measure("bounds, small buffer", small.count, [&]() {
+        GLTF::ComputeComponentBounds(small, lo, hi);
+    });
+    const double largeBounds = measure("bounds, > 4 GB region", large.count, [&]() {
+        GLTF::ComputeComponentBounds(large, lo, hi);
+    });
+    printf("  %-36s %10.2fx per vertex, max %g %g %g\n", "", (largeBounds / large.count) / (smallBounds / small.count),
+           hi[0], hi[1], hi[2]);
+
+    std::vector<uint8_t> packed(large.count * large.elementSize());
+    const double smallCopy = measure("strided copy, small buffer", small.count, [&]() {
+        copyPackedElements(small, packed.data());
+    });
+    const double largeCopy = measure("strided copy, > 4 GB region", large.count, [&]() {
+        copyPackedElements(large, packed.data());
+    });
+    float last[3];
+    memcpy(last, &packed[(large.count - 1) * large.elementSize()], sizeof(last));
+    printf("  %-36s %10.2fx per vertex, last %g %g %g\n", "", (largeCopy / large.count) / (smallCopy / small.count),
+           last[0], last[1], last[2]);
+}
+
+GLTF_BENCHMARK(TangentGeneration) {
+    // The wave grid with its analytic normals, textured once across, and again with the texture mirrored across the
+    // middle column so that a seam of vertices is split
+    const uint32_t size = 512;
+    const GridMesh mesh = makeGridMesh(size);
+    const size_t vertexCount = mesh.positions.size() / 3;
+    std::vector<float> normals, texCoords, mirroredTexCoords;
+    normals.reserve(3 * vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const float x = mesh.positions[3 * v], y = mesh.positions[3 * v + 1];
+        const float dzdx = 0.1f * std::cos(0.1f * x) * std::cos(0.1f * y);
+        const float dzdy = -0.1f * std::sin(0.1f * x) * std::sin(0.1f * y);
+        const float length = std::sqrt(dzdx * dzdx + dzdy * dzdy + 1.0f);
+        normals.push_back(-dzdx / length);
+        normals.push_back(-dzdy / length);
+        normals.push_back(1.0f / length);
+        texCoords.push_back(x / size);
+        texCoords.push_back(1.0f - y / size);
+        mirroredTexCoords.push_back(std::fabs(2.0f * x / size - 1.0f));
+        mirroredTexCoords.push_back(1.0f - y / size);
+    }
+    const size_t triangleCount = mesh.indices.size() / 3;
+    printf("  %zu triangles, %zu vertices\n", triangleCount, vertexCount);
+
+    const std::vector<float> *mappings[] = { &texCoords, &mirroredTexCoords };
+    const char *labels[] = { "continuous mapping (per triangle)", "mirrored mapping (per triangle)" };
+    for (int m = 0; m < 2; ++m) {
+        GLTF::GeneratedTangents generated;
+        measure(labels[m], triangleCount, [&]() {
+            GLTF::GenerateTangents(floatView(mesh.positions, 3), floatView(normals, 3), floatView(*mappings[m], 2),
+                                   mesh.indices.data(), mesh.indices.size(), generated);
+        });
+        printf("  %-36s %10zu split vertices\n", "", generated.splitSourceVertices.size());
+    }
+}
+
+// A clip of `nodeCount` nodes, each with linear translation, rotation and scale tracks keyed at `keyRate` for
+// `duration` seconds, moving as a character's joints might: smooth oscillations at varied rates, with scale
+// constant on most nodes
+GLTF::AnimationClip makeAnimationClip(uint32_t nodeCount, float duration, float keyRate) {
+    GLTF::AnimationClip clip;
+    const size_t keyCount = static_cast<size_t>(duration * keyRate) + 1;
+    std::vector<float> times(keyCount);
+    for (size_t k = 0; k < keyCount; ++k) {
+        times[k] = k / keyRate;
+    }
+    for (uint32_t node = 0; node < nodeCount; ++node) {
+        const float rate = 0.5f + 0.37f * (node % 7), phase = 0.61f * node;
+        std::vector<float> translations, rotations, scales;
+        for (float t : times) {
+            translations.push_back(0.1f * std::sin(rate * t + phase));
+            translations.push_back(1.0f + 0.05f * std::cos(2.0f * rate * t));
+            translations.push_back(0.0f);
+            const float angle = 0.8f * std::sin(rate * t + phase);
+            const float axisLength = std::sqrt(1.0f + 0.09f);
+            rotations.push_back(std::sin(0.5f * angle) / axisLength);
+            rotations.push_back(0.0f);
+            rotations.push_back(0.3f * std::sin(0.5f * angle) / axisLength);
+            rotations.push_back(std::cos(0.5f * angle));
+            const float scale = (node % 5 == 0) ? 1.0f + 0.1f * std::sin(rate * t) : 1.0f;
+            scales.insert(scales.end(), 3, scale);
+        }
+        clip.addTrack(GLTF::AnimationPathTranslation, GLTF::InterpolationLinear, node, 3, floatView(times, 1),
+                      floatView(translations, 3));
+        clip.addTrack(GLTF::AnimationPathRotation, GLTF::InterpolationLinear, node, 4, floatView(times, 1),
+                      floatView(rotations, 4));
+        clip.addTrack(GLTF::AnimationPathScale, GLTF::InterpolationLinear, node, 3, floatView(times, 1),
+                      floatView(scales, 3));
+    }
+    return clip;
+}
+
+GLTF::AnimationPose makeAnimationPose(size_t nodeCount) {
+    GLTF::AnimationPose pose;
+    pose.translations.assign(3 * nodeCount, 0.0f);
+    pose.rotations.assign(4 * nodeCount, 0.0f);
+    pose.scales.assign(3 * nodeCount, 1.0f);
+    return pose;
+}
+
+GLTF_BENCHMARK(AnimationCompression) {
+    const uint32_t nodeCount = 80;
+    const GLTF::AnimationClip clip = makeAnimationClip(nodeCount, 20.0f, 30.0f);
+    printf("  %u nodes, %zu tracks, %.0f s at 30 keys/s\n", nodeCount, clip.tracks().size(), clip.duration());
+
+    GLTF::AnimationCompressionSettings settings;
+    GLTF::CompressedAnimationClip compressed;
+    GLTF::AnimationCompressionReport report;
+    measure("compress", 0, [&]() {
+        compressed.build(clip, settings, nullptr);
+    });
+    compressed.build(clip, settings, &report);
+    printf("  %-36s %10zu bytes -> %zu bytes (%.2fx), %u of %u tracks constant, %u raw\n", "",
+           report.sourceByteCount, report.compressedByteCount,
+           double(report.sourceByteCount) / report.compressedByteCount, report.constantTrackCount,
+           report.trackCount, report.rawTrackCount);
+    printf("  %-36s %10.2e translation %.2e scale %.2e rad rotation error\n", "", report.maxTranslationError,
+           report.maxScaleError, report.maxRotationError);
+
+    // Sampling a pose at times that step through the clip as playback at 60 Hz would
+    const int sampleCount = 1200;
+    GLTF::AnimationPose pose = makeAnimationPose(nodeCount);
+    GLTF::AnimationCursor cursor;
+    measure("sample source (per pose)", sampleCount, [&]() {
+        for (int i = 0; i < sampleCount; ++i) {
+            clip.sample(i / 60.0f, cursor, pose);
+        }
+    });
+    measure("sample compressed (per pose)", sampleCount, [&]() {
+        for (int i = 0; i < sampleCount; ++i) {
+            compressed.sample(i / 60.0f, pose);
+        }
+    });
+    // Random access, which the source clip's cursor cannot help with
+    measure("sample source, random times", sampleCount, [&]() {
+        for (int i = 0; i < sampleCount; ++i) {
+            clip.sample(float((i * 7919) % sampleCount) / 60.0f, cursor, pose);
+        }
+    });
+    measure("sample compressed, random times", sampleCount, [&]() {
+        for (int i = 0; i < sampleCount; ++i) {
+            compressed.sample(float((i * 7919) % sampleCount) / 60.0f, pose);
+        }
+    });
+}
+
+GLTF_BENCHMARK(MorphBlending) {
+    // A face-like mesh whose targets each move a small region, as most blend shapes do
+    const size_t vertexCount = 100000, targetCount = 16;
+    const float movedFraction = 0.04f;
+    std::vector<float> base(3 * vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        base[3 * v] = std::sin(0.001f * v);
+        base[3 * v + 1] = std::cos(0.0013f * v);
+        base[3 * v + 2] = 0.00001f * v;
+    }
+    std::vector<std::vector<float>> targets(targetCount, std::vector<float>(3 * vertexCount, 0.0f));
+    const size_t regionSize = static_cast<size_t>(movedFraction * vertexCount);
+    for (size_t t = 0; t < targetCount; ++t) {
+        const size_t first = (t * 7919 * 13) % (vertexCount - regionSize);
+        for (size_t v = first; v < first + regionSize; ++v) {
+            targets[t][3 * v] = 0.01f * std::sin(float(v - first));
+            targets[t][3 * v + 1] = 0.02f;
+        }
+    }
+
+    GLTF::MorphTargetSet set;
+    set.reset(vertexCount, 3);
+    for (const std::vector<float> &deltas : targets) {
+        set.addTarget(floatView(deltas, 3), 0.0f);
+    }
+    printf("  %zu vertices, %zu targets moving %.0f%% of them each\n", vertexCount, targetCount,
+           100.0f * movedFraction);
+    printf("  %-36s %10zu bytes sparse, %zu bytes dense\n", "", set.byteCount(),
+           targetCount * 3 * vertexCount * sizeof(float));
+
+    // Half of the targets active, as is typical of a facial expression
+    std::vector<float> weights(targetCount, 0.0f);
+    for (size_t t = 0; t < targetCount; t += 2) {
+        weights[t] = 0.1f + 0.05f * t;
+    }
+    std::vector<float> output(3 * vertexCount);
+    measure("dense blend (per vertex)", vertexCount, [&]() {
+        std::copy(base.begin(), base.end(), output.begin());
+        for (size_t t = 0; t < targetCount; ++t) {
+            if (weights[t] != 0.0f) {
+                const float *deltas = targets[t].data();
+                for (size_t i = 0; i < 3 * vertexCount; ++i) {
+                    output[i] += weights[t] * deltas[i];
+                }
+            }
+        }
+    });
+    const std::vector<float> denseOutput = output;
+    measure("sparse blend (per vertex)", vertexCount, [&]() {
+        set.blend(base.data(), weights.data(), weights.size(), output.data());
+    });
+    float largestDifference = 0.0f;
+    for (size_t i = 0; i < output.size(); ++i) {
+        largestDifference = std::max(largestDifference, std::fabs(output[i] - denseOutput[i]));
+    }
+    printf("  %-36s %10.2e largest difference from dense\n", "", largestDifference);
+}
+
+// A scene of `characterCount` animated characters of 64 joints, in eight limbs of eight joints from a root, and
+// `propCount` static props of eight nodes, in depth-first order. Returns the parent of each node, and lists the
+// character joints in `animatedNodes`.
+std::vector<int32_t> makeSceneHierarchy(size_t characterCount, size_t propCount, std::vector<uint32_t> &animatedNodes) {
+    std::vector<int32_t> parents;
+    for (size_t character = 0; character < characterCount; ++character) {
+        const int32_t root = static_cast<int32_t>(parents.size());
+        for (int joint = 0; joint < 64; ++joint) {
+            animatedNodes.push_back(static_cast<uint32_t>(parents.size()));
+            parents.push_back((joint == 0) ? -1 : (joint % 8 == 1) ? root : static_cast<int32_t>(parents.size()) - 1);
+        }
+    }
+    for (size_t prop = 0; prop < propCount; ++prop) {
+        const int32_t root = static_cast<int32_t>(parents.size());
+        parents.push_back(-1);
+        for (int part = 1; part < 8; ++part) {
+            parents.push_back(root);
+        }
+    }
+    return parents;
+}
+
+GLTF_BENCHMARK(TransformUpdate) {
+    std::vector<uint32_t> animatedNodes;
+    const std::vector<int32_t> parents = makeSceneHierarchy(50, 2500, animatedNodes);
+    GLTF::SceneGraph graph;
+    graph.build(parents.data(), parents.size());
+    graph.updateWorldTransforms();
+    printf("  %zu nodes, %zu animated\n", parents.size(), animatedNodes.size());
+
+    const int frameCount = 100;
+    int frame = 0;
+    const float translation[3] = { 0.0f, 0.1f, 0.0f }, scale[3] = { 1.0f, 1.0f, 1.0f };
+    auto animate = [&]() {
+        const float angle = 0.01f * ++frame;
+        const float rotation[4] = { std::sin(0.5f * angle), 0.0f, 0.0f, std::cos(0.5f * angle) };
+        for (uint32_t node : animatedNodes) {
+            graph.setTransform(node, translation, rotation, scale);
+        }
+    };
+
+    size_t updatedCount = 0;
+    measure("incremental (per frame)", frameCount, [&]() {
+        for (int i = 0; i < frameCount; ++i) {
+            animate();
+            updatedCount = graph.updateWorldTransforms();
+        }
+    });
+    printf("  %-36s %10zu world transforms per frame\n", "", updatedCount);
+    // Marking every root dirty recomposes the whole scene, as an update without dirty tracking would. Roots are
+    // marked before animating, so that animated roots still recompose their local transforms.
+    measure("full (per frame)", frameCount, [&]() {
+        for (int i = 0; i < frameCount; ++i) {
+            for (size_t node = 0; node < graph.nodeCount(); node = graph.subtreeEnd(node)) {
+                graph.setLocalTransform(node, graph.localTransforms()[node]);
+            }
+            animate();
+            updatedCount = graph.updateWorldTransforms();
+        }
+    });
+    printf("  %-36s %10zu world transforms per frame\n", "", updatedCount);
+}
+
+// Whether `box` is at least partly on the inner side of every plane, by testing the corner furthest along each normal
+bool boxIntersectsPlanes(const GLTF::AxisAlignedBox &box, const float *planes, size_t planeCount) {
+    for (size_t i = 0; i < planeCount; ++i) {
+        const float *plane = &planes[4 * i];
+        float distance = plane[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            distance += plane[axis] * ((plane[axis] >= 0.0f) ? box.max[axis] : box.min[axis]);
+        }
+        if (distance < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+GLTF_BENCHMARK(Culling) {
+    // A larger scene of the kind TransformUpdate uses, spread over a 60 by 60 grid with ten units between objects, with one unit box
+    // for each node of the characters and two for each node of the props
+    std::vector<uint32_t> animatedNodes;
+    const std::vector<int32_t> parents = makeSceneHierarchy(100, 3500, animatedNodes);
+    GLTF::SceneGraph graph;
+    graph.build(parents.data(), parents.size());
+    GLTF::SceneGeometry geometry;
+    const GLTF::AxisAlignedBox unitBox = { { -0.5f, -0.5f, -0.5f, 0.0f }, { 0.5f, 0.5f, 0.5f, 0.0f } };
+    size_t objectIndex = 0;
+    for (size_t node = 0; node < parents.size(); ++node) {
+        geometry.primitiveStarts.push_back(static_cast<uint32_t>(geometry.primitiveBoxes.size()));
+        const bool isProp = node >= animatedNodes.size();
+        geometry.primitiveBoxes.insert(geometry.primitiveBoxes.end(), isProp ? 2 : 1, unitBox);
+        const float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f }, scale[3] = { 1.0f, 1.0f, 1.0f };
+        if (parents[node] == -1) {
+            const float translation[3] = { 10.0f * (objectIndex % 60), 0.0f, 10.0f * (objectIndex / 60) };
+            graph.setTransform(node, translation, rotation, scale);
+            ++objectIndex;
+        } else {
+            const float translation[3] = { 0.0f, 0.5f, 0.0f };
+            graph.setTransform(node, translation, rotation, scale);
+        }
+    }
+    geometry.primitiveStarts.push_back(static_cast<uint32_t>(geometry.primitiveBoxes.size()));
+    graph.updateWorldTransforms();
+    GLTF::SceneBounds bounds;
+    bounds.build(graph, geometry);
+    printf("  %zu nodes, %zu primitives\n", bounds.nodeCount(), bounds.primitiveCount());
+
+    // A box-shaped view volume over about a quarter of the grid, with its sides at an angle to the axes
+    const float s = std::sqrt(0.5f);
+    const float planes[6][4] = {
+        { s, 0, s, -150.0f }, { -s, 0, -s, 400.0f }, { -s, 0, s, 150.0f }, { s, 0, -s, 150.0f },
+        { 0, 1, 0, 10.0f }, { 0, -1, 0, 50.0f },
+    };
+    std::vector<uint32_t> visibleNodes, visiblePrimitives;
+    const int queryCount = 100;
+    measure("hierarchical (per query)", queryCount, [&]() {
+        for (int i = 0; i < queryCount; ++i) {
+            visibleNodes.clear();
+            visiblePrimitives.clear();
+            bounds.cull(graph, &planes[0][0], 6, visibleNodes, visiblePrimitives);
+        }
+    });
+    const size_t visibleCount = visiblePrimitives.size();
+    measure("every primitive (per query)", queryCount, [&]() {
+        for (int i = 0; i < queryCount; ++i) {
+            visiblePrimitives.clear();
+            for (size_t p = 0; p < bounds.primitiveCount(); ++p) {
+                if (boxIntersectsPlanes(bounds.primitiveBox(p), &planes[0][0], 6)) {
+                    visiblePrimitives.push_back(static_cast<uint32_t>(p));
+                }
+            }
+        }
+    });
+    printf("  %-36s %10zu visible primitives, %zu by brute force\n", "", visibleCount, visiblePrimitives.size());
+
+    // Moving the characters, then updating the bounds of their subtrees only
+    int frame = 0;
+    measure("animate and update bounds (per frame)", queryCount, [&]() {
+        for (int i = 0; i < queryCount; ++i) {
+            const float angle = 0.01f * ++frame;
+            const float translation[3] = { 0.0f, 0.5f, 0.0f }, scale[3] = { 1.0f, 1.0f, 1.0f };
+            const float rotation[4] = { std::sin(0.5f * angle), 0.0f, 0.0f, std::cos(0.5f * angle) };
+            for (uint32_t node : animatedNodes) {
+                if (parents[node] != -1) {
+                    graph.setTransform(node, translation, rotation, scale);
+                }
+            }
+            graph.updateWorldTransforms();
+            bounds.update(graph, graph.lastUpdatedRoots());
+        }
+    });
+}
+
+// The lookup behind GLTFIndexOfObjectInArray, mirrored in C++: an object records its position in the asset's array,
+// which is trusted once the array is seen to hold the object there, in place of a scan of the whole array.
+struct IndexedObject {
+    long index;
+};
+
+long indexOfObjectByScan(const IndexedObject *object, const std::vector<IndexedObject *> &objects) {
+    const std::vector<IndexedObject *>::const_iterator found = std::find(objects.begin(), objects.end(), object);
+    return (found != objects.end()) ? long(found - objects.begin()) : -1;
+}
+
+long indexOfObjectInArray(const IndexedObject *object, const std::vector<IndexedObject *> &objects) {
+    if (object->index >= 0 && size_t(object->index) < objects.size() && objects[object->index] == object) {
+        return object->index;
+    }
+    return indexOfObjectByScan(object, objects);
+}
+
+GLTF_BENCHMARK(IndexLookup) {
+    // A synthetic asset whose primitives each name one of its materials, as a writer resolves them
+    const size_t materialCount = 10000;
+    const size_t primitiveCount = 100000;
+    std::mt19937 random(11);
+
+    std::vector<IndexedObject> storage(materialCount);
+    std::vector<IndexedObject *> materials;
+    for (size_t i = 0; i < materialCount; ++i) {
+        materials.push_back(&storage[i]);
+    }
+    // Objects are scattered in memory relative to their order in the asset
+    std::shuffle(materials.begin(), materials.end(), random);
+    for (size_t i = 0; i < materialCount; ++i) {
+        materials[i]->index = long(i);
+    }
+    std::vector<const IndexedObject *> primitiveMaterials(primitiveCount);
+    for (const IndexedObject *&material : primitiveMaterials) {
+        material = materials[random() % materialCount];
+    }
+    printf("  %zu materials, %zu primitives\n", materialCount, primitiveCount);
+
+    long checksum = 0;
+    measure("stored index", primitiveCount, [&]() {
+        for (const IndexedObject *material : primitiveMaterials) {
+            checksum += indexOfObjectInArray(material, materials);
+        }
+    });
+    measure("scan of the array", primitiveCount, [&]() {
+        for (const IndexedObject *material : primitiveMaterials) {
+            checksum += indexOfObjectByScan(material, materials);
+        }
+    });
+    printf("  checksum %ld\n", checksum);
+}
+
+// The per-lookup costs behind object handles, mirrored in C++: looking objects up by a 64-bit handle rather than a
+// 16-byte UUID, and reading a lazily created value through an acquire load rather than under a lock. This times only
+// the keys; it does not load or convert an asset, so it says nothing about load time or memory use.
+struct UUIDKey {
+    std::array<uint8_t, 16> bytes;
+
+    bool operator==(const UUIDKey &other) const { return bytes == other.bytes; }
+};
+
+struct UUIDKeyHash {
+    size_t operator()(const UUIDKey &key) const {
+        // FNV-1a over all the bytes, as a hash of an NSUUID must be
+        uint64_t hash = 14695981039346656037ull;
+        for (uint8_t byte : key.bytes) {
+            hash = (hash ^ byte) * 1099511628211ull;
+        }
+        return size_t(hash);
+    }
+};
+
+GLTF_BENCHMARK(ObjectKeys) {
+    const size_t objectCount = 10000;
+    const size_t lookupCount = 1000000;
+    std::mt19937_64 random(7);
+
+    std::vector<uint64_t> handles;
+    std::vector<UUIDKey> uuids;
+    const uint64_t assetNumber = 1;
+    const uint64_t kind = 6;
+    for (size_t i = 0; i < objectCount; ++i) {
+        handles.push_back((assetNumber << 40) | (kind << 32) | i);
+        UUIDKey uuid;
+        const uint64_t high = random(), low = random();
+        memcpy(uuid.bytes.data(), &high, 8);
+        memcpy(uuid.bytes.data() + 8, &low, 8);
+        uuids.push_back(uuid);
+    }
+    std::vector<uint32_t> order(lookupCount);
+    for (uint32_t &index : order) {
+        index = uint32_t(random() % objectCount);
+    }
+
+    std::unordered_map<uint64_t, uint32_t> byHandle;
+    std::unordered_map<UUIDKey, uint32_t, UUIDKeyHash> byUUID;
+    for (size_t i = 0; i < objectCount; ++i) {
+        byHandle[handles[i]] = uint32_t(i);
+        byUUID[uuids[i]] = uint32_t(i);
+    }
+    printf("  %zu objects, %zu-byte handle keys, %zu-byte UUID keys\n", objectCount, sizeof(uint64_t),
+           sizeof(UUIDKey));
+
+    uint64_t checksum = 0;
+    measure("look up by handle", lookupCount, [&]() {
+        for (uint32_t index : order) {
+            checksum += byHandle.find(handles[index])->second;
+        }
+    });
+    measure("look up by UUID", lookupCount, [&]() {
+        for (uint32_t index : order) {
+            checksum += byUUID.find(uuids[index])->second;
+        }
+    });
+
+    std::atomic<const UUIDKey *> published(&uuids[0]);
+    std::mutex mutex;
+    const UUIDKey *guarded = &uuids[0];
+    measure("read identifier, acquire load", lookupCount, [&]() {
+        for (size_t i = 0; i < lookupCount; ++i) {
+            checksum += published.load(std::memory_order_acquire)->bytes[0];
+        }
+    });
+    measure("read identifier, under a lock", lookupCount, [&]() {
+        for (size_t i = 0; i < lookupCount; ++i) {
+            std::lock_guard<std::mutex> lock(mutex);
+            checksum += guarded->bytes[0];
+        }
+    });
+    printf("  checksum %llu\n", (unsigned long long)checksum);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    for (const Benchmark &benchmark : registeredBenchmarks()) {
+        bool selected = (argc < 2);
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || strcmp(argv[i], benchmark.name) == 0;
+        }
+        if (selected) {
+            printf("%s\n", benchmark.name);
+            benchmark.function();
+        }
+    }
+    return 0;
+}
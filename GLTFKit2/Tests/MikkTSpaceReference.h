@@ -0,0 +1,450 @@
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// A plain transcription of the triangle path of the reference MikkTSpace implementation (mikktspace.c by Morten S.
+// Mikkelsen, zlib license) with its default 180 degree threshold, used as an oracle for GLTF::GenerateTangents. It
+// keeps the reference's names, data layout, recursive grouping, and floating-point expressions, and none of the
+// port's restructuring: vertices are welded and neighbors found by exhaustive search, as the reference's fallback
+// paths do, which agree with its fast paths on manifold meshes. Quads are not supported.
+
+namespace MikkTSpaceReference {
+
+struct Mesh {
+    std::vector<float> positions; // Three floats per vertex
+    std::vector<float> normals;   // Three floats per vertex
+    std::vector<float> texCoords; // Two floats per vertex, with the origin at the bottom left as MikkTSpace expects
+    std::vector<uint32_t> indices;
+};
+
+struct CornerTangent {
+    float tangent[3];
+    float sign;
+};
+
+namespace Detail {
+
+struct SVec3 {
+    float x, y, z;
+};
+
+inline bool veq(SVec3 v1, SVec3 v2) { return (v1.x == v2.x) && (v1.y == v2.y) && (v1.z == v2.z); }
+inline SVec3 vadd(SVec3 v1, SVec3 v2) { SVec3 v = { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z }; return v; }
+inline SVec3 vsub(SVec3 v1, SVec3 v2) { SVec3 v = { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z }; return v; }
+inline SVec3 vscale(float fS, SVec3 v) { SVec3 r = { fS * v.x, fS * v.y, fS * v.z }; return r; }
+inline float LengthSquared(SVec3 v) { return v.x * v.x + v.y * v.y + v.z * v.z; }
+inline float Length(SVec3 v) { return std::sqrt(LengthSquared(v)); }
+inline SVec3 Normalize(SVec3 v) { return vscale(1 / Length(v), v); }
+inline float vdot(SVec3 v1, SVec3 v2) { return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z; }
+inline bool NotZero(float fX) { return std::fabs(fX) > FLT_MIN; }
+inline bool VNotZero(SVec3 v) { return NotZero(v.x) || NotZero(v.y) || NotZero(v.z); }
+
+const int MARK_DEGENERATE = 1;
+const int GROUP_WITH_ANY = 4;
+const int ORIENT_PRESERVING = 8;
+
+struct SGroup {
+    std::vector<int> faceIndices;
+    int iVertexRepresentitive;
+    bool bOrientPreserving;
+};
+
+struct STriInfo {
+    int FaceNeighbors[3];
+    SGroup *AssignedGroup[3];
+    SVec3 vOs, vOt;
+    int iOrgFaceNumber;
+    int iFlag;
+};
+
+struct STSpace {
+    SVec3 vOs;
+    bool bOrient;
+};
+
+struct Context {
+    const Mesh &mesh;
+
+    // Vertex "indices" are corners of the original triangle list, as in the reference's MakeIndex encoding
+    SVec3 GetPosition(int index) const {
+        const float *p = &mesh.positions[3 * mesh.indices[index]];
+        SVec3 v = { p[0], p[1], p[2] };
+        return v;
+    }
+
+    SVec3 GetNormal(int index) const {
+        const float *n = &mesh.normals[3 * mesh.indices[index]];
+        SVec3 v = { n[0], n[1], n[2] };
+        return v;
+    }
+
+    SVec3 GetTexCoord(int index) const {
+        const float *t = &mesh.texCoords[2 * mesh.indices[index]];
+        SVec3 v = { t[0], t[1], 1.0f };
+        return v;
+    }
+};
+
+inline bool AssignRecur(const int piTriListIn[], STriInfo psTriInfos[], int iMyTriIndex, SGroup *pGroup) {
+    STriInfo *pMyTriInfo = &psTriInfos[iMyTriIndex];
+    const int iVertRep = pGroup->iVertexRepresentitive;
+    const int *pVerts = &piTriListIn[3 * iMyTriIndex + 0];
+    int i = -1;
+    if (pVerts[0] == iVertRep) {
+        i = 0;
+    } else if (pVerts[1] == iVertRep) {
+        i = 1;
+    } else if (pVerts[2] == iVertRep) {
+        i = 2;
+    }
+    if (pMyTriInfo->AssignedGroup[i] == pGroup) {
+        return true;
+    } else if (pMyTriInfo->AssignedGroup[i] != nullptr) {
+        return false;
+    }
+    if ((pMyTriInfo->iFlag & GROUP_WITH_ANY) != 0) {
+        // First to group with a group-with-anything triangle determines its orientation
+        if (pMyTriInfo->AssignedGroup[0] == nullptr && pMyTriInfo->AssignedGroup[1] == nullptr &&
+            pMyTriInfo->AssignedGroup[2] == nullptr)
+        {
+            pMyTriInfo->iFlag &= (~ORIENT_PRESERVING);
+            pMyTriInfo->iFlag |= (pGroup->bOrientPreserving ? ORIENT_PRESERVING : 0);
+        }
+    }
+    {
+        const bool bOrient = (pMyTriInfo->iFlag & ORIENT_PRESERVING) != 0;
+        if (bOrient != pGroup->bOrientPreserving) {
+            return false;
+        }
+    }
+    pGroup->faceIndices.push_back(iMyTriIndex);
+    pMyTriInfo->AssignedGroup[i] = pGroup;
+    {
+        const int neigh_indexL = pMyTriInfo->FaceNeighbors[i];
+        const int neigh_indexR = pMyTriInfo->FaceNeighbors[i > 0 ? (i - 1) : 2];
+        if (neigh_indexL >= 0) {
+            AssignRecur(piTriListIn, psTriInfos, neigh_indexL, pGroup);
+        }
+        if (neigh_indexR >= 0) {
+            AssignRecur(piTriListIn, psTriInfos, neigh_indexR, pGroup);
+        }
+    }
+    return true;
+}
+
+inline STSpace EvalTspace(const std::vector<int> &face_indices, const int piTriListIn[], const STriInfo pTriInfos[],
+                          const Context &context, int iVertexRepresentitive)
+{
+    STSpace res;
+    res.vOs.x = 0.0f; res.vOs.y = 0.0f; res.vOs.z = 0.0f;
+    res.bOrient = false;
+    for (size_t face = 0; face < face_indices.size(); face++) {
+        const int f = face_indices[face];
+        // Only valid triangles get to add their contribution
+        if ((pTriInfos[f].iFlag & GROUP_WITH_ANY) == 0) {
+            int i = -1;
+            if (piTriListIn[3 * f + 0] == iVertexRepresentitive) {
+                i = 0;
+            } else if (piTriListIn[3 * f + 1] == iVertexRepresentitive) {
+                i = 1;
+            } else if (piTriListIn[3 * f + 2] == iVertexRepresentitive) {
+                i = 2;
+            }
+            const int index = piTriListIn[3 * f + i];
+            const SVec3 n = context.GetNormal(index);
+            SVec3 vOs = vsub(pTriInfos[f].vOs, vscale(vdot(n, pTriInfos[f].vOs), n));
+            if (VNotZero(vOs)) {
+                vOs = Normalize(vOs);
+            }
+            const int i2 = piTriListIn[3 * f + (i < 2 ? (i + 1) : 0)];
+            const int i1 = piTriListIn[3 * f + i];
+            const int i0 = piTriListIn[3 * f + (i > 0 ? (i - 1) : 2)];
+            const SVec3 p0 = context.GetPosition(i0);
+            const SVec3 p1 = context.GetPosition(i1);
+            const SVec3 p2 = context.GetPosition(i2);
+            SVec3 v1 = vsub(p0, p1);
+            SVec3 v2 = vsub(p2, p1);
+            v1 = vsub(v1, vscale(vdot(n, v1), n));
+            if (VNotZero(v1)) {
+                v1 = Normalize(v1);
+            }
+            v2 = vsub(v2, vscale(vdot(n, v2), n));
+            if (VNotZero(v2)) {
+                v2 = Normalize(v2);
+            }
+            float fCos = vdot(v1, v2);
+            fCos = fCos > 1 ? 1 : (fCos < (-1) ? (-1) : fCos);
+            const float fAngle = static_cast<float>(std::acos(static_cast<double>(fCos)));
+            res.vOs = vadd(res.vOs, vscale(fAngle, vOs));
+        }
+    }
+    if (VNotZero(res.vOs)) {
+        res.vOs = Normalize(res.vOs);
+    }
+    return res;
+}
+
+} // namespace Detail
+
+/// Returns the tangent and sign that the reference assigns to each corner of the triangle list.
+inline std::vector<CornerTangent> GenerateTangents(const Mesh &mesh) {
+    using namespace Detail;
+    const Context context = { mesh };
+    const int iNrTrianglesTotal = static_cast<int>(mesh.indices.size() / 3);
+    const int iNrTSpaces = 3 * iNrTrianglesTotal;
+
+    // GenerateSharedVerticesIndexList: each corner refers to the first corner with identical vertex data
+    std::vector<int> piShared(iNrTSpaces);
+    for (int c = 0; c < iNrTSpaces; ++c) {
+        piShared[c] = c;
+        for (int c2 = 0; c2 < c; ++c2) {
+            if (veq(context.GetPosition(c), context.GetPosition(c2)) && veq(context.GetNormal(c), context.GetNormal(c2)) &&
+                veq(context.GetTexCoord(c), context.GetTexCoord(c2)))
+            {
+                piShared[c] = piShared[c2];
+                break;
+            }
+        }
+    }
+
+    // DegenPrologue: mark degenerate triangles and move them to the back without reordering the good ones
+    std::vector<STriInfo> pTriInfos(iNrTrianglesTotal);
+    std::vector<int> piTriListIn(iNrTSpaces);
+    int iNrTrianglesIn = 0;
+    {
+        int k = 0;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int t = 0; t < iNrTrianglesTotal; ++t) {
+                const SVec3 p0 = context.GetPosition(piShared[3 * t + 0]);
+                const SVec3 p1 = context.GetPosition(piShared[3 * t + 1]);
+                const SVec3 p2 = context.GetPosition(piShared[3 * t + 2]);
+                const bool bDegenerate = veq(p0, p1) || veq(p0, p2) || veq(p1, p2);
+                if (bDegenerate != (pass == 1)) {
+                    continue;
+                }
+                if (!bDegenerate) {
+                    ++iNrTrianglesIn;
+                }
+                pTriInfos[k].iOrgFaceNumber = t;
+                pTriInfos[k].iFlag = bDegenerate ? MARK_DEGENERATE : 0;
+                for (int i = 0; i < 3; ++i) {
+                    piTriListIn[3 * k + i] = piShared[3 * t + i];
+                }
+                ++k;
+            }
+        }
+    }
+
+    // InitTriInfo
+    for (int f = 0; f < iNrTrianglesIn; f++) {
+        for (int i = 0; i < 3; i++) {
+            pTriInfos[f].FaceNeighbors[i] = -1;
+            pTriInfos[f].AssignedGroup[i] = nullptr;
+        }
+        pTriInfos[f].vOs.x = 0.0f; pTriInfos[f].vOs.y = 0.0f; pTriInfos[f].vOs.z = 0.0f;
+        pTriInfos[f].vOt.x = 0.0f; pTriInfos[f].vOt.y = 0.0f; pTriInfos[f].vOt.z = 0.0f;
+        pTriInfos[f].iFlag |= GROUP_WITH_ANY;
+    }
+    for (int f = 0; f < iNrTrianglesIn; f++) {
+        const SVec3 v1 = context.GetPosition(piTriListIn[f * 3 + 0]);
+        const SVec3 v2 = context.GetPosition(piTriListIn[f * 3 + 1]);
+        const SVec3 v3 = context.GetPosition(piTriListIn[f * 3 + 2]);
+        const SVec3 t1 = context.GetTexCoord(piTriListIn[f * 3 + 0]);
+        const SVec3 t2 = context.GetTexCoord(piTriListIn[f * 3 + 1]);
+        const SVec3 t3 = context.GetTexCoord(piTriListIn[f * 3 + 2]);
+        const float t21x = t2.x - t1.x;
+        const float t21y = t2.y - t1.y;
+        const float t31x = t3.x - t1.x;
+        const float t31y = t3.y - t1.y;
+        const SVec3 d1 = vsub(v2, v1);
+        const SVec3 d2 = vsub(v3, v1);
+        const float fSignedAreaSTx2 = t21x * t31y - t21y * t31x;
+        const SVec3 vOs = vsub(vscale(t31y, d1), vscale(t21y, d2));
+        const SVec3 vOt = vadd(vscale(-t31x, d1), vscale(t21x, d2));
+        pTriInfos[f].iFlag |= (fSignedAreaSTx2 > 0 ? ORIENT_PRESERVING : 0);
+        if (NotZero(fSignedAreaSTx2)) {
+            const float fAbsArea = std::fabs(fSignedAreaSTx2);
+            const float fLenOs = Length(vOs);
+            const float fLenOt = Length(vOt);
+            const float fS = (pTriInfos[f].iFlag & ORIENT_PRESERVING) == 0 ? (-1.0f) : 1.0f;
+            if (NotZero(fLenOs)) {
+                pTriInfos[f].vOs = vscale(fS / fLenOs, vOs);
+            }
+            if (NotZero(fLenOt)) {
+                pTriInfos[f].vOt = vscale(fS / fLenOt, vOt);
+            }
+            // If this is a good triangle, it does not group with anything
+            if (NotZero(fLenOs / fAbsArea) && NotZero(fLenOt / fAbsArea)) {
+                pTriInfos[f].iFlag &= (~GROUP_WITH_ANY);
+            }
+        }
+    }
+
+    // BuildNeighborsSlow
+    for (int f = 0; f < iNrTrianglesIn; f++) {
+        for (int i = 0; i < 3; i++) {
+            if (pTriInfos[f].FaceNeighbors[i] == -1) {
+                const int i0_A = piTriListIn[f * 3 + i];
+                const int i1_A = piTriListIn[f * 3 + (i < 2 ? (i + 1) : 0)];
+                bool bFound = false;
+                int t = 0, j = 0;
+                while (!bFound && t < iNrTrianglesIn) {
+                    if (t != f) {
+                        j = 0;
+                        while (!bFound && j < 3) {
+                            // In rev order
+                            const int i1_B = piTriListIn[t * 3 + j];
+                            const int i0_B = piTriListIn[t * 3 + (j < 2 ? (j + 1) : 0)];
+                            if (i0_A == i0_B && i1_A == i1_B) {
+                                bFound = true;
+                            } else {
+                                ++j;
+                            }
+                        }
+                    }
+                    if (!bFound) {
+                        ++t;
+                    }
+                }
+                if (bFound) {
+                    pTriInfos[f].FaceNeighbors[i] = t;
+                    pTriInfos[t].FaceNeighbors[j] = f;
+                }
+            }
+        }
+    }
+
+    // Build4RuleGroups
+    std::vector<SGroup> pGroups;
+    pGroups.reserve(iNrTSpaces); // Groups are referenced by address
+    for (int f = 0; f < iNrTrianglesIn; f++) {
+        for (int i = 0; i < 3; i++) {
+            // If not assigned to a group
+            if ((pTriInfos[f].iFlag & GROUP_WITH_ANY) == 0 && pTriInfos[f].AssignedGroup[i] == nullptr) {
+                const int vert_index = piTriListIn[f * 3 + i];
+                SGroup group;
+                group.iVertexRepresentitive = vert_index;
+                group.bOrientPreserving = (pTriInfos[f].iFlag & ORIENT_PRESERVING) != 0;
+                pGroups.push_back(group);
+                SGroup *pGroup = &pGroups.back();
+                pTriInfos[f].AssignedGroup[i] = pGroup;
+                pGroup->faceIndices.push_back(f);
+                const int neigh_indexL = pTriInfos[f].FaceNeighbors[i];
+                const int neigh_indexR = pTriInfos[f].FaceNeighbors[i > 0 ? (i - 1) : 2];
+                if (neigh_indexL >= 0) {
+                    AssignRecur(piTriListIn.data(), pTriInfos.data(), neigh_indexL, pGroup);
+                }
+                if (neigh_indexR >= 0) {
+                    AssignRecur(piTriListIn.data(), pTriInfos.data(), neigh_indexR, pGroup);
+                }
+            }
+        }
+    }
+
+    // GenerateTSpaces, with the default tangent space for corners that no group reaches
+    std::vector<STSpace> psTspace(iNrTSpaces);
+    for (int t = 0; t < iNrTSpaces; t++) {
+        psTspace[t].vOs.x = 1.0f; psTspace[t].vOs.y = 0.0f; psTspace[t].vOs.z = 0.0f;
+        psTspace[t].bOrient = false;
+    }
+    const double Pi = 3.14159265358979323846;
+    const float fThresCos = static_cast<float>(std::cos((180.0f * static_cast<float>(Pi)) / 180.0f));
+    for (size_t g = 0; g < pGroups.size(); g++) {
+        const SGroup *pGroup = &pGroups[g];
+        std::vector<std::vector<int>> pUniSubGroups;
+        std::vector<STSpace> pSubGroupTspace;
+        for (size_t i = 0; i < pGroup->faceIndices.size(); i++) {
+            const int f = pGroup->faceIndices[i];
+            int index = -1;
+            if (pTriInfos[f].AssignedGroup[0] == pGroup) {
+                index = 0;
+            } else if (pTriInfos[f].AssignedGroup[1] == pGroup) {
+                index = 1;
+            } else if (pTriInfos[f].AssignedGroup[2] == pGroup) {
+                index = 2;
+            }
+            const int iVertIndex = piTriListIn[f * 3 + index];
+            const SVec3 n = context.GetNormal(iVertIndex);
+            SVec3 vOs = vsub(pTriInfos[f].vOs, vscale(vdot(n, pTriInfos[f].vOs), n));
+            SVec3 vOt = vsub(pTriInfos[f].vOt, vscale(vdot(n, pTriInfos[f].vOt), n));
+            if (VNotZero(vOs)) {
+                vOs = Normalize(vOs);
+            }
+            if (VNotZero(vOt)) {
+                vOt = Normalize(vOt);
+            }
+            const int iOF_1 = pTriInfos[f].iOrgFaceNumber;
+            std::vector<int> pTmpMembers;
+            for (size_t j = 0; j < pGroup->faceIndices.size(); j++) {
+                const int t = pGroup->faceIndices[j];
+                const int iOF_2 = pTriInfos[t].iOrgFaceNumber;
+                SVec3 vOs2 = vsub(pTriInfos[t].vOs, vscale(vdot(n, pTriInfos[t].vOs), n));
+                SVec3 vOt2 = vsub(pTriInfos[t].vOt, vscale(vdot(n, pTriInfos[t].vOt), n));
+                if (VNotZero(vOs2)) {
+                    vOs2 = Normalize(vOs2);
+                }
+                if (VNotZero(vOt2)) {
+                    vOt2 = Normalize(vOt2);
+                }
+                const bool bAny = ((pTriInfos[f].iFlag | pTriInfos[t].iFlag) & GROUP_WITH_ANY) != 0;
+                // Make sure triangles which belong to the same quad are joined
+                const bool bSameOrgFace = iOF_1 == iOF_2;
+                const float fCosS = vdot(vOs, vOs2);
+                const float fCosT = vdot(vOt, vOt2);
+                if (bAny || bSameOrgFace || (fCosS > fThresCos && fCosT > fThresCos)) {
+                    pTmpMembers.push_back(t);
+                }
+            }
+            std::sort(pTmpMembers.begin(), pTmpMembers.end());
+            size_t l = 0;
+            while (l < pUniSubGroups.size() && pUniSubGroups[l] != pTmpMembers) {
+                ++l;
+            }
+            if (l == pUniSubGroups.size()) {
+                pUniSubGroups.push_back(pTmpMembers);
+                pSubGroupTspace.push_back(EvalTspace(pTmpMembers, piTriListIn.data(), pTriInfos.data(), context,
+                                                     pGroup->iVertexRepresentitive));
+            }
+            STSpace *pTS_out = &psTspace[3 * pTriInfos[f].iOrgFaceNumber + index];
+            *pTS_out = pSubGroupTspace[l];
+            pTS_out->bOrient = pGroup->bOrientPreserving;
+        }
+    }
+
+    // DegenEpilogue: degenerate corners copy the first good corner at the same vertex
+    for (int t = iNrTrianglesIn; t < iNrTrianglesTotal; t++) {
+        for (int i = 0; i < 3; i++) {
+            const int index1 = piTriListIn[t * 3 + i];
+            bool bNotFound = true;
+            int j = 0;
+            while (bNotFound && j < (3 * iNrTrianglesIn)) {
+                const int index2 = piTriListIn[j];
+                if (index1 == index2) {
+                    bNotFound = false;
+                } else {
+                    ++j;
+                }
+            }
+            if (!bNotFound) {
+                const int iTri = j / 3;
+                const int iVert = j % 3;
+                psTspace[3 * pTriInfos[t].iOrgFaceNumber + i] = psTspace[3 * pTriInfos[iTri].iOrgFaceNumber + iVert];
+            }
+        }
+    }
+
+    std::vector<CornerTangent> corners(iNrTSpaces);
+    for (int c = 0; c < iNrTSpaces; ++c) {
+        corners[c].tangent[0] = psTspace[c].vOs.x;
+        corners[c].tangent[1] = psTspace[c].vOs.y;
+        corners[c].tangent[2] = psTspace[c].vOs.z;
+        corners[c].sign = psTspace[c].bOrient ? 1.0f : -1.0f;
+    }
+    return corners;
+}
+
+} // namespace MikkTSpaceReference
@@ -0,0 +1,123 @@
+#include "TestSupport.h"
+
+#include "GLTFAnimationSampling.h"
+
+// Expected values are worked by hand from the glTF definitions of slerp and of cubic spline interpolation, in which
+// tangents are scaled by the length of the key interval.
+
+using GLTFTest::FloatView;
+
+namespace {
+
+const float Pi = 3.14159265358979f;
+
+GLTF::AnimationPose makePose(size_t nodeCount, size_t weightCount) {
+    GLTF::AnimationPose pose;
+    pose.translations.assign(3 * nodeCount, 0.0f);
+    pose.rotations.assign(4 * nodeCount, 0.0f);
+    pose.scales.assign(3 * nodeCount, 1.0f);
+    pose.weights.assign(weightCount, 0.0f);
+    return pose;
+}
+
+} // namespace
+
+GLTF_TEST(LinearRotationsFollowSlerpTheShortWay) {
+    // A quarter turn about z, with the second key given both ways around the double cover
+    const float s = std::sin(0.25f * Pi), c = std::cos(0.25f * Pi);
+    const std::vector<float> times = { 0.0f, 2.0f };
+    const std::vector<float> rotations = { 0, 0, 0, 1,   0, 0, s, c };
+    const std::vector<float> negatedRotations = { 0, 0, 0, 1,   0, 0, -s, -c };
+    GLTF::AnimationClip clip;
+    EXPECT_TRUE(clip.addTrack(GLTF::AnimationPathRotation, GLTF::InterpolationLinear, 0, 4, FloatView(times, 1),
+                              FloatView(rotations, 4)));
+    EXPECT_TRUE(clip.addTrack(GLTF::AnimationPathRotation, GLTF::InterpolationLinear, 1, 4, FloatView(times, 1),
+                              FloatView(negatedRotations, 4)));
+
+    // A quarter of the way through is an eighth of the quarter turn: a half-angle of 11.25 degrees
+    GLTF::AnimationPose pose = makePose(2, 0);
+    GLTF::AnimationCursor cursor;
+    EXPECT_TRUE(clip.sample(0.5f, cursor, pose));
+    const float halfAngle = 11.25f * Pi / 180.0f;
+    for (int node = 0; node < 2; ++node) {
+        const float *q = &pose.rotations[4 * node];
+        EXPECT_NEAR(q[0], 0.0, 1e-6);
+        EXPECT_NEAR(q[1], 0.0, 1e-6);
+        EXPECT_NEAR(q[2], std::sin(halfAngle), 1e-5);
+        EXPECT_NEAR(q[3], std::cos(halfAngle), 1e-5);
+    }
+}
+
+GLTF_TEST(CubicSplinesFollowHermiteWithScaledTangents) {
+    // Keys at 1 and 3 (an interval of length 2): value 0 leaving with slope 1, and value 2 arriving with slope -1.
+    // At the midpoint the Hermite bases are h00 = h01 = 1/2, h10 = 1/8 and h11 = -1/8, and the tangent terms are
+    // scaled by 2, so the value is 0/2 + 2 * (1/8) * 1 + 2/2 + 2 * (-1/8) * (-1) = 1.5. A quarter of the way through,
+    // h00 = 27/32, h10 = 9/64, h01 = 5/32 and h11 = -3/64, giving 2 * 9/64 + 10/32 + 2 * (-3/64) * (-1) = 0.6875.
+    const std::vector<float> times = { 1.0f, 3.0f };
+    // In-tangent, value and out-tangent of each key, for x; y is twice x and z is constant
+    const std::vector<float> translations = {
+        9, 9, 9,    0, 0, 5,    1, 2, 0,
+        -1, -2, 0,  2, 4, 5,    9, 9, 9,
+    };
+    // One morph weight, animated the same way as x
+    const std::vector<float> weights = { 9, 0, 1,   -1, 2, 9 };
+    GLTF::AnimationClip clip;
+    EXPECT_TRUE(clip.addTrack(GLTF::AnimationPathTranslation, GLTF::InterpolationCubic, 0, 3, FloatView(times, 1),
+                              FloatView(translations, 3)));
+    EXPECT_TRUE(clip.addTrack(GLTF::AnimationPathWeights, GLTF::InterpolationCubic, 0, 1, FloatView(times, 1),
+                              FloatView(weights, 1)));
+
+    GLTF::AnimationPose pose = makePose(1, 1);
+    GLTF::AnimationCursor cursor;
+    const float sampleTimes[] = { 2.0f, 1.5f };
+    const float expected[] = { 1.5f, 0.6875f };
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_TRUE(clip.sample(sampleTimes[i], cursor, pose));
+        EXPECT_NEAR(pose.translations[0], expected[i], 1e-6);
+        EXPECT_NEAR(pose.translations[1], 2 * expected[i], 1e-6);
+        EXPECT_NEAR(pose.translations[2], 5.0, 1e-6);
+        EXPECT_NEAR(pose.weights[0], expected[i], 1e-6);
+    }
+
+    // Outside the keys, the first and last values hold, and the tangents play no part
+    EXPECT_TRUE(clip.sample(0.0f, cursor, pose));
+    EXPECT_NEAR(pose.translations[0], 0.0, 1e-6);
+    EXPECT_TRUE(clip.sample(10.0f, cursor, pose));
+    EXPECT_NEAR(pose.translations[0], 2.0, 1e-6);
+    EXPECT_NEAR(pose.weights[0], 2.0, 1e-6);
+}
+
+GLTF_TEST(LinearAndStepTracksAcrossLanes) {
+    // Five translation tracks, more than one group of four lanes, each offset by its node index, and a step track
+    const std::vector<float> times = { 0.0f, 1.0f, 3.0f };
+    GLTF::AnimationClip clip;
+    std::vector<std::vector<float>> values(5);
+    for (uint32_t node = 0; node < 5; ++node) {
+        values[node] = { float(node), 0, 0,   float(node) + 1, 0, 0,   float(node) + 5, 0, 0 };
+        EXPECT_TRUE(clip.addTrack(GLTF::AnimationPathTranslation, GLTF::InterpolationLinear, node, 3,
+                                  FloatView(times, 1), FloatView(values[node], 3)));
+    }
+    const std::vector<float> scales = { 1, 1, 1,   2, 2, 2,   3, 3, 3 };
+    EXPECT_TRUE(clip.addTrack(GLTF::AnimationPathScale, GLTF::InterpolationStep, 0, 3, FloatView(times, 1),
+                              FloatView(scales, 3)));
+    EXPECT_NEAR(clip.duration(), 3.0, 0.0);
+
+    GLTF::AnimationPose pose = makePose(5, 0);
+    GLTF::AnimationCursor cursor;
+    // Forward, then back, so that the cursor must move both ways
+    const float sampleTimes[] = { 0.5f, 2.0f, 0.25f };
+    const float expectedOffsets[] = { 0.5f, 3.0f, 0.25f };
+    const float expectedScales[] = { 1.0f, 2.0f, 1.0f };
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(clip.sample(sampleTimes[i], cursor, pose));
+        for (int node = 0; node < 5; ++node) {
+            EXPECT_NEAR(pose.translations[3 * node], node + expectedOffsets[i], 1e-6);
+        }
+        EXPECT_EQ(pose.scales[0], expectedScales[i]);
+    }
+
+    // A pose too small for the tracks is left alone
+    GLTF::AnimationPose smallPose = makePose(4, 0);
+    EXPECT_TRUE(!clip.sample(1.0f, cursor, smallPose));
+    EXPECT_EQ(smallPose.translations[0], 0.0f);
+}
@@ -0,0 +1,113 @@
+#include "TestSupport.h"
+
+#include "GLTFBVH.h"
+
+// Hits are checked against a hand-worked triangle, and against a brute-force test of every triangle of a random soup.
+
+namespace {
+
+// A deterministic pseudo-random sequence in [0, 1)
+struct Random {
+    uint32_t state = 12345;
+
+    float next() {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+// Moller-Trumbore, hitting both faces
+bool intersectTriangle(const float *corners, const float *origin, const float *direction, float tMax, float &t) {
+    float e1[3], e2[3], s[3];
+    for (int i = 0; i < 3; ++i) {
+        e1[i] = corners[3 + i] - corners[i];
+        e2[i] = corners[6 + i] - corners[i];
+        s[i] = origin[i] - corners[i];
+    }
+    const float p[3] = { direction[1] * e2[2] - direction[2] * e2[1], direction[2] * e2[0] - direction[0] * e2[2],
+                         direction[0] * e2[1] - direction[1] * e2[0] };
+    const float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+    if (std::fabs(det) < 1e-12f) {
+        return false;
+    }
+    const float inverseDet = 1.0f / det;
+    const float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverseDet;
+    const float q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+    const float v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inverseDet;
+    t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverseDet;
+    return u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f && t < tMax;
+}
+
+} // namespace
+
+GLTF_TEST(BVHHitsSingleTriangleWithBarycentrics) {
+    const float corners[9] = { 0, 0, 0,   2, 0, 0,   0, 2, 0 };
+    GLTF::BVH bvh;
+    bvh.build(corners, 1);
+
+    // From behind, so that the back face is hit too
+    const float origin[3] = { 0.5f, 0.25f, -3.0f };
+    const float direction[3] = { 0, 0, 2 };
+    GLTF::BVHHit hit;
+    EXPECT_TRUE(bvh.intersectClosest(origin, direction, 0.0f, 10.0f, hit));
+    EXPECT_EQ(hit.triangle, 0u);
+    EXPECT_NEAR(hit.distance, 1.5, 1e-6);
+    EXPECT_NEAR(hit.u, 0.25, 1e-6);
+    EXPECT_NEAR(hit.v, 0.125, 1e-6);
+
+    // Beyond tMax, and outside the triangle
+    EXPECT_TRUE(!bvh.intersectClosest(origin, direction, 0.0f, 1.4f, hit));
+    const float outside[3] = { 1.5f, 1.5f, -3.0f };
+    EXPECT_TRUE(!bvh.intersectClosest(outside, direction, 0.0f, 10.0f, hit));
+    EXPECT_TRUE(!bvh.intersectAny(outside, direction, 0.0f, 10.0f, hit));
+}
+
+GLTF_TEST(BVHMatchesBruteForceOnTriangleSoup) {
+    const size_t triangleCount = 2000;
+    Random random;
+    std::vector<float> corners(9 * triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const float center[3] = { random.next() * 10, random.next() * 10, random.next() * 10 };
+        for (int corner = 0; corner < 3; ++corner) {
+            for (int axis = 0; axis < 3; ++axis) {
+                corners[9 * t + 3 * corner + axis] = center[axis] + random.next() - 0.5f;
+            }
+        }
+    }
+    GLTF::BVH bvh;
+    bvh.build(corners.data(), triangleCount);
+
+    int hitCount = 0;
+    for (int ray = 0; ray < 500; ++ray) {
+        const float origin[3] = { random.next() * 12 - 1, random.next() * 12 - 1, -2.0f };
+        const float direction[3] = { random.next() - 0.5f, random.next() - 0.5f, 1.0f };
+        const float tMax = 8.0f + 8.0f * random.next();
+
+        float nearest = tMax;
+        uint32_t nearestTriangle = UINT32_MAX;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            float distance;
+            if (intersectTriangle(&corners[9 * t], origin, direction, nearest, distance)) {
+                nearest = distance;
+                nearestTriangle = static_cast<uint32_t>(t);
+            }
+        }
+
+        GLTF::BVHHit closest, any;
+        const bool hitClosest = bvh.intersectClosest(origin, direction, 0.0f, tMax, closest);
+        const bool hitAny = bvh.intersectAny(origin, direction, 0.0f, tMax, any);
+        EXPECT_EQ(hitClosest, nearestTriangle != UINT32_MAX);
+        EXPECT_EQ(hitAny, hitClosest);
+        if (hitClosest && nearestTriangle != UINT32_MAX) {
+            ++hitCount;
+            EXPECT_NEAR(closest.distance, nearest, 1e-4);
+            // A different triangle is only acceptable if it is hit at the same distance
+            float distance;
+            EXPECT_TRUE(closest.triangle == nearestTriangle ||
+                        (intersectTriangle(&corners[9 * closest.triangle], origin, direction, tMax, distance) &&
+                         std::fabs(distance - nearest) <= 1e-4f));
+            EXPECT_TRUE(any.distance >= closest.distance - 1e-4f && any.distance < tMax);
+        }
+    }
+    EXPECT_TRUE(hitCount > 100);
+}
@@ -0,0 +1,126 @@
+#include "TestSupport.h"
+
+#include "GLTFIndexProcessing.h"
+
+namespace {
+
+const uint8_t Restart8 = 0xFF;
+const uint16_t Restart16 = 0xFFFF;
+const uint32_t Restart32 = 0xFFFFFFFFu;
+
+// Enough indices to cover several vector iterations of each width plus a scalar tail
+const size_t ConversionCount = 53;
+
+template <typename Src_t, typename Dst_t>
+void expectConversionPreservesValuesAndRestarts(Src_t srcRestart, Dst_t dstRestart) {
+    std::vector<Src_t> src(ConversionCount);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = (i % 7 == 3) ? srcRestart : Src_t(i * 5 % 251);
+    }
+    std::vector<Dst_t> dst(src.size(), 0);
+    GLTF::ConvertIndices(src.data(), src.size(), dst.data());
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < src.size(); ++i) {
+        const Dst_t expected = (src[i] == srcRestart) ? dstRestart : Dst_t(src[i]);
+        mismatchCount += (dst[i] != expected) ? 1 : 0;
+    }
+    EXPECT_EQ(mismatchCount, 0u);
+}
+
+template <typename Src_t>
+std::vector<uint32_t> toList(GLTF::PrimitiveTopology topology, const std::vector<Src_t> &src) {
+    std::vector<uint32_t> dst(GLTF::ListIndexCountUpperBound(topology, src.size()));
+    dst.resize(GLTF::ConvertIndicesToListTopology(topology, src.data(), src.size(), dst.data()));
+    return dst;
+}
+
+} // namespace
+
+GLTF_TEST(IndexConversionPreservesRestartIndices) {
+    expectConversionPreservesValuesAndRestarts<uint8_t, uint16_t>(Restart8, Restart16);
+    expectConversionPreservesValuesAndRestarts<uint8_t, uint32_t>(Restart8, Restart32);
+    expectConversionPreservesValuesAndRestarts<uint16_t, uint32_t>(Restart16, Restart32);
+    expectConversionPreservesValuesAndRestarts<uint32_t, uint16_t>(Restart32, Restart16);
+}
+
+GLTF_TEST(IndexConversionKeepsValuesAboveSignedRange) {
+    // The SSE2 paths use signed compares and packs, so values with the top bit set must survive them
+    std::vector<uint16_t> shorts(ConversionCount);
+    for (size_t i = 0; i < shorts.size(); ++i) {
+        shorts[i] = uint16_t(0x8000 + i * 997);
+    }
+    std::vector<uint32_t> widened(shorts.size());
+    GLTF::ConvertIndices(shorts.data(), shorts.size(), widened.data());
+    std::vector<uint16_t> narrowed(shorts.size());
+    GLTF::ConvertIndices(widened.data(), widened.size(), narrowed.data());
+    EXPECT_TRUE(narrowed == shorts);
+    EXPECT_EQ(widened[1], 0x8000u + 997u);
+}
+
+GLTF_TEST(MaxIndexValueFindsLargestOfEachWidth) {
+    std::vector<uint8_t> bytes(ConversionCount, 3);
+    bytes[40] = 200;
+    EXPECT_EQ(GLTF::MaxIndexValue(bytes.data(), bytes.size()), 200u);
+
+    std::vector<uint16_t> shorts(ConversionCount, 3);
+    shorts[9] = 0x9000;
+    shorts[50] = 0x8001; // In the scalar tail
+    EXPECT_EQ(GLTF::MaxIndexValue(shorts.data(), shorts.size()), 0x9000u);
+
+    std::vector<uint32_t> ints(ConversionCount, 3);
+    ints[2] = 0x7FFFFFFFu;
+    ints[17] = 0x80000005u;
+    EXPECT_EQ(GLTF::MaxIndexValue(ints.data(), ints.size()), 0x80000005u);
+
+    ints[30] = Restart32;
+    EXPECT_EQ(GLTF::MaxIndexValue(ints.data(), ints.size()), Restart32);
+    EXPECT_EQ(GLTF::MaxIndexValue(ints.data(), 0), 0u);
+}
+
+GLTF_TEST(SequentialIndicesCountUp) {
+    std::vector<uint16_t> indices(ConversionCount);
+    GLTF::GenerateSequentialIndices(indices.size(), indices.data());
+    EXPECT_EQ(indices.front(), 0);
+    EXPECT_EQ(indices.back(), ConversionCount - 1);
+}
+
+GLTF_TEST(TriangleStripAlternatesWinding) {
+    const std::vector<uint16_t> strip = { 0, 1, 2, 3, 4, 5 };
+    EXPECT_TRUE(toList(GLTF::PrimitiveTopologyTriangleStrip, strip) ==
+                std::vector<uint32_t>({ 0, 1, 2,   2, 1, 3,   2, 3, 4,   4, 3, 5 }));
+}
+
+GLTF_TEST(TriangleStripDropsDegenerateTriangles) {
+    // Two strips stitched with repeated vertices. The stitching triangles are dropped, and the second strip's
+    // triangles keep the parity of their position in the whole strip.
+    const std::vector<uint16_t> strip = { 0, 1, 2, 3, 3, 4, 4, 5, 6, 7 };
+    EXPECT_TRUE(toList(GLTF::PrimitiveTopologyTriangleStrip, strip) ==
+                std::vector<uint32_t>({ 0, 1, 2,   2, 1, 3,   4, 5, 6,   6, 5, 7 }));
+}
+
+GLTF_TEST(TriangleStripRestartsWindingAfterRestartIndex) {
+    const std::vector<uint8_t> strip = { 0, 1, 2, 3, Restart8, 4, 5, 6, 7, Restart8, 8, 9 };
+    EXPECT_TRUE(toList(GLTF::PrimitiveTopologyTriangleStrip, strip) ==
+                std::vector<uint32_t>({ 0, 1, 2,   2, 1, 3,   4, 5, 6,   6, 5, 7 }));
+}
+
+GLTF_TEST(TriangleFanSplitsAtRestartsAndDropsDegenerates) {
+    const std::vector<uint32_t> fan = { 0, 1, 2, 2, 3, Restart32, 4, 5, 6 };
+    EXPECT_TRUE(toList(GLTF::PrimitiveTopologyTriangleFan, fan) ==
+                std::vector<uint32_t>({ 0, 1, 2,   0, 2, 3,   4, 5, 6 }));
+}
+
+GLTF_TEST(LineLoopsAndStripsSplitAtRestarts) {
+    const std::vector<uint16_t> loop = { 0, 1, 2, Restart16, 3, 4 };
+    EXPECT_TRUE(toList(GLTF::PrimitiveTopologyLineLoop, loop) ==
+                std::vector<uint32_t>({ 0, 1, 1, 2, 2, 0,   3, 4, 4, 3 }));
+    const std::vector<uint16_t> strip = { 0, 1, 2, Restart16, 3, Restart16, 4, 5 };
+    EXPECT_TRUE(toList(GLTF::PrimitiveTopologyLineStrip, strip) ==
+                std::vector<uint32_t>({ 0, 1, 1, 2,   4, 5 }));
+}
+
+GLTF_TEST(ListsDropPrimitivesThatReferenceRestart) {
+    const std::vector<uint16_t> triangles = { 0, 1, 2,   3, Restart16, 5,   6, 7, 8,   9 };
+    EXPECT_TRUE(toList(GLTF::PrimitiveTopologyTriangles, triangles) ==
+                std::vector<uint32_t>({ 0, 1, 2,   6, 7, 8 }));
+}
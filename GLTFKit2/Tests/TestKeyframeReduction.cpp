@@ -0,0 +1,146 @@
+#include "TestSupport.h"
+
+#include "GLTFAnimationSampling.h"
+#include "GLTFKeyframeReduction.h"
+
+// Reduced tracks are played back with the runtime sampler and compared with the source at the sample times, where
+// the reduction guarantees its tolerances.
+
+using GLTFTest::FloatView;
+
+namespace {
+
+// Evaluates `track` of one node at `time`
+std::vector<float> evaluate(const GLTF::KeyframeTrack &track, float time) {
+    GLTF::AnimationClip clip;
+    const int outputComponents = (track.path == GLTF::AnimationPathWeights) ? 1 : int(track.componentCount);
+    const bool added = clip.addTrack(track.path, track.interpolation, 0, track.componentCount,
+                                     FloatView(track.times, 1), FloatView(track.values, outputComponents));
+    EXPECT_TRUE(added);
+    GLTF::AnimationPose pose;
+    pose.translations.assign(3, 0.0f);
+    pose.rotations.assign(4, 0.0f);
+    pose.scales.assign(3, 0.0f);
+    pose.weights.assign(track.componentCount, 0.0f);
+    GLTF::AnimationCursor cursor;
+    clip.sample(time, cursor, pose);
+    switch (track.path) {
+        case GLTF::AnimationPathTranslation: return pose.translations;
+        case GLTF::AnimationPathRotation:    return pose.rotations;
+        case GLTF::AnimationPathScale:       return pose.scales;
+        default:                             return pose.weights;
+    }
+}
+
+// The largest distance (or, for rotations, angle) between the source and the reduced track over the sample times
+float largestError(const GLTF::KeyframeTrack &source, const GLTF::KeyframeTrack &reduced, float sampleRate) {
+    float largest = 0.0f;
+    const float end = source.times.back();
+    for (float time = source.times.front(); time <= end; time += 1.0f / sampleRate) {
+        const std::vector<float> a = evaluate(source, time), b = evaluate(reduced, time);
+        float error = 0.0f;
+        if (source.path == GLTF::AnimationPathRotation) {
+            const float cosine = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+            error = 2.0f * std::acos(std::min(std::fabs(cosine), 1.0f));
+        } else {
+            for (size_t c = 0; c < a.size(); ++c) {
+                error += (a[c] - b[c]) * (a[c] - b[c]);
+            }
+            error = std::sqrt(error);
+        }
+        largest = std::max(largest, error);
+    }
+    return largest;
+}
+
+} // namespace
+
+GLTF_TEST(ReducedTranslationsStayWithinTolerance) {
+    GLTF::KeyframeTrack track;
+    track.path = GLTF::AnimationPathTranslation;
+    track.interpolation = GLTF::InterpolationLinear;
+    track.componentCount = 3;
+    for (int k = 0; k <= 240; ++k) {
+        const float t = k / 120.0f;
+        track.times.push_back(t);
+        track.values.push_back(std::sin(2.0f * t));
+        track.values.push_back(0.5f * t);
+        track.values.push_back(t < 1.0f ? 0.0f : t - 1.0f);
+    }
+    GLTF::KeyframeReductionSettings settings;
+    settings.positionTolerance = 1e-3f;
+    GLTF::KeyframeTrack reduced = track;
+    EXPECT_TRUE(GLTF::ReduceKeyframes(reduced, settings));
+    EXPECT_EQ(reduced.interpolation, int(GLTF::InterpolationLinear));
+    EXPECT_TRUE(reduced.times.size() < track.times.size() / 4);
+    EXPECT_EQ(reduced.times.front(), track.times.front());
+    EXPECT_EQ(reduced.times.back(), track.times.back());
+    EXPECT_TRUE(largestError(track, reduced, settings.sampleRate) <= settings.positionTolerance * 1.01f);
+}
+
+GLTF_TEST(ReducedCubicRotationsStayWithinTolerance) {
+    // A cubic spline turning about y, slowing down, with tangents that match the turn's rate at each key
+    GLTF::KeyframeTrack track;
+    track.path = GLTF::AnimationPathRotation;
+    track.interpolation = GLTF::InterpolationCubic;
+    track.componentCount = 4;
+    for (int k = 0; k <= 20; ++k) {
+        const float t = k * 0.1f;
+        const float angle = 3.0f * t - 0.6f * t * t, rate = 3.0f - 1.2f * t;
+        const float s = std::sin(0.5f * angle), c = std::cos(0.5f * angle);
+        const float tangent[4] = { 0, 0.5f * rate * c, 0, -0.5f * rate * s };
+        const float value[4] = { 0, s, 0, c };
+        track.times.push_back(t);
+        track.values.insert(track.values.end(), tangent, tangent + 4);
+        track.values.insert(track.values.end(), value, value + 4);
+        track.values.insert(track.values.end(), tangent, tangent + 4);
+    }
+    GLTF::KeyframeReductionSettings settings;
+    settings.sampleRate = 60.0f;
+    settings.angleTolerance = 2e-3f;
+    GLTF::KeyframeTrack reduced = track;
+    EXPECT_TRUE(GLTF::ReduceKeyframes(reduced, settings));
+    EXPECT_EQ(reduced.interpolation, int(GLTF::InterpolationLinear));
+    EXPECT_TRUE(reduced.values.size() < track.values.size());
+    EXPECT_TRUE(largestError(track, reduced, settings.sampleRate) <= settings.angleTolerance * 1.01f);
+}
+
+GLTF_TEST(ConstantAndStepTracksReduce) {
+    GLTF::KeyframeTrack constant;
+    constant.path = GLTF::AnimationPathScale;
+    constant.interpolation = GLTF::InterpolationLinear;
+    constant.componentCount = 3;
+    for (int k = 0; k < 10; ++k) {
+        constant.times.push_back(float(k));
+        constant.values.push_back(2.0f);
+        constant.values.push_back(2.0f + ((k % 2) ? 5e-5f : 0.0f));
+        constant.values.push_back(2.0f);
+    }
+    GLTF::KeyframeReductionSettings settings;
+    EXPECT_TRUE(GLTF::ReduceKeyframes(constant, settings));
+    EXPECT_EQ(constant.times.size(), 1u);
+    EXPECT_EQ(constant.values.size(), 3u);
+
+    // Step tracks keep their key times, and only lose keys that repeat the previous value
+    GLTF::KeyframeTrack step;
+    step.path = GLTF::AnimationPathWeights;
+    step.interpolation = GLTF::InterpolationStep;
+    step.componentCount = 1;
+    step.times = { 0, 1, 2, 3, 4 };
+    step.values = { 0, 0, 1, 1, 0 };
+    EXPECT_TRUE(GLTF::ReduceKeyframes(step, settings));
+    EXPECT_TRUE(step.times == std::vector<float>({ 0, 2, 4 }));
+    EXPECT_TRUE(step.values == std::vector<float>({ 0, 1, 0 }));
+}
+
+GLTF_TEST(InvalidTracksAreLeftUnchanged) {
+    GLTF::KeyframeTrack track;
+    track.path = GLTF::AnimationPathTranslation;
+    track.interpolation = GLTF::InterpolationLinear;
+    track.componentCount = 3;
+    track.times = { 0, 2, 1 };
+    track.values = { 0, 0, 0,   1, 1, 1,   2, 2, 2 };
+    const GLTF::KeyframeTrack original = track;
+    EXPECT_TRUE(!GLTF::ReduceKeyframes(track, GLTF::KeyframeReductionSettings()));
+    EXPECT_TRUE(track.times == original.times && track.values == original.values);
+}
@@ -0,0 +1,103 @@
+
+#include "TestSupport.h"
+
+#include "GLTFAccessorView.h"
+#include "GLTFBoundsComputation.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Accessors whose elements lie beyond 4 GB from the start of their buffer. The buffer is a sparse temporary
+// file, so only the pages that hold elements occupy memory or disk.
+
+namespace {
+
+const size_t LargeStride = 1 << 20;
+const size_t LargeCount = 5000; // The last element starts ~4.9 GB into the buffer
+
+float ExpectedComponent(size_t index, int component) {
+    const float scale[3] = { 1.0f, -0.5f, 0.0f };
+    return static_cast<float>(index) * scale[component] + static_cast<float>(component);
+}
+
+struct SparseBuffer {
+    int fd = -1;
+    void *base = MAP_FAILED;
+    size_t length = 0;
+
+    ~SparseBuffer() {
+        if (base != MAP_FAILED) {
+            munmap(base, length);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool create(size_t byteLength) {
+        char path[] = "/tmp/GLTFKitLargeOffsetsXXXXXX";
+        fd = mkstemp(path);
+        if (fd < 0) {
+            return false;
+        }
+        unlink(path);
+        if (ftruncate(fd, static_cast<off_t>(byteLength)) != 0) {
+            return false;
+        }
+        for (size_t i = 0; i < LargeCount; ++i) {
+            float element[3];
+            for (int c = 0; c < 3; ++c) {
+                element[c] = ExpectedComponent(i, c);
+            }
+            const off_t offset = static_cast<off_t>(i * LargeStride);
+            if (pwrite(fd, element, sizeof(element), offset) != static_cast<ssize_t>(sizeof(element))) {
+                return false;
+            }
+        }
+        length = byteLength;
+        base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        return base != MAP_FAILED;
+    }
+};
+
+} // namespace
+
+GLTF_TEST(AccessorElementsBeyondFourGigabytes) {
+    if (sizeof(size_t) < 8) {
+        return;
+    }
+    SparseBuffer buffer;
+    if (!buffer.create(LargeCount * LargeStride)) {
+        fprintf(stderr, "note: skipping large offset test, could not map a sparse 5 GB file\n");
+        return;
+    }
+
+    GLTF::AccessorView view;
+    view.data = static_cast<const uint8_t *>(buffer.base);
+    view.stride = LargeStride;
+    view.count = LargeCount;
+    view.componentType = GLTF::ComponentTypeFloat;
+    view.componentCount = 3;
+
+    const size_t last = LargeCount - 1;
+    EXPECT_TRUE(static_cast<uint64_t>(last) * LargeStride > UINT64_C(0xFFFFFFFF));
+    EXPECT_EQ(view.element(last) - view.data, static_cast<ptrdiff_t>(last * LargeStride));
+
+    float element[3];
+    EXPECT_EQ(GLTF::ReadFloats(view, last, element, 3), 3);
+    for (int c = 0; c < 3; ++c) {
+        EXPECT_EQ(element[c], ExpectedComponent(last, c));
+    }
+
+    double lo[3], hi[3];
+    EXPECT_TRUE(GLTF::ComputeComponentBounds(view, lo, hi));
+    EXPECT_EQ(lo[0], 0.0);
+    EXPECT_EQ(hi[0], static_cast<double>(ExpectedComponent(last, 0)));
+    EXPECT_EQ(lo[1], static_cast<double>(ExpectedComponent(last, 1)));
+    EXPECT_EQ(hi[1], 1.0);
+    EXPECT_EQ(lo[2], 2.0);
+    EXPECT_EQ(hi[2], 2.0);
+}
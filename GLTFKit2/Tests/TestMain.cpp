@@ -0,0 +1,13 @@
+
+#include "TestSupport.h"
+
+int main() {
+    const std::vector<GLTFTest::TestCase> &tests = GLTFTest::RegisteredTests();
+    for (size_t i = 0; i < tests.size(); ++i) {
+        const int failuresBefore = GLTFTest::FailureCount();
+        tests[i].function();
+        printf("%s %s\n", GLTFTest::FailureCount() == failuresBefore ? "[ PASS ]" : "[ FAIL ]", tests[i].name);
+    }
+    printf("%zu tests, %d failed expectations\n", tests.size(), GLTFTest::FailureCount());
+    return GLTFTest::FailureCount() == 0 ? 0 : 1;
+}
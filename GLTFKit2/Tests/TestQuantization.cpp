@@ -0,0 +1,96 @@
+#include "TestSupport.h"
+
+#include "GLTFQuantization.h"
+
+// Quantized data is decoded through an AccessorView, as the framework reads it, and compared with the source.
+
+using GLTFTest::FloatView;
+
+namespace {
+
+GLTF::AccessorView quantizedView(const std::vector<uint8_t> &data, int format, int componentCount, size_t count) {
+    GLTF::AccessorView view;
+    view.data = data.data();
+    view.stride = GLTF::QuantizedStride(format, componentCount);
+    view.count = count;
+    switch (format) {
+        case GLTF::VertexComponentFormatSNorm8:  view.componentType = GLTF::ComponentTypeByte; break;
+        case GLTF::VertexComponentFormatUNorm8:  view.componentType = GLTF::ComponentTypeUnsignedByte; break;
+        case GLTF::VertexComponentFormatSNorm16: view.componentType = GLTF::ComponentTypeShort; break;
+        default:                                 view.componentType = GLTF::ComponentTypeUnsignedShort; break;
+    }
+    view.componentCount = componentCount;
+    view.normalized = true;
+    return view;
+}
+
+} // namespace
+
+GLTF_TEST(QuantizedPositionsRoundTripWithinHalfAStep) {
+    // Positions spanning [-3, 5] on every axis, mapped into [-1, 1] about the center of that range
+    std::vector<float> positions;
+    for (int i = 0; i < 1000; ++i) {
+        positions.push_back(-3.0f + 8.0f * i / 999.0f);
+        positions.push_back(5.0f - 0.00737f * i);
+        positions.push_back(std::sin(0.37f * i) * 4.0f + 1.0f);
+    }
+    GLTF::QuantizationParameters parameters;
+    parameters.format = GLTF::VertexComponentFormatSNorm16;
+    const float center = 1.0f, halfExtent = 4.0f;
+    for (int c = 0; c < 3; ++c) {
+        parameters.offset[c] = center;
+        parameters.scale[c] = 1.0f / halfExtent;
+    }
+    const GLTF::AccessorView source = FloatView(positions, 3);
+    std::vector<uint8_t> quantized(GLTF::QuantizedStride(parameters.format, 3) * source.count);
+    const float reportedError = GLTF::QuantizeVertexStream(source, parameters, quantized.data());
+    EXPECT_EQ(GLTF::QuantizedStride(parameters.format, 3), 8u);
+
+    const GLTF::AccessorView decoded = quantizedView(quantized, parameters.format, 3, source.count);
+    float largestError = 0.0f;
+    for (size_t i = 0; i < source.count; ++i) {
+        float values[3];
+        GLTF::ReadFloats(decoded, i, values, 3);
+        for (int c = 0; c < 3; ++c) {
+            largestError = std::max(largestError, std::fabs(values[c] * halfExtent + center - positions[3 * i + c]));
+        }
+    }
+    const float halfStep = 0.5f * halfExtent / 32767.0f;
+    EXPECT_TRUE(largestError <= halfStep + 4e-6f); // Allowing for float rounding in decoding and restoring
+    EXPECT_NEAR(reportedError, largestError, 1e-6);
+}
+
+GLTF_TEST(QuantizedWeightsKeepTheirSum) {
+    // Weights that each round the same way, so that rounding separately would leave the sum one step short
+    const std::vector<float> weights = {
+        0.25f, 0.25f, 0.25f, 0.25f,
+        0.3f, 0.3f, 0.3f, 0.1f,
+        1.0f, 0.0f, 0.0f, 0.0f,
+    };
+    GLTF::QuantizationParameters parameters;
+    parameters.format = GLTF::VertexComponentFormatUNorm8;
+    parameters.preservesSum = true;
+    const GLTF::AccessorView source = FloatView(weights, 4);
+    std::vector<uint8_t> quantized(GLTF::QuantizedStride(parameters.format, 4) * source.count);
+    const float reportedError = GLTF::QuantizeVertexStream(source, parameters, quantized.data());
+    for (size_t i = 0; i < source.count; ++i) {
+        const uint8_t *element = &quantized[4 * i];
+        EXPECT_EQ(element[0] + element[1] + element[2] + element[3], 255);
+    }
+    // The adjustment may move the largest weight by more than half a step, but by less than two
+    EXPECT_TRUE(reportedError < 2.0f / 255.0f);
+}
+
+GLTF_TEST(QuantizationClampsOutOfRangeValues) {
+    const std::vector<float> normals = { 2.0f, -2.0f, 0.5f };
+    GLTF::QuantizationParameters parameters;
+    parameters.format = GLTF::VertexComponentFormatSNorm8;
+    const GLTF::AccessorView source = FloatView(normals, 3);
+    std::vector<uint8_t> quantized(GLTF::QuantizedStride(parameters.format, 3));
+    const float reportedError = GLTF::QuantizeVertexStream(source, parameters, quantized.data());
+    EXPECT_EQ(static_cast<int8_t>(quantized[0]), 127);
+    EXPECT_EQ(static_cast<int8_t>(quantized[1]), -127);
+    EXPECT_EQ(static_cast<int8_t>(quantized[2]), 64);
+    EXPECT_EQ(quantized[3], 0); // Padding
+    EXPECT_NEAR(reportedError, 1.0, 1e-6);
+}
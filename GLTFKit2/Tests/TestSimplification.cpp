@@ -0,0 +1,78 @@
+#include "TestSupport.h"
+
+#include "GLTFSimplification.h"
+
+using GLTFTest::FloatView;
+
+namespace {
+
+const int GridSize = 17; // Vertices along each side of a flat, square grid
+
+struct Grid {
+    std::vector<float> positions;
+    std::vector<float> texCoords;
+    std::vector<uint32_t> indices;
+};
+
+// A flat grid over the unit square whose texture coordinates are (x, y) warped by `warp`
+Grid makeGrid(float warp) {
+    Grid grid;
+    for (int y = 0; y < GridSize; ++y) {
+        for (int x = 0; x < GridSize; ++x) {
+            const float u = x / float(GridSize - 1), v = y / float(GridSize - 1);
+            grid.positions.push_back(u);
+            grid.positions.push_back(v);
+            grid.positions.push_back(0);
+            grid.texCoords.push_back(u + warp * u * u * v * v);
+            grid.texCoords.push_back(v);
+        }
+    }
+    for (int y = 0; y + 1 < GridSize; ++y) {
+        for (int x = 0; x + 1 < GridSize; ++x) {
+            const uint32_t a = y * GridSize + x, b = a + 1, c = a + GridSize, d = c + 1;
+            const uint32_t quad[6] = { a, b, d, a, d, c };
+            grid.indices.insert(grid.indices.end(), quad, quad + 6);
+        }
+    }
+    return grid;
+}
+
+size_t simplifiedIndexCount(const Grid &grid, bool useTexCoords, float targetError) {
+    const GLTF::AccessorView noView;
+    const std::vector<size_t> targets(1, 6);
+    const std::vector<GLTF::SimplifiedLevel> levels = GLTF::SimplifyToLevels(
+        FloatView(grid.positions, 3), noView, useTexCoords ? FloatView(grid.texCoords, 2) : noView,
+        grid.indices.data(), grid.indices.size(), targets, targetError);
+    return levels.empty() ? grid.indices.size() : levels.back().indices.size();
+}
+
+} // namespace
+
+GLTF_TEST(SimplificationCollapsesLinearTexCoordsFreely) {
+    // Texture coordinates that vary linearly across a plane are reproduced exactly by any collapse, so they must not
+    // hold back simplification of the interior.
+    const Grid grid = makeGrid(0.0f);
+    const size_t withoutTexCoords = simplifiedIndexCount(grid, false, 1e-3f);
+    const size_t withTexCoords = simplifiedIndexCount(grid, true, 1e-3f);
+    EXPECT_TRUE(withoutTexCoords < grid.indices.size());
+    EXPECT_EQ(withTexCoords, withoutTexCoords);
+}
+
+GLTF_TEST(SimplificationChargesTexCoordDistortion) {
+    // The geometry is flat, so only the texture coordinate error can stop collapses of a warped mapping.
+    const Grid grid = makeGrid(0.5f);
+    const size_t withoutTexCoords = simplifiedIndexCount(grid, false, 1e-3f);
+    const size_t withTexCoords = simplifiedIndexCount(grid, true, 1e-3f);
+    EXPECT_TRUE(withTexCoords > withoutTexCoords);
+
+    // The recorded error accounts for the texture coordinate error it allowed
+    const std::vector<size_t> targets(1, 6);
+    const std::vector<GLTF::SimplifiedLevel> levels = GLTF::SimplifyToLevels(
+        FloatView(grid.positions, 3), GLTF::AccessorView(), FloatView(grid.texCoords, 2), grid.indices.data(),
+        grid.indices.size(), targets, 0.05f);
+    EXPECT_TRUE(!levels.empty());
+    if (!levels.empty()) {
+        EXPECT_TRUE(levels[0].error > 0.0f);
+        EXPECT_TRUE(levels[0].error <= 0.05f);
+    }
+}
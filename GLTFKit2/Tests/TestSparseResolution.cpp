@@ -0,0 +1,111 @@
+#include "TestSupport.h"
+
+#include "GLTFSparseResolution.h"
+
+#include <cstring>
+
+namespace {
+
+struct Resolution {
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> slots;
+    size_t discardedCount;
+};
+
+template <typename Index_t>
+Resolution resolve(const std::vector<Index_t> &sparseIndices, size_t elementCount) {
+    Resolution resolution;
+    resolution.indices.resize(sparseIndices.size());
+    resolution.slots.resize(sparseIndices.size());
+    resolution.discardedCount = 0;
+    const size_t resolvedCount = GLTF::ResolveSparseIndices(sparseIndices.data(), sparseIndices.size(), elementCount,
+                                                            resolution.indices.data(), resolution.slots.data(),
+                                                            resolution.discardedCount);
+    resolution.indices.resize(resolvedCount);
+    resolution.slots.resize(resolvedCount);
+    return resolution;
+}
+
+} // namespace
+
+GLTF_TEST(SparseResolutionPassesSortedIndicesThrough) {
+    const Resolution resolution = resolve(std::vector<uint16_t>({ 1, 4, 5, 9 }), 10);
+    EXPECT_TRUE(resolution.indices == std::vector<uint32_t>({ 1, 4, 5, 9 }));
+    EXPECT_TRUE(resolution.slots == std::vector<uint32_t>({ 0, 1, 2, 3 }));
+    EXPECT_EQ(resolution.discardedCount, 0u);
+}
+
+GLTF_TEST(SparseResolutionSortsUnsortedIndices) {
+    const Resolution resolution = resolve(std::vector<uint8_t>({ 7, 2, 5, 0 }), 8);
+    EXPECT_TRUE(resolution.indices == std::vector<uint32_t>({ 0, 2, 5, 7 }));
+    EXPECT_TRUE(resolution.slots == std::vector<uint32_t>({ 3, 1, 2, 0 }));
+    EXPECT_EQ(resolution.discardedCount, 0u);
+}
+
+GLTF_TEST(SparseResolutionKeepsLastOccurrenceOfDuplicates) {
+    // Index 3 appears at slots 0, 2 and 4; index 1 at slots 1 and 3. The later values replace the earlier ones.
+    const Resolution resolution = resolve(std::vector<uint32_t>({ 3, 1, 3, 1, 3, 6 }), 8);
+    EXPECT_TRUE(resolution.indices == std::vector<uint32_t>({ 1, 3, 6 }));
+    EXPECT_TRUE(resolution.slots == std::vector<uint32_t>({ 3, 4, 5 }));
+    EXPECT_EQ(resolution.discardedCount, 0u);
+}
+
+GLTF_TEST(SparseResolutionDropsOutOfRangeIndices) {
+    const Resolution resolution = resolve(std::vector<uint32_t>({ 2, 10, 0, 0xFFFFFFFFu, 9, 4 }), 10);
+    EXPECT_TRUE(resolution.indices == std::vector<uint32_t>({ 0, 2, 4, 9 }));
+    EXPECT_TRUE(resolution.slots == std::vector<uint32_t>({ 2, 0, 5, 4 }));
+    EXPECT_EQ(resolution.discardedCount, 2u);
+
+    const Resolution empty = resolve(std::vector<uint16_t>({ 5, 6 }), 5);
+    EXPECT_TRUE(empty.indices.empty());
+    EXPECT_EQ(empty.discardedCount, 2u);
+}
+
+GLTF_TEST(SparseGatherFollowsSlotsAndStride) {
+    // Three-byte elements padded to a four-byte stride
+    const std::vector<uint8_t> values = { 10, 11, 12, 0, 20, 21, 22, 0, 30, 31, 32, 0 };
+    const std::vector<uint32_t> slots = { 2, 0 };
+    std::vector<uint8_t> gathered(6);
+    GLTF::GatherSparseValues(values.data(), 4, slots.data(), slots.size(), 3, gathered.data());
+    EXPECT_TRUE(gathered == std::vector<uint8_t>({ 30, 31, 32, 10, 11, 12 }));
+
+    std::vector<uint8_t> packed(9);
+    GLTF::GatherSparseValues(values.data(), 4, nullptr, 3, 3, packed.data());
+    EXPECT_TRUE(packed == std::vector<uint8_t>({ 10, 11, 12, 20, 21, 22, 30, 31, 32 }));
+}
+
+GLTF_TEST(SparseScatterWritesRunsAndLeavesGapsAlone) {
+    // Runs of 3 (indices 1-3) and 2 (indices 6-7) with a single element at 9, for a template element size and for
+    // the generic path
+    const std::vector<uint32_t> indices = { 1, 2, 3, 6, 7, 9 };
+    const size_t elementSizes[] = { 4, 5 };
+    for (size_t elementSize : elementSizes) {
+        std::vector<uint8_t> values(indices.size() * elementSize);
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = uint8_t(100 + i);
+        }
+        std::vector<uint8_t> destination(10 * elementSize, 0xEE);
+        GLTF::ScatterSparseValues(values.data(), indices.data(), indices.size(), elementSize, destination.data());
+
+        std::vector<uint8_t> expected(10 * elementSize, 0xEE);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            memcpy(&expected[indices[i] * elementSize], &values[i * elementSize], elementSize);
+        }
+        EXPECT_TRUE(destination == expected);
+    }
+}
+
+GLTF_TEST(SparseResolveThenScatterAppliesLastValue) {
+    const std::vector<uint8_t> sparseIndices = { 4, 1, 4, 12 };
+    const std::vector<float> sparseValues = { 1.0f, 2.0f, 3.0f, 4.0f };
+    const Resolution resolution = resolve(sparseIndices, 6);
+
+    std::vector<float> gathered(resolution.indices.size());
+    GLTF::GatherSparseValues(sparseValues.data(), sizeof(float), resolution.slots.data(), resolution.slots.size(),
+                             sizeof(float), gathered.data());
+    std::vector<float> elements(6, 0.0f);
+    GLTF::ScatterSparseValues(gathered.data(), resolution.indices.data(), resolution.indices.size(), sizeof(float),
+                              elements.data());
+    EXPECT_TRUE(elements == std::vector<float>({ 0, 2, 0, 0, 3, 0 }));
+    EXPECT_EQ(resolution.discardedCount, 1u);
+}
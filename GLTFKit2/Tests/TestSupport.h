@@ -0,0 +1,71 @@
+
+#pragma once
+
+#include "GLTFAccessorView.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// A minimal self-registering test harness, so that the kernel tests need nothing beyond the standard library.
+
+namespace GLTFTest {
+
+typedef void (*TestFunction)();
+
+struct TestCase {
+    const char *name;
+    TestFunction function;
+};
+
+inline std::vector<TestCase> &RegisteredTests() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+inline int &FailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+struct TestRegistrar {
+    TestRegistrar(const char *name, TestFunction function) {
+        TestCase test = { name, function };
+        RegisteredTests().push_back(test);
+    }
+};
+
+inline void ReportFailure(const char *file, int line, const char *expression) {
+    fprintf(stderr, "%s:%d: expectation failed: %s\n", file, line, expression);
+    ++FailureCount();
+}
+
+/// A tightly packed float view of `values`, which must outlive the view.
+inline GLTF::AccessorView FloatView(const std::vector<float> &values, int componentCount) {
+    GLTF::AccessorView view;
+    view.data = reinterpret_cast<const uint8_t *>(values.data());
+    view.stride = sizeof(float) * componentCount;
+    view.count = values.size() / componentCount;
+    view.componentType = GLTF::ComponentTypeFloat;
+    view.componentCount = componentCount;
+    return view;
+}
+
+} // namespace GLTFTest
+
+#define GLTF_TEST(name)                                                                                         \
+    static void name();                                                                                         \
+    static GLTFTest::TestRegistrar name##Registrar(#name, &name);                                               \
+    static void name()
+
+#define EXPECT_TRUE(expression)                                                                                 \
+    do {                                                                                                        \
+        if (!(expression)) {                                                                                    \
+            GLTFTest::ReportFailure(__FILE__, __LINE__, #expression);                                           \
+        }                                                                                                       \
+    } while (0)
+
+#define EXPECT_EQ(a, b) EXPECT_TRUE((a) == (b))
+
+#define EXPECT_NEAR(a, b, tolerance)                                                                            \
+    EXPECT_TRUE(std::fabs(static_cast<double>(a) - static_cast<double>(b)) <= (tolerance))
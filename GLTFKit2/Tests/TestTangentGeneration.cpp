@@ -0,0 +1,176 @@
+
+#include "TestSupport.h"
+
+#include "GLTFTangentGeneration.h"
+#include "MikkTSpaceReference.h"
+
+// Expected tangents are derived by hand from the texture mapping of each face, and every fixture is also compared,
+// corner by corner, with the reference algorithm in MikkTSpaceReference.h. Texture coordinates are in the glTF
+// convention, so a mapping whose v coordinate increases downward (toward -y) is not mirrored and has w = 1.
+
+using GLTFTest::FloatView;
+
+namespace {
+
+void expectTangent(const GLTF::GeneratedTangents &generated, uint32_t vertex, float x, float y, float z, float w) {
+    EXPECT_TRUE(4 * vertex + 3 < generated.tangents.size());
+    if (4 * vertex + 3 >= generated.tangents.size()) {
+        return;
+    }
+    const float *tangent = &generated.tangents[4 * vertex];
+    EXPECT_NEAR(tangent[0], x, 1e-6);
+    EXPECT_NEAR(tangent[1], y, 1e-6);
+    EXPECT_NEAR(tangent[2], z, 1e-6);
+    EXPECT_EQ(tangent[3], w);
+}
+
+// Checks that every corner's output vertex carries exactly the tangent and sign the reference gives that corner.
+void expectMatchesReference(const std::vector<float> &positions, const std::vector<float> &normals,
+                            const std::vector<float> &texCoords, const std::vector<uint32_t> &indices,
+                            const GLTF::GeneratedTangents &generated)
+{
+    MikkTSpaceReference::Mesh mesh;
+    mesh.positions = positions;
+    mesh.normals = normals;
+    mesh.texCoords = texCoords;
+    for (size_t v = 0; v < texCoords.size() / 2; ++v) {
+        mesh.texCoords[2 * v + 1] = 1.0f - texCoords[2 * v + 1]; // To MikkTSpace's bottom-left origin
+    }
+    mesh.indices = indices;
+    const std::vector<MikkTSpaceReference::CornerTangent> reference = MikkTSpaceReference::GenerateTangents(mesh);
+
+    size_t mismatchCount = 0;
+    for (size_t c = 0; c < indices.size(); ++c) {
+        const uint32_t vertex = generated.indices.empty() ? indices[c] : generated.indices[c];
+        if (4 * vertex + 3 >= generated.tangents.size()) {
+            ++mismatchCount;
+            continue;
+        }
+        const float *tangent = &generated.tangents[4 * vertex];
+        const bool matches = tangent[0] == reference[c].tangent[0] && tangent[1] == reference[c].tangent[1] &&
+                             tangent[2] == reference[c].tangent[2] && tangent[3] == reference[c].sign;
+        mismatchCount += matches ? 0 : 1;
+    }
+    EXPECT_EQ(mismatchCount, 0u);
+}
+
+} // namespace
+
+GLTF_TEST(TangentsSplitAlongMirroredSeam) {
+    // Two quads side by side. The right one mirrors the texture of the left one across their shared edge (x = 1), so
+    // the seam vertices have the same position, normal, and texture coordinates on both sides.
+    const std::vector<float> positions = {
+        0, 0, 0,   1, 0, 0,   2, 0, 0,
+        0, 1, 0,   1, 1, 0,   2, 1, 0,
+    };
+    const std::vector<float> normals = {
+        0, 0, 1,   0, 0, 1,   0, 0, 1,
+        0, 0, 1,   0, 0, 1,   0, 0, 1,
+    };
+    const std::vector<float> texCoords = {
+        0, 1,   1, 1,   0, 1,
+        0, 0,   1, 0,   0, 0,
+    };
+    const std::vector<uint32_t> indices = { 0, 1, 4,   0, 4, 3,   1, 2, 5,   1, 5, 4 };
+
+    GLTF::GeneratedTangents generated;
+    EXPECT_TRUE(GLTF::GenerateTangents(FloatView(positions, 3), FloatView(normals, 3), FloatView(texCoords, 2),
+                                       indices.data(), indices.size(), generated));
+    expectMatchesReference(positions, normals, texCoords, indices, generated);
+    EXPECT_EQ(generated.splitSourceVertices.size(), size_t(2));
+    EXPECT_EQ(generated.indices.size(), size_t(12));
+    EXPECT_EQ(generated.tangents.size(), size_t(4 * 8));
+    if (generated.indices.size() != 12) {
+        return;
+    }
+    for (size_t c = 0; c < 12; ++c) {
+        const uint32_t vertex = generated.indices[c];
+        if (vertex >= 6) {
+            EXPECT_EQ(generated.splitSourceVertices[vertex - 6], indices[c]);
+        } else {
+            EXPECT_EQ(vertex, indices[c]);
+        }
+        // Along +x with u on the left, and along -x with mirrored handedness on the right
+        if (c < 6) {
+            expectTangent(generated, vertex, 1, 0, 0, 1);
+        } else {
+            expectTangent(generated, vertex, -1, 0, 0, -1);
+        }
+    }
+}
+
+GLTF_TEST(TangentsFollowSkewedMappingInNormalPlane) {
+    // u = x + y and v = 1 - (y - x), so the surface's derivative with respect to u is (1, 1, 0) / 2. The normals are
+    // tilted to (0, -1, 1) / sqrt(2), into whose plane that direction projects as (2, 1, 1) / sqrt(6).
+    const float s = 1.0f / std::sqrt(2.0f);
+    const std::vector<float> positions = { 0, 0, 0,   1, 0, 0,   0, 1, 0 };
+    const std::vector<float> normals = { 0, -s, s,   0, -s, s,   0, -s, s };
+    const std::vector<float> texCoords = { 0, 1,   1, 2,   1, 0 };
+    const std::vector<uint32_t> indices = { 0, 1, 2 };
+
+    GLTF::GeneratedTangents generated;
+    EXPECT_TRUE(GLTF::GenerateTangents(FloatView(positions, 3), FloatView(normals, 3), FloatView(texCoords, 2),
+                                       indices.data(), indices.size(), generated));
+    expectMatchesReference(positions, normals, texCoords, indices, generated);
+    EXPECT_TRUE(generated.splitSourceVertices.empty());
+    EXPECT_TRUE(generated.indices.empty());
+    const float r = 1.0f / std::sqrt(6.0f);
+    for (uint32_t v = 0; v < 3; ++v) {
+        expectTangent(generated, v, 2 * r, r, r, 1);
+    }
+}
+
+GLTF_TEST(TangentsOfDegenerateTrianglesMatchReferenceFallbacks) {
+    // The second triangle has two corners at the same position. Its corner at vertex 0 copies the tangent of the good
+    // triangle; vertex 3 is used by no good triangle and gets the reference's default of (1, 0, 0) with w = -1.
+    const std::vector<float> positions = { 0, 0, 0,   1, 0, 0,   0, 1, 0,   1, 0, 0 };
+    const std::vector<float> normals = { 0, 0, 1,   0, 0, 1,   0, 0, 1,   0, 0, 1 };
+    const std::vector<float> texCoords = { 0, 1,   0, 0,   1, 1,   0.5f, 0.5f };
+    const std::vector<uint32_t> indices = { 0, 1, 2,   0, 1, 3 };
+
+    GLTF::GeneratedTangents generated;
+    EXPECT_TRUE(GLTF::GenerateTangents(FloatView(positions, 3), FloatView(normals, 3), FloatView(texCoords, 2),
+                                       indices.data(), indices.size(), generated));
+    expectMatchesReference(positions, normals, texCoords, indices, generated);
+    EXPECT_TRUE(generated.splitSourceVertices.empty());
+    // u increases along +y and v along -x, which is a mirrored mapping
+    for (uint32_t v = 0; v < 3; ++v) {
+        expectTangent(generated, v, 0, 1, 0, -1);
+    }
+    expectTangent(generated, 3, 1, 0, 0, -1);
+}
+
+GLTF_TEST(TangentsMatchReferenceOnCurvedMirroredGrid) {
+    // A curved 12 x 12 grid with smooth normals whose texture is mirrored across its middle column and skewed, with
+    // stitching triangles that are degenerate in position appended. Grouping, angle weighting, splitting, and the
+    // degenerate fallbacks all take part.
+    const uint32_t size = 12;
+    std::vector<float> positions, normals, texCoords;
+    for (uint32_t y = 0; y <= size; ++y) {
+        for (uint32_t x = 0; x <= size; ++x) {
+            const float fx = float(x), fy = float(y);
+            const float z = 0.3f * std::sin(0.5f * fx) * std::cos(0.4f * fy);
+            positions.insert(positions.end(), { fx, fy, z });
+            const float dzdx = 0.15f * std::cos(0.5f * fx) * std::cos(0.4f * fy);
+            const float dzdy = -0.12f * std::sin(0.5f * fx) * std::sin(0.4f * fy);
+            const float length = std::sqrt(dzdx * dzdx + dzdy * dzdy + 1.0f);
+            normals.insert(normals.end(), { -dzdx / length, -dzdy / length, 1.0f / length });
+            const float u = std::fabs(fx - 0.5f * size) / size + 0.05f * fy / size;
+            texCoords.insert(texCoords.end(), { u, 1.0f - fy / size });
+        }
+    }
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            const uint32_t a = y * (size + 1) + x, b = a + 1, c = a + size + 1, d = c + 1;
+            indices.insert(indices.end(), { a, b, d, a, d, c });
+        }
+    }
+    indices.insert(indices.end(), { 0, 0, 14,   20, 33, 33,   7, 8, 7 });
+
+    GLTF::GeneratedTangents generated;
+    EXPECT_TRUE(GLTF::GenerateTangents(FloatView(positions, 3), FloatView(normals, 3), FloatView(texCoords, 2),
+                                       indices.data(), indices.size(), generated));
+    EXPECT_TRUE(!generated.splitSourceVertices.empty());
+    expectMatchesReference(positions, normals, texCoords, indices, generated);
+}
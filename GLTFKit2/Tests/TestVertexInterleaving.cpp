@@ -0,0 +1,158 @@
+#include "TestSupport.h"
+
+#include "GLTFVertexInterleaving.h"
+
+#include <cstring>
+
+using GLTFTest::FloatView;
+
+namespace {
+
+// Encodes a value that is exactly representable as a normal binary16 number (or zero), independently of FloatToHalf.
+uint16_t exactHalf(float value) {
+    if (value == 0.0f) {
+        return 0;
+    }
+    int exponent = 0;
+    const float mantissa = std::frexp(std::fabs(value), &exponent); // In [0.5, 1)
+    const uint16_t sign = (value < 0.0f) ? 0x8000 : 0;
+    return uint16_t(sign | ((exponent - 1 + 15) << 10) | uint16_t((mantissa * 2.0f - 1.0f) * 1024.0f));
+}
+
+template <typename T>
+void append(std::vector<uint8_t> &bytes, size_t offset, T value) {
+    memcpy(&bytes[offset], &value, sizeof(T));
+}
+
+} // namespace
+
+GLTF_TEST(InterleavingWritesEveryStreamByteForByte) {
+    // Not a multiple of the tile size, so the last tile is partial
+    const size_t vertexCount = 5000;
+    const size_t stride = 48;
+    const uint8_t Padding = 0xCD;
+
+    // Float positions, copied bitwise to offset 0
+    std::vector<float> positions(3 * vertexCount);
+    for (size_t i = 0; i < positions.size(); ++i) {
+        positions[i] = float(i) * 0.25f - 100.0f;
+    }
+
+    // Normalized shorts in a padded source (8-byte stride), copied bitwise to offset 12
+    const size_t normalStride = 8;
+    std::vector<uint8_t> normals(normalStride * vertexCount, 0x77);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        for (size_t c = 0; c < 3; ++c) {
+            append<int16_t>(normals, v * normalStride + c * 2, int16_t(int(v * 3 + c) % 65535 - 32767));
+        }
+    }
+    GLTF::AccessorView normalView;
+    normalView.data = normals.data();
+    normalView.stride = normalStride;
+    normalView.count = vertexCount;
+    normalView.componentType = GLTF::ComponentTypeShort;
+    normalView.componentCount = 3;
+    normalView.normalized = true;
+
+    // Float texture coordinates, flipped and converted to half at offset 20
+    std::vector<float> texCoords(2 * vertexCount);
+    for (size_t i = 0; i < texCoords.size(); ++i) {
+        texCoords[i] = float(i % 65) / 64.0f;
+    }
+
+    // Normalized unsigned shorts, converted to unsigned normalized bytes at offset 24. Multiples of 257 are exactly
+    // k / 255, so they convert to k.
+    std::vector<uint16_t> colors(4 * vertexCount);
+    for (size_t i = 0; i < colors.size(); ++i) {
+        colors[i] = uint16_t((i % 256) * 257);
+    }
+    GLTF::AccessorView colorView;
+    colorView.data = reinterpret_cast<const uint8_t *>(colors.data());
+    colorView.stride = 4 * sizeof(uint16_t);
+    colorView.count = vertexCount;
+    colorView.componentType = GLTF::ComponentTypeUnsignedShort;
+    colorView.componentCount = 4;
+    colorView.normalized = true;
+
+    // Two unnormalized unsigned shorts widened to three floats at offset 32; z is filled with 0
+    std::vector<uint16_t> pairs(2 * vertexCount);
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        pairs[i] = uint16_t(i * 7);
+    }
+    GLTF::AccessorView pairView;
+    pairView.data = reinterpret_cast<const uint8_t *>(pairs.data());
+    pairView.stride = 2 * sizeof(uint16_t);
+    pairView.count = vertexCount;
+    pairView.componentType = GLTF::ComponentTypeUnsignedShort;
+    pairView.componentCount = 2;
+
+    GLTF::VertexStream streams[6];
+    streams[0].source = FloatView(positions, 3);
+    streams[0].format = GLTF::VertexComponentFormatFloat;
+    streams[0].componentCount = 3;
+    streams[0].offset = 0;
+    streams[1].source = normalView;
+    streams[1].format = GLTF::VertexComponentFormatSNorm16;
+    streams[1].componentCount = 3;
+    streams[1].offset = 12;
+    streams[2].source = FloatView(texCoords, 2);
+    streams[2].format = GLTF::VertexComponentFormatHalf;
+    streams[2].componentCount = 2;
+    streams[2].offset = 20;
+    streams[2].flipTexCoordVertical = true;
+    streams[3].source = colorView;
+    streams[3].format = GLTF::VertexComponentFormatUNorm8;
+    streams[3].componentCount = 4;
+    streams[3].offset = 24;
+    // No source: filled with (0, 0, 0, 1)
+    streams[4].format = GLTF::VertexComponentFormatUNorm8;
+    streams[4].componentCount = 4;
+    streams[4].offset = 28;
+    streams[5].source = pairView;
+    streams[5].format = GLTF::VertexComponentFormatFloat;
+    streams[5].componentCount = 3;
+    streams[5].offset = 32;
+
+    std::vector<uint8_t> interleaved(stride * vertexCount, Padding);
+    GLTF::InterleaveVertexStreams(streams, 6, vertexCount, stride, interleaved.data());
+
+    std::vector<uint8_t> expected(stride * vertexCount, Padding);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const size_t base = v * stride;
+        memcpy(&expected[base], &positions[3 * v], 12);
+        memcpy(&expected[base + 12], &normals[v * normalStride], 6);
+        append<uint16_t>(expected, base + 20, exactHalf(texCoords[2 * v]));
+        append<uint16_t>(expected, base + 22, exactHalf(1.0f - texCoords[2 * v + 1]));
+        for (size_t c = 0; c < 4; ++c) {
+            expected[base + 24 + c] = uint8_t(colors[4 * v + c] / 257);
+        }
+        expected[base + 28] = 0;
+        expected[base + 29] = 0;
+        expected[base + 30] = 0;
+        expected[base + 31] = 255;
+        append<float>(expected, base + 32, float(pairs[2 * v]));
+        append<float>(expected, base + 36, float(pairs[2 * v + 1]));
+        append<float>(expected, base + 40, 0.0f);
+    }
+
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (interleaved[i] != expected[i]) {
+            ++mismatchCount;
+        }
+    }
+    EXPECT_EQ(mismatchCount, 0u);
+}
+
+GLTF_TEST(InterleavingFillsVerticesBeyondAShortSource) {
+    // A source with fewer elements than vertices defaults the rest instead of reading past its end
+    const std::vector<float> weights = { 0.5f, 0.25f, 0.75f, 1.0f };
+    GLTF::VertexStream stream;
+    stream.source = FloatView(weights, 2);
+    stream.format = GLTF::VertexComponentFormatFloat;
+    stream.componentCount = 2;
+
+    std::vector<float> interleaved(2 * 3, -1.0f);
+    GLTF::InterleaveVertexStreams(&stream, 1, 3, 2 * sizeof(float), reinterpret_cast<uint8_t *>(interleaved.data()));
+    EXPECT_TRUE(interleaved == std::vector<float>({ 0.5f, 0.25f, 0.75f, 1.0f, 0.0f, 0.0f }));
+}
@@ -0,0 +1,78 @@
+#include "TestSupport.h"
+
+#include "GLTFVertexWelding.h"
+
+#include <limits>
+
+using GLTFTest::FloatView;
+
+namespace {
+
+struct WeldResult {
+    std::vector<uint32_t> sourceVertices;
+    std::vector<uint32_t> indices;
+};
+
+WeldResult weld(const std::vector<float> &positions, const std::vector<uint32_t> &indices, float epsilon) {
+    const std::vector<GLTF::AccessorView> streams(1, FloatView(positions, 3));
+    WeldResult result;
+    const bool succeeded = GLTF::WeldVertices(streams, positions.size() / 3, indices.empty() ? nullptr : indices.data(),
+                                              indices.size(), epsilon, result.sourceVertices, result.indices);
+    EXPECT_TRUE(succeeded);
+    return result;
+}
+
+} // namespace
+
+GLTF_TEST(WeldingMergesExactDuplicatesInOrderOfUse) {
+    const std::vector<float> positions = {
+        0, 0, 0,   1, 0, 0,   0, 1, 0,
+        1, 0, 0,   -0.0f, 0, 0,   0, 1, 0,
+    };
+    const std::vector<uint32_t> indices = { 2, 1, 0, 3, 4, 5 };
+    const WeldResult result = weld(positions, indices, 0.0f);
+    EXPECT_TRUE(result.sourceVertices == std::vector<uint32_t>({ 2, 1, 0 }));
+    EXPECT_TRUE(result.indices == std::vector<uint32_t>({ 0, 1, 2, 1, 2, 0 }));
+}
+
+GLTF_TEST(WeldingRoundsToMultiplesOfEpsilon) {
+    const std::vector<float> positions = {
+        1.0f, 2.0f, 3.0f,
+        1.0004f, 1.9996f, 3.0f, // Rounds to the same multiples of 1e-3
+        1.0016f, 2.0f, 3.0f,    // Does not
+    };
+    const WeldResult result = weld(positions, std::vector<uint32_t>(), 1e-3f);
+    EXPECT_TRUE(result.sourceVertices == std::vector<uint32_t>({ 0, 2 }));
+    EXPECT_TRUE(result.indices == std::vector<uint32_t>({ 0, 0, 1 }));
+}
+
+GLTF_TEST(WeldingComparesValuesBeyondRoundingExactly) {
+    // With a tiny epsilon, large components are far beyond the range of rounded keys; they must still be compared
+    // (exactly) rather than overflow, and must not collide with rounded keys or with non-finite values.
+    const float large = std::numeric_limits<float>::max();
+    const float infinity = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const std::vector<float> positions = {
+        large, 0, 0,
+        large, 0, 0,
+        -large, 0, 0,
+        std::nextafter(large, 0.0f), 0, 0,
+        infinity, 0, 0,
+        infinity, 0, 0,
+        -infinity, 0, 0,
+        nan, 0, 0,
+        nan, 0, 0,
+        0, 0, 0,
+    };
+    const WeldResult result = weld(positions, std::vector<uint32_t>(), 1e-30f);
+    EXPECT_TRUE(result.sourceVertices == std::vector<uint32_t>({ 0, 2, 3, 4, 6, 7, 9 }));
+    EXPECT_TRUE(result.indices == std::vector<uint32_t>({ 0, 0, 1, 2, 3, 3, 4, 5, 5, 6 }));
+}
+
+GLTF_TEST(WeldingRejectsOutOfRangeIndices) {
+    const std::vector<float> positions = { 0, 0, 0 };
+    const std::vector<GLTF::AccessorView> streams(1, FloatView(positions, 3));
+    const uint32_t indices[] = { 0, 1 };
+    std::vector<uint32_t> sourceVertices, weldedIndices;
+    EXPECT_TRUE(!GLTF::WeldVertices(streams, 1, indices, 2, 0.0f, sourceVertices, weldedIndices));
+}